@@ -0,0 +1,406 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    BatchProcessor.cpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Batch Processor Class File
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class file for the offline processing of recorded videos into per
+ *  frame CSV files of lane fits, confidence and timing.
+ *
+ */
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include "BatchProcessor.hpp"
+
+/**
+ *   @brief Default constructor for BatchProcessor
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+BatchProcessor::BatchProcessor() {
+  outputDir = ".";
+  queueDepth = 4;
+  displayEnabled = false;
+  // the fits are written even with visualization and tracking off
+  lanes.setLaneFitting(true);
+  lanes.getVisualizer().setMode(LaneVisualizer::VISUALIZE_NONE);
+}
+/**
+ *   @brief Default destructor for BatchProcessor
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+BatchProcessor::~BatchProcessor() {
+}
+/**
+ *   @brief Function to set the directory the CSV files are written to;
+ *          it must exist
+ *
+ *   @param directory of type std::string
+ *   @return nothing
+ */
+void BatchProcessor::setOutputDir(const std::string& outputDir_) {
+  CV_Assert(!outputDir_.empty());
+  outputDir = outputDir_;
+}
+/**
+ *   @brief Function to get the directory the CSV files are written to
+ *
+ *   @param nothing
+ *   @return directory of type std::string
+ */
+std::string BatchProcessor::getOutputDir(void) {
+  return outputDir;
+}
+/**
+ *   @brief Function to set the size frames are resized to before
+ *          processing
+ *
+ *   @param size, empty to keep the size of the video, of type cv::Size
+ *   @return nothing
+ */
+void BatchProcessor::setResolution(const cv::Size& resolution_) {
+  CV_Assert(resolution_.width >= 0 && resolution_.height >= 0);
+  resolution = resolution_;
+}
+/**
+ *   @brief Function to get the size frames are resized to before
+ *          processing
+ *
+ *   @param nothing
+ *   @return size, empty for the size of the video, of type cv::Size
+ */
+cv::Size BatchProcessor::getResolution(void) {
+  return resolution;
+}
+/**
+ *   @brief Function to set the number of frames in flight in the pipeline
+ *
+ *   @param number of frames, at least 1, of type int
+ *   @return nothing
+ */
+void BatchProcessor::setQueueDepth(int queueDepth_) {
+  CV_Assert(queueDepth_ >= 1);
+  queueDepth = queueDepth_;
+}
+/**
+ *   @brief Function to get the number of frames in flight in the pipeline
+ *
+ *   @param nothing
+ *   @return number of frames of type int
+ */
+int BatchProcessor::getQueueDepth(void) {
+  return queueDepth;
+}
+/**
+ *   @brief Function to show the frames in a window while processing
+ *
+ *   @param true to show the frames of type bool
+ *   @return nothing
+ */
+void BatchProcessor::setDisplay(bool displayEnabled_) {
+  displayEnabled = displayEnabled_;
+  lanes.getVisualizer().setMode(displayEnabled
+      ? LaneVisualizer::VISUALIZE_WINDOW : LaneVisualizer::VISUALIZE_NONE);
+}
+/**
+ *   @brief Function to check if the frames are shown while processing
+ *
+ *   @param nothing
+ *   @return true if the frames are shown of type bool
+ */
+bool BatchProcessor::isDisplay(void) {
+  return displayEnabled;
+}
+/**
+ *   @brief Function to get the lane detection run on every video
+ *
+ *   @param nothing
+ *   @return lane detection of type LaneDetection&
+ */
+LaneDetection& BatchProcessor::getLaneDetection(void) {
+  return lanes;
+}
+/**
+ *   @brief Function to get the splitting of videos into parallel time
+ *          chunks; with more than one chunk videos are processed in
+ *          chunks unless the frames are shown
+ *
+ *   @param nothing
+ *   @return chunked processor of type ChunkedProcessor&
+ */
+ChunkedProcessor& BatchProcessor::getChunkedProcessor(void) {
+  return chunkedProcessor;
+}
+/**
+ *   @brief Function to expand the input arguments into video paths;
+ *          arguments with wildcards are globbed
+ *
+ *   @param input paths or globs of type std::vector<std::string>
+ *   @param video paths of type std::vector<std::string>
+ *   @return false if a glob matched nothing, type bool
+ */
+bool BatchProcessor::expandInputs(const std::vector<std::string>& inputs,
+                                  std::vector<std::string>& videoPaths) {
+  bool isMatched = true;
+  for (const std::string& input : inputs) {
+    if (input.find_first_of("*?[") == std::string::npos) {
+      videoPaths.push_back(input);
+      continue;
+    }
+    std::vector<cv::String> matches;
+    try {
+      cv::glob(input, matches, false);
+    } catch (const cv::Exception&) {
+      // the directory of the pattern does not exist
+      matches.clear();
+    }
+    if (matches.empty()) {
+      std::cerr << "No video matches " << input << std::endl;
+      isMatched = false;
+    }
+    // glob order depends on the file system
+    std::sort(matches.begin(), matches.end());
+    for (const cv::String& match : matches) {
+      videoPaths.push_back(match);
+    }
+  }
+  return isMatched;
+}
+/**
+ *   @brief Function to get the CSV file of a video, named after it in the
+ *          output directory
+ *
+ *   @param path of the video of type std::string
+ *   @return path of the CSV file of type std::string
+ */
+std::string BatchProcessor::getOutputPath(const std::string& videoPath) {
+  std::size_t nameBegin = videoPath.find_last_of("/\\");
+  nameBegin = (nameBegin == std::string::npos) ? 0 : nameBegin + 1;
+  std::string name = videoPath.substr(nameBegin);
+  std::size_t extBegin = name.find_last_of('.');
+  if (extBegin != std::string::npos && extBegin > 0) {
+    name = name.substr(0, extBegin);
+  }
+  return outputDir + "/" + name + ".csv";
+}
+/**
+ *   @brief Function to write the column names of the CSV file
+ *
+ *   @param CSV file of type std::ostream
+ *   @return nothing
+ */
+void BatchProcessor::writeHeader(std::ostream& csv) {
+  csv << "frame,latency_ms,decode_ms,transform_ms,search_ms,output_ms,"
+      << "left_pixels,right_pixels,left_confidence,right_confidence";
+  const char* laneNames[LaneTracker::NUM_LANES] = { "left", "right" };
+  for (int lane = 0; lane < LaneTracker::NUM_LANES; lane++) {
+    for (int k = 0; k <= lanes.getLaneFitter().getOrder(); k++) {
+      csv << "," << laneNames[lane] << "_c" << k;
+    }
+  }
+  csv << "\n";
+}
+/**
+ *   @brief Function to write the row of a processed frame
+ *
+ *   @param CSV file of type std::ostream
+ *   @param processed frame of type FramePipeline::FrameResult
+ *   @return nothing
+ */
+void BatchProcessor::writeRow(std::ostream& csv,
+                              const FramePipeline::FrameResult& result) {
+  FrameWorkspace& workspace = *result.workspace;
+  csv << result.frameIdx << "," << result.latencyMs;
+  for (int stage = 0; stage < FramePipeline::NUM_STAGES; stage++) {
+    csv << "," << result.stageMs[stage];
+  }
+  std::size_t lanePixels[LaneTracker::NUM_LANES];
+  for (int lane = 0; lane < LaneTracker::NUM_LANES; lane++) {
+    lanePixels[lane] = workspace.getLanePoints(lane).size();
+    csv << "," << lanePixels[lane];
+  }
+  // share of the pixels a confident fit needs, up to 1
+  double minPixels = std::max<double>(lanes.getMinTrackPixels(), 1);
+  for (int lane = 0; lane < LaneTracker::NUM_LANES; lane++) {
+    csv << "," << std::min(1.0, lanePixels[lane] / minPixels);
+  }
+  const cv::Mat* laneFits = workspace.getLaneFits();
+  int numCoeffs = lanes.getLaneFitter().getOrder() + 1;
+  for (int lane = 0; lane < LaneTracker::NUM_LANES; lane++) {
+    for (int k = 0; k < numCoeffs; k++) {
+      // a lane too short to fit has no coefficients
+      if (laneFits[lane].empty()) {
+        csv << ",nan";
+      } else {
+        csv << "," << laneFits[lane].at<double>(k);
+      }
+    }
+  }
+  csv << "\n";
+}
+/**
+ *   @brief Function to process a video into its CSV file
+ *
+ *   @param path of the video of type std::string
+ *   @return false if the video could not be read, processed or written,
+ *          type bool
+ */
+bool BatchProcessor::processVideo(const std::string& videoPath) {
+  cv::VideoCapture cap(videoPath);
+  if (!cap.isOpened()) {
+    std::cerr << "Can not open video " << videoPath << std::endl;
+    return false;
+  }
+  std::string outputPath = getOutputPath(videoPath);
+  std::ofstream csv(outputPath.c_str());
+  if (!csv) {
+    std::cerr << "Can not write " << outputPath << std::endl;
+    return false;
+  }
+  csv.precision(9);
+  writeHeader(csv);
+  // every video starts without the lanes of the previous one
+  lanes.getLaneTracker().reset();
+  lanes.resetTrack();
+  lanes.resetSearchStats();
+  uint64_t framesWritten = 0;
+  try {
+    bool isChunked = chunkedProcessor.getNumChunks() > 1 && !displayEnabled;
+    if (isChunked && !processChunks(videoPath, cap, csv)) {
+      std::cerr << "Can not seek in " << videoPath
+          << ", processing it sequentially" << std::endl;
+      isChunked = false;
+    }
+    framesWritten = isChunked ? chunkedProcessor.getFramesWritten()
+        : processSequential(cap, csv);
+  } catch (const std::exception& e) {
+    // cv::Exception, and std::bad_alloc or std::system_error of the
+    // pipeline threads, fail only this video
+    std::cerr << "Failed processing " << videoPath << ": " << e.what()
+        << std::endl;
+    return false;
+  }
+  if (framesWritten == 0) {
+    std::cerr << "No frame decoded from " << videoPath << std::endl;
+    return false;
+  }
+  csv.flush();
+  if (!csv) {
+    std::cerr << "Failed writing " << outputPath << std::endl;
+    return false;
+  }
+  return true;
+}
+/**
+ *   @brief Function to process a video in frame order through the
+ *          pipeline
+ *
+ *   @param opened video of type cv::VideoCapture
+ *   @param CSV file of type std::ostream
+ *   @return number of frames written of type uint64_t
+ */
+uint64_t BatchProcessor::processSequential(cv::VideoCapture& cap,
+                                           std::ostream& csv) {
+  FramePipeline pipeline(lanes);
+  pipeline.setQueueDepth(queueDepth);
+  pipeline.setFrameSink([&](const FramePipeline::FrameResult& result) {
+    writeRow(csv, result);
+    return !displayEnabled || lanes.getVisualizer().show(
+        result.workspace->getBuffer(FrameWorkspace::OUTPUT_FRAME));
+  });
+  cv::Mat videoFrame;  // decoded frame before resizing
+  if (resolution.area() > 0) {
+    pipeline.run([&](cv::Mat& frame) {
+      if (!cap.read(videoFrame)) {
+        return false;
+      }
+      cv::resize(videoFrame, frame, resolution);
+      return true;
+    });
+  } else {
+    pipeline.run(cap);
+  }
+  return pipeline.getFramesProcessed();
+}
+/**
+ *   @brief Function to process a video as parallel time chunks, each
+ *          read by its own capture
+ *
+ *   @param path of the video of type std::string
+ *   @param opened video of type cv::VideoCapture
+ *   @param CSV file of type std::ostream
+ *   @return false if a chunk could not seek to its first frame, type bool
+ */
+bool BatchProcessor::processChunks(const std::string& videoPath,
+                                   cv::VideoCapture& cap, std::ostream& csv) {
+  // only tells the length, the chunks read through their own captures
+  double frameCount = std::max(0.0, cap.get(cv::CAP_PROP_FRAME_COUNT));
+  cv::Size size = resolution;
+  ChunkedProcessor::SourceOpener openSource = [&videoPath, size](
+      uint64_t firstFrame) -> FramePipeline::FrameSource {
+    std::shared_ptr<cv::VideoCapture> chunkCap =
+        std::make_shared<cv::VideoCapture>(videoPath);
+    if (!chunkCap->isOpened()) {
+      return FramePipeline::FrameSource();
+    }
+    if (firstFrame > 0) {
+      // a seek the container can not do exactly would shift the rows
+      chunkCap->set(cv::CAP_PROP_POS_FRAMES, static_cast<double>(firstFrame));
+      if (static_cast<uint64_t>(chunkCap->get(cv::CAP_PROP_POS_FRAMES) + 0.5)
+          != firstFrame) {
+        return FramePipeline::FrameSource();
+      }
+    }
+    std::shared_ptr<cv::Mat> videoFrame = std::make_shared<cv::Mat>();
+    return [chunkCap, videoFrame, size](cv::Mat& frame) -> bool {
+      if (size.area() == 0) {
+        return chunkCap->read(frame);
+      }
+      if (!chunkCap->read(*videoFrame)) {
+        return false;
+      }
+      cv::resize(*videoFrame, frame, size);
+      return true;
+    };
+  };
+  return chunkedProcessor.process(
+      lanes, static_cast<uint64_t>(frameCount), openSource,
+      [this](std::ostream& rows, const FramePipeline::FrameResult& result) {
+        writeRow(rows, result);
+      }, csv);
+}
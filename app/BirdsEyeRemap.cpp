@@ -0,0 +1,244 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright [2018] rohithjayarajan, Akash Guha
+ *  @file    BirdsEyeRemap.cpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Birds Eye Remap Class File
+ *
+ *  @section DESCRIPTION
+ *
+ *  Composes the lens distortion model with the perspective homography
+ *  into one lookup table, replacing the undistortion pass and the
+ *  perspective warp pass of the lane detection pipeline with a single
+ *  remap from the raw sensor image to the bird's-eye view.
+ *
+ */
+
+#include "BirdsEyeRemap.hpp"
+/**
+ *   @brief Default constructor for BirdsEyeRemap
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+BirdsEyeRemap::BirdsEyeRemap() {
+  hasROI = false;
+}
+/**
+ *   @brief Default destructor for BirdsEyeRemap
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+BirdsEyeRemap::~BirdsEyeRemap() {
+}
+/**
+ *   @brief Function to compose the distortion model and the homography
+ *          into the raw sensor to bird's-eye lookup tables
+ *
+ *   @param camera matrix of type cv::Mat
+ *   @param distortion coefficients k1, k2, p1, p2, k3 of type cv::Mat
+ *   @param undistorted image to bird's-eye homography of type cv::Mat
+ *   @param lane polygon in undistorted image coordinates, empty for none,
+ *          type std::vector<cv::Point>
+ *   @param raw sensor image size of type cv::Size
+ *   @param bird's-eye image size of type cv::Size
+ *   @return nothing
+ */
+void BirdsEyeRemap::build(const cv::Mat& intrinsic,
+                          const cv::Mat& distortionCoeffs,
+                          const cv::Mat& T_perspective,
+                          const std::vector<cv::Point>& laneROIVertices,
+                          const cv::Size& srcSize_, const cv::Size& dstSize_) {
+  CV_Assert(distortionCoeffs.total() == 5);
+  cv::Mat_<double> K, dist, T_inv;
+  intrinsic.convertTo(K, CV_64F);
+  distortionCoeffs.reshape(1, 1).convertTo(dist, CV_64F);
+  // bird's-eye pixels are looked up backwards, so walk the inverse homography
+  T_inv = T_perspective.inv();
+  const double fx = K(0, 0), fy = K(1, 1), cx = K(0, 2), cy = K(1, 2);
+  const double k1 = dist(0, 0), k2 = dist(0, 1), p1 = dist(0, 2),
+      p2 = dist(0, 3), k3 = dist(0, 4);
+  cv::Mat map(dstSize_, CV_32FC2);
+  for (int v = 0; v < dstSize_.height; v++) {
+    cv::Vec2f* mapRow = map.ptr<cv::Vec2f>(v);
+    for (int u = 0; u < dstSize_.width; u++) {
+      // bird's-eye pixel to undistorted image pixel
+      double w = T_inv(2, 0) * u + T_inv(2, 1) * v + T_inv(2, 2);
+      double xu = (T_inv(0, 0) * u + T_inv(0, 1) * v + T_inv(0, 2)) / w;
+      double yu = (T_inv(1, 0) * u + T_inv(1, 1) * v + T_inv(1, 2)) / w;
+      // undistorted image pixel to raw sensor pixel through the same
+      // distortion model cv::initUndistortRectifyMap uses
+      double x = (xu - cx) / fx;
+      double y = (yu - cy) / fy;
+      double r2 = x * x + y * y;
+      double radial = 1.0 + r2 * (k1 + r2 * (k2 + r2 * k3));
+      double xd = x * radial + 2.0 * p1 * x * y + p2 * (r2 + 2.0 * x * x);
+      double yd = y * radial + p1 * (r2 + 2.0 * y * y) + 2.0 * p2 * x * y;
+      mapRow[u] = cv::Vec2f(static_cast<float>(fx * xd + cx),
+                            static_cast<float>(fy * yd + cy));
+    }
+  }
+  // fixed-point tables keep the per frame remap on the fast integer path
+  cv::Mat unused;
+  cv::convertMaps(map, cv::Mat(), linearMap1, linearMap2, CV_16SC2, false);
+  cv::convertMaps(map, cv::Mat(), nearestMap, unused, CV_16SC2, true);
+  // the lane polygon is a straight edged shape in the undistorted image,
+  // so its image under the homography is again a convex polygon
+  hasROI = !laneROIVertices.empty();
+  if (hasROI) {
+    std::vector<cv::Point2f> srcVertices, dstVertices;
+    for (auto& n : laneROIVertices) {
+      srcVertices.push_back(cv::Point2f(n.x, n.y));
+    }
+    cv::perspectiveTransform(srcVertices, dstVertices, T_perspective);
+    std::vector<cv::Point> birdsEyeVertices;
+    for (auto& n : dstVertices) {
+      birdsEyeVertices.push_back(cv::Point(cvRound(n.x), cvRound(n.y)));
+    }
+    birdsEyeROI.setVertices(birdsEyeVertices);
+    birdsEyeROI.update(dstSize_);
+  }
+  srcSize = srcSize_;
+  dstSize = dstSize_;
+}
+/**
+ *   @brief Function to drop the lookup tables
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void BirdsEyeRemap::clear(void) {
+  linearMap1.release();
+  linearMap2.release();
+  nearestMap.release();
+  hasROI = false;
+}
+/**
+ *   @brief Function to check if the lookup tables are built for the
+ *          given image sizes
+ *
+ *   @param raw sensor image size of type cv::Size
+ *   @param bird's-eye image size of type cv::Size
+ *   @return true if the tables can be used, type bool
+ */
+bool BirdsEyeRemap::isBuiltFor(const cv::Size& srcSize_,
+                               const cv::Size& dstSize_) const {
+  return !nearestMap.empty() && srcSize == srcSize_ && dstSize == dstSize_;
+}
+/**
+ *   @brief Function to sample a raw sensor image into the bird's-eye view
+ *          with bilinear interpolation
+ *
+ *   @param raw sensor image of type cv::Mat
+ *   @param bird's-eye image of type cv::Mat
+ *   @return nothing
+ */
+void BirdsEyeRemap::warpImage(const cv::Mat& src, cv::Mat& dst) const {
+  cv::remap(src, dst, linearMap1, linearMap2, cv::INTER_LINEAR,
+            cv::BORDER_CONSTANT);
+}
+/**
+ *   @brief Function to sample a raw sensor binary mask into the bird's-eye
+ *          view with nearest neighbour interpolation, so the output stays
+ *          binary, and clip it to the lane polygon
+ *
+ *   @param raw sensor binary image of type cv::Mat
+ *   @param bird's-eye binary image of type cv::Mat
+ *   @return nothing
+ */
+void BirdsEyeRemap::warpMask(const cv::Mat& src, cv::Mat& dst) const {
+  CV_Assert(src.type() == CV_8U && src.size() == srcSize);
+  dst.create(dstSize, CV_8U);
+  for (int y = 0; y < dstSize.height; y++) {
+    uchar* dstRow = dst.ptr<uchar>(y);
+    cv::Vec2i span(0, dstSize.width);
+    if (hasROI) {
+      span = birdsEyeROI.getSpan(y);
+    }
+    if (span[1] <= span[0]) {
+      std::memset(dstRow, 0, dstSize.width);
+      continue;
+    }
+    // only pixels inside the lane polygon are sampled
+    std::memset(dstRow, 0, span[0]);
+    std::memset(dstRow + span[1], 0, dstSize.width - span[1]);
+    // nearest neighbour lookup, same as cv::remap with INTER_NEAREST and a
+    // zero constant border
+    const cv::Vec2s* xy = nearestMap.ptr<cv::Vec2s>(y);
+    for (int x = span[0]; x < span[1]; x++) {
+      unsigned int srcX = static_cast<unsigned int>(xy[x][0]);
+      unsigned int srcY = static_cast<unsigned int>(xy[x][1]);
+      dstRow[x] = (srcX < static_cast<unsigned int>(srcSize.width)
+          && srcY < static_cast<unsigned int>(srcSize.height)) ?
+          src.ptr<uchar>(srcY)[srcX] : 0;
+    }
+  }
+}
+/**
+ *   @brief Function to sample a raw sensor binary mask straight into a
+ *          packed bird's-eye mask, same pixels as warpMask
+ *
+ *   @param raw sensor binary image of type cv::Mat
+ *   @param packed bird's-eye binary image of type PackedBinaryImage
+ *   @return nothing
+ */
+void BirdsEyeRemap::warpMaskPacked(const cv::Mat& src,
+                                   PackedBinaryImage& dst) const {
+  CV_Assert(src.type() == CV_8U && src.size() == srcSize);
+  dst.create(dstSize);
+  dst.clear();
+  for (int y = 0; y < dstSize.height; y++) {
+    uint64_t* dstRow = dst.getRow(y);
+    cv::Vec2i span(0, dstSize.width);
+    if (hasROI) {
+      span = birdsEyeROI.getSpan(y);
+    }
+    // nearest neighbour lookup inside the lane polygon, one bit per hit
+    const cv::Vec2s* xy = nearestMap.ptr<cv::Vec2s>(y);
+    for (int x = span[0]; x < span[1]; x++) {
+      unsigned int srcX = static_cast<unsigned int>(xy[x][0]);
+      unsigned int srcY = static_cast<unsigned int>(xy[x][1]);
+      if (srcX < static_cast<unsigned int>(srcSize.width)
+          && srcY < static_cast<unsigned int>(srcSize.height)
+          && src.ptr<uchar>(srcY)[srcX]) {
+        dstRow[x >> 6] |= static_cast<uint64_t>(1) << (x & 63);
+      }
+    }
+  }
+}
+/**
+ *   @brief Function to get the lane polygon in bird's-eye space
+ *
+ *   @param nothing
+ *   @return per row spans of the polygon of type PolygonSpans
+ */
+const PolygonSpans& BirdsEyeRemap::getBirdsEyeROI(void) const {
+  return birdsEyeROI;
+}
@@ -0,0 +1,206 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright [2018] rohithjayarajan, Akash Guha
+ *  @file    ChunkedProcessor.cpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Chunked Processor Class File
+ *
+ *  @section DESCRIPTION
+ *
+ *  Splits a recording into time chunks with a warm-up before each, runs
+ *  them as parallel streams and merges their output in time order.
+ *
+ */
+
+#include <algorithm>
+#include <limits>
+#include "ChunkedProcessor.hpp"
+
+/**
+ *   @brief Default constructor for ChunkedProcessor
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+ChunkedProcessor::ChunkedProcessor() {
+  numChunks = 1;
+  warmupFrames = 30;  // twice the default tracker history
+}
+/**
+ *   @brief Default destructor for ChunkedProcessor
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+ChunkedProcessor::~ChunkedProcessor() {
+}
+/**
+ *   @brief Function to set the number of chunks a recording is split
+ *          into
+ *
+ *   @param number of chunks, 1 for a sequential run, of type int
+ *   @return nothing
+ */
+void ChunkedProcessor::setNumChunks(int numChunks_) {
+  CV_Assert(numChunks_ >= 1);
+  numChunks = numChunks_;
+}
+/**
+ *   @brief Function to get the number of chunks a recording is split
+ *          into
+ *
+ *   @param nothing
+ *   @return number of chunks of type int
+ */
+int ChunkedProcessor::getNumChunks(void) {
+  return numChunks;
+}
+/**
+ *   @brief Function to set the number of frames processed before the
+ *          first frame of a chunk
+ *
+ *   @param number of frames, at least 0, of type int
+ *   @return nothing
+ */
+void ChunkedProcessor::setWarmupFrames(int warmupFrames_) {
+  CV_Assert(warmupFrames_ >= 0);
+  warmupFrames = warmupFrames_;
+}
+/**
+ *   @brief Function to get the number of frames processed before the
+ *          first frame of a chunk
+ *
+ *   @param nothing
+ *   @return number of frames of type int
+ */
+int ChunkedProcessor::getWarmupFrames(void) {
+  return warmupFrames;
+}
+/**
+ *   @brief Function to get the engine running the chunks, e.g. to set
+ *          the number of workers
+ *
+ *   @param nothing
+ *   @return engine of type LaneDetectionEngine&
+ */
+LaneDetectionEngine& ChunkedProcessor::getEngine(void) {
+  return engine;
+}
+/**
+ *   @brief Function to process a recording in chunks and write the
+ *          output of every frame in time order
+ *
+ *   @param settings every chunk starts from of type LaneDetection
+ *   @param frames in the recording, 0 if unknown for a sequential run,
+ *          of type uint64_t; the last chunk reads to the end
+ *   @param opener of a source at a frame of type
+ *          ChunkedProcessor::SourceOpener
+ *   @param writer of the output of a frame, called on the workers, of
+ *          type ChunkedProcessor::RowWriter
+ *   @param merged output of type std::ostream
+ *   @return false if a chunk could not be opened, nothing is processed
+ *          then, type bool
+ */
+bool ChunkedProcessor::process(LaneDetection& settings, uint64_t frameCount,
+                               const SourceOpener& openSource,
+                               const RowWriter& writeRow,
+                               std::ostream& output) {
+  // chunks of at least one frame; an unknown length is one chunk
+  uint64_t numRanges = std::max<uint64_t>(1, std::min<uint64_t>(numChunks,
+                                                                frameCount));
+  uint64_t chunkFrames = (frameCount + numRanges - 1) / numRanges;
+  chunks.clear();
+  engine.clearStreams();
+  for (uint64_t c = 0; c < numRanges; c++) {
+    std::unique_ptr<Chunk> chunk(new Chunk());
+    chunk->begin = c * chunkFrames;
+    chunk->end = (c + 1 == numRanges) ? std::numeric_limits<uint64_t>::max()
+        : (c + 1) * chunkFrames;
+    chunk->warmupBegin = chunk->begin
+        - std::min<uint64_t>(chunk->begin, warmupFrames);
+    chunk->nextFrame = chunk->warmupBegin;
+    chunk->framesWritten = 0;
+    chunk->rows.precision(output.precision());
+    chunk->readFrame = openSource(chunk->warmupBegin);
+    if (!chunk->readFrame) {
+      chunks.clear();
+      return false;
+    }
+    chunks.push_back(std::move(chunk));
+  }
+  for (auto& chunkPtr : chunks) {
+    Chunk* chunk = chunkPtr.get();
+    engine.addStream(settings, [chunk](cv::Mat& frame) {
+      // the next chunk reads on from here
+      if (chunk->nextFrame == chunk->end || !chunk->readFrame(frame)) {
+        return false;
+      }
+      chunk->nextFrame++;
+      return true;
+    }, [chunk, writeRow](const FramePipeline::FrameResult& result) {
+      uint64_t frameIdx = chunk->warmupBegin + result.frameIdx;
+      // warm-up frames only settle the tracker
+      if (frameIdx >= chunk->begin) {
+        FramePipeline::FrameResult row = result;
+        row.frameIdx = frameIdx;
+        writeRow(chunk->rows, row);
+        chunk->framesWritten++;
+      }
+      return true;
+    });
+  }
+  engine.run();
+  for (auto& chunk : chunks) {
+    output << chunk->rows.str();
+  }
+  return true;
+}
+/**
+ *   @brief Function to get the number of frames the last run wrote
+ *
+ *   @param nothing
+ *   @return number of frames of type uint64_t
+ */
+uint64_t ChunkedProcessor::getFramesWritten(void) {
+  uint64_t framesWritten = 0;
+  for (auto& chunk : chunks) {
+    framesWritten += chunk->framesWritten;
+  }
+  return framesWritten;
+}
+/**
+ *   @brief Function to get the number of frames the last run processed,
+ *          warm-up frames included
+ *
+ *   @param nothing
+ *   @return number of frames of type uint64_t
+ */
+uint64_t ChunkedProcessor::getFramesProcessed(void) {
+  return engine.getFramesProcessed();
+}
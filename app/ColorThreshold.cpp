@@ -0,0 +1,445 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright [2018] rohithjayarajan, Akash Guha
+ *  @file    ColorThreshold.cpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Color Threshold Class File
+ *
+ *  @section DESCRIPTION
+ *
+ *  Fused multi-rule colour threshold kernel of the lane detection
+ *  pipeline. Each pixel is first tested against conservative per rule
+ *  bounds, 16 pixels at a time with OpenCV universal intrinsics: a box
+ *  test for BGR rules and lightness and saturation bounds computed from
+ *  the largest and smallest channel for HLS rules. Pixels that can pass
+ *  are resolved exactly with a bit table of all 2^24 BGR colours holding
+ *  the OR of all rules. The tables are generated from cv::cvtColor and
+ *  cv::inRange, so no converted image is produced and the mask is
+ *  bit-exact with thresholding each colour space and ORing the masks.
+ *
+ */
+
+#include "ColorThreshold.hpp"
+
+#if CV_SIMD128
+/**
+ *   @brief Function to test 8 pixels against the conservative HLS bounds
+ *
+ *   @param largest channel of each pixel of type cv::v_uint16x8
+ *   @param smallest channel of each pixel of type cv::v_uint16x8
+ *   @param lowest max+min passing the lightness bound of type
+ *          cv::v_uint16x8
+ *   @param highest max+min passing the lightness bound of type
+ *          cv::v_uint16x8
+ *   @param saturation bound of type cv::v_uint16x8
+ *   @return all ones for pixels that can pass, type cv::v_uint16x8
+ */
+static inline cv::v_uint16x8 hlsCandidates(const cv::v_uint16x8& vmax,
+                                           const cv::v_uint16x8& vmin,
+                                           const cv::v_uint16x8& minSumL,
+                                           const cv::v_uint16x8& maxSumL,
+                                           const cv::v_uint16x8& minSat) {
+  // all intermediate values stay below 2^16: sums are at most 510 and
+  // both sides of the saturation test are at most 255 * 255
+  const cv::v_uint16x8 v255 = cv::v_setall_u16(255);
+  const cv::v_uint16x8 v510 = cv::v_setall_u16(510);
+  cv::v_uint16x8 sum = vmax + vmin;
+  cv::v_uint16x8 sat = (vmax - vmin) * v255;
+  cv::v_uint16x8 bound = cv::v_min(sum, v510 - sum) * minSat;
+  return (sum >= minSumL) & (sum <= maxSumL) & (sat >= bound);
+}
+#endif
+/**
+ *   @brief Default constructor for ColorThreshold
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+ColorThreshold::ColorThreshold() {
+  dirty = true;
+  hitCounting = false;
+  pixelCount = 0;
+}
+/**
+ *   @brief Default destructor for ColorThreshold
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+ColorThreshold::~ColorThreshold() {
+}
+/**
+ *   @brief Function to add a range rule
+ *
+ *   @param colour space of type ColorSpace
+ *   @param lower bounds per channel of type cv::Scalar
+ *   @param upper bounds per channel of type cv::Scalar
+ *   @return index of the rule of type int
+ */
+int ColorThreshold::addRule(int colorSpace, const cv::Scalar& lower,
+                            const cv::Scalar& upper) {
+  CV_Assert(colorSpace >= COLOR_SPACE_BGR && colorSpace <= COLOR_SPACE_YUV);
+  ColorRule rule;
+  rule.colorSpace = colorSpace;
+  rule.lower = lower;
+  rule.upper = upper;
+  rules.push_back(rule);
+  dirty = true;
+  return static_cast<int>(rules.size()) - 1;
+}
+/**
+ *   @brief Function to change the bounds of a rule
+ *
+ *   @param index of the rule of type int
+ *   @param lower bounds per channel of type cv::Scalar
+ *   @param upper bounds per channel of type cv::Scalar
+ *   @return nothing
+ */
+void ColorThreshold::setRule(int ruleIdx, const cv::Scalar& lower,
+                             const cv::Scalar& upper) {
+  CV_Assert(ruleIdx >= 0 && ruleIdx < static_cast<int>(rules.size()));
+  if (rules[ruleIdx].lower == lower && rules[ruleIdx].upper == upper) {
+    return;
+  }
+  rules[ruleIdx].lower = lower;
+  rules[ruleIdx].upper = upper;
+  rules[ruleIdx].lut.reset();  // only this rule's table is regenerated
+  dirty = true;
+}
+/**
+ *   @brief Function to remove all rules
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void ColorThreshold::clearRules(void) {
+  rules.clear();
+  dirty = true;
+}
+/**
+ *   @brief Function to get the number of rules
+ *
+ *   @param nothing
+ *   @return number of rules of type int
+ */
+int ColorThreshold::getNumRules(void) {
+  return static_cast<int>(rules.size());
+}
+/**
+ *   @brief Function to generate the predicate table and the conservative
+ *          bounds of a rule
+ *
+ *   @param rule of type ColorRule
+ *   @return nothing
+ */
+void ColorThreshold::buildRule(ColorRule& rule) {
+  // built aside and published once complete, copies holding the previous
+  // table keep it
+  std::shared_ptr<std::vector<uint64_t> > table =
+      std::make_shared<std::vector<uint64_t> >((1 << 24) / 64, 0);
+  uint64_t* bits = table->data();
+  // one 256x256 slice of the colour cube per blue value, green along the
+  // rows and red along the columns
+  cv::Mat slice(256, 256, CV_8UC3), sliceConverted, sliceMask;
+  for (int b = 0; b < 256; b++) {
+    for (int g = 0; g < 256; g++) {
+      uchar* row = slice.ptr<uchar>(g);
+      for (int r = 0; r < 256; r++) {
+        row[3 * r] = static_cast<uchar>(b);
+        row[3 * r + 1] = static_cast<uchar>(g);
+        row[3 * r + 2] = static_cast<uchar>(r);
+      }
+    }
+    switch (rule.colorSpace) {
+      case COLOR_SPACE_HLS:
+        cv::cvtColor(slice, sliceConverted, cv::COLOR_BGR2HLS);
+        break;
+      case COLOR_SPACE_LAB:
+        cv::cvtColor(slice, sliceConverted, cv::COLOR_BGR2Lab);
+        break;
+      case COLOR_SPACE_YUV:
+        cv::cvtColor(slice, sliceConverted, cv::COLOR_BGR2YUV);
+        break;
+      default:
+        sliceConverted = slice;
+        break;
+    }
+    cv::inRange(sliceConverted, rule.lower, rule.upper, sliceMask);
+    for (int g = 0; g < 256; g++) {
+      const uchar* maskRow = sliceMask.ptr<uchar>(g);
+      for (int r = 0; r < 256; r++) {
+        if (maskRow[r]) {
+          uint32_t idx = (static_cast<uint32_t>(b) << 16)
+              | (static_cast<uint32_t>(g) << 8) | r;
+          bits[idx >> 6] |= static_cast<uint64_t>(1) << (idx & 63);
+        }
+      }
+    }
+  }
+  rule.lut = table;
+  // lightness is round((max + min) / 2), so with one unit of slack for
+  // rounding only sums in [2 * Lmin - 2, 2 * Lmax + 2] can pass
+  rule.minSumL = std::max(0, 2 * cvFloor(rule.lower[1]) - 2);
+  rule.maxSumL = std::min(510, 2 * cvCeil(rule.upper[1]) + 2);
+  // saturation is (max - min) / min(max + min, 510 - max - min) scaled to
+  // 255 and rounded, so a pixel can only pass if
+  // 255 * (max - min) >= (Smin - 1) * min(max + min, 510 - max - min)
+  rule.minSat = std::min(255, std::max(0, cvFloor(rule.lower[2]) - 1));
+  for (int c = 0; c < 3; c++) {
+    rule.lowerBGR[c] = cv::saturate_cast<uchar>(cvFloor(rule.lower[c]));
+    rule.upperBGR[c] = cv::saturate_cast<uchar>(cvCeil(rule.upper[c]));
+  }
+}
+/**
+ *   @brief Function to build the predicate tables if the rules changed
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void ColorThreshold::build(void) {
+  if (!dirty) {
+    return;
+  }
+  for (auto& rule : rules) {
+    if (!rule.lut) {
+      buildRule(rule);
+    }
+  }
+  if (rules.size() == 1) {
+    // the OR of a single rule is its own table
+    lut = rules[0].lut;
+  } else {
+    std::shared_ptr<std::vector<uint64_t> > table =
+        std::make_shared<std::vector<uint64_t> >((1 << 24) / 64, 0);
+    for (auto& rule : rules) {
+      for (std::size_t i = 0; i < table->size(); i++) {
+        (*table)[i] |= (*rule.lut)[i];
+      }
+    }
+    lut = table;
+  }
+  ruleHits.assign(rules.size(), 0);
+  pixelCount = 0;
+  dirty = false;
+}
+/**
+ *   @brief Function to enable per rule hit counting
+ *
+ *   @param true to count hits of type bool
+ *   @return nothing
+ */
+void ColorThreshold::setHitCounting(bool hitCounting_) {
+  hitCounting = hitCounting_;
+}
+/**
+ *   @brief Function to reset the hit counters
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void ColorThreshold::resetHits(void) {
+  ruleHits.assign(rules.size(), 0);
+  pixelCount = 0;
+}
+/**
+ *   @brief Function to get the number of pixels that passed each rule
+ *          since the counters were reset
+ *
+ *   @param nothing
+ *   @return per rule hit counts of type std::vector<uint64_t>
+ */
+std::vector<uint64_t> ColorThreshold::getRuleHits(void) {
+  return ruleHits;
+}
+/**
+ *   @brief Function to get the number of pixels thresholded since the
+ *          counters were reset
+ *
+ *   @param nothing
+ *   @return pixel count of type uint64_t
+ */
+uint64_t ColorThreshold::getPixelCount(void) {
+  return pixelCount;
+}
+/**
+ *   @brief Function to get the built OR table of all rules. Copies of a
+ *          built threshold share it until their rules change
+ *
+ *   @param nothing
+ *   @return table, nullptr before the first build, of type
+ *           const std::vector<uint64_t>*
+ */
+const std::vector<uint64_t>* ColorThreshold::getTable(void) const {
+  return lut.get();
+}
+/**
+ *   @brief Function to look up a BGR colour in a predicate table
+ *
+ *   @param predicate table of type std::vector<uint64_t>
+ *   @param pointer to a BGR pixel of type const uchar*
+ *   @return true if the colour is set in the table, type bool
+ */
+inline bool ColorThreshold::lookup(const std::vector<uint64_t>& table,
+                                   const uchar* bgr) {
+  uint32_t idx = (static_cast<uint32_t>(bgr[0]) << 16)
+      | (static_cast<uint32_t>(bgr[1]) << 8) | bgr[2];
+  return (table[idx >> 6] >> (idx & 63)) & 1;
+}
+/**
+ *   @brief Function to check if a pixel can pass any rule
+ *
+ *   @param pointer to a BGR pixel of type const uchar*
+ *   @return false if the pixel surely fails every rule, type bool
+ */
+inline bool ColorThreshold::isCandidate(const uchar* bgr) const {
+  int vmax = std::max(std::max(bgr[0], bgr[1]), bgr[2]);
+  int vmin = std::min(std::min(bgr[0], bgr[1]), bgr[2]);
+  int sum = vmax + vmin;
+  for (auto& rule : rules) {
+    if (rule.colorSpace == COLOR_SPACE_BGR) {
+      if (bgr[0] >= rule.lowerBGR[0] && bgr[0] <= rule.upperBGR[0]
+          && bgr[1] >= rule.lowerBGR[1] && bgr[1] <= rule.upperBGR[1]
+          && bgr[2] >= rule.lowerBGR[2] && bgr[2] <= rule.upperBGR[2]) {
+        return true;
+      }
+    } else if (rule.colorSpace == COLOR_SPACE_HLS) {
+      if (sum >= rule.minSumL && sum <= rule.maxSumL
+          && 255 * (vmax - vmin) >= rule.minSat * std::min(sum, 510 - sum)) {
+        return true;
+      }
+    } else {
+      return true;  // no cheap bound, always resolve with the table
+    }
+  }
+  return false;
+}
+/**
+ *   @brief Function to resolve a candidate pixel exactly and update the
+ *          per rule hit counters
+ *
+ *   @param pointer to a BGR pixel of type const uchar*
+ *   @return 255 if the pixel passes any rule else 0, type uchar
+ */
+inline uchar ColorThreshold::resolve(const uchar* bgr) {
+  if (!lookup(*lut, bgr)) {
+    return 0;
+  }
+  if (hitCounting) {
+    for (std::size_t i = 0; i < rules.size(); i++) {
+      if (lookup(*rules[i].lut, bgr)) {
+        ruleHits[i]++;
+      }
+    }
+  }
+  return 255;
+}
+/**
+ *   @brief Function to threshold a span of one BGR row
+ *
+ *   @param BGR row of type const uchar*
+ *   @param binary row of type uchar*
+ *   @param first column of the span of type int
+ *   @param column after the last column of the span of type int
+ *   @return nothing
+ */
+void ColorThreshold::thresholdRow(const uchar* bgrRow, uchar* maskRow,
+                                  int xBegin, int xEnd) {
+  build();
+  if (hitCounting && xEnd > xBegin) {
+    pixelCount += xEnd - xBegin;
+  }
+  int x = xBegin;
+#if CV_SIMD128
+  for (; x <= xEnd - 16; x += 16) {
+    cv::v_uint8x16 b, g, r;
+    cv::v_load_deinterleave(bgrRow + 3 * x, b, g, r);
+    cv::v_uint8x16 cand = cv::v_setzero_u8();
+    cv::v_uint16x8 vmax0, vmax1, vmin0, vmin1;
+    bool haveMinMax = false;
+    for (auto& rule : rules) {
+      if (rule.colorSpace == COLOR_SPACE_BGR) {
+        cand |= (b >= cv::v_setall_u8(rule.lowerBGR[0]))
+            & (b <= cv::v_setall_u8(rule.upperBGR[0]))
+            & (g >= cv::v_setall_u8(rule.lowerBGR[1]))
+            & (g <= cv::v_setall_u8(rule.upperBGR[1]))
+            & (r >= cv::v_setall_u8(rule.lowerBGR[2]))
+            & (r <= cv::v_setall_u8(rule.upperBGR[2]));
+      } else if (rule.colorSpace == COLOR_SPACE_HLS) {
+        if (!haveMinMax) {
+          cv::v_expand(cv::v_max(cv::v_max(b, g), r), vmax0, vmax1);
+          cv::v_expand(cv::v_min(cv::v_min(b, g), r), vmin0, vmin1);
+          haveMinMax = true;
+        }
+        const cv::v_uint16x8 minSumL = cv::v_setall_u16(
+            static_cast<ushort>(rule.minSumL));
+        const cv::v_uint16x8 maxSumL = cv::v_setall_u16(
+            static_cast<ushort>(rule.maxSumL));
+        const cv::v_uint16x8 minSat = cv::v_setall_u16(
+            static_cast<ushort>(rule.minSat));
+        cand |= cv::v_pack(
+            hlsCandidates(vmax0, vmin0, minSumL, maxSumL, minSat),
+            hlsCandidates(vmax1, vmin1, minSumL, maxSumL, minSat));
+      } else {
+        // no cheap bound, always resolve with the table
+        cand = cv::v_setall_u8(255);
+        break;
+      }
+    }
+    if (!cv::v_check_any(cand)) {
+      // the common case on asphalt and sky: the whole block fails
+      cv::v_store(maskRow + x, cv::v_setzero_u8());
+      continue;
+    }
+    uchar candFlags[16];
+    cv::v_store(candFlags, cand);
+    for (int i = 0; i < 16; i++) {
+      maskRow[x + i] = candFlags[i] ? resolve(bgrRow + 3 * (x + i)) : 0;
+    }
+  }
+#endif
+  // scalar fallback and row tail
+  for (; x < xEnd; x++) {
+    const uchar* bgr = bgrRow + 3 * x;
+    maskRow[x] = isCandidate(bgr) ? resolve(bgr) : 0;
+  }
+}
+/**
+ *   @brief Function to threshold a whole BGR image
+ *
+ *   @param BGR image of type cv::Mat
+ *   @param binary image of type cv::Mat
+ *   @return nothing
+ */
+void ColorThreshold::apply(const cv::Mat& src, cv::Mat& dst) {
+  CV_Assert(src.type() == CV_8UC3);
+  dst.create(src.size(), CV_8U);
+  for (int y = 0; y < src.rows; y++) {
+    thresholdRow(src.ptr<uchar>(y), dst.ptr<uchar>(y), 0, src.cols);
+  }
+}
@@ -0,0 +1,307 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright [2018] rohithjayarajan, Akash Guha
+ *  @file    Denoiser.cpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Denoiser Class File
+ *
+ *  @section DESCRIPTION
+ *
+ *  Denoise stage of the lane detection pipeline. The integer modes run a
+ *  separable fixed-point filter with OpenCV universal intrinsics: the
+ *  horizontal pass accumulates in 16 bits, the vertical pass in 32 bits,
+ *  and a single rounding shift produces the 8 bit result.
+ *
+ */
+
+#include "Denoiser.hpp"
+
+/**
+ *   @brief Function to reflect an index into [0, n) like
+ *          cv::BORDER_REFLECT_101
+ *
+ *   @param index of type int
+ *   @param length of type int
+ *   @return reflected index of type int
+ */
+static inline int reflect101(int i, int n) {
+  if (n == 1) {
+    return 0;
+  }
+  while (i < 0 || i >= n) {
+    i = (i < 0) ? -i : 2 * n - 2 - i;
+  }
+  return i;
+}
+/**
+ *   @brief Default constructor for Denoiser
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+Denoiser::Denoiser() {
+  mode = DENOISE_GAUSSIAN;
+  sigmaX = 0.0;
+  sigmaY = 0.0;
+  kernelShift = 0;
+  bypass = false;
+  updateKernels();
+}
+/**
+ *   @brief Default destructor for Denoiser
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+Denoiser::~Denoiser() {
+}
+/**
+ *   @brief Function to select the denoise filter
+ *
+ *   @param filter of type Denoiser::DenoiseMode
+ *   @return nothing
+ */
+void Denoiser::setMode(int mode_) {
+  CV_Assert(mode_ >= DENOISE_BYPASS && mode_ <= DENOISE_MEDIAN3);
+  mode = mode_;
+  updateKernels();
+}
+/**
+ *   @brief Function to set the standard deviations of the Gaussian modes
+ *
+ *   @param standard deviation in X of type double
+ *   @param standard deviation in Y of type double
+ *   @return nothing
+ */
+void Denoiser::setSigma(double sigmaX_, double sigmaY_) {
+  sigmaX = sigmaX_;
+  sigmaY = sigmaY_;
+  updateKernels();
+}
+/**
+ *   @brief Function to get the selected denoise filter
+ *
+ *   @param nothing
+ *   @return filter of type Denoiser::DenoiseMode
+ */
+int Denoiser::getMode(void) {
+  return mode;
+}
+/**
+ *   @brief Function to check if the selected filter leaves every pixel
+ *          unchanged, so callers can skip the stage altogether
+ *
+ *   @param nothing
+ *   @return true if the stage is bypassed, type bool
+ */
+bool Denoiser::isBypass(void) {
+  return bypass;
+}
+/**
+ *   @brief Function to recompute the kernels and the bypass decision
+ *          after the mode or a sigma changed
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void Denoiser::updateKernels(void) {
+  // cv::GaussianBlur uses sigmaX in Y when sigmaY is not positive
+  double effectiveSigmaY = (sigmaY > 0) ? sigmaY : sigmaX;
+  bypass = false;
+  switch (mode) {
+    case DENOISE_BYPASS:
+      bypass = true;
+      break;
+    case DENOISE_GAUSSIAN: {
+      cv::Mat gaussX = cv::getGaussianKernel(5, sigmaX, CV_64F);
+      cv::Mat gaussY = cv::getGaussianKernel(5, effectiveSigmaY, CV_64F);
+      // weight the 5x5 kernel puts outside its centre
+      double offCentre = 1.0 - gaussX.at<double>(2) * gaussY.at<double>(2);
+      // neighbours then move an 8 bit pixel by less than half a grey
+      // level, so rounding returns every input pixel unchanged
+      bypass = 255.0 * offCentre < 0.5;
+      break;
+    }
+    case DENOISE_BINOMIAL3:
+      kernelX = { 1, 2, 1 };
+      kernelY = { 1, 2, 1 };
+      kernelShift = 4;
+      break;
+    case DENOISE_GAUSSIAN5_FIXED:
+      quantizeGaussian(sigmaX, kernelX);
+      quantizeGaussian(effectiveSigmaY, kernelY);
+      kernelShift = 16;
+      bypass = kernelX[2] == 256 && kernelY[2] == 256;
+      break;
+    default:
+      break;
+  }
+}
+/**
+ *   @brief Function to quantize a 5 tap Gaussian to 8 bit fixed-point
+ *          taps summing to 256
+ *
+ *   @param standard deviation of type double
+ *   @param fixed-point taps of type std::vector<int>
+ *   @return nothing
+ */
+void Denoiser::quantizeGaussian(double sigma, std::vector<int>& taps) {
+  cv::Mat gauss = cv::getGaussianKernel(5, sigma, CV_64F);
+  taps.resize(5);
+  int sum = 0;
+  for (int i = 0; i < 5; i++) {
+    taps[i] = cvRound(256 * gauss.at<double>(i));
+    sum += taps[i];
+  }
+  // the centre tap absorbs the rounding so the kernel keeps unit gain
+  taps[2] += 256 - sum;
+}
+/**
+ *   @brief Function to denoise an 8 bit image
+ *
+ *   @param input image of type cv::Mat
+ *   @param denoised image of type cv::Mat
+ *   @return nothing
+ */
+void Denoiser::apply(const cv::Mat& src, cv::Mat& dst) {
+  CV_Assert(src.depth() == CV_8U);
+  if (bypass) {
+    if (src.data != dst.data) {
+      src.copyTo(dst);
+    }
+    return;
+  }
+  switch (mode) {
+    case DENOISE_GAUSSIAN:
+      cv::GaussianBlur(src, dst, cv::Size(5, 5), sigmaX, sigmaY);
+      break;
+    case DENOISE_MEDIAN3:
+      cv::medianBlur(src, dst, 3);
+      break;
+    default:
+      separableFixedPoint(src, dst);
+      break;
+  }
+}
+/**
+ *   @brief Function to filter an 8 bit image with separable fixed-point
+ *          kernels and a reflected border, like cv::BORDER_DEFAULT
+ *
+ *   @param input image of type cv::Mat
+ *   @param filtered image of type cv::Mat
+ *   @return nothing
+ */
+void Denoiser::separableFixedPoint(const cv::Mat& src, cv::Mat& dst) {
+  // rows are filtered top down, so the output must not overwrite the
+  // input
+  cv::Mat input = (src.data == dst.data) ? src.clone() : src;
+  dst.create(input.size(), input.type());
+  int cn = input.channels();
+  int ksize = static_cast<int>(kernelX.size());
+  int radius = ksize / 2;
+  int width = input.cols * cn;  // row length in interleaved samples
+  paddedRow.resize((input.cols + 2 * radius) * cn);
+  rowSums.resize(static_cast<std::size_t>(ksize) * width);
+  rowSumTags.assign(ksize, INT_MIN);
+  const ushort* sums[5];
+  for (int y = 0; y < input.rows; y++) {
+    for (int i = 0; i < ksize; i++) {
+      int j = y + i - radius;  // unreflected source row
+      int slot = (j + radius) % ksize;
+      ushort* rowSum = &rowSums[static_cast<std::size_t>(slot) * width];
+      sums[i] = rowSum;
+      if (rowSumTags[slot] == j) {
+        continue;  // horizontal pass already done for this row
+      }
+      rowSumTags[slot] = j;
+      // copy the source row with a reflected apron on both sides
+      const uchar* srcRow = input.ptr<uchar>(reflect101(j, input.rows));
+      std::memcpy(&paddedRow[radius * cn], srcRow, width);
+      for (int p = 1; p <= radius; p++) {
+        int left = reflect101(-p, input.cols);
+        int right = reflect101(input.cols - 1 + p, input.cols);
+        for (int c = 0; c < cn; c++) {
+          paddedRow[(radius - p) * cn + c] = srcRow[left * cn + c];
+          paddedRow[(radius + input.cols - 1 + p) * cn + c] =
+              srcRow[right * cn + c];
+        }
+      }
+      // horizontal pass, taps sum to at most 256 so 16 bits suffice
+      const uchar* padded = &paddedRow[0];
+      int x = 0;
+#if CV_SIMD128
+      for (; x <= width - 8; x += 8) {
+        cv::v_uint16x8 acc = cv::v_setzero_u16();
+        for (int k = 0; k < ksize; k++) {
+          acc += cv::v_load_expand(padded + x + k * cn)
+              * cv::v_setall_u16(static_cast<ushort>(kernelX[k]));
+        }
+        cv::v_store(rowSum + x, acc);
+      }
+#endif
+      for (; x < width; x++) {
+        int acc = 0;
+        for (int k = 0; k < ksize; k++) {
+          acc += kernelX[k] * padded[x + k * cn];
+        }
+        rowSum[x] = static_cast<ushort>(acc);
+      }
+    }
+    // vertical pass in 32 bits with a single rounding shift
+    uchar* dstRow = dst.ptr<uchar>(y);
+    unsigned int delta = 1u << (kernelShift - 1);
+    int x = 0;
+#if CV_SIMD128
+    for (; x <= width - 16; x += 16) {
+      cv::v_uint32x4 acc0 = cv::v_setall_u32(delta);
+      cv::v_uint32x4 acc1 = acc0, acc2 = acc0, acc3 = acc0;
+      for (int k = 0; k < ksize; k++) {
+        cv::v_uint16x8 tap = cv::v_setall_u16(static_cast<ushort>(kernelY[k]));
+        cv::v_uint32x4 prod0, prod1;
+        cv::v_mul_expand(cv::v_load(sums[k] + x), tap, prod0, prod1);
+        acc0 += prod0;
+        acc1 += prod1;
+        cv::v_mul_expand(cv::v_load(sums[k] + x + 8), tap, prod0, prod1);
+        acc2 += prod0;
+        acc3 += prod1;
+      }
+      cv::v_store(dstRow + x, cv::v_pack(
+          cv::v_pack(acc0 >> kernelShift, acc1 >> kernelShift),
+          cv::v_pack(acc2 >> kernelShift, acc3 >> kernelShift)));
+    }
+#endif
+    for (; x < width; x++) {
+      unsigned int acc = delta;
+      for (int k = 0; k < ksize; k++) {
+        acc += kernelY[k] * sums[k][x];
+      }
+      dstRow[x] = cv::saturate_cast<uchar>(acc >> kernelShift);
+    }
+  }
+}
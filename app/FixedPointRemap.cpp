@@ -0,0 +1,139 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright [2018] rohithjayarajan, Akash Guha
+ *  @file    FixedPointRemap.cpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Fixed Point Remap Class File
+ *
+ *  @section DESCRIPTION
+ *
+ *  Bilinear remap of 8 bit images through fixed-point maps, row bands in
+ *  parallel, without scratch buffers.
+ *
+ */
+
+#include "FixedPointRemap.hpp"
+
+namespace {
+const int TAB_BITS = 5;  // fraction bits of the maps, cv::INTER_BITS
+const int TAB_SIZE = 1 << TAB_BITS;  // cv::INTER_TAB_SIZE
+const int COEF_BITS = 15;  // weight bits, cv::INTER_REMAP_COEF_BITS
+// scales a product of two fractions of TAB_SIZE to 1 << COEF_BITS
+const int COEF_SHIFT = COEF_BITS - 2 * TAB_BITS;
+
+/**
+ *  Loop body of cv::parallel_for_ remapping a band of output rows
+ */
+class RemapLoopBody : public cv::ParallelLoopBody {
+ private:
+  const cv::Mat& src;
+  cv::Mat& dst;
+  const cv::Mat& map1;
+  const cv::Mat& map2;
+
+ public:
+  RemapLoopBody(const cv::Mat& src_, cv::Mat& dst_, const cv::Mat& map1_,
+                const cv::Mat& map2_)
+      : src(src_), dst(dst_), map1(map1_), map2(map2_) {
+  }
+  void operator()(const cv::Range& range) const {
+    const int cn = src.channels();
+    const unsigned int lastX = static_cast<unsigned int>(src.cols - 1);
+    const unsigned int lastY = static_cast<unsigned int>(src.rows - 1);
+    const int delta = 1 << (COEF_BITS - 1);
+    for (int y = range.start; y < range.end; y++) {
+      const cv::Vec2s* xy = map1.ptr<cv::Vec2s>(y);
+      const ushort* alpha = map2.ptr<ushort>(y);
+      uchar* dstPixel = dst.ptr<uchar>(y);
+      for (int x = 0; x < dst.cols; x++, dstPixel += cn) {
+        int sx = xy[x][0], sy = xy[x][1];
+        int fx = alpha[x] & (TAB_SIZE - 1);
+        int fy = (alpha[x] >> TAB_BITS) & (TAB_SIZE - 1);
+        // weights of the top left, top right, bottom left and bottom
+        // right neighbours, summing to 1 << COEF_BITS
+        int w00 = ((TAB_SIZE - fy) * (TAB_SIZE - fx)) << COEF_SHIFT;
+        int w01 = ((TAB_SIZE - fy) * fx) << COEF_SHIFT;
+        int w10 = (fy * (TAB_SIZE - fx)) << COEF_SHIFT;
+        int w11 = (fy * fx) << COEF_SHIFT;
+        if (static_cast<unsigned int>(sx) < lastX
+            && static_cast<unsigned int>(sy) < lastY) {
+          const uchar* s0 = src.ptr<uchar>(sy) + sx * cn;
+          const uchar* s1 = s0 + src.step[0];
+          for (int c = 0; c < cn; c++) {
+            dstPixel[c] = cv::saturate_cast<uchar>((s0[c] * w00
+                + s0[c + cn] * w01 + s1[c] * w10 + s1[c + cn] * w11 + delta)
+                >> COEF_BITS);
+          }
+          continue;
+        }
+        // neighbours outside the image read as 0
+        bool x0In = static_cast<unsigned int>(sx) <= lastX;
+        bool x1In = static_cast<unsigned int>(sx + 1) <= lastX;
+        bool y0In = static_cast<unsigned int>(sy) <= lastY;
+        bool y1In = static_cast<unsigned int>(sy + 1) <= lastY;
+        const uchar* s0 = y0In ? src.ptr<uchar>(sy) : nullptr;
+        const uchar* s1 = y1In ? src.ptr<uchar>(sy + 1) : nullptr;
+        for (int c = 0; c < cn; c++) {
+          int v00 = (s0 && x0In) ? s0[sx * cn + c] : 0;
+          int v01 = (s0 && x1In) ? s0[(sx + 1) * cn + c] : 0;
+          int v10 = (s1 && x0In) ? s1[sx * cn + c] : 0;
+          int v11 = (s1 && x1In) ? s1[(sx + 1) * cn + c] : 0;
+          dstPixel[c] = cv::saturate_cast<uchar>((v00 * w00 + v01 * w01
+              + v10 * w10 + v11 * w11 + delta) >> COEF_BITS);
+        }
+      }
+    }
+  }
+};
+}  // namespace
+
+/**
+ *   @brief Function to sample an image through fixed-point maps with
+ *          bilinear interpolation and a zero constant border, like
+ *          cv::remap with cv::INTER_LINEAR and cv::BORDER_CONSTANT
+ *
+ *   @param 8 bit input image of type cv::Mat
+ *   @param output image, of the size of the maps, of type cv::Mat; must
+ *          not share the input's pixels
+ *   @param integer positions of type cv::Mat (CV_16SC2)
+ *   @param interpolation table indices of type cv::Mat (CV_16UC1)
+ *   @return nothing
+ */
+void FixedPointRemap::remap(const cv::Mat& src, cv::Mat& dst,
+                            const cv::Mat& map1, const cv::Mat& map2) {
+  CV_Assert(src.depth() == CV_8U && !src.empty());
+  CV_Assert(map1.type() == CV_16SC2 && map2.type() == CV_16UC1
+      && map1.size() == map2.size());
+  dst.create(map1.size(), src.type());
+  CV_Assert(dst.data != src.data);
+  // bands of about 64k pixels, like cv::remap
+  cv::parallel_for_(cv::Range(0, dst.rows),
+                    RemapLoopBody(src, dst, map1, map2),
+                    dst.total() / static_cast<double>(1 << 16));
+}
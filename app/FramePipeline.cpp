@@ -0,0 +1,436 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    FramePipeline.cpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Frame Pipeline Class File
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class file for the pipelined executor of the lane detection, running
+ *  each stage on its own thread over a fixed set of frame slots.
+ *
+ */
+
+#include <thread>
+#include "FramePipeline.hpp"
+
+/**
+ *   @brief Constructor for FramePipeline
+ *
+ *   @param lane detection whose stages are run, of type LaneDetection
+ *   @return nothing
+ */
+FramePipeline::FramePipeline(LaneDetection& lanes_)
+    : lanes(lanes_),
+      stopRequested(false) {
+  queueDepth = 4;
+  backPressure = BACKPRESSURE_BLOCK;
+  framesProcessed = 0;
+  framesDropped = 0;
+  for (int stage = 0; stage < NUM_STAGES; stage++) {
+    queueWaiters[stage] = 0;
+  }
+}
+/**
+ *   @brief Default destructor for FramePipeline
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+FramePipeline::~FramePipeline() {
+}
+/**
+ *   @brief Function to set the number of frames in flight
+ *
+ *   @param number of frame slots, at least 1, of type int
+ *   @return nothing
+ */
+void FramePipeline::setQueueDepth(int queueDepth_) {
+  CV_Assert(queueDepth_ >= 1);
+  queueDepth = queueDepth_;
+}
+/**
+ *   @brief Function to get the number of frames in flight
+ *
+ *   @param nothing
+ *   @return number of frame slots of type int
+ */
+int FramePipeline::getQueueDepth(void) {
+  return queueDepth;
+}
+/**
+ *   @brief Function to select what decode does when every slot is in
+ *          flight
+ *
+ *   @param policy of type FramePipeline::BackPressure
+ *   @return nothing
+ */
+void FramePipeline::setBackPressure(int backPressure_) {
+  CV_Assert(backPressure_ == BACKPRESSURE_BLOCK
+            || backPressure_ == BACKPRESSURE_DROP);
+  backPressure = backPressure_;
+}
+/**
+ *   @brief Function to get what decode does when every slot is in flight
+ *
+ *   @param nothing
+ *   @return policy of type FramePipeline::BackPressure
+ */
+int FramePipeline::getBackPressure(void) {
+  return backPressure;
+}
+/**
+ *   @brief Function to set the consumer of the rendered frames; without
+ *          one the frames are shown by the visualizer
+ *
+ *   @param consumer of type FramePipeline::FrameSink
+ *   @return nothing
+ */
+void FramePipeline::setFrameSink(const FrameSink& frameSink_) {
+  frameSink = frameSink_;
+}
+/**
+ *   @brief Function to wake the threads blocked on a queue, if any
+ *
+ *   @param stage of the queue of type FramePipeline::Stage
+ *   @return nothing
+ */
+void FramePipeline::notifyQueue(int stage) {
+  // orders the queue change before reading the waiters; a waiter
+  // registers before its last try, so either it sees the change or it is
+  // seen here
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (queueWaiters[stage].load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  {
+    // a waiter between its last try and the wait holds the mutex
+    std::lock_guard<std::mutex> lock(queueMutexes[stage]);
+  }
+  queueChanged[stage].notify_all();
+}
+/**
+ *   @brief Function to take the next slot of a stage without waiting
+ *
+ *   @param stage of type FramePipeline::Stage
+ *   @param slot index or END_OF_STREAM of type int
+ *   @return false if the queue is empty, type bool
+ */
+bool FramePipeline::tryPopSlot(int stage, int& slotIdx) {
+  if (!queues[stage].tryPop(slotIdx)) {
+    return false;
+  }
+  // the producer may wait for the room
+  notifyQueue(stage);
+  return true;
+}
+/**
+ *   @brief Function to wait for the next slot of a stage, blocking once
+ *          the lock-free try fails
+ *
+ *   @param stage of type FramePipeline::Stage
+ *   @param slot index or END_OF_STREAM of type int
+ *   @param true to give up when the pipeline stops of type bool
+ *   @return false if it gave up, type bool
+ */
+bool FramePipeline::waitPopSlot(int stage, int& slotIdx, bool isStoppable) {
+  if (tryPopSlot(stage, slotIdx)) {
+    return true;
+  }
+  bool isPopped = false;
+  {
+    std::unique_lock<std::mutex> lock(queueMutexes[stage]);
+    queueWaiters[stage]++;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    isPopped = queues[stage].tryPop(slotIdx);
+    while (!isPopped && !(isStoppable && stopRequested)) {
+      queueChanged[stage].wait(lock);
+      isPopped = queues[stage].tryPop(slotIdx);
+    }
+    queueWaiters[stage]--;
+  }
+  if (isPopped) {
+    notifyQueue(stage);
+  }
+  return isPopped;
+}
+/**
+ *   @brief Function to hand a slot to the next stage
+ *
+ *   @param stage whose queue takes the slot of type FramePipeline::Stage
+ *   @param slot index or END_OF_STREAM of type int
+ *   @return nothing
+ */
+void FramePipeline::pushSlot(int stage, int slotIdx) {
+  // the queues hold every slot and the end of the stream, so this only
+  // blocks if the consumer lags behind publishing its index
+  if (!queues[stage].tryPush(slotIdx)) {
+    std::unique_lock<std::mutex> lock(queueMutexes[stage]);
+    queueWaiters[stage]++;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (!queues[stage].tryPush(slotIdx)) {
+      queueChanged[stage].wait(lock);
+    }
+    queueWaiters[stage]--;
+  }
+  // the consumer may wait for the slot
+  notifyQueue(stage);
+}
+/**
+ *   @brief Function to wait for the next slot of a stage
+ *
+ *   @param stage of type FramePipeline::Stage
+ *   @return slot index or END_OF_STREAM of type int
+ */
+int FramePipeline::popSlot(int stage) {
+  int slotIdx;
+  // slots keep moving after a stop, every stage waits for the end of the
+  // stream
+  waitPopSlot(stage, slotIdx, false);
+  return slotIdx;
+}
+/**
+ *   @brief Function to stop the pipeline and wake decode if it waits
+ *          for a free slot
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void FramePipeline::requestStop(void) {
+  stopRequested = true;
+  notifyQueue(DECODE_STAGE);
+}
+/**
+ *   @brief Function to record the failure of a stage and stop the
+ *          pipeline
+ *
+ *   @param failure of type std::exception_ptr
+ *   @return nothing
+ */
+void FramePipeline::fail(std::exception_ptr stageError) {
+  std::lock_guard<std::mutex> lock(errorMutex);
+  if (!error) {
+    error = stageError;
+  }
+  requestStop();
+}
+/**
+ *   @brief Function to read frames into free slots until the stream ends
+ *          or the pipeline stops
+ *
+ *   @param source of the frames of type FramePipeline::FrameSource
+ *   @return nothing
+ */
+void FramePipeline::decodeLoop(const FrameSource& readFrame) {
+  uint64_t frameIdx = 0;
+  try {
+    while (!stopRequested) {
+      int slotIdx;
+      if (backPressure == BACKPRESSURE_DROP) {
+        if (!tryPopSlot(DECODE_STAGE, slotIdx)) {
+          // every slot is in flight, drop the frame rather than fall
+          // behind the stream
+          if (!readFrame(droppedFrame) || droppedFrame.empty()) {
+            break;
+          }
+          framesDropped++;
+          frameIdx++;
+          continue;
+        }
+      } else if (!waitPopSlot(DECODE_STAGE, slotIdx, true)) {
+        // stopped while every slot was in flight
+        break;
+      }
+      FrameSlot& slot = *slots[slotIdx];
+      slot.stageBegin[DECODE_STAGE] = cv::getTickCount();
+      if (!readFrame(slot.frame) || slot.frame.empty()) {
+        break;
+      }
+      slot.stageEnd[DECODE_STAGE] = cv::getTickCount();
+      slot.frameIdx = frameIdx++;
+      pushSlot(TRANSFORM_STAGE, slotIdx);
+    }
+  } catch (...) {
+    fail(std::current_exception());
+  }
+  pushSlot(TRANSFORM_STAGE, END_OF_STREAM);
+}
+/**
+ *   @brief Function to run the transform or the search stage on every
+ *          slot until the end of the stream
+ *
+ *   @param stage of type FramePipeline::Stage
+ *   @return nothing
+ */
+void FramePipeline::stageLoop(int stage) {
+  for (int slotIdx = popSlot(stage); slotIdx != END_OF_STREAM;
+      slotIdx = popSlot(stage)) {
+    // once stopped, slots are only passed on to be recycled
+    if (!stopRequested) {
+      FrameSlot& slot = *slots[slotIdx];
+      slot.stageBegin[stage] = cv::getTickCount();
+      try {
+        if (stage == TRANSFORM_STAGE) {
+          if (!slot.workspace.isAllocatedFor(slot.frame.size())) {
+            slot.workspace.allocate(slot.frame.size());
+          }
+          lanes.transformFrame(slot.frame, slot.workspace);
+        } else {
+          lanes.searchFrame(slot.workspace);
+        }
+        slot.stageEnd[stage] = cv::getTickCount();
+      } catch (...) {
+        fail(std::current_exception());
+      }
+    }
+    pushSlot(stage + 1, slotIdx);
+  }
+  pushSlot(stage + 1, END_OF_STREAM);
+}
+/**
+ *   @brief Function to render every slot, hand it to the sink and
+ *          recycle it, until the end of the stream
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void FramePipeline::outputLoop(void) {
+  for (int slotIdx = popSlot(OUTPUT_STAGE); slotIdx != END_OF_STREAM;
+      slotIdx = popSlot(OUTPUT_STAGE)) {
+    if (!stopRequested) {
+      FrameSlot& slot = *slots[slotIdx];
+      slot.stageBegin[OUTPUT_STAGE] = cv::getTickCount();
+      try {
+        lanes.renderFrame(slot.frame, slot.workspace);
+        slot.stageEnd[OUTPUT_STAGE] = cv::getTickCount();
+        framesProcessed++;
+        bool isRunning = true;
+        if (frameSink) {
+          FrameResult result;
+          result.frameIdx = slot.frameIdx;
+          result.workspace = &slot.workspace;
+          double msPerTick = 1000.0 / cv::getTickFrequency();
+          // time waiting in the queues counts only for the latency
+          for (int stage = 0; stage < NUM_STAGES; stage++) {
+            result.stageMs[stage] = msPerTick
+                * (slot.stageEnd[stage] - slot.stageBegin[stage]);
+          }
+          result.latencyMs = msPerTick * (slot.stageEnd[OUTPUT_STAGE]
+              - slot.stageBegin[DECODE_STAGE]);
+          isRunning = frameSink(result);
+        } else {
+          isRunning = lanes.getVisualizer().show(
+              slot.workspace.getBuffer(FrameWorkspace::OUTPUT_FRAME));
+        }
+        if (!isRunning) {
+          requestStop();
+        }
+      } catch (...) {
+        fail(std::current_exception());
+      }
+    }
+    // back to decode as a free slot
+    pushSlot(DECODE_STAGE, slotIdx);
+  }
+}
+/**
+ *   @brief Function to run the pipeline on a video until it ends or the
+ *          sink stops it
+ *
+ *   @param opened video of type cv::VideoCapture
+ *   @return nothing
+ */
+void FramePipeline::run(cv::VideoCapture& cap) {
+  run([&cap](cv::Mat& frame) {
+    return cap.read(frame);
+  });
+}
+/**
+ *   @brief Function to run the pipeline on a source of frames until it
+ *          ends or the sink stops it. The output stage runs on the calling
+ *          thread; a failure of any stage is rethrown here
+ *
+ *   @param source of the frames of type FramePipeline::FrameSource
+ *   @return nothing
+ */
+void FramePipeline::run(const FrameSource& readFrame) {
+  // slots keep their buffers across runs of the same depth
+  if (slots.size() != static_cast<std::size_t>(queueDepth)) {
+    slots.clear();
+    for (int i = 0; i < queueDepth; i++) {
+      slots.emplace_back(new FrameSlot());
+    }
+  }
+  // room for every slot and the end of the stream
+  for (int stage = 0; stage < NUM_STAGES; stage++) {
+    queues[stage].reset(queueDepth + 1);
+  }
+  for (int i = 0; i < queueDepth; i++) {
+    queues[DECODE_STAGE].tryPush(i);
+  }
+  stopRequested = false;
+  error = nullptr;
+  framesProcessed = 0;
+  framesDropped = 0;
+  std::thread decodeThread(&FramePipeline::decodeLoop, this,
+                           std::cref(readFrame));
+  std::thread transformThread(&FramePipeline::stageLoop, this,
+                              static_cast<int>(TRANSFORM_STAGE));
+  std::thread searchThread(&FramePipeline::stageLoop, this,
+                           static_cast<int>(SEARCH_STAGE));
+  // the GUI stays on the calling thread
+  outputLoop();
+  decodeThread.join();
+  transformThread.join();
+  searchThread.join();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+/**
+ *   @brief Function to get the number of frames the last run handed to
+ *          the sink
+ *
+ *   @param nothing
+ *   @return number of frames of type uint64_t
+ */
+uint64_t FramePipeline::getFramesProcessed(void) {
+  return framesProcessed;
+}
+/**
+ *   @brief Function to get the number of frames the last run dropped
+ *          under back-pressure
+ *
+ *   @param nothing
+ *   @return number of frames of type uint64_t
+ */
+uint64_t FramePipeline::getFramesDropped(void) {
+  return framesDropped;
+}
@@ -0,0 +1,279 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright [2018] rohithjayarajan, Akash Guha
+ *  @file    FrameWorkspace.cpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Frame Workspace Class File
+ *
+ *  @section DESCRIPTION
+ *
+ *  Arena owning the intermediate buffers of the lane detection pipeline,
+ *  sized once from the stream resolution. All image buffers share an
+ *  allocator that counts allocations, so tests can assert that the
+ *  steady state of the pipeline does not allocate.
+ *
+ */
+
+#include "FrameWorkspace.hpp"
+/**
+ *   @brief Default constructor for CountingAllocator
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+FrameWorkspace::CountingAllocator::CountingAllocator() {
+  allocationCount = 0;
+}
+/**
+ *   @brief Function to allocate an image buffer with the default allocator
+ *
+ *   @param arguments of cv::MatAllocator::allocate
+ *   @return buffer of type cv::UMatData*
+ */
+cv::UMatData* FrameWorkspace::CountingAllocator::allocate(
+    int dims, const int* sizes, int type, void* data, size_t* step, int flags,
+    cv::UMatUsageFlags usageFlags) const {
+  allocationCount++;
+  return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data, step,
+                                              flags, usageFlags);
+}
+/**
+ *   @brief Function to allocate host memory of a buffer with the default
+ *          allocator
+ *
+ *   @param arguments of cv::MatAllocator::allocate
+ *   @return true on success, type bool
+ */
+bool FrameWorkspace::CountingAllocator::allocate(
+    cv::UMatData* data, int accessflags, cv::UMatUsageFlags usageFlags) const {
+  return cv::Mat::getStdAllocator()->allocate(data, accessflags, usageFlags);
+}
+/**
+ *   @brief Function to free a buffer with the default allocator
+ *
+ *   @param buffer of type cv::UMatData*
+ *   @return nothing
+ */
+void FrameWorkspace::CountingAllocator::deallocate(cv::UMatData* data) const {
+  cv::Mat::getStdAllocator()->deallocate(data);
+}
+/**
+ *   @brief Function to get the number of buffers allocated
+ *
+ *   @param nothing
+ *   @return number of allocations of type uint64_t
+ */
+uint64_t FrameWorkspace::CountingAllocator::getAllocationCount(void) const {
+  return allocationCount;
+}
+/**
+ *   @brief Function to reset the allocation counter
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void FrameWorkspace::CountingAllocator::resetAllocationCount(void) {
+  allocationCount = 0;
+}
+/**
+ *   @brief Default constructor for FrameWorkspace
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+FrameWorkspace::FrameWorkspace() {
+  for (int i = 0; i < NUM_BUFFERS; i++) {
+    buffers[i].allocator = &allocator;
+  }
+}
+/**
+ *   @brief Default destructor for FrameWorkspace
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+FrameWorkspace::~FrameWorkspace() {
+}
+/**
+ *   @brief Function to size all buffers for a stream resolution
+ *
+ *   @param frame size of the stream of type cv::Size
+ *   @return nothing
+ */
+void FrameWorkspace::allocate(const cv::Size& frameSize_) {
+  frameSize = frameSize_;
+  buffers[UNDISTORTED_IMG].create(frameSize, CV_8UC3);
+  buffers[PROCESSED_FRAME].create(frameSize, CV_8UC3);
+  buffers[BINARY_FRAME].create(frameSize, CV_8U);
+  buffers[PERSPECTIVE_IMG].create(frameSize, CV_8U);
+  buffers[DRAW_WINDOW].create(frameSize, CV_8UC3);
+  buffers[OUTPUT_FRAME].create(frameSize, CV_8UC3);
+  buffers[OVERLAY_FRAME].create(frameSize, CV_8UC3);
+  packedPerspective.create(frameSize);
+  occupancy.create(frameSize);
+  cv::Size levelSize = frameSize;
+  for (int level = 0; level < MAX_PYRAMID_LEVEL; level++) {
+    levelSize = cv::Size((levelSize.width + 1) / 2,
+                         (levelSize.height + 1) / 2);
+    packedPyramid[level].create(levelSize);
+  }
+  // the ROI bands depend on the ROI and are created by the first frame
+  histogram.resize(frameSize.width);
+  pyramidHistogram.reserve((frameSize.width + 1) / 2);
+  // every pixel of the 8 default sliding windows of each lane
+  for (int i = 0; i < NUM_LANE_BUFFERS; i++) {
+    lanePoints[i].clear();
+    lanePoints[i].reserveForWindows(frameSize, 8, 0);
+  }
+}
+/**
+ *   @brief Function to check if the buffers are sized for a resolution
+ *
+ *   @param frame size of the stream of type cv::Size
+ *   @return true if allocate was called with this size, type bool
+ */
+bool FrameWorkspace::isAllocatedFor(const cv::Size& frameSize_) {
+  return !buffers[PROCESSED_FRAME].empty() && frameSize == frameSize_;
+}
+/**
+ *   @brief Function to get an intermediate image
+ *
+ *   @param buffer of type FrameWorkspace::Buffer
+ *   @return image of type cv::Mat&
+ */
+cv::Mat& FrameWorkspace::getBuffer(int buffer) {
+  CV_Assert(buffer >= 0 && buffer < NUM_BUFFERS);
+  return buffers[buffer];
+}
+/**
+ *   @brief Function to get the packed bird's-eye mask
+ *
+ *   @param nothing
+ *   @return packed bird's-eye mask of type PackedBinaryImage&
+ */
+PackedBinaryImage& FrameWorkspace::getPackedPerspective(void) {
+  return packedPerspective;
+}
+/**
+ *   @brief Function to get the occupancy table of the bird's-eye mask
+ *
+ *   @param nothing
+ *   @return occupancy table of type OccupancyIntegral&
+ */
+OccupancyIntegral& FrameWorkspace::getOccupancy(void) {
+  return occupancy;
+}
+/**
+ *   @brief Function to get the lane pixel histogram
+ *
+ *   @param nothing
+ *   @return histogram of type std::vector<double>&
+ */
+std::vector<double>& FrameWorkspace::getHistogram(void) {
+  return histogram;
+}
+/**
+ *   @brief Function to get a max pooled level of the packed bird's-eye
+ *          mask
+ *
+ *   @param level, 1 for 1/2 scale up to MAX_PYRAMID_LEVEL, of type int
+ *   @return packed mask at the level of type PackedBinaryImage&
+ */
+PackedBinaryImage& FrameWorkspace::getPackedPyramid(int level) {
+  CV_Assert(level >= 1 && level <= MAX_PYRAMID_LEVEL);
+  return packedPyramid[level - 1];
+}
+/**
+ *   @brief Function to get the lane pixel histogram of a coarse level
+ *
+ *   @param nothing
+ *   @return histogram of type std::vector<double>&
+ */
+std::vector<double>& FrameWorkspace::getPyramidHistogram(void) {
+  return pyramidHistogram;
+}
+/**
+ *   @brief Function to get the pixels of one lane of the current frame
+ *
+ *   @param lane of type FrameWorkspace::LaneBuffer
+ *   @return lane pixels of type LanePointSet&
+ */
+LanePointSet& FrameWorkspace::getLanePoints(int lane) {
+  CV_Assert(lane >= 0 && lane < NUM_LANE_BUFFERS);
+  return lanePoints[lane];
+}
+/**
+ *   @brief Function to get the fits of the lanes of the current frame,
+ *          in FrameWorkspace::LaneBuffer order
+ *
+ *   @param nothing
+ *   @return column of each lane as a polynomial in the row, or empty, of
+ *           type cv::Mat*
+ */
+cv::Mat* FrameWorkspace::getLaneFits(void) {
+  return laneFits;
+}
+/**
+ *   @brief Function to get the inverse perspective transform the current
+ *          frame was warped with
+ *
+ *   @param nothing
+ *   @return 3x3 transform of type cv::Mat&
+ */
+cv::Mat& FrameWorkspace::getPerspectiveInverse(void) {
+  return perspectiveInverse;
+}
+/**
+ *   @brief Function to get the resolution the workspace is sized for
+ *
+ *   @param nothing
+ *   @return frame size of type cv::Size
+ */
+cv::Size FrameWorkspace::getFrameSize(void) {
+  return frameSize;
+}
+/**
+ *   @brief Function to get the number of image buffers allocated since
+ *          the counter was reset
+ *
+ *   @param nothing
+ *   @return number of allocations of type uint64_t
+ */
+uint64_t FrameWorkspace::getAllocationCount(void) {
+  return allocator.getAllocationCount();
+}
+/**
+ *   @brief Function to reset the allocation counter
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void FrameWorkspace::resetAllocationCount(void) {
+  allocator.resetAllocationCount();
+}
@@ -55,8 +55,28 @@ ImageProcessing::ImageProcessing() {
       (cv::Mat_<double>(1, 5) << -0.242565104, -0.0477893070, -0.00131388084, -0.0000879107779, 0.0220573263);
   gaussianSigmaX = 0.04;  // set S.D. in X for Gaussian blur
   gaussianSigmaY = 0.06;  // set S.D. in Y for Gaussian blur
+  // 5x5 Gaussian, bypassed while the sigmas make it a delta
+  denoiser.setMode(Denoiser::DENOISE_GAUSSIAN);
+  denoiser.setSigma(gaussianSigmaX, gaussianSigmaY);
   minThreshHLS = cv::Scalar(18, 97, 97);  // set lower bounds for HLS mask
   maxThreshHLS = cv::Scalar(32, 255, 255);  // set lower bounds for HLS mask
+  minThreshBGR = cv::Scalar(200, 200, 200);  // set lower bounds for BGR mask
+  maxThreshBGR = cv::Scalar(255, 255, 255);  // set upper bounds for BGR mask
+  // yellow markings pass the HLS rule, white markings the BGR rule
+  hlsRule = colorThreshold.addRule(ColorThreshold::COLOR_SPACE_HLS,
+                                   minThreshHLS, maxThreshHLS);
+  bgrRule = colorThreshold.addRule(ColorThreshold::COLOR_SPACE_BGR,
+                                   minThreshBGR, maxThreshBGR);
+  // vertices of the polygon in which lanes appear
+  std::vector<cv::Point> laneROIVertices;
+  laneROIVertices.push_back(cv::Point(560, 429));
+  laneROIVertices.push_back(cv::Point(690, 429));
+  laneROIVertices.push_back(cv::Point(1155, 672));
+  laneROIVertices.push_back(cv::Point(225, 672));
+  laneSpans.setVertices(laneROIVertices);
+  fusedRemap = false;  // undistort and warp in separate passes by default
+  roiRect = cv::Rect(0, 429, 1280, 244);  // rows 429 to 672 of the frame
+  roiProcessing = false;  // process the whole frame by default
 }
 /**
  *   @brief Default destructor for ImageProcessing
@@ -74,20 +94,153 @@ ImageProcessing::~ImageProcessing() {
  *   @return nothing
  */
 void ImageProcessing::preProcessing(cv::Mat& src, cv::Mat& dst) {
-  cv::Mat undistortedImg, densoisedImg;  // declare variable holders
-                                         // for undistorted and denoised images
-  // undistort frame using camera intrinsics
-  cv::undistort(src, undistortedImg, intrinsic, distortionCoeffs);
-  // smoothen or denoise the image using Gaussian blur
-  cv::GaussianBlur(undistortedImg, densoisedImg, cv::Size(5, 5), gaussianSigmaX,
-                   gaussianSigmaY);
-  // create and fill ROImask with zeros of same image size and type as src
-  cv::Mat ROImask = cv::Mat::zeros(src.size(), src.type());
-  // create rectangle mask to ignore areas not of interest for lane detection
-  cv::rectangle(ROImask, cv::Point(0, 429), cv::Point(1280, 672),
-                cv::Scalar(255, 255, 255), -1, 8, 0);
-  // mask the smoothened image with the rectangular mask
-  densoisedImg.copyTo(dst, ROImask);
+  // intermediate images only live for this call
+  FrameWorkspace workspace;
+  preProcessing(src, dst, workspace);
+}
+/**
+ *   @brief Function to pre-process the input image without allocating
+ *          once the workspace buffers are sized
+ *
+ *   @param input image of type cv::Mat
+ *   @param processed image of type cv::Mat
+ *   @param workspace holding the intermediate images of type
+ *          FrameWorkspace
+ *   @return nothing
+ */
+void ImageProcessing::preProcessing(cv::Mat& src, cv::Mat& dst,
+                                    FrameWorkspace& workspace) {
+  if (roiProcessing) {
+    preProcessingROI(src, dst, workspace);
+    return;
+  }
+  if (fusedRemap) {
+    // undistortion is folded into the bird's-eye remap and the lane polygon
+    // applied there covers the rectangular ROI, so only denoise here
+    denoiser.apply(src, dst);
+    return;
+  }
+  const SharedCalibration* shared = findSharedCalibration(src.size());
+  if (!shared) {
+    // build the undistortion maps once for this camera model and frame size
+    updateUndistortMaps(src.size());
+  }
+  const cv::Mat& map1 = shared ? shared->getUndistortMap1() : undistortMap1;
+  const cv::Mat& map2 = shared ? shared->getUndistortMap2() : undistortMap2;
+  if (denoiser.isBypass()) {
+    // undistort straight into the output, denoising would not change it
+    cv::remap(src, dst, map1, map2, cv::INTER_LINEAR, cv::BORDER_CONSTANT);
+  } else {
+    cv::Mat& undistortedImg = workspace.getBuffer(
+        FrameWorkspace::UNDISTORTED_IMG);
+    // undistort frame by resampling it through the cached maps
+    cv::remap(src, undistortedImg, map1, map2, cv::INTER_LINEAR,
+              cv::BORDER_CONSTANT);
+    // smoothen or denoise the image
+    denoiser.apply(undistortedImg, dst);
+  }
+  // zero the areas not of interest for lane detection in place instead of
+  // building and applying a rectangular mask
+  zeroOutsideROI(dst, getClippedROI(src.size()));
+}
+/**
+ *   @brief Function to build the undistortion maps if the camera model or
+ *          the image size changed since they were last built
+ *
+ *   @param size of the image to be undistorted of type cv::Size
+ *   @return nothing
+ */
+void ImageProcessing::updateUndistortMaps(const cv::Size& imgSize) {
+  if (!undistortMap1.empty() && undistortMapSize == imgSize) {
+    return;
+  }
+  // same rectification cv::undistort performs: no rotation and the camera
+  // matrix itself as the new camera matrix
+  cv::initUndistortRectifyMap(intrinsic, distortionCoeffs, cv::Mat(),
+                              intrinsic, imgSize, CV_16SC2, undistortMap1,
+                              undistortMap2);
+  undistortMapSize = imgSize;
+}
+/**
+ *   @brief Function to get the region of interest clipped to the image
+ *
+ *   @param image size of type cv::Size
+ *   @return clipped region of interest of type cv::Rect
+ */
+cv::Rect ImageProcessing::getClippedROI(const cv::Size& imgSize) {
+  return roiRect & cv::Rect(0, 0, imgSize.width, imgSize.height);
+}
+/**
+ *   @brief Function to set all pixels outside the region of interest to 0
+ *
+ *   @param image of type cv::Mat
+ *   @param region of interest inside the image of type cv::Rect
+ *   @return nothing
+ */
+void ImageProcessing::zeroOutsideROI(cv::Mat& img, const cv::Rect& roi) {
+  int roiEndX = roi.x + roi.width;  // first column right of the ROI
+  int roiEndY = roi.y + roi.height;  // first row below the ROI
+  if (roi.y > 0) {
+    img.rowRange(0, roi.y).setTo(cv::Scalar::all(0));
+  }
+  if (roiEndY < img.rows) {
+    img.rowRange(roiEndY, img.rows).setTo(cv::Scalar::all(0));
+  }
+  if (roi.x > 0 && roi.height > 0) {
+    img(cv::Rect(0, roi.y, roi.x, roi.height)).setTo(cv::Scalar::all(0));
+  }
+  if (roiEndX < img.cols && roi.height > 0) {
+    img(cv::Rect(roiEndX, roi.y, img.cols - roiEndX, roi.height)).setTo(
+        cv::Scalar::all(0));
+  }
+}
+/**
+ *   @brief Function to pre-process only the region of interest of the
+ *          input image
+ *
+ *   @param input image of type cv::Mat
+ *   @param processed image, zero outside the ROI, of type cv::Mat
+ *   @param workspace holding the intermediate images of type
+ *          FrameWorkspace
+ *   @return nothing
+ */
+void ImageProcessing::preProcessingROI(cv::Mat& src, cv::Mat& dst,
+                                       FrameWorkspace& workspace) {
+  cv::Rect roi = getClippedROI(src.size());
+  // undistort a band with the 2 pixel apron the 5x5 blur reads around the
+  // ROI, so the blurred ROI matches blurring the whole frame
+  cv::Rect band(roi.x - 2, roi.y - 2, roi.width + 4, roi.height + 4);
+  band &= cv::Rect(0, 0, src.cols, src.rows);
+  cv::Mat undistortedBand;  // header of the band to denoise
+  cv::Mat denoisedBand;  // header of the denoised band
+  if (fusedRemap) {
+    // undistortion happens later in the fused bird's-eye remap
+    undistortedBand = src(band);
+  } else {
+    cv::Mat& remappedBand = workspace.getBuffer(
+        FrameWorkspace::UNDISTORTED_BAND);
+    const SharedCalibration* shared = findSharedCalibration(src.size());
+    if (!shared) {
+      updateUndistortMaps(src.size());
+    }
+    const cv::Mat& map1 = shared ? shared->getUndistortMap1() : undistortMap1;
+    const cv::Mat& map2 = shared ? shared->getUndistortMap2() : undistortMap2;
+    // remap only the band, the maps are indexed by destination pixel
+    cv::remap(src, remappedBand, map1(band), map2(band), cv::INTER_LINEAR,
+              cv::BORDER_CONSTANT);
+    undistortedBand = remappedBand;
+  }
+  if (denoiser.isBypass()) {
+    denoisedBand = undistortedBand;
+  } else {
+    cv::Mat& filteredBand = workspace.getBuffer(
+        FrameWorkspace::DENOISED_BAND);
+    denoiser.apply(undistortedBand, filteredBand);
+    denoisedBand = filteredBand;
+  }
+  dst.create(src.size(), src.type());
+  zeroOutsideROI(dst, roi);
+  denoisedBand(roi - band.tl()).copyTo(dst(roi));
 }
 /**
  *   @brief Function to get a binary image after color thresholding and edge
@@ -98,24 +251,51 @@ void ImageProcessing::preProcessing(cv::Mat& src, cv::Mat& dst) {
  *   @return nothing
  */
 void ImageProcessing::getBinaryImg(cv::Mat& src, cv::Mat& dst) {
-  cv::Mat HLSimg, thresholdImg;  // declare variable holders for HLS image and
-                                 // thresholded image
-  // convert image to HLS colorspace
-  cv::cvtColor(src, HLSimg, cv::COLOR_BGR2HLS);
-  // threshold in HLS colorspace
-  cv::inRange(HLSimg, minThreshHLS, maxThreshHLS, thresholdImg);
-  std::vector<cv::Point> lanePoints;  // declare variable holder for points
-                                      // of polygon in which lanes appear
-  // create laneMaskROI with zeros image size of src and binary type
-  cv::Mat laneMaskROI(src.size(), CV_8U, cv::Scalar(0));
-  lanePoints.push_back(cv::Point(560, 429));  // points of vertex 1 of polygon
-  lanePoints.push_back(cv::Point(690, 429));  // points of vertex 2 of polygon
-  lanePoints.push_back(cv::Point(1155, 672));  // points of vertex 3 of polygon
-  lanePoints.push_back(cv::Point(225, 672));  // points of vertex 4 of polygon
-  // fill convex polygon having vertices described by lanePoints with value 255
-  cv::fillConvexPoly(laneMaskROI, lanePoints, 255);
-  // mask the thresholded image using bitwise AND to only display the lane ROI
-  cv::bitwise_and(thresholdImg, laneMaskROI, dst);
+  CV_Assert(src.type() == CV_8UC3);
+  // build the colour predicate tables once per threshold setting
+  colorThreshold.build();
+  const SharedCalibration* shared = findSharedCalibration(src.size());
+  if (!shared) {
+    // lane polygon spans are rasterized once per frame size
+    laneSpans.update(src.size());
+  }
+  const PolygonSpans& spans = shared ? shared->getLaneSpans() : laneSpans;
+  cv::Rect roi(0, 0, src.cols, src.rows);  // rows and columns to threshold
+  if (roiProcessing) {
+    roi = getClippedROI(src.size());
+  }
+  if (!fusedRemap) {
+    // rows the lane polygon does not cover are never read
+    int beginRow = std::max(roi.y, spans.getBeginRow());
+    int endRow = std::min(roi.y + roi.height, spans.getEndRow());
+    roi.y = beginRow;
+    roi.height = std::max(0, endRow - beginRow);
+  }
+  dst.create(src.size(), CV_8U);
+  for (int y = 0; y < src.rows; y++) {
+    uchar* dstRow = dst.ptr<uchar>(y);
+    int xBegin = 0, xEnd = 0;  // span of the row to threshold
+    if (y >= roi.y && y < roi.y + roi.height) {
+      xBegin = roi.x;
+      xEnd = roi.x + roi.width;
+      if (!fusedRemap) {
+        // only the lane polygon is kept; with the fused remap the frame is
+        // still distorted and the polygon is applied in bird's-eye space
+        cv::Vec2i span = spans.getSpan(y);
+        xBegin = std::max(xBegin, span[0]);
+        xEnd = std::min(xEnd, span[1]);
+      }
+    }
+    if (xEnd <= xBegin) {
+      std::memset(dstRow, 0, src.cols);
+      continue;
+    }
+    // pixels outside the span are never read
+    std::memset(dstRow, 0, xBegin);
+    std::memset(dstRow + xEnd, 0, src.cols - xEnd);
+    // OR of all colour rules straight from the BGR pixels
+    colorThreshold.thresholdRow(src.ptr<uchar>(y), dstRow, xBegin, xEnd);
+  }
 }
 /**
  *   @brief Function to perform prospective transform
@@ -126,29 +306,84 @@ void ImageProcessing::getBinaryImg(cv::Mat& src, cv::Mat& dst) {
  */
 void ImageProcessing::prespectiveTransform(cv::Mat& src, cv::Mat& dst,
                                            cv::Mat& T_perspective_inv) {
-  cv::Point2f inputQuadrilateral[4];  // declare variable holder for vertices of
-                                      // input polygon for perspective transform
-  cv::Point2f outputQuadrilateral[4];  // declare variable holder for vertices
-                                       // of output for perspective transform
-  // initialize variable T_perspective
-  cv::Mat T_perspective = cv::Mat::zeros(src.size(), src.type());
-  // set variable T_perspective_inv to zeros
-  T_perspective_inv = cv::Mat::zeros(src.size(), src.type());
-  // set vertices of input polygon for perspective transform
-  cv::Point2f inQuadrilateral[4] = { cv::Point(544, 462), cv::Point(731, 462),
-      cv::Point(1268, 708), cv::Point(0, 708) };
-  // set vertices of output polygon for perspective transform
-  cv::Point2f outQuadrilateral[4] = { cv::Point(0, 0), cv::Point(src.cols, 0),
-      cv::Point(src.cols, src.rows), cv::Point(0, src.rows) };
-  // get perspective transform using inQuadrilateral and outQuadrilateral
-  T_perspective = cv::getPerspectiveTransform(inQuadrilateral,
-                                              outQuadrilateral);
-  // get inverse of perspective transform using inQuadrilateral
-  // and outQuadrilateral
-  T_perspective_inv = cv::getPerspectiveTransform(outQuadrilateral,
-                                                  inQuadrilateral);
-  // transform image points using the perspective transform obtained
-  cv::warpPerspective(src, dst, T_perspective, src.size());
+  const PerspectiveGeometry* geometry = nullptr;
+  const BirdsEyeRemap* fusedMap = nullptr;
+  updatePerspective(src.size(), T_perspective_inv, geometry, fusedMap);
+  if (fusedRemap) {
+    // sample the raw mask straight into the bird's-eye view
+    fusedMap->warpMask(src, dst);
+    return;
+  }
+  // transform image points through the cached perspective warp maps
+  geometry->warpCached(src, dst);
+}
+/**
+ *   @brief Function to perform prospective transform into a packed one
+ *          bit per pixel bird's-eye mask, set where the bird's-eye view
+ *          of the binary image is non-zero
+ *
+ *   @param binary image of type cv::Mat
+ *   @param packed bird's view image of type PackedBinaryImage
+ *   @param inverse perspective transform, a header sharing the cached
+ *          3x3 matrix, of type cv::Mat
+ *   @param workspace holding the intermediate images of type
+ *          FrameWorkspace
+ *   @return nothing
+ */
+void ImageProcessing::prespectiveTransform(cv::Mat& src,
+                                           PackedBinaryImage& dst,
+                                           cv::Mat& T_perspective_inv,
+                                           FrameWorkspace& workspace) {
+  const PerspectiveGeometry* geometry = nullptr;
+  const BirdsEyeRemap* fusedMap = nullptr;
+  updatePerspective(src.size(), T_perspective_inv, geometry, fusedMap);
+  if (fusedRemap) {
+    // sample the raw mask straight into packed bits
+    fusedMap->warpMaskPacked(src, dst);
+    return;
+  }
+  // bilinear warp, then keep every pixel the warp touched
+  cv::Mat& perspectiveImg = workspace.getBuffer(
+      FrameWorkspace::PERSPECTIVE_IMG);
+  geometry->warpCached(src, perspectiveImg);
+  dst.pack(perspectiveImg);
+}
+/**
+ *   @brief Function to build the bird's-eye geometry for an image size,
+ *          or pick the shared one, and hand out the inverse perspective
+ *          transform
+ *
+ *   @param size of the binary image of type cv::Size
+ *   @param inverse perspective transform, a header sharing the cached
+ *          3x3 matrix, of type cv::Mat
+ *   @param geometry built for the size of type const PerspectiveGeometry*
+ *   @param fused remap built for the size, used only with the fused
+ *          remap, of type const BirdsEyeRemap*
+ *   @return nothing
+ */
+void ImageProcessing::updatePerspective(const cv::Size& imgSize,
+                                        cv::Mat& T_perspective_inv,
+                                        const PerspectiveGeometry*& geometry,
+                                        const BirdsEyeRemap*& fusedMap) {
+  const SharedCalibration* shared = findSharedCalibration(imgSize);
+  if (shared) {
+    // built by whichever stream met this calibration first
+    geometry = &shared->getPerspectiveGeometry();
+    fusedMap = &shared->getBirdsEyeRemap();
+  } else {
+    // homographies and warp maps are built once per frame size
+    perspectiveGeometry.update(imgSize);
+    // compose distortion model and homography once for this frame size
+    if (fusedRemap && !birdsEyeRemap.isBuiltFor(imgSize, imgSize)) {
+      birdsEyeRemap.build(intrinsic, distortionCoeffs,
+                          perspectiveGeometry.getTransform(),
+                          laneSpans.getVertices(), imgSize, imgSize);
+    }
+    geometry = &perspectiveGeometry;
+    fusedMap = &birdsEyeRemap;
+  }
+  // hand out the cached inverse transform without copying it
+  T_perspective_inv = geometry->getInverseTransform();
 }
 /**
  *   @brief Function to set camera matrix
@@ -164,6 +399,11 @@ void ImageProcessing::setIntrinsic(double fx_, double fy_, double cx_,
   // set intrinsic matrix
   intrinsic =
       (cv::Mat_<double>(3, 3) << fx_, 0.0, cx_, 0.0, fy_, cy_, 0.0, 0.0, 1.0);
+  // camera model changed, rebuild undistortion maps on the next frame
+  undistortMap1.release();
+  undistortMap2.release();
+  birdsEyeRemap.clear();
+  sharedCalibration.reset();
 }
 /**
  *   @brief Function to set camera distortion
@@ -180,6 +420,11 @@ void ImageProcessing::setDistCoeffs(double k1_, double k2_, double p1_,
   // set distortion coefficients
   distortionCoeffs =
       (cv::Mat_<double>(1, 5) << k1_, k2_, p1_, p2_, k3_);
+  // camera model changed, rebuild undistortion maps on the next frame
+  undistortMap1.release();
+  undistortMap2.release();
+  birdsEyeRemap.clear();
+  sharedCalibration.reset();
 }
 /**
  *   @brief Function to set standard deviation in X for gaussian blur
@@ -189,6 +434,7 @@ void ImageProcessing::setDistCoeffs(double k1_, double k2_, double p1_,
  */
 void ImageProcessing::setgaussianSigmaX(double gaussianSigmaX_) {
   gaussianSigmaX = gaussianSigmaX_;
+  denoiser.setSigma(gaussianSigmaX, gaussianSigmaY);
 }
 /**
  *   @brief Function to set standard deviation in Y for gaussian blur
@@ -198,6 +444,16 @@ void ImageProcessing::setgaussianSigmaX(double gaussianSigmaX_) {
  */
 void ImageProcessing::setgaussianSigmaY(double gaussianSigmaY_) {
   gaussianSigmaY = gaussianSigmaY_;
+  denoiser.setSigma(gaussianSigmaX, gaussianSigmaY);
+}
+/**
+ *   @brief Function to select the denoise filter of preProcessing
+ *
+ *   @param filter of type Denoiser::DenoiseMode
+ *   @return nothing
+ */
+void ImageProcessing::setDenoiseMode(int denoiseMode_) {
+  denoiser.setMode(denoiseMode_);
 }
 /**
  *   @brief Function to set HSL color space minimum threshold value
@@ -207,6 +463,7 @@ void ImageProcessing::setgaussianSigmaY(double gaussianSigmaY_) {
  */
 void ImageProcessing::setMinThreshHLS(cv::Scalar minThreshHLS_) {
   minThreshHLS = minThreshHLS_;
+  colorThreshold.setRule(hlsRule, minThreshHLS, maxThreshHLS);
 }
 /**
  *   @brief Function to set HSL color space maximum threshold value
@@ -216,6 +473,7 @@ void ImageProcessing::setMinThreshHLS(cv::Scalar minThreshHLS_) {
  */
 void ImageProcessing::setMaxThreshHLS(cv::Scalar maxThreshHLS_) {
   maxThreshHLS = maxThreshHLS_;
+  colorThreshold.setRule(hlsRule, minThreshHLS, maxThreshHLS);
 }
 /**
  *   @brief Function to set RGB color space minimum threshold value
@@ -225,6 +483,7 @@ void ImageProcessing::setMaxThreshHLS(cv::Scalar maxThreshHLS_) {
  */
 void ImageProcessing::setMinThreshBGR(cv::Scalar minThreshBGR_) {
   minThreshBGR = minThreshBGR_;
+  colorThreshold.setRule(bgrRule, minThreshBGR, maxThreshBGR);
 }
 /**
  *   @brief Function to set RGB color space maximum threshold value
@@ -234,6 +493,78 @@ void ImageProcessing::setMinThreshBGR(cv::Scalar minThreshBGR_) {
  */
 void ImageProcessing::setMaxThreshBGR(cv::Scalar maxThreshBGR_) {
   maxThreshBGR = maxThreshBGR_;
+  colorThreshold.setRule(bgrRule, minThreshBGR, maxThreshBGR);
+}
+/**
+ *   @brief Function to enable the fused raw sensor to bird's-eye remap
+ *
+ *   @param true to use the fused remap of type bool
+ *   @return nothing
+ */
+void ImageProcessing::setFusedRemap(bool fusedRemap_) {
+  fusedRemap = fusedRemap_;
+}
+/**
+ *   @brief Function to set the quadrilaterals of the perspective transform
+ *
+ *   @param four vertices in the camera image of type
+ *          std::vector<cv::Point2f>
+ *   @param four vertices in the bird's-eye image, or none to use the image
+ *          corners, of type std::vector<cv::Point2f>
+ *   @return nothing
+ */
+void ImageProcessing::setPerspectiveQuads(
+    const std::vector<cv::Point2f>& srcQuad,
+    const std::vector<cv::Point2f>& dstQuad) {
+  perspectiveGeometry.setSrcQuad(srcQuad);
+  perspectiveGeometry.setDstQuad(dstQuad);
+  // the fused remap embeds the homography
+  birdsEyeRemap.clear();
+  sharedCalibration.reset();
+}
+/**
+ *   @brief Function to set the region of the frame used for lane detection
+ *
+ *   @param region of interest of type cv::Rect
+ *   @return nothing
+ */
+void ImageProcessing::setROI(cv::Rect roiRect_) {
+  roiRect = roiRect_;
+}
+/**
+ *   @brief Function to enable ROI only processing
+ *
+ *   @param true to process only the ROI of type bool
+ *   @return nothing
+ */
+void ImageProcessing::setROIProcessing(bool roiProcessing_) {
+  roiProcessing = roiProcessing_;
+}
+/**
+ *   @brief Function to set the convex polygon in which lanes appear
+ *
+ *   @param vertices of the polygon of type std::vector<cv::Point>
+ *   @return nothing
+ */
+void ImageProcessing::setLaneROI(
+    const std::vector<cv::Point>& laneROIVertices) {
+  laneSpans.setVertices(laneROIVertices);
+  // the fused remap clips to the polygon in bird's-eye space
+  birdsEyeRemap.clear();
+  sharedCalibration.reset();
+}
+/**
+ *   @brief Function to add a colour range rule to the binary image, ORed
+ *          with the HLS and BGR threshold rules
+ *
+ *   @param colour space of type ColorThreshold::ColorSpace
+ *   @param lower bounds per channel of type cv::Scalar
+ *   @param upper bounds per channel of type cv::Scalar
+ *   @return index of the rule of type int
+ */
+int ImageProcessing::addColorRule(int colorSpace, const cv::Scalar& lower,
+                                  const cv::Scalar& upper) {
+  return colorThreshold.addRule(colorSpace, lower, upper);
 }
 /**
  *   @brief Function to get camera matrix
@@ -278,6 +609,25 @@ double ImageProcessing::getgaussianSigmaX(void) {
 double ImageProcessing::getgaussianSigmaY(void) {
   return gaussianSigmaY;
 }
+/**
+ *   @brief Function to get the denoise filter of preProcessing
+ *
+ *   @param nothing
+ *   @return filter of type Denoiser::DenoiseMode
+ */
+int ImageProcessing::getDenoiseMode(void) {
+  return denoiser.getMode();
+}
+/**
+ *   @brief Function to check if the denoise stage is skipped because the
+ *          selected filter would not change any pixel
+ *
+ *   @param nothing
+ *   @return true if denoising is bypassed, type bool
+ */
+bool ImageProcessing::isDenoiseBypassed(void) {
+  return denoiser.isBypass();
+}
 /**
  *   @brief Function to get HSL color space minimum threshold value
  *
@@ -320,3 +670,132 @@ cv::Scalar ImageProcessing::getMinThreshBGR(void) {
 cv::Scalar ImageProcessing::getMaxThreshBGR(void) {
   return maxThreshBGR;
 }
+/**
+ *   @brief Function to check if the fused raw sensor to bird's-eye remap
+ *          is enabled
+ *
+ *   @param nothing
+ *   @return true if the fused remap is used, type bool
+ */
+bool ImageProcessing::getFusedRemap(void) {
+  return fusedRemap;
+}
+/**
+ *   @brief Function to get the cached perspective geometry; the quads are
+ *          changed through setPerspectiveQuads, which drops the remaps built
+ *          from them
+ *
+ *   @param nothing
+ *   @return perspective geometry of type const PerspectiveGeometry&
+ */
+const PerspectiveGeometry& ImageProcessing::getPerspectiveGeometry(
+    void) const {
+  return perspectiveGeometry;
+}
+/**
+ *   @brief Function to get the region of the frame used for lane detection
+ *
+ *   @param nothing
+ *   @return region of interest of type cv::Rect
+ */
+cv::Rect ImageProcessing::getROI(void) {
+  return roiRect;
+}
+/**
+ *   @brief Function to check if ROI only processing is enabled
+ *
+ *   @param nothing
+ *   @return true if only the ROI is processed, type bool
+ */
+bool ImageProcessing::getROIProcessing(void) {
+  return roiProcessing;
+}
+/**
+ *   @brief Function to get the convex polygon in which lanes appear
+ *
+ *   @param nothing
+ *   @return vertices of the polygon of type std::vector<cv::Point>
+ */
+std::vector<cv::Point> ImageProcessing::getLaneROI(void) {
+  return laneSpans.getVertices();
+}
+/**
+ *   @brief Function to get the colour threshold kernel, e.g. to read the
+ *          per rule hit counters
+ *
+ *   @param nothing
+ *   @return colour threshold kernel of type ColorThreshold&
+ */
+ColorThreshold& ImageProcessing::getColorThreshold(void) {
+  return colorThreshold;
+}
+/**
+ *   @brief Function to get the shared artefacts if they are built for
+ *          the image size and the remap mode in use
+ *
+ *   @param size of the image of type cv::Size
+ *   @return shared artefacts, or nullptr to use the own caches, of type
+ *           const SharedCalibration*
+ */
+const SharedCalibration* ImageProcessing::findSharedCalibration(
+    const cv::Size& imgSize) {
+  if (!sharedCalibration || sharedCalibration->getImageSize() != imgSize
+      || sharedCalibration->isFusedRemap() != fusedRemap) {
+    return nullptr;
+  }
+  return sharedCalibration.get();
+}
+/**
+ *   @brief Function to build the undistortion maps, bird's-eye geometry
+ *          and lane polygon of the current calibration for sharing
+ *
+ *   @param frame size of type cv::Size
+ *   @return immutable artefacts of type
+ *           std::shared_ptr<const SharedCalibration>
+ */
+std::shared_ptr<const SharedCalibration>
+ImageProcessing::buildSharedCalibration(const cv::Size& imgSize) {
+  return std::make_shared<SharedCalibration>(
+      intrinsic, distortionCoeffs, perspectiveGeometry.getSrcQuad(),
+      perspectiveGeometry.getDstQuad(), laneSpans.getVertices(), imgSize,
+      fusedRemap);
+}
+/**
+ *   @brief Function to check if shared artefacts were built from the
+ *          current calibration
+ *
+ *   @param shared artefacts of type SharedCalibration
+ *   @return true if they can be used, type bool
+ */
+bool ImageProcessing::canShareCalibration(
+    const SharedCalibration& calibration) {
+  return calibration.matches(intrinsic, distortionCoeffs,
+                             perspectiveGeometry.getSrcQuad(),
+                             perspectiveGeometry.getDstQuad(),
+                             laneSpans.getVertices(), fusedRemap);
+}
+/**
+ *   @brief Function to use shared artefacts instead of the own caches
+ *          for frames of their size. Changing the camera model, the
+ *          perspective quadrilaterals or the lane polygon drops them
+ *
+ *   @param artefacts of the current calibration, or null, of type
+ *          std::shared_ptr<const SharedCalibration>
+ *   @return nothing
+ */
+void ImageProcessing::setSharedCalibration(
+    const std::shared_ptr<const SharedCalibration>& calibration) {
+  CV_Assert(!calibration || canShareCalibration(*calibration));
+  sharedCalibration = calibration;
+}
+/**
+ *   @brief Function to get the shared artefacts in use
+ *
+ *   @param nothing
+ *   @return artefacts, or null, of type
+ *           std::shared_ptr<const SharedCalibration>
+ */
+std::shared_ptr<const SharedCalibration>
+ImageProcessing::getSharedCalibration(void) {
+  return sharedCalibration;
+}
@@ -40,9 +40,44 @@
  *
  */
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include "LaneDetection.hpp"
+#include "FramePipeline.hpp"
 #include "ImageProcessing.hpp"
 
+namespace {
+/**
+ *  Loop body of cv::parallel_for_ running a function for every lane of its
+ *  range. The function is referenced, not copied into a std::function, so
+ *  running the lanes does not allocate
+ */
+template<typename LaneFunction>
+class LaneLoopBody : public cv::ParallelLoopBody {
+ private:
+  const LaneFunction& laneFunction;  // search or fit of one lane
+
+ public:
+  explicit LaneLoopBody(const LaneFunction& laneFunction_)
+      : laneFunction(laneFunction_) {
+  }
+  void operator()(const cv::Range& range) const {
+    for (int lane = range.start; lane < range.end; lane++) {
+      laneFunction(lane);
+    }
+  }
+};
+/**
+ *  Runs a function for every lane, the lanes in parallel
+ */
+template<typename LaneFunction>
+void parallelForLanes(int numLanes, const LaneFunction& laneFunction) {
+  cv::parallel_for_(cv::Range(0, numLanes),
+                    LaneLoopBody<LaneFunction>(laneFunction), numLanes);
+}
+}  // namespace
+
 /**
  *   @brief Default constructor for LaneDetection
  *
@@ -50,7 +85,18 @@
  *   @return nothing
  */
 LaneDetection::LaneDetection() {
-  windowBuffer = 15;
+  histBandBegin = 0.5;  // histogram over the bottom half of the image
+  histBandEnd = 1.0;
+  numWindows = 8;  // sliding windows per lane
+  windowWidth = 0;  // twice the window height
+  trackingEnabled = false;
+  fittingEnabled = false;
+  trackValid = false;
+  pyramidLevel = 0;  // sliding windows at full resolution
+  trackMargin = 100;  // half width of the band around the previous fits
+  minTrackPixels = 200;  // pixels per lane for a confident fit
+  frameCount = 0;
+  fullSearchCount = 0;
   }
 /**
  *   @brief Default destructor for LaneDetection
@@ -82,32 +128,66 @@ void LaneDetection::generateHist(cv::Mat& src, std::vector<double>& hist) {
   cv::reduce(bottomHalfImage, hist, 0, CV_REDUCE_SUM, CV_64FC1);
 }
 /**
- *   @brief Function to get average of window center
+ *   @brief Function to generate lane pixel histogram from a packed
+ *          bird's-eye mask, equal to the histogram of the unpacked mask
  *
- *   @param histogram containing lane pixels of type cv::Mat
- *   @param pixel locations of left or right lane, type std::vector<cv::Point_<int>>
- *   @param lane to be extracted - left or right of type string
+ *   @param packed projective transform of binary image of type
+ *          PackedBinaryImage
+ *   @param histogram containing lane pixels of type std::vector<double>
+ *   @return nothing
+ */
+void LaneDetection::generateHist(const PackedBinaryImage& src,
+                                 std::vector<double>& hist) {
+  cv::Size imgSize = src.getSize();
+  // bottom half of the image, same rows as the cv::Mat overload
+  src.columnHistogram(imgSize.height / 2,
+                      imgSize.height / 2 + imgSize.height / 2, hist);
+}
+/**
+ *   @brief Function to generate lane pixel histogram over the configured
+ *          band of rows from the occupancy table of the bird's-eye mask
+ *
+ *   @param occupancy table of the bird's-eye mask of type
+ *          OccupancyIntegral
+ *   @param histogram containing lane pixels of type std::vector<double>
  *   @return nothing
  */
+void LaneDetection::generateHist(const OccupancyIntegral& src,
+                                 std::vector<double>& hist) {
+  int rows = src.getSize().height;
+  int rowBegin = std::min(rows, std::max(0, cvFloor(histBandBegin * rows)));
+  int rowEnd = std::min(rows, std::max(rowBegin,
+                                       cvFloor(histBandEnd * rows)));
+  // two lookups per column whatever the height of the band
+  src.columnHistogram(rowBegin, rowEnd, hist);
+}
+/**
+ *   @brief Function to get the start of the right lane's sliding windows,
+ *          the histogram peak filtered over the last frames
+ *
+ *   @param x of the right histogram peak of type int
+ *   @return x of the centre of the bottom window of type int
+ */
 int LaneDetection::averageWindowCenter(int& xVal_) {
-  int new_xVal = 0;  // initialize variable for new histogram center
-  //  condition to push elements in vector to compute average center of
-  //  histogram
-  if (avgRightCenter.size() < windowBuffer) {
-    // push element in the container
-    avgRightCenter.push_back(xVal_);
-  } else {
-    // erase first four values of container
-    avgRightCenter.erase(avgRightCenter.begin(), avgRightCenter.begin() + 3);
-    avgRightCenter.push_back(xVal_);
-  }
-  // compute sum of the histogram center
-  for (int& n : avgRightCenter) {
-    new_xVal += n;
+  return seedWindowCenter(LaneTracker::RIGHT_LANE, xVal_, true);
+}
+/**
+ *   @brief Function to get the start of a lane's sliding windows. A
+ *          histogram peak is filtered with the previous frames' peaks; an
+ *          empty histogram falls back to the lane's predicted position
+ *
+ *   @param lane of type LaneTracker::Lane
+ *   @param x of the lane's histogram peak of type int
+ *   @param true if the peak holds lane pixels of type bool
+ *   @return x of the centre of the bottom window of type int
+ */
+int LaneDetection::seedWindowCenter(int lane, int xPeak, bool isPeakValid) {
+  if (!isPeakValid) {
+    return laneTracker.hasBase(lane) ? cvRound(laneTracker.predictBase(lane))
+        : xPeak;
   }
-  // compute average of the histogram center
-  new_xVal = new_xVal / avgRightCenter.size();
-  return new_xVal;
+  laneTracker.updateBase(lane, xPeak);
+  return cvRound(laneTracker.getBase(lane));
 }
 /**
  *   @brief Function to extract left or right lane
@@ -121,120 +201,521 @@ void LaneDetection::extractLane(cv::Mat& perspectiveImg,
                                 std::vector<double>& hist,
                                 std::vector<cv::Point>& dstLane,
                                 std::string laneType, cv::Mat& drawWindow) {
-  cv::Mat debug;  // create image container called debug
-  // copy contents of perspectiveImg to debug
-  perspectiveImg.copyTo(debug);
-  // convert debug to color space BGR and save it in drawWindow
-  cv::cvtColor(debug, drawWindow, cv::COLOR_GRAY2BGR);
+  // search the lanes on the packed mask
+  PackedBinaryImage packedImg;
+  packedImg.pack(perspectiveImg);
+  extractLane(packedImg, hist, dstLane, laneType, drawWindow);
+}
+/**
+ *   @brief Function to extract left or right lane from a packed bird's-eye
+ *          mask, visiting only the set pixels with bit-scan
+ *
+ *   @param packed projective transform of binary image of type
+ *          PackedBinaryImage
+ *   @param histogram containing lane pixels of type std::vector<double>
+ *   @param pixel locations of left or right lane, type std::vector<cv::Point_<int>>
+ *   @param lane to be extracted - left or right of type string
+ *   @param debug image with the lane pixels marked of type cv::Mat
+ *   @return nothing
+ */
+void LaneDetection::extractLane(const PackedBinaryImage& perspectiveImg,
+                                std::vector<double>& hist,
+                                std::vector<cv::Point>& dstLane,
+                                std::string laneType, cv::Mat& drawWindow) {
+  // window occupancy of the mask for skipping empty windows
+  OccupancyIntegral occupancy;
+  occupancy.build(perspectiveImg);
+  extractLane(perspectiveImg, occupancy, hist, dstLane, laneType,
+              drawWindow);
+}
+/**
+ *   @brief Function to extract left or right lane from a packed bird's-eye
+ *          mask, skipping windows the occupancy table reports empty and
+ *          visiting only the set pixels with bit-scan
+ *
+ *   @param packed projective transform of binary image of type
+ *          PackedBinaryImage
+ *   @param occupancy table of the packed image of type OccupancyIntegral
+ *   @param histogram containing lane pixels of type std::vector<double>
+ *   @param pixel locations of left or right lane, type std::vector<cv::Point_<int>>
+ *   @param lane to be extracted - left or right of type string
+ *   @param debug image with the lane pixels marked of type cv::Mat
+ *   @return nothing
+ */
+void LaneDetection::extractLane(const PackedBinaryImage& perspectiveImg,
+                                const OccupancyIntegral& occupancy,
+                                std::vector<double>& hist,
+                                std::vector<cv::Point>& dstLane,
+                                std::string laneType, cv::Mat& drawWindow) {
+  LanePointSet lanePts;
+  extractLanePoints(perspectiveImg, occupancy, hist, laneType, lanePts,
+                    dstLane, drawWindow);
+}
+/**
+ *   @brief Function to extract left or right lane, packing the mask into
+ *          the workspace's packed bird's-eye buffer
+ *
+ *   @param projective transform of binary image of type cv::Mat
+ *   @param histogram containing lane pixels of type std::vector<double>
+ *   @param pixel locations of left or right lane, type std::vector<cv::Point_<int>>
+ *   @param lane to be extracted - left or right of type string
+ *   @param debug image with the lane pixels marked of type cv::Mat
+ *   @param workspace whose buffers are reused of type FrameWorkspace
+ *   @return nothing
+ */
+void LaneDetection::extractLane(cv::Mat& perspectiveImg,
+                                std::vector<double>& hist,
+                                std::vector<cv::Point>& dstLane,
+                                std::string laneType, cv::Mat& drawWindow,
+                                FrameWorkspace& workspace) {
+  PackedBinaryImage& packedImg = workspace.getPackedPerspective();
+  packedImg.pack(perspectiveImg);
+  extractLane(packedImg, hist, dstLane, laneType, drawWindow, workspace);
+}
+/**
+ *   @brief Function to extract left or right lane from a packed bird's-eye
+ *          mask, building the occupancy table in the workspace
+ *
+ *   @param packed projective transform of binary image of type
+ *          PackedBinaryImage
+ *   @param histogram containing lane pixels of type std::vector<double>
+ *   @param pixel locations of left or right lane, type std::vector<cv::Point_<int>>
+ *   @param lane to be extracted - left or right of type string
+ *   @param debug image with the lane pixels marked of type cv::Mat
+ *   @param workspace whose buffers are reused of type FrameWorkspace
+ *   @return nothing
+ */
+void LaneDetection::extractLane(const PackedBinaryImage& perspectiveImg,
+                                std::vector<double>& hist,
+                                std::vector<cv::Point>& dstLane,
+                                std::string laneType, cv::Mat& drawWindow,
+                                FrameWorkspace& workspace) {
+  OccupancyIntegral& occupancy = workspace.getOccupancy();
+  occupancy.build(perspectiveImg);
+  extractLane(perspectiveImg, occupancy, hist, dstLane, laneType, drawWindow,
+              workspace);
+}
+/**
+ *   @brief Function to extract left or right lane from a packed bird's-eye
+ *          mask and its occupancy table, gathering the pixels in the
+ *          workspace's set of the lane
+ *
+ *   @param packed projective transform of binary image of type
+ *          PackedBinaryImage
+ *   @param occupancy table of the packed image of type OccupancyIntegral
+ *   @param histogram containing lane pixels of type std::vector<double>
+ *   @param pixel locations of left or right lane, type std::vector<cv::Point_<int>>
+ *   @param lane to be extracted - left or right of type string
+ *   @param debug image with the lane pixels marked of type cv::Mat
+ *   @param workspace whose buffers are reused of type FrameWorkspace
+ *   @return nothing
+ */
+void LaneDetection::extractLane(const PackedBinaryImage& perspectiveImg,
+                                const OccupancyIntegral& occupancy,
+                                std::vector<double>& hist,
+                                std::vector<cv::Point>& dstLane,
+                                std::string laneType, cv::Mat& drawWindow,
+                                FrameWorkspace& workspace) {
+  int lane = (laneType == "Right") ? LaneTracker::RIGHT_LANE
+      : LaneTracker::LEFT_LANE;
+  LanePointSet& lanePts = workspace.getLanePoints(lane);
+  lanePts.clear();
+  extractLanePoints(perspectiveImg, occupancy, hist, laneType, lanePts,
+                    dstLane, drawWindow);
+}
+/**
+ *   @brief Function to follow a lane up a packed bird's-eye mask with
+ *          sliding windows from the peak of its half of the histogram,
+ *          appending its pixels to the legacy lane points
+ *
+ *   @param packed projective transform of binary image of type
+ *          PackedBinaryImage
+ *   @param occupancy table of the packed image of type OccupancyIntegral
+ *   @param histogram containing lane pixels of type std::vector<double>
+ *   @param lane to be extracted - left or right of type string
+ *   @param empty pixel set the windows are gathered in of type
+ *          LanePointSet
+ *   @param pixel locations of left or right lane, type std::vector<cv::Point_<int>>
+ *   @param debug image with the lane pixels marked of type cv::Mat
+ *   @return nothing
+ */
+void LaneDetection::extractLanePoints(const PackedBinaryImage& perspectiveImg,
+                                      const OccupancyIntegral& occupancy,
+                                      const std::vector<double>& hist,
+                                      const std::string& laneType,
+                                      LanePointSet& lanePts,
+                                      std::vector<cv::Point>& dstLane,
+                                      cv::Mat& drawWindow) {
+  if (drawWindow.size() != perspectiveImg.getSize()
+      || drawWindow.type() != CV_8UC3) {
+    visualizer.drawLaneMask(perspectiveImg, drawWindow);
+  }
+  int lane = (laneType == "Right") ? LaneTracker::RIGHT_LANE
+      : LaneTracker::LEFT_LANE;
+  // a no-op once the set is large enough
+  lanePts.reserveForWindows(perspectiveImg.getSize(), numWindows,
+                            windowWidth);
+  scanWindows(perspectiveImg, occupancy, laneStart(hist, lane, 1), lanePts);
+  lanePts.appendTo(dstLane);
+  visualizer.drawLanePoints(lanePts, lane, drawWindow);
+}
+/**
+ *   @brief Function to get the start of a lane's sliding windows from the
+ *          peak of its half of the histogram
+ *
+ *   @param histogram containing lane pixels of type std::vector<double>
+ *   @param lane of type LaneTracker::Lane
+ *   @param full resolution pixels per histogram bin of type int
+ *   @return x of the centre of the bottom window of type int
+ */
+int LaneDetection::laneStart(const std::vector<double>& hist, int lane,
+                             int scale) {
   // initialize midpoint of histogram
   std::size_t const histMidPoint = hist.size() / 2;
-  // get left half of histogram
-  std::vector<double> histLeft(hist.begin(), hist.begin() + histMidPoint);
-  // get right half of histogram
-  std::vector<double> histRight(hist.begin() + histMidPoint, hist.end());
-  int idxPeakL, idxPeakR;  // declare peaks of histogram
-  // get left peak of histogram
-  idxPeakL = std::max_element(histLeft.begin(), histLeft.end())
-      - histLeft.begin();
-  int xValL = idxPeakL;  // initialize xValL to left histograms  peak
-  int numWindowsL = 8;  // set the number of left lane sliding windows
-  // set the height of sliding window for left lane
-  int heightWindowL = perspectiveImg.rows / numWindowsL;
-  // set the width of sliding window for left lane
-  int widthWindowL = 2 * heightWindowL;
-  int temp_xValL;  // temporary variable to hold new peak
-  // variable to update the height of sliding window from bottom of image
-  int var_heightWindowL = perspectiveImg.rows;
-  std::vector<int> updated_xVal_listL;  // initialize list of updated peaks
-  // algorithm to find the lane pixels using sliding window approach
-  for (int windowsL = 0; windowsL < numWindowsL; windowsL++) {
-    // initialize the top left corner coordinates of sliding window
-    cv::Point windowTopLeft(xValL - widthWindowL / 2,
-                            var_heightWindowL - heightWindowL);
-    // initialize the bottom right corner coordinates of sliding window
-    cv::Point windowBottomRight(xValL + widthWindowL / 2, var_heightWindowL);
-    for (int x_iterL = windowTopLeft.x; x_iterL <= windowBottomRight.x;
-        x_iterL++) {
-      for (int y_iterL = windowTopLeft.y; y_iterL <= windowBottomRight.y;
-          y_iterL++) {
-        // if image consists lane pixel, push it to container
-        if (perspectiveImg.at<uchar>(y_iterL, x_iterL) > 0) {
-          dstLane.push_back(cv::Point(y_iterL, x_iterL));
-          // mark the lane pixels to a distinct color
-          drawWindow.at<cv::Vec3b>(cv::Point(x_iterL, y_iterL)) = cv::Vec3b(0,
-                                                                            255,
-                                                                            0);
-          // container to update the new x coordinate value for
-          // further processing
-          updated_xVal_listL.push_back(x_iterL);
-          }
-        }
-      }
-    // calculate the average value of the new x position of sliding window
-    if (!updated_xVal_listL.empty()) {
-      temp_xValL = 0;
-      for (int& n : updated_xVal_listL) {
-        temp_xValL += n;
-        }
-      xValL = temp_xValL / updated_xVal_listL.size();
-      }
+  // get the peak of the lane's half of the histogram, searching in place
+  std::vector<double>::const_iterator halfBegin = hist.begin();
+  std::vector<double>::const_iterator halfEnd = hist.begin() + histMidPoint;
+  if (lane == LaneTracker::RIGHT_LANE) {
+    halfBegin = halfEnd;
+    halfEnd = hist.end();
+  }
+  int idxPeak = std::max_element(halfBegin, halfEnd) - hist.begin();
+  // start from the peak filtered over the last frames, at the centre of
+  // its bin
+  return seedWindowCenter(lane, idxPeak * scale + scale / 2,
+                          hist[idxPeak] > 0);
+}
+/**
+ *   @brief Function to follow a lane up the bird's-eye mask with sliding
+ *          windows, each centred on the mean x of the hits of the window
+ *          below it
+ *
+ *   @param packed projective transform of binary image of type
+ *          PackedBinaryImage
+ *   @param occupancy table of the packed image of type OccupancyIntegral
+ *   @param x coordinate of the centre of the bottom window of type int
+ *   @param pixels of the lane, one window per sliding window, of type
+ *          LanePointSet
+ *   @return nothing
+ */
+void LaneDetection::scanWindows(const PackedBinaryImage& perspectiveImg,
+                                const OccupancyIntegral& occupancy,
+                                int xStart, LanePointSet& dstLane) {
+  cv::Size imgSize = perspectiveImg.getSize();
+  // image bounds the sliding windows are clipped to
+  cv::Rect imgRect(0, 0, imgSize.width, imgSize.height);
+  // set the height and width of the sliding windows
+  int heightWindow = imgSize.height / numWindows;
+  int widthWindow = (windowWidth > 0) ? windowWidth : 2 * heightWindow;
+  int xVal = xStart;  // centre of the current window
+  // bottom row of the current window, moving up the image
+  int bottomWindow = imgSize.height;
+  for (int windowIdx = 0; windowIdx < numWindows; windowIdx++) {
+    // window between its top left and bottom right corners, inclusive,
+    // clipped to the image
+    cv::Rect window(cv::Point(xVal - widthWindow / 2,
+                              bottomWindow - heightWindow),
+                    cv::Point(xVal + widthWindow / 2 + 1, bottomWindow + 1));
+    window &= imgRect;
     // update the height of window
-    var_heightWindowL = var_heightWindowL - heightWindowL - 1;
-    // clear the list
-    updated_xVal_listL.clear();
+    bottomWindow = bottomWindow - heightWindow - 1;
+    // skip the pixel walk if the window holds no lane pixel
+    if (occupancy.count(window) == 0) {
+      dstLane.endWindow();
+      continue;
     }
-  // get right peak of histogram
-  idxPeakR = std::max_element(histRight.begin(), histRight.end())
-        - histRight.begin()
-        + histMidPoint;
-  // initialize xValL to right histograms  peak
-  int xValR = averageWindowCenter(idxPeakR);
-  // set the number of left lane sliding windows
-  int numWindowsR = 8;
-  // set the height of sliding window for left lane
-  int heightWindowR = perspectiveImg.rows / numWindowsR;
-  // set the width of sliding window for left lane
-  int widthWindowR = 2 * heightWindowR;
-  int temp_xValR;  // temporary variable to hold new peak
-  // variable to update the height of sliding window from bottom of image
-  int var_heightWindowR = perspectiveImg.rows;
-  std::vector<int> updated_xVal_listR;  // initialize list of updated peaks
-  // algorithm to find the lane pixels using sliding window approach
-  for (int windowsR = 0; windowsR < numWindowsR; windowsR++) {
-    // initialize the top left corner coordinates of sliding window
-    cv::Point windowTopLeft(xValR - widthWindowR / 2,
-                            var_heightWindowR - heightWindowR);
-    // initialize the bottom right corner coordinates of sliding window
-    cv::Point windowBottomRight(xValR + widthWindowR / 2, var_heightWindowR);
-    for (int x_iterR = windowTopLeft.x; x_iterR <= windowBottomRight.x;
-        x_iterR++) {
-      // if image consists lane pixel, push it to container
-      for (int y_iterR = windowTopLeft.y; y_iterR <= windowBottomRight.y;
-          y_iterR++) {
-        if (perspectiveImg.at<uchar>(y_iterR, x_iterR) > 0) {
-          dstLane.push_back(cv::Point(y_iterR, x_iterR));
-          // mark the lane pixels to a distinct color
-          drawWindow.at<cv::Vec3b>(cv::Point(x_iterR, y_iterR)) = cv::Vec3b(
-                0, 0, 255);
-          // container to update the new x coordinate value for
-          // further processing
-          updated_xVal_listR.push_back(x_iterR);
-          }
-        }
+    // hits and their running x sum in one row-major pass, testing 64
+    // pixels per word and visiting only the lane pixels
+    long sumX = 0;
+    int countX = 0;
+    int windowEnd = window.x + window.width;
+    for (int y = window.y; y < window.y + window.height; y++) {
+      for (int x = perspectiveImg.nextSetBit(y, window.x, windowEnd);
+          x < windowEnd; x = perspectiveImg.nextSetBit(y, x + 1, windowEnd)) {
+        dstLane.push(x, y);
+        sumX += x;
+        countX++;
       }
-    // calculate the average value of the new x position
-    // of sliding window
-    if (!updated_xVal_listR.empty()) {
-      temp_xValR = 0;
-      for (int& n : updated_xVal_listR) {
-        temp_xValR += n;
-        }
-      xValR = temp_xValR / updated_xVal_listR.size();
+    }
+    dstLane.endWindow();
+    // centre the next window on the mean x of the hits
+    xVal = static_cast<int>(sumX / countX);
+  }
+}
+/**
+ *   @brief Function to follow a lane up the bird's-eye mask coarse to fine.
+ *          Each sliding window is centred on the mean x of its hits in a
+ *          max pooled level of the mask; only a window narrower by the
+ *          scale around that centre is read at full resolution
+ *
+ *   @param packed projective transform of binary image of type
+ *          PackedBinaryImage
+ *   @param max pooled level of the packed image of type PackedBinaryImage
+ *   @param full resolution pixels per pooled pixel of type int
+ *   @param x coordinate of the centre of the bottom window of type int
+ *   @param pixels of the lane, one window per sliding window, of type
+ *          LanePointSet
+ *   @return nothing
+ */
+void LaneDetection::scanWindowsPyramid(const PackedBinaryImage& perspectiveImg,
+                                       const PackedBinaryImage& coarseImg,
+                                       int scale, int xStart,
+                                       LanePointSet& dstLane) {
+  cv::Size imgSize = perspectiveImg.getSize();
+  cv::Size coarseSize = coarseImg.getSize();
+  // image bounds the sliding windows are clipped to
+  cv::Rect imgRect(0, 0, imgSize.width, imgSize.height);
+  cv::Rect coarseRect(0, 0, coarseSize.width, coarseSize.height);
+  // set the height and width of the sliding windows
+  int heightWindow = imgSize.height / numWindows;
+  int widthWindow = (windowWidth > 0) ? windowWidth : 2 * heightWindow;
+  // the coarse centre is within a pooled pixel of the lane
+  int widthRefine = std::max(widthWindow / scale, 2 * scale + 1);
+  int xVal = xStart;  // centre of the current window
+  // bottom row of the current window, moving up the image
+  int bottomWindow = imgSize.height;
+  for (int windowIdx = 0; windowIdx < numWindows; windowIdx++) {
+    int top = bottomWindow - heightWindow;
+    cv::Rect window(cv::Point(xVal - widthWindow / 2, top),
+                    cv::Point(xVal + widthWindow / 2 + 1, bottomWindow + 1));
+    // pooled pixels covering the window, clipped to the pooled image
+    cv::Rect coarseWindow(
+        cv::Point(cvFloor(static_cast<double>(window.x) / scale),
+                  cvFloor(static_cast<double>(window.y) / scale)),
+        cv::Point(cvCeil(static_cast<double>(window.br().x) / scale),
+                  cvCeil(static_cast<double>(window.br().y) / scale)));
+    coarseWindow &= coarseRect;
+    bottomWindow = bottomWindow - heightWindow - 1;
+    // centre of the lane in the pooled window
+    long sumCoarse = 0;
+    int countCoarse = 0;
+    int coarseEnd = coarseWindow.x + coarseWindow.width;
+    for (int y = coarseWindow.y; y < coarseWindow.y + coarseWindow.height;
+        y++) {
+      for (int x = coarseImg.nextSetBit(y, coarseWindow.x, coarseEnd);
+          x < coarseEnd; x = coarseImg.nextSetBit(y, x + 1, coarseEnd)) {
+        sumCoarse += x;
+        countCoarse++;
       }
-    // update the height of window
-    var_heightWindowR = var_heightWindowR - heightWindowR - 1;
+    }
+    if (countCoarse == 0) {
+      dstLane.endWindow();
+      continue;
+    }
+    int xCoarse = static_cast<int>(sumCoarse * scale / countCoarse)
+        + scale / 2;
+    // read the full resolution pixels only around the coarse centre
+    cv::Rect refineWindow(cv::Point(xCoarse - widthRefine / 2, top),
+                          cv::Point(xCoarse + widthRefine / 2 + 1,
+                                    top + heightWindow + 1));
+    refineWindow &= imgRect;
+    long sumX = 0;
+    int countX = 0;
+    int refineEnd = refineWindow.x + refineWindow.width;
+    for (int y = refineWindow.y; y < refineWindow.y + refineWindow.height;
+        y++) {
+      for (int x = perspectiveImg.nextSetBit(y, refineWindow.x, refineEnd);
+          x < refineEnd; x = perspectiveImg.nextSetBit(y, x + 1, refineEnd)) {
+        dstLane.push(x, y);
+        sumX += x;
+        countX++;
+      }
+    }
+    dstLane.endWindow();
+    // centre the next window on the mean x of the hits
+    xVal = (countX > 0) ? static_cast<int>(sumX / countX) : xCoarse;
   }
+}
+/**
+ *   @brief Function to extract left or right lane from a packed bird's-eye
+ *          mask by gathering the pixels in a band of trackMargin pixels on
+ *          either side of the lane's previous fit
+ *
+ *   @param packed projective transform of binary image of type
+ *          PackedBinaryImage
+ *   @param pixel locations of left or right lane, type std::vector<cv::Point_<int>>
+ *   @param lane to be extracted - left or right of type string
+ *   @param debug image with the lane pixels marked of type cv::Mat
+ *   @return nothing
+ */
+void LaneDetection::extractLaneAroundFit(const PackedBinaryImage& perspectiveImg,
+                                         std::vector<cv::Point>& dstLane,
+                                         std::string laneType,
+                                         cv::Mat& drawWindow) {
+  if (drawWindow.size() != perspectiveImg.getSize()
+      || drawWindow.type() != CV_8UC3) {
+    visualizer.drawLaneMask(perspectiveImg, drawWindow);
   }
+  int lane = (laneType == "Right") ? LaneTracker::RIGHT_LANE
+      : LaneTracker::LEFT_LANE;
+  LanePointSet lanePts;
+  lanePts.reserveForWindows(perspectiveImg.getSize(), numWindows,
+                            2 * trackMargin);
+  scanAroundFit(perspectiveImg,
+                (lane == LaneTracker::RIGHT_LANE) ? rightLaneCoeffs
+                    : leftLaneCoeffs, lanePts);
+  lanePts.appendTo(dstLane);
+  visualizer.drawLanePoints(lanePts, lane, drawWindow);
+}
+/**
+ *   @brief Function to gather the pixels of a packed bird's-eye mask in a
+ *          band of trackMargin pixels on either side of a lane fit. The
+ *          rows are split bottom up into numWindows windows
+ *
+ *   @param packed projective transform of binary image of type
+ *          PackedBinaryImage
+ *   @param column of the lane as a polynomial in the row, coefficients in
+ *          increasing order of power, of type cv::Mat; rows where it is not
+ *          finite are skipped
+ *   @param pixels of the lane of type LanePointSet
+ *   @return nothing
+ */
+void LaneDetection::scanAroundFit(const PackedBinaryImage& perspectiveImg,
+                                  const cv::Mat& laneCoeffs,
+                                  LanePointSet& dstLane) {
+  cv::Size imgSize = perspectiveImg.getSize();
+  CV_Assert(laneCoeffs.type() == CV_64F && laneCoeffs.total() >= 1);
+  const double* coeffs = laneCoeffs.ptr<double>();
+  int order = static_cast<int>(laneCoeffs.total()) - 1;
+  int heightWindow = std::max(imgSize.height / numWindows, 1);
+  int windowIdx = 0;
+  // bottom window first, as for the sliding windows; the top window takes
+  // the rows left over
+  for (int y = imgSize.height - 1; y >= 0; y--) {
+    if (y < imgSize.height - 1 && windowIdx < numWindows - 1
+        && (imgSize.height - 1 - y) % heightWindow == 0) {
+      dstLane.endWindow();
+      windowIdx++;
+    }
+    // column of the previous fit on this row, by Horner's rule
+    double xFit = coeffs[order];
+    for (int k = order - 1; k >= 0; k--) {
+      xFit = xFit * y + coeffs[k];
+    }
+    // a fit set from outside or solved from degenerate points can be NaN
+    // or overflow, and has no band then
+    if (!std::isfinite(xFit)) {
+      continue;
+    }
+    // band around the fit, clipped to the image
+    double xLow = std::max(xFit - trackMargin, 0.0);
+    double xHigh = std::min(xFit + trackMargin + 1,
+                            static_cast<double>(imgSize.width));
+    if (xLow >= xHigh) {
+      continue;
+    }
+    int bandBegin = static_cast<int>(xLow);
+    int bandEnd = static_cast<int>(xHigh);
+    for (int x = perspectiveImg.nextSetBit(y, bandBegin, bandEnd);
+        x < bandEnd; x = perspectiveImg.nextSetBit(y, x + 1, bandEnd)) {
+      dstLane.push(x, y);
+    }
+  }
+  if (imgSize.height > 0) {
+    dstLane.endWindow();
+  }
+}
+/**
+ *   @brief Function to search lanes concurrently, one task per lane. Each
+ *          task reads the mask and writes only its own lane's points, so
+ *          the result does not depend on the scheduling
+ *
+ *   @param packed projective transform of binary image of type
+ *          PackedBinaryImage
+ *   @param occupancy table of the packed image for the sliding windows of
+ *          type OccupancyIntegral*
+ *   @param max pooled image at pyramidLevel for the coarse to fine
+ *          sliding windows of type PackedBinaryImage*
+ *   @param x of the bottom window of each lane of type int*
+ *   @param fit of each lane to search around, or nullptr for the sliding
+ *          windows, of type cv::Mat*
+ *   @param number of lanes of type int
+ *   @param pixels of each lane, cleared first, of type
+ *          LanePointSet* const*
+ *   @return nothing
+ */
+void LaneDetection::searchLanes(const PackedBinaryImage& perspectiveImg,
+                                const OccupancyIntegral* occupancy,
+                                const PackedBinaryImage* coarseImg,
+                                const int* xStarts, const cv::Mat* laneFits,
+                                int numLanes,
+                                LanePointSet* const* dstLanes) {
+  parallelForLanes(numLanes, [&](int lane) {
+    dstLanes[lane]->clear();
+    if (laneFits) {
+      scanAroundFit(perspectiveImg, laneFits[lane], *dstLanes[lane]);
+    } else if (coarseImg) {
+      scanWindowsPyramid(perspectiveImg, *coarseImg, 1 << pyramidLevel,
+                         xStarts[lane], *dstLanes[lane]);
+    } else {
+      scanWindows(perspectiveImg, *occupancy, xStarts[lane], *dstLanes[lane]);
+    }
+  });
+}
+/**
+ *   @brief Function to fit each lane's column as a polynomial in the row
+ *          concurrently. A lane with too few pixels for the fit is left
+ *          empty
+ *
+ *   @param left lane pixels of type LanePointSet
+ *   @param right lane pixels of type LanePointSet
+ *   @param fit of each lane of type cv::Mat*
+ *   @return nothing
+ */
+void LaneDetection::fitLanes(const LanePointSet& leftLanePts,
+                             const LanePointSet& rightLanePts,
+                             cv::Mat* laneFits) {
+  const LanePointSet* const lanes[LaneTracker::NUM_LANES] = { &leftLanePts,
+      &rightLanePts };
+  std::size_t minPixels = static_cast<std::size_t>(laneFitter.getOrder() + 1);
+  // the right lane fits with its own fitter of the same settings, so the
+  // fits share no scratch
+  rightLaneFitter.copySettings(laneFitter);
+  parallelForLanes(LaneTracker::NUM_LANES, [&](int lane) {
+    if (lanes[lane]->size() < minPixels) {
+      laneFits[lane].release();
+    } else if (lane == LaneTracker::LEFT_LANE) {
+      laneFitter.fit(*lanes[lane], laneFits[lane]);
+    } else {
+      rightLaneFitter.fit(*lanes[lane], laneFits[lane]);
+    }
+  });
+}
+/**
+ *   @brief Function to track the frame's fits for the next frame's search,
+ *          or to fall back to the full search if either lane has too few
+ *          pixels
+ *
+ *   @param left lane pixels of type LanePointSet
+ *   @param right lane pixels of type LanePointSet
+ *   @param frame's fit of each lane, or empty, of type cv::Mat*
+ *   @return nothing
+ */
+void LaneDetection::updateTrack(const LanePointSet& leftLanePts,
+                                const LanePointSet& rightLanePts,
+                                const cv::Mat* laneFits) {
+  trackValid = leftLanePts.size() >= minTrackPixels
+      && rightLanePts.size() >= minTrackPixels
+      && !laneFits[LaneTracker::LEFT_LANE].empty()
+      && !laneFits[LaneTracker::RIGHT_LANE].empty();
+  if (!trackValid) {
+    // a fit from before the lane was lost would bias the next track
+    laneTracker.resetFit(LaneTracker::LEFT_LANE);
+    laneTracker.resetFit(LaneTracker::RIGHT_LANE);
+    return;
+  }
+  if (laneTracker.getOrder() != laneFitter.getOrder()) {
+    laneTracker.setOrder(laneFitter.getOrder());
+  }
+  // search the next frame around the fits filtered over the last frames
+  // and moved on to where they are predicted
+  laneTracker.updateFit(LaneTracker::LEFT_LANE,
+                        laneFits[LaneTracker::LEFT_LANE]);
+  laneTracker.predictFit(LaneTracker::LEFT_LANE, leftLaneCoeffs);
+  laneTracker.updateFit(LaneTracker::RIGHT_LANE,
+                        laneFits[LaneTracker::RIGHT_LANE]);
+  laneTracker.predictFit(LaneTracker::RIGHT_LANE, rightLaneCoeffs);
+}
 /**
  *   @brief Function to fit a polynomial on the received lane pixel data
  *
@@ -244,27 +725,11 @@ void LaneDetection::extractLane(cv::Mat& perspectiveImg,
  */
 void LaneDetection::fitPoly(std::vector<cv::Point>& laneLR,
                             cv::Mat& dstLaneParameters, int order) {
-  cv::Mat src_x = cv::Mat(laneLR.size(), 1, CV_32F);
-  cv::Mat src_y = cv::Mat(laneLR.size(), 1, CV_32F);
-  for (int iter = 0; iter < laneLR.size(); iter++) {
-    src_x.at<float>(iter, 0) = static_cast<float>(laneLR[iter].x);
-    src_y.at<float>(iter, 0) = static_cast<float>(laneLR[iter].y);
-  }
-  int npoints = src_x.checkVector(1);
-  int nypoints = src_y.checkVector(1);
-  CV_Assert(npoints == nypoints && npoints >= order + 1);
-  cv::Mat_<double> srcX(src_x), srcY(src_y);
-  cv::Mat_<double> A = cv::Mat_<double>::ones(npoints, order + 1);
-  // build A matrix
-  for (int y = 0; y < npoints; ++y) {
-    for (int x = 1; x < A.cols; ++x)
-      A.at<double>(y, x) = srcX.at<double>(y) * A.at<double>(y, x - 1);
-  }
-  cv::Mat w;
-  cv::solve(A, srcY, w, cv::DECOMP_SVD);
-  w.convertTo(
-      dstLaneParameters,
-      ((src_x.depth() == CV_64F || src_y.depth() == CV_64F) ? CV_64F : CV_32F));
+  // power sums in one pass instead of the SVD of the Vandermonde matrix
+  PolyFitter polyFitter;
+  polyFitter.setOrder(order);
+  polyFitter.fit(laneLR, dstLaneParameters);
+  dstLaneParameters.convertTo(dstLaneParameters, CV_32F);
 }
 /**
  *   @brief Function to extract central line
@@ -296,9 +761,9 @@ double LaneDetection::computeTurnAngle(
  *   @brief Function to implement the entire system pipeline
  *
  *   @param nothing
- *   @return nothing
+ *   @return false if the video could not be opened, type bool
  */
-void LaneDetection::detectLanes(void) {
+bool LaneDetection::detectLanes(void) {
   // uncomment this block to use input from image sensor
   //  cv::VideoCapture cap(0);  // open default camera
   //  if (!cap.isOpened()) {  // check if camera not opened
@@ -311,61 +776,471 @@ void LaneDetection::detectLanes(void) {
   cv::VideoCapture cap("test_video.mp4");  // open video file
   if (!cap.isOpened()) {  // check if file is opened
     std::cout << "No video file detected!!!" << std::endl;
+    return false;
+  }
+  // decode, transform, search and output overlap on their own threads;
+  // only the window sink calls into the GUI, and any key stops
+  FramePipeline pipeline(*this);
+  pipeline.run(cap);
+  cap.release();  // release video capture object
+  visualizer.close();
+  return true;
+}
+/**
+ *   @brief Function to run the pipeline on one frame
+ *
+ *   @param input frame of type cv::Mat
+ *   @param workspace holding the intermediate images of type
+ *          FrameWorkspace
+ *   @return nothing
+ */
+void LaneDetection::processFrame(cv::Mat& frame, FrameWorkspace& workspace) {
+  transformFrame(frame, workspace);
+  searchFrame(workspace);
+  renderFrame(frame, workspace);
+}
+/**
+ *   @brief Function to run the geometric and colour stage of the pipeline:
+ *          pre-process and threshold a frame and pack its bird's-eye mask
+ *          into the workspace
+ *
+ *   @param input frame of type cv::Mat
+ *   @param workspace holding the intermediate images of type
+ *          FrameWorkspace
+ *   @return nothing
+ */
+void LaneDetection::transformFrame(cv::Mat& frame, FrameWorkspace& workspace) {
+  cv::Mat& processedFrame = workspace.getBuffer(
+      FrameWorkspace::PROCESSED_FRAME);
+  cv::Mat& binaryFrame = workspace.getBuffer(FrameWorkspace::BINARY_FRAME);
+  PackedBinaryImage& packedPerspective = workspace.getPackedPerspective();
+  cv::Mat T_perspective_inv;  // header of the cached inverse transform
+  // pre process image
+  processImage.preProcessing(frame, processedFrame, workspace);
+  // get binary thresholded image
+  processImage.getBinaryImg(processedFrame, binaryFrame);
+  // get packed perspective image
+  processImage.prespectiveTransform(binaryFrame, packedPerspective,
+                                    T_perspective_inv, workspace);
+  // the frame keeps its own copy, later stages may run after the cache
+  // changes
+  T_perspective_inv.copyTo(workspace.getPerspectiveInverse());
+}
+/**
+ *   @brief Function to run the lane search and fitting stage of the
+ *          pipeline on the bird's-eye mask of the workspace, leaving the
+ *          lane pixels and fits in the workspace
+ *
+ *   @param workspace holding the intermediate images of type
+ *          FrameWorkspace
+ *   @return nothing
+ */
+void LaneDetection::searchFrame(FrameWorkspace& workspace) {
+  PackedBinaryImage& packedPerspective = workspace.getPackedPerspective();
+  OccupancyIntegral& occupancy = workspace.getOccupancy();
+  std::vector<double>& histogram = workspace.getHistogram();
+  frameCount++;
+  LanePointSet& leftLanePts = workspace.getLanePoints(
+      FrameWorkspace::LEFT_LANE_POINTS);
+  LanePointSet& rightLanePts = workspace.getLanePoints(
+      FrameWorkspace::RIGHT_LANE_POINTS);
+  LanePointSet* const lanes[LaneTracker::NUM_LANES] = { &leftLanePts,
+      &rightLanePts };
+  // room for every pixel of the windows or of the bands around the fits,
+  // a no-op once the sets are large enough
+  cv::Size birdsEyeSize = packedPerspective.getSize();
+  int bandWidth = std::max((windowWidth > 0) ? windowWidth
+      : 2 * (birdsEyeSize.height / numWindows), 2 * trackMargin);
+  for (int lane = 0; lane < LaneTracker::NUM_LANES; lane++) {
+    lanes[lane]->reserveForWindows(birdsEyeSize, numWindows, bandWidth);
+  }
+  bool isTracked = false;
+  if (trackingEnabled && trackValid) {
+    // search only around the previous fits
+    const cv::Mat trackedFits[LaneTracker::NUM_LANES] = { leftLaneCoeffs,
+        rightLaneCoeffs };
+    searchLanes(packedPerspective, nullptr, nullptr, nullptr, trackedFits,
+                LaneTracker::NUM_LANES, lanes);
+    // lost a lane, redo the full search
+    isTracked = leftLanePts.size() >= minTrackPixels
+        && rightLanePts.size() >= minTrackPixels;
   }
-  // declare the images to be used or processed
-  cv::Mat frame, processedFrame, binaryFrame, perspectiveImg, T_perspective_inv,
-      drawWindow, ouputFrame, unWarp_drawWindow;
-  ImageProcessing processImage;
-  // declare the containers to be used
-  std::vector<double> histogram;
-  std::vector<cv::Point> leftLanePts, rightLanePts;
-  while (true) {
-    cap >> frame;  // process video frame by frame
-    // if frame is empty, break
-    if (frame.empty()) {
-      break;
+  if (!isTracked && pyramidLevel > 0) {
+    fullSearchCount++;
+    // max pool down to the coarse level, thin lines survive
+    const PackedBinaryImage* coarseImg = &packedPerspective;
+    for (int level = 1; level <= pyramidLevel; level++) {
+      workspace.getPackedPyramid(level).maxPool(*coarseImg);
+      coarseImg = &workspace.getPackedPyramid(level);
     }
-    // pre process image
-    processImage.preProcessing(frame, processedFrame);
-    // get binary thresholded image
-    processImage.getBinaryImg(processedFrame, binaryFrame);
-    // get perspective image
-    processImage.prespectiveTransform(binaryFrame, perspectiveImg,
-                                      T_perspective_inv);
+    // lane bases from the histogram of the coarse level
+    std::vector<double>& coarseHist = workspace.getPyramidHistogram();
+    int rows = coarseImg->getSize().height;
+    int rowBegin = std::min(rows, std::max(0, cvFloor(histBandBegin * rows)));
+    int rowEnd = std::min(rows, std::max(rowBegin,
+                                         cvFloor(histBandEnd * rows)));
+    coarseImg->columnHistogram(rowBegin, rowEnd, coarseHist);
+    // the starts update the lane tracker, so they are taken in lane order
+    int xStarts[LaneTracker::NUM_LANES];
+    for (int lane = 0; lane < LaneTracker::NUM_LANES; lane++) {
+      xStarts[lane] = laneStart(coarseHist, lane, 1 << pyramidLevel);
+    }
+    searchLanes(packedPerspective, nullptr, coarseImg, xStarts, nullptr,
+                LaneTracker::NUM_LANES, lanes);
+  } else if (!isTracked) {
+    fullSearchCount++;
+    // lane pixel counts of every window and band in one pass
+    occupancy.build(packedPerspective);
     // generate histogram of image pixels
-    generateHist(perspectiveImg, histogram);
-    // extract lanes
-    extractLane(perspectiveImg, histogram, leftLanePts, "Left", drawWindow);
-    cv::Mat outImage, colorOutImage;
-    // undo perspective transformation
-    cv::warpPerspective(drawWindow, outImage, T_perspective_inv,
-                        drawWindow.size());
-
-    outImage.copyTo(colorOutImage);
-    int width = frame.cols;
-    int height = frame.rows;
-    for (int i = 0; i < width; i++) {
-      for (int j = 0; j < height; j++) {
-        if ((colorOutImage.at<cv::Vec3b>(j, i)[0] == 0)
-            && (colorOutImage.at<cv::Vec3b>(j, i)[1] == 0)
-            && (colorOutImage.at<cv::Vec3b>(j, i)[2] == 0)) {
-          colorOutImage.at<cv::Vec3b>(j, i)[0] = frame.at<cv::Vec3b>(j, i)[0];
-          colorOutImage.at<cv::Vec3b>(j, i)[1] = frame.at<cv::Vec3b>(j, i)[1];
-          colorOutImage.at<cv::Vec3b>(j, i)[2] = frame.at<cv::Vec3b>(j, i)[2];
-        }
-      }
+    generateHist(occupancy, histogram);
+    // the starts update the lane tracker, so they are taken in lane order
+    int xStarts[LaneTracker::NUM_LANES];
+    for (int lane = 0; lane < LaneTracker::NUM_LANES; lane++) {
+      xStarts[lane] = laneStart(histogram, lane, 1);
     }
-
-    cv::imshow("Undistorted Frame", colorOutImage);
-//    cv::waitKey(0);
-//    //    press ESC
-//    //    to exit
-//    char c = (char) cv::waitKey(25);
-//    if (c == 27)
-//      break;
-    if (cv::waitKey(30) >= 0)
-      break;
+    searchLanes(packedPerspective, &occupancy, nullptr, xStarts, nullptr,
+                LaneTracker::NUM_LANES, lanes);
   }
-  cap.release();  // release video capture object
-  cv::destroyAllWindows();  // destroy/close all frames
+  // the frame's fits feed the track, the sparse overlay and the output
+  bool isSparseRender = visualizer.isEnabled()
+      && visualizer.getRenderMode() == LaneVisualizer::RENDER_SPARSE;
+  bool isConfident = leftLanePts.size() >= minTrackPixels
+      && rightLanePts.size() >= minTrackPixels;
+  cv::Mat* const laneFits = workspace.getLaneFits();
+  if (fittingEnabled || isSparseRender || (trackingEnabled && isConfident)) {
+    fitLanes(leftLanePts, rightLanePts, laneFits);
+  } else {
+    // no stale fits of an earlier frame in the workspace
+    laneFits[LaneTracker::LEFT_LANE].release();
+    laneFits[LaneTracker::RIGHT_LANE].release();
+  }
+  if (trackingEnabled) {
+    updateTrack(leftLanePts, rightLanePts, laneFits);
+  }
+}
+/**
+ *   @brief Function to run the output stage of the pipeline: draw the
+ *          lanes of the workspace and composite them on the frame into the
+ *          FrameWorkspace::OUTPUT_FRAME buffer, unless visualization is off
+ *
+ *   @param input frame of type cv::Mat
+ *   @param workspace holding the intermediate images of type
+ *          FrameWorkspace
+ *   @return nothing
+ */
+void LaneDetection::renderFrame(const cv::Mat& frame,
+                                FrameWorkspace& workspace) {
+  PackedBinaryImage& packedPerspective = workspace.getPackedPerspective();
+  cv::Mat& drawWindow = workspace.getBuffer(FrameWorkspace::DRAW_WINDOW);
+  cv::Mat& outputFrame = workspace.getBuffer(FrameWorkspace::OUTPUT_FRAME);
+  cv::Mat& overlay = workspace.getBuffer(FrameWorkspace::OVERLAY_FRAME);
+  const cv::Mat& T_perspective_inv = workspace.getPerspectiveInverse();
+  if (visualizer.getRenderMode() == LaneVisualizer::RENDER_SPARSE) {
+    visualizer.renderFits(frame, workspace.getLaneFits(),
+                          packedPerspective.getSize(), T_perspective_inv,
+                          overlay, outputFrame);
+  } else {
+    visualizer.render(frame, packedPerspective,
+                      workspace.getLanePoints(
+                          FrameWorkspace::LEFT_LANE_POINTS),
+                      workspace.getLanePoints(
+                          FrameWorkspace::RIGHT_LANE_POINTS),
+                      T_perspective_inv, drawWindow, outputFrame);
+  }
+}
+/**
+ *   @brief Function to get the image processing stage of the pipeline
+ *
+ *   @param nothing
+ *   @return image processing stage of type ImageProcessing&
+ */
+ImageProcessing& LaneDetection::getImageProcessing(void) {
+  return processImage;
+}
+/**
+ *   @brief Function to get the fitter of the lanes tracked across frames
+ *
+ *   @param nothing
+ *   @return lane fitter of type PolyFitter&
+ */
+PolyFitter& LaneDetection::getLaneFitter(void) {
+  return laneFitter;
+}
+/**
+ *   @brief Function to get the temporal filter of the lanes
+ *
+ *   @param nothing
+ *   @return lane tracker of type LaneTracker&
+ */
+LaneTracker& LaneDetection::getLaneTracker(void) {
+  return laneTracker;
+}
+/**
+ *   @brief Function to get the debug visualization of the pipeline
+ *
+ *   @param nothing
+ *   @return visualization sink of type LaneVisualizer&
+ */
+LaneVisualizer& LaneDetection::getVisualizer(void) {
+  return visualizer;
+}
+/**
+ *   @brief Function to set the band of rows the lane histogram is computed
+ *          over, as fractions of the image height
+ *
+ *   @param top of the band, 0 is the top row, of type double
+ *   @param bottom of the band, 1 is below the bottom row, of type double
+ *   @return nothing
+ */
+void LaneDetection::setHistBand(double histBandBegin_, double histBandEnd_) {
+  CV_Assert(0.0 <= histBandBegin_ && histBandBegin_ <= histBandEnd_
+            && histBandEnd_ <= 1.0);
+  histBandBegin = histBandBegin_;
+  histBandEnd = histBandEnd_;
+}
+/**
+ *   @brief Function to get the band of rows the lane histogram is computed
+ *          over, as fractions of the image height
+ *
+ *   @param nothing
+ *   @return top and bottom of the band of type cv::Vec2d
+ */
+cv::Vec2d LaneDetection::getHistBand(void) {
+  return cv::Vec2d(histBandBegin, histBandEnd);
+}
+/**
+ *   @brief Function to set the number of sliding windows per lane
+ *
+ *   @param number of windows of type int
+ *   @return nothing
+ */
+void LaneDetection::setNumWindows(int numWindows_) {
+  CV_Assert(numWindows_ > 0);
+  numWindows = numWindows_;
+}
+/**
+ *   @brief Function to set the width of the sliding windows
+ *
+ *   @param width in pixels, 0 for twice the window height, of type int
+ *   @return nothing
+ */
+void LaneDetection::setWindowWidth(int windowWidth_) {
+  CV_Assert(windowWidth_ >= 0);
+  windowWidth = windowWidth_;
+}
+/**
+ *   @brief Function to get the number of sliding windows per lane
+ *
+ *   @param nothing
+ *   @return number of windows of type int
+ */
+int LaneDetection::getNumWindows(void) {
+  return numWindows;
+}
+/**
+ *   @brief Function to get the width of the sliding windows
+ *
+ *   @param nothing
+ *   @return width in pixels, 0 for twice the window height, of type int
+ */
+int LaneDetection::getWindowWidth(void) {
+  return windowWidth;
+}
+/**
+ *   @brief Function to enable searching around the previous fits once both
+ *          lanes are fitted with confidence
+ *
+ *   @param true to enable tracking of type bool
+ *   @return nothing
+ */
+void LaneDetection::setTracking(bool trackingEnabled_) {
+  trackingEnabled = trackingEnabled_;
+  resetTrack();
+}
+/**
+ *   @brief Function to check if searching around the previous fits is
+ *          enabled
+ *
+ *   @param nothing
+ *   @return true if tracking is enabled of type bool
+ */
+bool LaneDetection::isTracking(void) {
+  return trackingEnabled;
+}
+/**
+ *   @brief Function to fit both lanes every frame, even when neither the
+ *          tracking nor the visualization needs the fits
+ *
+ *   @param true to fit every frame of type bool
+ *   @return nothing
+ */
+void LaneDetection::setLaneFitting(bool fittingEnabled_) {
+  fittingEnabled = fittingEnabled_;
+}
+/**
+ *   @brief Function to check if both lanes are fitted every frame
+ *
+ *   @param nothing
+ *   @return true if fitting every frame of type bool
+ */
+bool LaneDetection::isLaneFitting(void) {
+  return fittingEnabled;
+}
+/**
+ *   @brief Function to check if the next frame will be searched around the
+ *          previous fits
+ *
+ *   @param nothing
+ *   @return true if both lanes have a confident fit of type bool
+ */
+bool LaneDetection::isTrackValid(void) {
+  return trackingEnabled && trackValid;
+}
+/**
+ *   @brief Function to drop the previous fits, so the next frame is searched
+ *          in full; the coefficients are released rather than cleared, so a
+ *          copy never writes into the buffers of the fits it was copied from
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void LaneDetection::resetTrack(void) {
+  trackValid = false;
+  leftLaneCoeffs.release();
+  rightLaneCoeffs.release();
+  laneTracker.resetFit(LaneTracker::LEFT_LANE);
+  laneTracker.resetFit(LaneTracker::RIGHT_LANE);
+}
+/**
+ *   @brief Function to set the half width of the band searched around the
+ *          previous fits
+ *
+ *   @param margin in pixels of type int
+ *   @return nothing
+ */
+void LaneDetection::setTrackMargin(int trackMargin_) {
+  CV_Assert(trackMargin_ >= 0);
+  trackMargin = trackMargin_;
+}
+/**
+ *   @brief Function to get the half width of the band searched around the
+ *          previous fits
+ *
+ *   @param nothing
+ *   @return margin in pixels of type int
+ */
+int LaneDetection::getTrackMargin(void) {
+  return trackMargin;
+}
+/**
+ *   @brief Function to set the number of pixels each lane needs for its fit
+ *          to be trusted for the next frame
+ *
+ *   @param number of pixels of type std::size_t
+ *   @return nothing
+ */
+void LaneDetection::setMinTrackPixels(std::size_t minTrackPixels_) {
+  CV_Assert(minTrackPixels_ >= 3);
+  minTrackPixels = minTrackPixels_;
+}
+/**
+ *   @brief Function to get the number of pixels each lane needs for its fit
+ *          to be trusted for the next frame
+ *
+ *   @param nothing
+ *   @return number of pixels of type std::size_t
+ */
+std::size_t LaneDetection::getMinTrackPixels(void) {
+  return minTrackPixels;
+}
+/**
+ *   @brief Function to set the fit of a lane, column as a polynomial in the
+ *          row, and search around it from the next frame on
+ *
+ *   @param lane to be set - left or right of type string
+ *   @param coefficients in increasing order of power of type cv::Mat
+ *   @return nothing
+ */
+void LaneDetection::setLaneFit(std::string laneType, const cv::Mat& coeffs) {
+  CV_Assert(coeffs.total() >= 1 && coeffs.channels() == 1);
+  cv::Mat& laneCoeffs = (laneType == "Right") ? rightLaneCoeffs
+      : leftLaneCoeffs;
+  coeffs.reshape(1, static_cast<int>(coeffs.total())).convertTo(laneCoeffs,
+                                                                CV_64F);
+  trackValid = !leftLaneCoeffs.empty() && !rightLaneCoeffs.empty();
+}
+/**
+ *   @brief Function to get the fit of a lane, column as a polynomial in the
+ *          row
+ *
+ *   @param lane to be returned - left or right of type string
+ *   @return coefficients in increasing order of power of type cv::Mat
+ */
+cv::Mat LaneDetection::getLaneFit(std::string laneType) {
+  return (laneType == "Right") ? rightLaneCoeffs : leftLaneCoeffs;
+}
+/**
+ *   @brief Function to get the number of frames processed
+ *
+ *   @param nothing
+ *   @return number of frames of type uint64_t
+ */
+uint64_t LaneDetection::getFrameCount(void) {
+  return frameCount;
+}
+/**
+ *   @brief Function to get the number of frames that needed the full
+ *          histogram and sliding window search
+ *
+ *   @param nothing
+ *   @return number of frames of type uint64_t
+ */
+uint64_t LaneDetection::getFullSearchCount(void) {
+  return fullSearchCount;
+}
+/**
+ *   @brief Function to get the share of processed frames that needed the
+ *          full histogram and sliding window search
+ *
+ *   @param nothing
+ *   @return share of frames in [0, 1], 0 before any frame, of type double
+ */
+double LaneDetection::getFullSearchRatio(void) {
+  if (frameCount == 0) {
+    return 0.0;
+  }
+  return static_cast<double>(fullSearchCount) / frameCount;
+}
+/**
+ *   @brief Function to reset the frame and full search counts
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void LaneDetection::resetSearchStats(void) {
+  frameCount = 0;
+  fullSearchCount = 0;
+}
+/**
+ *   @brief Function to set the level of the max pooled bird's-eye mask the
+ *          sliding windows are centred on
+ *
+ *   @param level, 0 for full resolution, 1 for 1/2 scale up to
+ *          FrameWorkspace::MAX_PYRAMID_LEVEL, of type int
+ *   @return nothing
+ */
+void LaneDetection::setPyramidLevel(int pyramidLevel_) {
+  CV_Assert(pyramidLevel_ >= 0
+            && pyramidLevel_ <= FrameWorkspace::MAX_PYRAMID_LEVEL);
+  pyramidLevel = pyramidLevel_;
+}
+/**
+ *   @brief Function to get the level of the max pooled bird's-eye mask the
+ *          sliding windows are centred on
+ *
+ *   @param nothing
+ *   @return level, 0 for full resolution, of type int
+ */
+int LaneDetection::getPyramidLevel(void) {
+  return pyramidLevel;
 }
@@ -0,0 +1,383 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright [2018] rohithjayarajan, Akash Guha
+ *  @file    LaneDetectionEngine.cpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Lane Detection Engine Class File
+ *
+ *  @section DESCRIPTION
+ *
+ *  Runs independent streams on a fixed pool of workers. A stream is queued
+ *  while it waits for a worker and processed by one worker at a time, so
+ *  its frames stay in order and its tracker is never shared, while the
+ *  streams together keep every worker busy.
+ *
+ */
+
+#include <algorithm>
+#include <thread>
+#include "LaneDetectionEngine.hpp"
+
+/**
+ *   @brief Constructor for Stream
+ *
+ *   @param settings to copy of type LaneDetection
+ *   @return nothing
+ */
+LaneDetectionEngine::Stream::Stream(const LaneDetection& lanes_)
+    : lanes(lanes_),
+      frameIdx(0),
+      framesProcessed(0) {
+  // the copy shares the cv::Mat data of the settings; every stream starts
+  // without the lanes of the settings and fits into buffers of its own
+  lanes.getLaneTracker().reset();
+  lanes.resetTrack();
+  lanes.resetSearchStats();
+}
+/**
+ *   @brief Default constructor for LaneDetectionEngine
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+LaneDetectionEngine::LaneDetectionEngine() {
+  numWorkers = std::max(1, cv::getNumberOfCPUs());
+  activeStreams = 0;
+  stopRequested = false;
+  // streams are headless, the sinks get the fits and the workspace
+  lanes.setLaneFitting(true);
+  lanes.getVisualizer().setMode(LaneVisualizer::VISUALIZE_NONE);
+}
+/**
+ *   @brief Default destructor for LaneDetectionEngine
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+LaneDetectionEngine::~LaneDetectionEngine() {
+}
+/**
+ *   @brief Function to get the settings new streams are copied from
+ *
+ *   @param nothing
+ *   @return lane detection of type LaneDetection&
+ */
+LaneDetection& LaneDetectionEngine::getLaneDetection(void) {
+  return lanes;
+}
+/**
+ *   @brief Function to set the number of worker threads, including the
+ *          thread calling run
+ *
+ *   @param number of threads, at least 1, of type int
+ *   @return nothing
+ */
+void LaneDetectionEngine::setNumWorkers(int numWorkers_) {
+  CV_Assert(numWorkers_ >= 1);
+  numWorkers = numWorkers_;
+}
+/**
+ *   @brief Function to get the number of worker threads
+ *
+ *   @param nothing
+ *   @return number of threads of type int
+ */
+int LaneDetectionEngine::getNumWorkers(void) {
+  return numWorkers;
+}
+/**
+ *   @brief Function to prepare settings for copying into streams: the
+ *          colour tables are built once so every copy shares them
+ *
+ *   @param settings of type LaneDetection
+ *   @return nothing
+ */
+void LaneDetectionEngine::prepareSettings(LaneDetection& settings) {
+  settings.getImageProcessing().getColorThreshold().build();
+}
+/**
+ *   @brief Function to add a stream with the engine's settings
+ *
+ *   @param source of the frames of type FramePipeline::FrameSource
+ *   @param consumer of the processed frames, called on a worker thread,
+ *          or empty, of type FramePipeline::FrameSink
+ *   @return index of the stream of type int
+ */
+int LaneDetectionEngine::addStream(const FramePipeline::FrameSource& readFrame,
+                                   const FramePipeline::FrameSink& frameSink) {
+  return addStream(lanes, readFrame, frameSink);
+}
+/**
+ *   @brief Function to add a stream with its own settings, e.g. the
+ *          calibration of its camera
+ *
+ *   @param settings to copy of type LaneDetection
+ *   @param source of the frames of type FramePipeline::FrameSource
+ *   @param consumer of the processed frames, called on a worker thread,
+ *          or empty, of type FramePipeline::FrameSink
+ *   @return index of the stream of type int
+ */
+int LaneDetectionEngine::addStream(LaneDetection& settings,
+                                   const FramePipeline::FrameSource& readFrame,
+                                   const FramePipeline::FrameSink& frameSink) {
+  CV_Assert(readFrame);
+  prepareSettings(settings);
+  std::unique_ptr<Stream> stream(new Stream(settings));
+  stream->readFrame = readFrame;
+  stream->frameSink = frameSink;
+  LaneVisualizer& visualizer = stream->lanes.getVisualizer();
+  if (visualizer.getMode() == LaneVisualizer::VISUALIZE_WINDOW) {
+    // windows can not be shown from the workers, the sink gets the overlay
+    visualizer.setMode(LaneVisualizer::VISUALIZE_OVERLAY);
+  }
+  streams.push_back(std::move(stream));
+  return static_cast<int>(streams.size()) - 1;
+}
+/**
+ *   @brief Function to remove all streams; the shared calibrations are
+ *          kept for later streams
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void LaneDetectionEngine::clearStreams(void) {
+  streams.clear();
+}
+/**
+ *   @brief Function to get the number of streams
+ *
+ *   @param nothing
+ *   @return number of streams of type int
+ */
+int LaneDetectionEngine::getNumStreams(void) {
+  return static_cast<int>(streams.size());
+}
+/**
+ *   @brief Function to get the lane detection of a stream
+ *
+ *   @param index of the stream of type int
+ *   @return lane detection of type LaneDetection&
+ */
+LaneDetection& LaneDetectionEngine::getStreamLanes(int streamIdx) {
+  CV_Assert(streamIdx >= 0 && streamIdx < getNumStreams());
+  return streams[streamIdx]->lanes;
+}
+/**
+ *   @brief Function to get the number of frames of a stream the last run
+ *          handed on
+ *
+ *   @param index of the stream of type int
+ *   @return number of frames of type uint64_t
+ */
+uint64_t LaneDetectionEngine::getFramesProcessed(int streamIdx) {
+  CV_Assert(streamIdx >= 0 && streamIdx < getNumStreams());
+  return streams[streamIdx]->framesProcessed;
+}
+/**
+ *   @brief Function to get the number of frames of all streams the last
+ *          run handed on
+ *
+ *   @param nothing
+ *   @return number of frames of type uint64_t
+ */
+uint64_t LaneDetectionEngine::getFramesProcessed(void) {
+  uint64_t framesProcessed = 0;
+  for (auto& stream : streams) {
+    framesProcessed += stream->framesProcessed;
+  }
+  return framesProcessed;
+}
+/**
+ *   @brief Function to get the number of distinct shared calibrations
+ *          built
+ *
+ *   @param nothing
+ *   @return number of calibrations of type int
+ */
+int LaneDetectionEngine::getNumCalibrations(void) {
+  std::lock_guard<std::mutex> lock(calibrationMutex);
+  return static_cast<int>(calibrations.size());
+}
+/**
+ *   @brief Function to point a stream at the shared artefacts of its
+ *          calibration, building them if no stream did yet
+ *
+ *   @param stream of type Stream
+ *   @param frame size of type cv::Size
+ *   @return nothing
+ */
+void LaneDetectionEngine::attachCalibration(Stream& stream,
+                                            const cv::Size& imgSize) {
+  ImageProcessing& processImage = stream.lanes.getImageProcessing();
+  // held while building, so streams starting together with the same
+  // calibration wait for one build instead of each building their own
+  std::lock_guard<std::mutex> lock(calibrationMutex);
+  std::shared_ptr<const SharedCalibration> sharedCalibration;
+  for (auto& calibration : calibrations) {
+    if (calibration->getImageSize() == imgSize
+        && processImage.canShareCalibration(*calibration)) {
+      sharedCalibration = calibration;
+      break;
+    }
+  }
+  if (!sharedCalibration) {
+    sharedCalibration = processImage.buildSharedCalibration(imgSize);
+    calibrations.push_back(sharedCalibration);
+  }
+  processImage.setSharedCalibration(sharedCalibration);
+  stream.calibratedSize = imgSize;
+}
+/**
+ *   @brief Function to read, process and hand on the next frame of a
+ *          stream
+ *
+ *   @param stream of type Stream
+ *   @return false at the end of the stream or if the sink stopped it,
+ *          type bool
+ */
+bool LaneDetectionEngine::processFrame(Stream& stream) {
+  int64 stageTicks[FramePipeline::NUM_STAGES + 1];
+  stageTicks[FramePipeline::DECODE_STAGE] = cv::getTickCount();
+  if (!stream.readFrame(stream.frame) || stream.frame.empty()) {
+    return false;
+  }
+  if (stream.frame.size() != stream.calibratedSize) {
+    attachCalibration(stream, stream.frame.size());
+  }
+  if (!stream.workspace.isAllocatedFor(stream.frame.size())) {
+    stream.workspace.allocate(stream.frame.size());
+  }
+  stageTicks[FramePipeline::TRANSFORM_STAGE] = cv::getTickCount();
+  stream.lanes.transformFrame(stream.frame, stream.workspace);
+  stageTicks[FramePipeline::SEARCH_STAGE] = cv::getTickCount();
+  stream.lanes.searchFrame(stream.workspace);
+  stageTicks[FramePipeline::OUTPUT_STAGE] = cv::getTickCount();
+  stream.lanes.renderFrame(stream.frame, stream.workspace);
+  stageTicks[FramePipeline::NUM_STAGES] = cv::getTickCount();
+  uint64_t frameIdx = stream.frameIdx++;
+  stream.framesProcessed++;
+  if (!stream.frameSink) {
+    return true;
+  }
+  // stages run back to back, so each ends where the next begins
+  FramePipeline::FrameResult result;
+  result.frameIdx = frameIdx;
+  result.workspace = &stream.workspace;
+  double msPerTick = 1000.0 / cv::getTickFrequency();
+  for (int stage = 0; stage < FramePipeline::NUM_STAGES; stage++) {
+    result.stageMs[stage] = msPerTick
+        * (stageTicks[stage + 1] - stageTicks[stage]);
+  }
+  result.latencyMs = msPerTick * (stageTicks[FramePipeline::NUM_STAGES]
+      - stageTicks[FramePipeline::DECODE_STAGE]);
+  return stream.frameSink(result);
+}
+/**
+ *   @brief Function to process frames of ready streams until every
+ *          stream ended
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void LaneDetectionEngine::workerLoop(void) {
+  std::unique_lock<std::mutex> lock(scheduleMutex);
+  while (true) {
+    // a stream being processed by another worker may still come back
+    streamReady.wait(lock, [this] {
+      return !readyStreams.empty() || activeStreams == 0;
+    });
+    if (readyStreams.empty()) {
+      return;
+    }
+    int streamIdx = readyStreams.front();
+    readyStreams.pop_front();
+    lock.unlock();
+    bool isRunning = false;
+    try {
+      isRunning = processFrame(*streams[streamIdx]);
+    } catch (...) {
+      lock.lock();
+      if (!error) {
+        error = std::current_exception();
+      }
+      stopRequested = true;
+      lock.unlock();
+    }
+    lock.lock();
+    if (isRunning && !stopRequested) {
+      // back of the queue, the other ready streams go first
+      readyStreams.push_back(streamIdx);
+      streamReady.notify_one();
+      continue;
+    }
+    activeStreams--;
+    if (stopRequested) {
+      // queued streams are not processed any further
+      activeStreams -= static_cast<int>(readyStreams.size());
+      readyStreams.clear();
+    }
+    if (activeStreams == 0) {
+      streamReady.notify_all();
+    }
+  }
+}
+/**
+ *   @brief Function to process every stream until it ends or its sink
+ *          stops it. The calling thread is one of the workers; the first
+ *          failure of a stream stops all and is rethrown here
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void LaneDetectionEngine::run(void) {
+  readyStreams.clear();
+  for (int i = 0; i < getNumStreams(); i++) {
+    Stream& stream = *streams[i];
+    stream.framesProcessed = 0;
+    // the calibration may have changed since the last run
+    stream.calibratedSize = cv::Size();
+    readyStreams.push_back(i);
+  }
+  activeStreams = getNumStreams();
+  stopRequested = false;
+  error = nullptr;
+  // more workers than streams would only wait
+  int numThreads = std::min(numWorkers, std::max(1, getNumStreams()));
+  std::vector<std::thread> workers;
+  for (int i = 1; i < numThreads; i++) {
+    workers.emplace_back(&LaneDetectionEngine::workerLoop, this);
+  }
+  workerLoop();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
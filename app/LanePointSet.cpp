@@ -0,0 +1,226 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    LanePointSet.cpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Lane Point Set Class File
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class file for the pixels of one lane, stored as separate contiguous
+ *  arrays of columns and rows with the number of hits of every sliding
+ *  window.
+ *
+ */
+
+#include "LanePointSet.hpp"
+
+/**
+ *   @brief Default constructor for LanePointSet
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+LanePointSet::LanePointSet() {
+}
+/**
+ *   @brief Default destructor for LanePointSet
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+LanePointSet::~LanePointSet() {
+}
+/**
+ *   @brief Function to reserve room, so filling the set does not
+ *          allocate
+ *
+ *   @param number of pixels of type std::size_t
+ *   @param number of windows of type int
+ *   @return nothing
+ */
+void LanePointSet::reserve(std::size_t capacity, int numWindows) {
+  xs.reserve(capacity);
+  ys.reserve(capacity);
+  windowEnds.reserve(numWindows);
+}
+/**
+ *   @brief Function to reserve room for every pixel of a lane's sliding
+ *          windows
+ *
+ *   @param size of the bird's-eye image of type cv::Size
+ *   @param number of windows of type int
+ *   @param width of the windows, 0 for twice their height, of type int
+ *   @return nothing
+ */
+void LanePointSet::reserveForWindows(const cv::Size& imgSize, int numWindows,
+                                     int windowWidth) {
+  int heightWindow = imgSize.height / numWindows;
+  int widthWindow = (windowWidth > 0) ? windowWidth : 2 * heightWindow;
+  // windows are heightWindow + 1 rows by widthWindow + 1 columns
+  reserve(static_cast<std::size_t>(numWindows) * (heightWindow + 1)
+          * (widthWindow + 1), numWindows);
+}
+/**
+ *   @brief Function to drop all pixels and windows, keeping the capacity
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void LanePointSet::clear(void) {
+  xs.clear();
+  ys.clear();
+  windowEnds.clear();
+}
+/**
+ *   @brief Function to close the current window; the pixels added since
+ *          the last window belong to it
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void LanePointSet::endWindow(void) {
+  windowEnds.push_back(xs.size());
+}
+/**
+ *   @brief Function to get the number of pixels
+ *
+ *   @param nothing
+ *   @return number of pixels of type std::size_t
+ */
+std::size_t LanePointSet::size(void) const {
+  return xs.size();
+}
+/**
+ *   @brief Function to check if the set holds no pixel
+ *
+ *   @param nothing
+ *   @return true if empty, type bool
+ */
+bool LanePointSet::empty(void) const {
+  return xs.empty();
+}
+/**
+ *   @brief Function to get the number of pixels the set can hold without
+ *          allocating
+ *
+ *   @param nothing
+ *   @return number of pixels of type std::size_t
+ */
+std::size_t LanePointSet::capacity(void) const {
+  return std::min(xs.capacity(), ys.capacity());
+}
+/**
+ *   @brief Function to get the columns of the pixels
+ *
+ *   @param nothing
+ *   @return contiguous columns of type const int*
+ */
+const int* LanePointSet::getX(void) const {
+  return xs.data();
+}
+/**
+ *   @brief Function to get the rows of the pixels
+ *
+ *   @param nothing
+ *   @return contiguous rows of type const int*
+ */
+const int* LanePointSet::getY(void) const {
+  return ys.data();
+}
+/**
+ *   @brief Function to get the number of closed windows
+ *
+ *   @param nothing
+ *   @return number of windows of type int
+ */
+int LanePointSet::getNumWindows(void) const {
+  return static_cast<int>(windowEnds.size());
+}
+/**
+ *   @brief Function to get the number of hits of a window
+ *
+ *   @param window, 0 for the bottom one, of type int
+ *   @return number of pixels of type std::size_t
+ */
+std::size_t LanePointSet::getWindowCount(int window) const {
+  std::size_t begin = getWindowBegin(window);
+  return windowEnds[window] - begin;
+}
+/**
+ *   @brief Function to get the first pixel of a window
+ *
+ *   @param window, 0 for the bottom one, of type int
+ *   @return index of the pixel of type std::size_t
+ */
+std::size_t LanePointSet::getWindowBegin(int window) const {
+  CV_Assert(window >= 0 && window < getNumWindows());
+  return (window == 0) ? 0 : windowEnds[window - 1];
+}
+/**
+ *   @brief Function to get the mean column of the hits of a window
+ *
+ *   @param window, 0 for the bottom one, of type int
+ *   @return column of type double, 0 for an empty window
+ */
+double LanePointSet::getWindowMeanX(int window) const {
+  std::size_t begin = getWindowBegin(window);
+  std::size_t end = windowEnds[window];
+  if (begin == end) {
+    return 0.0;
+  }
+  long sumX = 0;
+  for (std::size_t i = begin; i < end; i++) {
+    sumX += xs[i];
+  }
+  return static_cast<double>(sumX) / (end - begin);
+}
+/**
+ *   @brief Function to append the pixels as points of (row, column), the
+ *          order of the std::vector<cv::Point> lane interface
+ *
+ *   @param points of type std::vector<cv::Point>
+ *   @return nothing
+ */
+void LanePointSet::appendTo(std::vector<cv::Point>& dstLane) const {
+  dstLane.reserve(dstLane.size() + xs.size());
+  for (std::size_t i = 0; i < xs.size(); i++) {
+    dstLane.push_back(cv::Point(ys[i], xs[i]));
+  }
+}
+/**
+ *   @brief Function to check if two sets hold the same pixels in the same
+ *          windows
+ *
+ *   @param set to compare with of type LanePointSet
+ *   @return true if equal, type bool
+ */
+bool LanePointSet::operator==(const LanePointSet& other) const {
+  return xs == other.xs && ys == other.ys && windowEnds == other.windowEnds;
+}
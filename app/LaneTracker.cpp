@@ -0,0 +1,393 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    LaneTracker.cpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Lane Tracker Class File
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class file for the temporal filter of the lanes. Every value is
+ *  filtered on its own. The moving average keeps a running sum of the
+ *  ring, so dropping the oldest value is a subtraction, and the Kalman
+ *  filter keeps a 2x2 covariance per value.
+ *
+ */
+
+#include "LaneTracker.hpp"
+
+/**
+ *   @brief Default constructor for LaneTracker
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+LaneTracker::LaneTracker() {
+  mode = TRACK_MOVING_AVERAGE;
+  historyLength = 15;  // frames
+  order = 2;
+  gain = 0.2;
+  processNoise = 0.01;
+  for (int lane = 0; lane < NUM_LANES; lane++) {
+    allocateChannel(channels[lane][BASE_CHANNEL], 1);
+    allocateChannel(channels[lane][FIT_CHANNEL], order + 1);
+  }
+}
+/**
+ *   @brief Default destructor for LaneTracker
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+LaneTracker::~LaneTracker() {
+}
+/**
+ *   @brief Function to size a channel and clear its history
+ *
+ *   @param channel of type Channel
+ *   @param number of values of type int
+ *   @return nothing
+ */
+void LaneTracker::allocateChannel(Channel& channel, int size) {
+  channel.size = size;
+  channel.history.assign(historyLength * size, 0.0);
+  channel.sum.assign(size, 0.0);
+  channel.state.assign(size, 0.0);
+  channel.velocity.assign(size, 0.0);
+  channel.covariance.assign(3 * size, 0.0);
+  resetChannel(channel);
+}
+/**
+ *   @brief Function to clear the history and the filter state of a channel
+ *
+ *   @param channel of type Channel
+ *   @return nothing
+ */
+void LaneTracker::resetChannel(Channel& channel) {
+  channel.count = 0;
+  channel.head = 0;
+  std::fill(channel.sum.begin(), channel.sum.end(), 0.0);
+  std::fill(channel.velocity.begin(), channel.velocity.end(), 0.0);
+}
+/**
+ *   @brief Function to filter a new group of values into a channel
+ *
+ *   @param channel of type Channel
+ *   @param values of type double*
+ *   @return nothing
+ */
+void LaneTracker::updateChannel(Channel& channel, const double* values) {
+  double* slot = &channel.history[channel.head * channel.size];
+  bool isFull = channel.count >= historyLength;
+  int numValues = std::min(channel.count + 1, historyLength);
+  for (int i = 0; i < channel.size; i++) {
+    double value = values[i];
+    // running sum of the ring; the oldest value leaves once it is full
+    if (isFull) {
+      channel.sum[i] -= slot[i];
+    }
+    slot[i] = value;
+    channel.sum[i] += value;
+    double& state = channel.state[i];
+    double& velocity = channel.velocity[i];
+    double* P = &channel.covariance[3 * i];
+    if (channel.count == 0) {
+      // the first value starts every filter, at rest
+      state = value;
+      velocity = 0.0;
+      P[0] = 1.0;
+      P[1] = 0.0;
+      P[2] = 1.0;
+      continue;
+    }
+    if (mode == TRACK_MOVING_AVERAGE) {
+      state = channel.sum[i] / numValues;
+    } else if (mode == TRACK_EXPONENTIAL) {
+      state += gain * (value - state);
+    } else {
+      // predict one frame of constant velocity, with white acceleration
+      // noise, in units of the measurement noise
+      double P00 = P[0] + 2 * P[1] + P[2] + 0.25 * processNoise;
+      double P01 = P[1] + P[2] + 0.5 * processNoise;
+      double P11 = P[2] + processNoise;
+      double innovation = value - (state + velocity);
+      double K0 = P00 / (P00 + 1.0);
+      double K1 = P01 / (P00 + 1.0);
+      state += velocity + K0 * innovation;
+      velocity += K1 * innovation;
+      P[0] = (1.0 - K0) * P00;
+      P[1] = (1.0 - K0) * P01;
+      P[2] = P11 - K1 * P01;
+    }
+  }
+  channel.head = (channel.head + 1) % historyLength;
+  channel.count++;
+}
+/**
+ *   @brief Function to get a lane's channel
+ *
+ *   @param lane of type LaneTracker::Lane
+ *   @param channel of type ChannelType
+ *   @return channel of type Channel&
+ */
+LaneTracker::Channel& LaneTracker::getChannel(int lane, int channelType) {
+  CV_Assert(lane >= LEFT_LANE && lane < NUM_LANES);
+  return channels[lane][channelType];
+}
+/**
+ *   @brief Function to select the temporal filter; clears the tracks
+ *
+ *   @param filter of type LaneTracker::TrackMode
+ *   @return nothing
+ */
+void LaneTracker::setMode(int mode_) {
+  CV_Assert(mode_ >= TRACK_MOVING_AVERAGE && mode_ <= TRACK_KALMAN);
+  mode = mode_;
+  reset();
+}
+/**
+ *   @brief Function to get the temporal filter
+ *
+ *   @param nothing
+ *   @return filter of type LaneTracker::TrackMode
+ */
+int LaneTracker::getMode(void) {
+  return mode;
+}
+/**
+ *   @brief Function to set the capacity of the history; reallocates the
+ *          ring buffers and clears the tracks
+ *
+ *   @param number of frames of type int
+ *   @return nothing
+ */
+void LaneTracker::setHistoryLength(int historyLength_) {
+  CV_Assert(historyLength_ >= 1);
+  historyLength = historyLength_;
+  for (int lane = 0; lane < NUM_LANES; lane++) {
+    for (int c = 0; c < NUM_CHANNELS; c++) {
+      allocateChannel(channels[lane][c], channels[lane][c].size);
+    }
+  }
+}
+/**
+ *   @brief Function to get the capacity of the history
+ *
+ *   @param nothing
+ *   @return number of frames of type int
+ */
+int LaneTracker::getHistoryLength(void) {
+  return historyLength;
+}
+/**
+ *   @brief Function to set the degree of the tracked polynomials;
+ *          reallocates the ring buffers and clears the tracks
+ *
+ *   @param degree of type int
+ *   @return nothing
+ */
+void LaneTracker::setOrder(int order_) {
+  CV_Assert(order_ >= 0);
+  order = order_;
+  for (int lane = 0; lane < NUM_LANES; lane++) {
+    allocateChannel(channels[lane][FIT_CHANNEL], order + 1);
+  }
+}
+/**
+ *   @brief Function to get the degree of the tracked polynomials
+ *
+ *   @param nothing
+ *   @return degree of type int
+ */
+int LaneTracker::getOrder(void) {
+  return order;
+}
+/**
+ *   @brief Function to set the weight of a new value in the exponential
+ *          filter
+ *
+ *   @param gain in (0, 1] of type double
+ *   @return nothing
+ */
+void LaneTracker::setGain(double gain_) {
+  CV_Assert(gain_ > 0.0 && gain_ <= 1.0);
+  gain = gain_;
+}
+/**
+ *   @brief Function to get the weight of a new value in the exponential
+ *          filter
+ *
+ *   @param nothing
+ *   @return gain of type double
+ */
+double LaneTracker::getGain(void) {
+  return gain;
+}
+/**
+ *   @brief Function to set the Kalman process noise relative to the
+ *          measurement noise; larger values follow changes faster
+ *
+ *   @param ratio of the noise variances of type double
+ *   @return nothing
+ */
+void LaneTracker::setProcessNoise(double processNoise_) {
+  CV_Assert(processNoise_ > 0.0);
+  processNoise = processNoise_;
+}
+/**
+ *   @brief Function to get the Kalman process noise relative to the
+ *          measurement noise
+ *
+ *   @param nothing
+ *   @return ratio of the noise variances of type double
+ */
+double LaneTracker::getProcessNoise(void) {
+  return processNoise;
+}
+/**
+ *   @brief Function to clear the tracks of both lanes
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void LaneTracker::reset(void) {
+  for (int lane = 0; lane < NUM_LANES; lane++) {
+    for (int c = 0; c < NUM_CHANNELS; c++) {
+      resetChannel(channels[lane][c]);
+    }
+  }
+}
+/**
+ *   @brief Function to clear the polynomial track of a lane, keeping its
+ *          base position
+ *
+ *   @param lane of type LaneTracker::Lane
+ *   @return nothing
+ */
+void LaneTracker::resetFit(int lane) {
+  resetChannel(getChannel(lane, FIT_CHANNEL));
+}
+/**
+ *   @brief Function to filter a new base position of a lane
+ *
+ *   @param lane of type LaneTracker::Lane
+ *   @param x of the lane at the bottom of the image of type double
+ *   @return nothing
+ */
+void LaneTracker::updateBase(int lane, double base) {
+  updateChannel(getChannel(lane, BASE_CHANNEL), &base);
+}
+/**
+ *   @brief Function to filter new polynomial coefficients of a lane
+ *
+ *   @param lane of type LaneTracker::Lane
+ *   @param order + 1 coefficients in increasing order of power of type
+ *          cv::Mat
+ *   @return nothing
+ */
+void LaneTracker::updateFit(int lane, const cv::Mat& coeffs) {
+  CV_Assert(coeffs.type() == CV_64F && coeffs.isContinuous()
+            && coeffs.total() == static_cast<std::size_t>(order + 1));
+  updateChannel(getChannel(lane, FIT_CHANNEL), coeffs.ptr<double>());
+}
+/**
+ *   @brief Function to check if a lane's base position is tracked
+ *
+ *   @param lane of type LaneTracker::Lane
+ *   @return true after an update of the base, type bool
+ */
+bool LaneTracker::hasBase(int lane) {
+  return getChannel(lane, BASE_CHANNEL).count > 0;
+}
+/**
+ *   @brief Function to check if a lane's polynomial is tracked
+ *
+ *   @param lane of type LaneTracker::Lane
+ *   @return true after an update of the fit, type bool
+ */
+bool LaneTracker::hasFit(int lane) {
+  return getChannel(lane, FIT_CHANNEL).count > 0;
+}
+/**
+ *   @brief Function to get the filtered base position of a lane
+ *
+ *   @param lane of type LaneTracker::Lane
+ *   @return x of the lane at the bottom of the image of type double
+ */
+double LaneTracker::getBase(int lane) {
+  CV_Assert(hasBase(lane));
+  return getChannel(lane, BASE_CHANNEL).state[0];
+}
+/**
+ *   @brief Function to predict the base position of a lane in the next
+ *          frame
+ *
+ *   @param lane of type LaneTracker::Lane
+ *   @return x of the lane at the bottom of the image of type double
+ */
+double LaneTracker::predictBase(int lane) {
+  CV_Assert(hasBase(lane));
+  Channel& channel = getChannel(lane, BASE_CHANNEL);
+  return channel.state[0]
+      + ((mode == TRACK_KALMAN) ? channel.velocity[0] : 0.0);
+}
+/**
+ *   @brief Function to get the filtered polynomial coefficients of a lane
+ *
+ *   @param lane of type LaneTracker::Lane
+ *   @param coefficients in increasing order of power, as a column of
+ *          CV_64F, of type cv::Mat
+ *   @return nothing
+ */
+void LaneTracker::getFit(int lane, cv::Mat& coeffs) {
+  CV_Assert(hasFit(lane));
+  Channel& channel = getChannel(lane, FIT_CHANNEL);
+  coeffs.create(channel.size, 1, CV_64F);
+  std::copy(channel.state.begin(), channel.state.end(),
+            coeffs.ptr<double>());
+}
+/**
+ *   @brief Function to predict the polynomial coefficients of a lane in
+ *          the next frame
+ *
+ *   @param lane of type LaneTracker::Lane
+ *   @param coefficients in increasing order of power, as a column of
+ *          CV_64F, of type cv::Mat
+ *   @return nothing
+ */
+void LaneTracker::predictFit(int lane, cv::Mat& coeffs) {
+  getFit(lane, coeffs);
+  if (mode == TRACK_KALMAN) {
+    Channel& channel = getChannel(lane, FIT_CHANNEL);
+    double* dst = coeffs.ptr<double>();
+    for (int i = 0; i < channel.size; i++) {
+      dst[i] += channel.velocity[i];
+    }
+  }
+}
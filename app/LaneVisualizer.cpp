@@ -0,0 +1,487 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    LaneVisualizer.cpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Lane Visualizer Class File
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class file for the debug visualization of the lane detection
+ *  pipeline. The left lane is drawn green and the right lane red over the
+ *  white bird's-eye mask, which is then unwarped onto the frame.
+ *
+ */
+
+#include "LaneVisualizer.hpp"
+
+/**
+ *   @brief Default constructor for LaneVisualizer
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+LaneVisualizer::LaneVisualizer() {
+  mode = VISUALIZE_WINDOW;
+  renderMode = RENDER_SPARSE;
+  waitTime = 30;  // ms
+  windowName = "Undistorted Frame";
+  isWindowOpen = false;
+  alpha = 0.4;
+  numSamples = 100;
+  lineWidth = 8;  // px
+  reserveSamples();
+}
+/**
+ *   @brief Function to reserve the sample and polygon vectors for the
+ *          number of samples, so drawing the overlay does not allocate
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void LaneVisualizer::reserveSamples(void) {
+  birdsEyePts.reserve(LaneTracker::NUM_LANES * numSamples);
+  cameraPts.reserve(LaneTracker::NUM_LANES * numSamples);
+  for (int lane = 0; lane < LaneTracker::NUM_LANES; lane++) {
+    laneCurves[lane].reserve(numSamples);
+  }
+  lanePolygon.reserve(LaneTracker::NUM_LANES * numSamples);
+  // a row crosses at most every edge of the lane polygon
+  crossings.reserve(LaneTracker::NUM_LANES * numSamples);
+}
+/**
+ *   @brief Function to fill a polygon, even-odd, with pixel centres on
+ *          integer coordinates and each edge covering the rows from its
+ *          upper end up to but not including its lower end
+ *
+ *   @param colour image to draw in of type cv::Mat
+ *   @param vertices of the polygon of type cv::Point2d*
+ *   @param number of vertices of type int
+ *   @param colour of type cv::Vec3b
+ *   @return nothing
+ */
+void LaneVisualizer::fillPolygon(cv::Mat& img, const cv::Point2d* pts,
+                                 int numPts, const cv::Vec3b& color) {
+  CV_Assert(img.type() == CV_8UC3);
+  if (numPts < 3) {
+    return;
+  }
+  double yMin = pts[0].y, yMax = pts[0].y;
+  for (int i = 1; i < numPts; i++) {
+    yMin = std::min(yMin, pts[i].y);
+    yMax = std::max(yMax, pts[i].y);
+  }
+  int rowBegin = std::max(0, static_cast<int>(std::ceil(yMin)));
+  int rowEnd = std::min(img.rows, static_cast<int>(std::ceil(yMax)));
+  for (int y = rowBegin; y < rowEnd; y++) {
+    // columns where the edges cross the row, half-open in y so a vertex
+    // on the row is counted once
+    crossings.clear();
+    for (int i = 0, j = numPts - 1; i < numPts; j = i++) {
+      const cv::Point2d& p = pts[i];
+      const cv::Point2d& q = pts[j];
+      if ((p.y <= y && y < q.y) || (q.y <= y && y < p.y)) {
+        crossings.push_back(p.x + (y - p.y) * (q.x - p.x) / (q.y - p.y));
+      }
+    }
+    std::sort(crossings.begin(), crossings.end());
+    cv::Vec3b* row = img.ptr<cv::Vec3b>(y);
+    for (std::size_t k = 0; k + 1 < crossings.size(); k += 2) {
+      // pixel centres from the entering crossing up to the leaving one
+      int colBegin = std::max(0, static_cast<int>(std::ceil(crossings[k])));
+      int colEnd = std::min(img.cols,
+                            static_cast<int>(std::ceil(crossings[k + 1])));
+      for (int x = colBegin; x < colEnd; x++) {
+        row[x] = color;
+      }
+    }
+  }
+}
+/**
+ *   @brief Function to draw an open curve lineWidth wide, each segment
+ *          as a rectangle extended by half the width at both ends, so the
+ *          segments overlap at the joints
+ *
+ *   @param colour image to draw in of type cv::Mat
+ *   @param points of the curve of type std::vector<cv::Point2d>
+ *   @param colour of type cv::Vec3b
+ *   @return nothing
+ */
+void LaneVisualizer::drawCurve(cv::Mat& img,
+                               const std::vector<cv::Point2d>& curve,
+                               const cv::Vec3b& color) {
+  double halfWidth = 0.5 * lineWidth;
+  for (std::size_t i = 0; i + 1 < curve.size(); i++) {
+    cv::Point2d direction = curve[i + 1] - curve[i];
+    double length = std::sqrt(direction.dot(direction));
+    if (length <= 0.0) {
+      continue;
+    }
+    // half the width along and across the segment
+    cv::Point2d along = direction * (halfWidth / length);
+    cv::Point2d across(-along.y, along.x);
+    cv::Point2d segment[4] = { curve[i] - along - across,
+        curve[i + 1] + along - across, curve[i + 1] + along + across,
+        curve[i] - along + across };
+    fillPolygon(img, segment, 4, color);
+  }
+}
+/**
+ *   @brief Default destructor for LaneVisualizer
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+LaneVisualizer::~LaneVisualizer() {
+}
+/**
+ *   @brief Function to select the visualization sink
+ *
+ *   @param sink of type LaneVisualizer::VisualizationMode
+ *   @return nothing
+ */
+void LaneVisualizer::setMode(int mode_) {
+  CV_Assert(mode_ >= VISUALIZE_NONE && mode_ <= VISUALIZE_WINDOW);
+  mode = mode_;
+}
+/**
+ *   @brief Function to get the visualization sink
+ *
+ *   @param nothing
+ *   @return sink of type LaneVisualizer::VisualizationMode
+ */
+int LaneVisualizer::getMode(void) {
+  return mode;
+}
+/**
+ *   @brief Function to check if the pipeline should render its results
+ *
+ *   @param nothing
+ *   @return false for the null sink, type bool
+ */
+bool LaneVisualizer::isEnabled(void) {
+  return mode != VISUALIZE_NONE;
+}
+/**
+ *   @brief Function to set the time to wait for a key after showing a
+ *          frame in a window
+ *
+ *   @param time in ms, at least 1, of type int
+ *   @return nothing
+ */
+void LaneVisualizer::setWaitTime(int waitTime_) {
+  // 0 would wait for a key forever
+  CV_Assert(waitTime_ >= 1);
+  waitTime = waitTime_;
+}
+/**
+ *   @brief Function to get the time to wait for a key after showing a
+ *          frame in a window
+ *
+ *   @param nothing
+ *   @return time in ms of type int
+ */
+int LaneVisualizer::getWaitTime(void) {
+  return waitTime;
+}
+/**
+ *   @brief Function to select how the lanes are composited on the frame
+ *
+ *   @param mode of type LaneVisualizer::RenderMode
+ *   @return nothing
+ */
+void LaneVisualizer::setRenderMode(int renderMode_) {
+  CV_Assert(renderMode_ == RENDER_WARP || renderMode_ == RENDER_SPARSE);
+  renderMode = renderMode_;
+}
+/**
+ *   @brief Function to get how the lanes are composited on the frame
+ *
+ *   @param nothing
+ *   @return mode of type LaneVisualizer::RenderMode
+ */
+int LaneVisualizer::getRenderMode(void) {
+  return renderMode;
+}
+/**
+ *   @brief Function to set the opacity of the sparse lane overlay
+ *
+ *   @param opacity in [0, 1] of type double
+ *   @return nothing
+ */
+void LaneVisualizer::setAlpha(double alpha_) {
+  CV_Assert(alpha_ >= 0 && alpha_ <= 1);
+  alpha = alpha_;
+}
+/**
+ *   @brief Function to get the opacity of the sparse lane overlay
+ *
+ *   @param nothing
+ *   @return opacity of type double
+ */
+double LaneVisualizer::getAlpha(void) {
+  return alpha;
+}
+/**
+ *   @brief Function to set the number of rows each lane fit is sampled
+ *          at for the sparse overlay
+ *
+ *   @param number of samples, at least 2, of type int
+ *   @return nothing
+ */
+void LaneVisualizer::setNumSamples(int numSamples_) {
+  CV_Assert(numSamples_ >= 2);
+  numSamples = numSamples_;
+  reserveSamples();
+}
+/**
+ *   @brief Function to get the number of rows each lane fit is sampled
+ *          at for the sparse overlay
+ *
+ *   @param nothing
+ *   @return number of samples of type int
+ */
+int LaneVisualizer::getNumSamples(void) {
+  return numSamples;
+}
+/**
+ *   @brief Function to draw a packed bird's-eye mask in BGR as the
+ *          background of the debug image
+ *
+ *   @param packed projective transform of binary image of type
+ *          PackedBinaryImage
+ *   @param debug image of type cv::Mat
+ *   @return nothing
+ */
+void LaneVisualizer::drawLaneMask(const PackedBinaryImage& perspectiveImg,
+                                  cv::Mat& drawWindow) {
+  cv::Size imgSize = perspectiveImg.getSize();
+  drawWindow.create(imgSize, CV_8UC3);
+  for (int y = 0; y < imgSize.height; y++) {
+    cv::Vec3b* drawRow = drawWindow.ptr<cv::Vec3b>(y);
+    std::memset(drawRow, 0, 3 * imgSize.width);
+    for (int x = perspectiveImg.nextSetBit(y, 0, imgSize.width);
+        x < imgSize.width;
+        x = perspectiveImg.nextSetBit(y, x + 1, imgSize.width)) {
+      drawRow[x] = cv::Vec3b(255, 255, 255);
+    }
+  }
+}
+/**
+ *   @brief Function to mark lane pixels in the colour of their lane
+ *
+ *   @param pixels of the lane of type LanePointSet
+ *   @param lane of type LaneTracker::Lane
+ *   @param debug image with the lane pixels marked of type cv::Mat
+ *   @return nothing
+ */
+void LaneVisualizer::drawLanePoints(const LanePointSet& lanePts, int lane,
+                                    cv::Mat& drawWindow) {
+  // the left lane green, the right lane red
+  cv::Vec3b laneColor = (lane == LaneTracker::RIGHT_LANE)
+      ? cv::Vec3b(0, 0, 255) : cv::Vec3b(0, 255, 0);
+  const int* xs = lanePts.getX();
+  const int* ys = lanePts.getY();
+  for (std::size_t i = 0; i < lanePts.size(); i++) {
+    drawWindow.at<cv::Vec3b>(ys[i], xs[i]) = laneColor;
+  }
+}
+/**
+ *   @brief Function to draw the lanes of a frame over its bird's-eye mask
+ *          and composite them on the frame; the null sink returns at once
+ *
+ *   @param input frame of type cv::Mat
+ *   @param packed projective transform of binary image of type
+ *          PackedBinaryImage
+ *   @param left lane pixels of type LanePointSet
+ *   @param right lane pixels of type LanePointSet
+ *   @param inverse perspective transform of type cv::Mat
+ *   @param debug image with the lane pixels marked of type cv::Mat
+ *   @param frame with the lanes composited of type cv::Mat
+ *   @return nothing
+ */
+void LaneVisualizer::render(const cv::Mat& frame,
+                            const PackedBinaryImage& perspectiveImg,
+                            const LanePointSet& leftLanePts,
+                            const LanePointSet& rightLanePts,
+                            const cv::Mat& T_perspective_inv,
+                            cv::Mat& drawWindow, cv::Mat& outputFrame) {
+  if (!isEnabled()) {
+    return;
+  }
+  // mark the lanes over the mask in lane order, so a pixel in both lanes
+  // is always drawn in the colour of the right lane
+  drawLaneMask(perspectiveImg, drawWindow);
+  drawLanePoints(leftLanePts, LaneTracker::LEFT_LANE, drawWindow);
+  drawLanePoints(rightLanePts, LaneTracker::RIGHT_LANE, drawWindow);
+  // undo perspective transformation
+  cv::warpPerspective(drawWindow, outputFrame, T_perspective_inv,
+                      drawWindow.size());
+  // fill the pixels without lane information from the frame
+  for (int j = 0; j < outputFrame.rows; j++) {
+    cv::Vec3b* outRow = outputFrame.ptr<cv::Vec3b>(j);
+    const cv::Vec3b* frameRow = frame.ptr<cv::Vec3b>(j);
+    for (int i = 0; i < outputFrame.cols; i++) {
+      if (outRow[i] == cv::Vec3b(0, 0, 0)) {
+        outRow[i] = frameRow[i];
+      }
+    }
+  }
+}
+/**
+ *   @brief Function to composite lane fits on a frame. The fits are
+ *          sampled, projected into the frame and drawn as the lane area
+ *          and curves, blended over their bounding box only; the rest
+ *          of the frame is copied. The null sink returns at once
+ *
+ *   @param input frame of type cv::Mat
+ *   @param column of each lane as a polynomial in the bird's-eye row,
+ *          coefficients in increasing order of power, or empty, of type
+ *          cv::Mat*
+ *   @param size of the bird's-eye view of type cv::Size
+ *   @param inverse perspective transform of type cv::Mat
+ *   @param frame sized scratch the lanes are drawn in before blending,
+ *          of type cv::Mat
+ *   @param frame with the lanes composited of type cv::Mat
+ *   @return nothing
+ */
+void LaneVisualizer::renderFits(const cv::Mat& frame, const cv::Mat* laneFits,
+                                const cv::Size& birdsEyeSize,
+                                const cv::Mat& T_perspective_inv,
+                                cv::Mat& overlay, cv::Mat& outputFrame) {
+  if (!isEnabled()) {
+    return;
+  }
+  CV_Assert(frame.type() == CV_8UC3);
+  frame.copyTo(outputFrame);
+  // sample each fitted lane at evenly spaced rows of the bird's-eye view
+  birdsEyePts.clear();
+  int numLanesFitted = 0;
+  for (int lane = 0; lane < LaneTracker::NUM_LANES; lane++) {
+    if (laneFits[lane].empty()) {
+      continue;
+    }
+    CV_Assert(laneFits[lane].type() == CV_64F);
+    const double* coeffs = laneFits[lane].ptr<double>();
+    int order = static_cast<int>(laneFits[lane].total()) - 1;
+    for (int i = 0; i < numSamples; i++) {
+      double y = static_cast<double>(i) * (birdsEyeSize.height - 1)
+          / (numSamples - 1);
+      // column of the fit on this row, by Horner's rule
+      double x = coeffs[order];
+      for (int k = order - 1; k >= 0; k--) {
+        x = x * y + coeffs[k];
+      }
+      birdsEyePts.push_back(cv::Point2f(static_cast<float>(x),
+                                        static_cast<float>(y)));
+    }
+    numLanesFitted++;
+  }
+  if (numLanesFitted == 0) {
+    return;
+  }
+  // only the samples are projected, not the whole bird's-eye image
+  cv::perspectiveTransform(birdsEyePts, cameraPts, T_perspective_inv);
+  // region the lanes cover, widened by the curves and clipped to the frame
+  cv::Rect region = cv::boundingRect(cameraPts);
+  region -= cv::Point(lineWidth, lineWidth);
+  region += cv::Size(2 * lineWidth, 2 * lineWidth);
+  region &= cv::Rect(0, 0, frame.cols, frame.rows);
+  if (region.area() == 0) {
+    return;
+  }
+  // curves relative to the region, in the order the lanes were sampled
+  std::size_t sampleIdx = 0;
+  for (int lane = 0; lane < LaneTracker::NUM_LANES; lane++) {
+    laneCurves[lane].clear();
+    if (laneFits[lane].empty()) {
+      continue;
+    }
+    for (int i = 0; i < numSamples; i++, sampleIdx++) {
+      laneCurves[lane].push_back(
+          cv::Point2d(cameraPts[sampleIdx].x - region.x,
+                      cameraPts[sampleIdx].y - region.y));
+    }
+  }
+  cv::Mat overlayRegion;
+  overlay.create(frame.size(), frame.type());
+  overlayRegion = overlay(region);
+  frame(region).copyTo(overlayRegion);
+  // the area between the lanes, down the left curve and up the right one
+  if (numLanesFitted == LaneTracker::NUM_LANES) {
+    const std::vector<cv::Point2d>& leftCurve =
+        laneCurves[LaneTracker::LEFT_LANE];
+    const std::vector<cv::Point2d>& rightCurve =
+        laneCurves[LaneTracker::RIGHT_LANE];
+    lanePolygon.assign(leftCurve.begin(), leftCurve.end());
+    lanePolygon.insert(lanePolygon.end(), rightCurve.rbegin(),
+                       rightCurve.rend());
+    fillPolygon(overlayRegion, lanePolygon.data(),
+                static_cast<int>(lanePolygon.size()), cv::Vec3b(255, 0, 0));
+  }
+  // the left lane green, the right lane red
+  for (int lane = 0; lane < LaneTracker::NUM_LANES; lane++) {
+    if (laneCurves[lane].empty()) {
+      continue;
+    }
+    cv::Vec3b laneColor = (lane == LaneTracker::RIGHT_LANE)
+        ? cv::Vec3b(0, 0, 255) : cv::Vec3b(0, 255, 0);
+    drawCurve(overlayRegion, laneCurves[lane], laneColor);
+  }
+  cv::Mat outputRegion = outputFrame(region);
+  cv::addWeighted(overlayRegion, alpha, frame(region), 1 - alpha, 0,
+                  outputRegion);
+}
+/**
+ *   @brief Function to show a rendered frame in a window; only the window
+ *          sink calls into the GUI
+ *
+ *   @param frame with the lanes composited of type cv::Mat
+ *   @return false if a key was pressed to stop, type bool
+ */
+bool LaneVisualizer::show(const cv::Mat& outputFrame) {
+  if (mode != VISUALIZE_WINDOW) {
+    return true;
+  }
+  cv::imshow(windowName, outputFrame);
+  isWindowOpen = true;
+  return cv::waitKey(waitTime) < 0;
+}
+/**
+ *   @brief Function to close the window if one was shown
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void LaneVisualizer::close(void) {
+  if (isWindowOpen) {
+    cv::destroyAllWindows();  // destroy/close all frames
+    isWindowOpen = false;
+  }
+}
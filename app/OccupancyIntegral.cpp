@@ -0,0 +1,170 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright [2018] rohithjayarajan, Akash Guha
+ *  @file    OccupancyIntegral.cpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Occupancy Integral Class File
+ *
+ *  @section DESCRIPTION
+ *
+ *  Summed-area table of the bird's-eye lane mask. Each row adds the
+ *  running count of its set pixels, found word by word with empty words
+ *  skipped, to the row above with OpenCV universal intrinsics.
+ *
+ */
+
+#include "OccupancyIntegral.hpp"
+/**
+ *   @brief Default constructor for OccupancyIntegral
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+OccupancyIntegral::OccupancyIntegral() {
+  stride = 0;
+}
+/**
+ *   @brief Default destructor for OccupancyIntegral
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+OccupancyIntegral::~OccupancyIntegral() {
+}
+/**
+ *   @brief Function to size the table, keeping the buffer if the size
+ *          is unchanged
+ *
+ *   @param image size of type cv::Size
+ *   @return nothing
+ */
+void OccupancyIntegral::create(const cv::Size& imgSize_) {
+  imgSize = imgSize_;
+  stride = imgSize.width + 1;
+  table.resize(static_cast<std::size_t>(imgSize.height + 1) * stride);
+  rowPrefix.resize(stride);
+}
+/**
+ *   @brief Function to build the table of a packed binary image in one
+ *          pass over its rows
+ *
+ *   @param packed binary image of type PackedBinaryImage
+ *   @return nothing
+ */
+void OccupancyIntegral::build(const PackedBinaryImage& img) {
+  create(img.getSize());
+  std::fill(table.begin(), table.begin() + stride, 0);
+  rowPrefix[0] = 0;
+  for (int y = 0; y < imgSize.height; y++) {
+    // running count of set pixels along the row
+    const uint64_t* bits = img.getRow(y);
+    int run = 0;
+    for (int w = 0; w < img.getWordsPerRow(); w++) {
+      int xBegin = 64 * w;
+      int xEnd = std::min(xBegin + 64, imgSize.width);
+      uint64_t word = bits[w];
+      if (word == 0) {
+        // most of the bird's-eye mask is empty
+        std::fill(&rowPrefix[xBegin + 1], &rowPrefix[xEnd] + 1, run);
+        continue;
+      }
+      for (int x = xBegin; x < xEnd; x++) {
+        run += static_cast<int>((word >> (x - xBegin)) & 1);
+        rowPrefix[x + 1] = run;
+      }
+    }
+    // add the running count to the row above
+    const int* above = &table[static_cast<std::size_t>(y) * stride];
+    int* current = &table[static_cast<std::size_t>(y + 1) * stride];
+    int x = 0;
+#if CV_SIMD128
+    for (; x <= stride - 4; x += 4) {
+      cv::v_store(current + x,
+                  cv::v_load(above + x) + cv::v_load(&rowPrefix[x]));
+    }
+#endif
+    for (; x < stride; x++) {
+      current[x] = above[x] + rowPrefix[x];
+    }
+  }
+}
+/**
+ *   @brief Function to get a row of the table
+ *
+ *   @param row of the table, 0 to rows, of type int
+ *   @return entries of the row of type const int*
+ */
+const int* OccupancyIntegral::getRow(int y) const {
+  return &table[static_cast<std::size_t>(y) * stride];
+}
+/**
+ *   @brief Function to get the size of the image the table is built for
+ *
+ *   @param nothing
+ *   @return image size of type cv::Size
+ */
+cv::Size OccupancyIntegral::getSize(void) const {
+  return imgSize;
+}
+/**
+ *   @brief Function to count the set pixels of a window in constant time
+ *
+ *   @param window, clipped to the image, of type cv::Rect
+ *   @return number of set pixels of type int
+ */
+int OccupancyIntegral::count(const cv::Rect& window) const {
+  cv::Rect clipped = window & cv::Rect(0, 0, imgSize.width, imgSize.height);
+  if (clipped.area() == 0) {
+    return 0;
+  }
+  const int* top = getRow(clipped.y);
+  const int* bottom = getRow(clipped.y + clipped.height);
+  int xEnd = clipped.x + clipped.width;
+  return bottom[xEnd] - bottom[clipped.x] - top[xEnd] + top[clipped.x];
+}
+/**
+ *   @brief Function to compute the column histogram of a band of rows,
+ *          scaled by 255 to match summing a 0/255 mask
+ *
+ *   @param first row of the band of type int
+ *   @param row after the last row of the band of type int
+ *   @param histogram with one bin per column of type std::vector<double>
+ *   @return nothing
+ */
+void OccupancyIntegral::columnHistogram(int rowBegin, int rowEnd,
+                                        std::vector<double>& hist) const {
+  CV_Assert(0 <= rowBegin && rowBegin <= rowEnd && rowEnd <= imgSize.height);
+  hist.resize(imgSize.width);
+  const int* top = getRow(rowBegin);
+  const int* bottom = getRow(rowEnd);
+  for (int x = 0; x < imgSize.width; x++) {
+    int columnCount = (bottom[x + 1] - bottom[x]) - (top[x + 1] - top[x]);
+    hist[x] = 255.0 * columnCount;
+  }
+}
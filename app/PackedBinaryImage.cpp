@@ -0,0 +1,313 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright [2018] rohithjayarajan, Akash Guha
+ *  @file    PackedBinaryImage.cpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Packed Binary Image Class File
+ *
+ *  @section DESCRIPTION
+ *
+ *  One bit per pixel binary image of the lane detection pipeline. Masks
+ *  are packed 16 pixels at a time with OpenCV universal intrinsics, pixel
+ *  counts use popcount over 64 bit words and set pixels are found with
+ *  count trailing zeros.
+ *
+ */
+
+#include "PackedBinaryImage.hpp"
+
+/**
+ *   @brief Function to count the set bits of a word
+ *
+ *   @param word of type uint64_t
+ *   @return number of set bits of type int
+ */
+static inline int popCount64(uint64_t word) {
+  return __builtin_popcountll(word);
+}
+/**
+ *   @brief Function to get the index of the lowest set bit of a non-zero
+ *          word
+ *
+ *   @param word of type uint64_t
+ *   @return bit index of type int
+ */
+static inline int lowestSetBit64(uint64_t word) {
+  return __builtin_ctzll(word);
+}
+static inline uint64_t poolPairs64(uint64_t word) {
+  // OR every pair of pixels into its even bit, then gather the even bits
+  // into the low half
+  word = (word | (word >> 1)) & 0x5555555555555555ULL;
+  word = (word | (word >> 1)) & 0x3333333333333333ULL;
+  word = (word | (word >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+  word = (word | (word >> 4)) & 0x00FF00FF00FF00FFULL;
+  word = (word | (word >> 8)) & 0x0000FFFF0000FFFFULL;
+  return (word | (word >> 16)) & 0x00000000FFFFFFFFULL;
+}
+/**
+ *   @brief Default constructor for PackedBinaryImage
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+PackedBinaryImage::PackedBinaryImage() {
+  wordsPerRow = 0;
+}
+/**
+ *   @brief Default destructor for PackedBinaryImage
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+PackedBinaryImage::~PackedBinaryImage() {
+}
+/**
+ *   @brief Function to size the image, keeping the buffer if the size
+ *          is unchanged. Pixel values are undefined afterwards
+ *
+ *   @param image size of type cv::Size
+ *   @return nothing
+ */
+void PackedBinaryImage::create(const cv::Size& imgSize_) {
+  imgSize = imgSize_;
+  wordsPerRow = (imgSize.width + 63) / 64;
+  words.resize(static_cast<std::size_t>(wordsPerRow) * imgSize.height);
+}
+/**
+ *   @brief Function to set all pixels to 0
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void PackedBinaryImage::clear(void) {
+  std::fill(words.begin(), words.end(), 0);
+}
+/**
+ *   @brief Function to pack a mask, every non-zero pixel becomes a set
+ *          bit
+ *
+ *   @param mask of type CV_8U cv::Mat
+ *   @return nothing
+ */
+void PackedBinaryImage::pack(const cv::Mat& mask) {
+  CV_Assert(mask.type() == CV_8U);
+  create(mask.size());
+  for (int y = 0; y < imgSize.height; y++) {
+    const uchar* maskRow = mask.ptr<uchar>(y);
+    uint64_t* row = getRow(y);
+    for (int w = 0; w < wordsPerRow; w++) {
+      int x = 64 * w;
+      int xEnd = std::min(x + 64, imgSize.width);
+      uint64_t word = 0;
+#if CV_SIMD128
+      const cv::v_uint8x16 zero = cv::v_setzero_u8();
+      for (; x <= xEnd - 16; x += 16) {
+        // one bit per byte that is not zero
+        int bits = cv::v_signmask(~(cv::v_load(maskRow + x) == zero));
+        word |= static_cast<uint64_t>(bits & 0xffff) << (x & 63);
+      }
+#endif
+      for (; x < xEnd; x++) {
+        if (maskRow[x]) {
+          word |= static_cast<uint64_t>(1) << (x & 63);
+        }
+      }
+      row[w] = word;
+    }
+  }
+}
+/**
+ *   @brief Function to unpack the image into a 0/255 mask
+ *
+ *   @param mask of type CV_8U cv::Mat
+ *   @return nothing
+ */
+void PackedBinaryImage::unpack(cv::Mat& mask) const {
+  mask.create(imgSize, CV_8U);
+  for (int y = 0; y < imgSize.height; y++) {
+    uchar* maskRow = mask.ptr<uchar>(y);
+    std::memset(maskRow, 0, imgSize.width);
+    for (int x = nextSetBit(y, 0, imgSize.width); x < imgSize.width;
+        x = nextSetBit(y, x + 1, imgSize.width)) {
+      maskRow[x] = 255;
+    }
+  }
+}
+/**
+ *   @brief Function to get the size of the image
+ *
+ *   @param nothing
+ *   @return image size of type cv::Size
+ */
+cv::Size PackedBinaryImage::getSize(void) const {
+  return imgSize;
+}
+/**
+ *   @brief Function to get the number of 64 bit words per row
+ *
+ *   @param nothing
+ *   @return words per row of type int
+ */
+int PackedBinaryImage::getWordsPerRow(void) const {
+  return wordsPerRow;
+}
+/**
+ *   @brief Function to get the words of a row
+ *
+ *   @param row of type int
+ *   @return words of the row of type uint64_t*
+ */
+uint64_t* PackedBinaryImage::getRow(int y) {
+  return &words[static_cast<std::size_t>(y) * wordsPerRow];
+}
+/**
+ *   @brief Function to get the words of a row
+ *
+ *   @param row of type int
+ *   @return words of the row of type const uint64_t*
+ */
+const uint64_t* PackedBinaryImage::getRow(int y) const {
+  return &words[static_cast<std::size_t>(y) * wordsPerRow];
+}
+/**
+ *   @brief Function to count the set pixels of a row span
+ *
+ *   @param row of type int
+ *   @param first column of the span of type int
+ *   @param column after the last column of the span of type int
+ *   @return number of set pixels of type int
+ */
+int PackedBinaryImage::countRange(int y, int xBegin, int xEnd) const {
+  if (xEnd <= xBegin) {
+    return 0;
+  }
+  const uint64_t* row = getRow(y);
+  int firstWord = xBegin >> 6;
+  int lastWord = (xEnd - 1) >> 6;
+  uint64_t firstMask = ~static_cast<uint64_t>(0) << (xBegin & 63);
+  uint64_t lastMask = ~static_cast<uint64_t>(0) >> (63 - ((xEnd - 1) & 63));
+  if (firstWord == lastWord) {
+    return popCount64(row[firstWord] & firstMask & lastMask);
+  }
+  int count = popCount64(row[firstWord] & firstMask);
+  for (int w = firstWord + 1; w < lastWord; w++) {
+    count += popCount64(row[w]);
+  }
+  return count + popCount64(row[lastWord] & lastMask);
+}
+/**
+ *   @brief Function to count the set pixels of a window
+ *
+ *   @param window, clipped to the image, of type cv::Rect
+ *   @return number of set pixels of type int
+ */
+int PackedBinaryImage::countWindow(const cv::Rect& window) const {
+  int count = 0;
+  for (int y = window.y; y < window.y + window.height; y++) {
+    count += countRange(y, window.x, window.x + window.width);
+  }
+  return count;
+}
+/**
+ *   @brief Function to find the next set pixel of a row span
+ *
+ *   @param row of type int
+ *   @param first column to search of type int
+ *   @param column after the last column to search of type int
+ *   @return column of the first set pixel, or xEnd if there is none,
+ *           type int
+ */
+int PackedBinaryImage::nextSetBit(int y, int xBegin, int xEnd) const {
+  if (xEnd <= xBegin) {
+    return xEnd;
+  }
+  const uint64_t* row = getRow(y);
+  int w = xBegin >> 6;
+  int lastWord = (xEnd - 1) >> 6;
+  uint64_t word = row[w] & (~static_cast<uint64_t>(0) << (xBegin & 63));
+  while (word == 0) {
+    if (++w > lastWord) {
+      return xEnd;
+    }
+    word = row[w];
+  }
+  return std::min(64 * w + lowestSetBit64(word), xEnd);
+}
+/**
+ *   @brief Function to compute the column histogram of a band of rows,
+ *          scaled by 255 to match summing a 0/255 mask
+ *
+ *   @param first row of the band of type int
+ *   @param row after the last row of the band of type int
+ *   @param histogram with one bin per column of type std::vector<double>
+ *   @return nothing
+ */
+void PackedBinaryImage::columnHistogram(int rowBegin, int rowEnd,
+                                        std::vector<double>& hist) const {
+  hist.resize(imgSize.width);
+  std::fill(hist.begin(), hist.end(), 0.0);
+  for (int y = rowBegin; y < rowEnd; y++) {
+    const uint64_t* row = getRow(y);
+    for (int w = 0; w < wordsPerRow; w++) {
+      // visit only the set pixels, the mask is sparse
+      for (uint64_t word = row[w]; word != 0; word &= word - 1) {
+        hist[64 * w + lowestSetBit64(word)] += 255.0;
+      }
+    }
+  }
+}
+/**
+ *   @brief Function to downsample an image by 2 in both directions,
+ *          setting a pixel if any pixel of its 2x2 block is set, so thin
+ *          lines survive
+ *
+ *   @param image at twice the resolution of type PackedBinaryImage
+ *   @return nothing
+ */
+void PackedBinaryImage::maxPool(const PackedBinaryImage& src) {
+  CV_Assert(&src != this);
+  cv::Size srcSize = src.getSize();
+  create(cv::Size((srcSize.width + 1) / 2, (srcSize.height + 1) / 2));
+  int srcWords = src.getWordsPerRow();
+  for (int y = 0; y < imgSize.height; y++) {
+    const uint64_t* srcRow0 = src.getRow(2 * y);
+    // an odd last row pools with itself
+    const uint64_t* srcRow1 = src.getRow(std::min(2 * y + 1,
+                                                  srcSize.height - 1));
+    uint64_t* row = getRow(y);
+    for (int w = 0; w < wordsPerRow; w++) {
+      // 128 source pixels make 64 pooled ones
+      uint64_t low = srcRow0[2 * w] | srcRow1[2 * w];
+      uint64_t high = (2 * w + 1 < srcWords)
+          ? (srcRow0[2 * w + 1] | srcRow1[2 * w + 1]) : 0;
+      row[w] = poolPairs64(low) | (poolPairs64(high) << 32);
+    }
+  }
+}
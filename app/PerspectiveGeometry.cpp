@@ -0,0 +1,197 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright [2018] rohithjayarajan, Akash Guha
+ *  @file    PerspectiveGeometry.cpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Perspective Geometry Class File
+ *
+ *  @section DESCRIPTION
+ *
+ *  Computes the bird's-eye homographies and warp maps once and serves
+ *  them to every frame of the lane detection pipeline.
+ *
+ */
+
+#include "PerspectiveGeometry.hpp"
+/**
+ *   @brief Default constructor for PerspectiveGeometry
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+PerspectiveGeometry::PerspectiveGeometry() {
+  // set vertices of input polygon for perspective transform
+  srcQuad.push_back(cv::Point2f(544, 462));
+  srcQuad.push_back(cv::Point2f(731, 462));
+  srcQuad.push_back(cv::Point2f(1268, 708));
+  srcQuad.push_back(cv::Point2f(0, 708));
+}
+/**
+ *   @brief Default destructor for PerspectiveGeometry
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+PerspectiveGeometry::~PerspectiveGeometry() {
+}
+/**
+ *   @brief Function to set the quadrilateral in the camera image
+ *
+ *   @param four vertices of type std::vector<cv::Point2f>
+ *   @return nothing
+ */
+void PerspectiveGeometry::setSrcQuad(const std::vector<cv::Point2f>& srcQuad_) {
+  CV_Assert(srcQuad_.size() == 4);
+  srcQuad = srcQuad_;
+  warpMap1.release();  // rebuild on the next update
+}
+/**
+ *   @brief Function to set the quadrilateral in the bird's-eye image
+ *
+ *   @param four vertices, or none to use the image corners, of type
+ *          std::vector<cv::Point2f>
+ *   @return nothing
+ */
+void PerspectiveGeometry::setDstQuad(const std::vector<cv::Point2f>& dstQuad_) {
+  CV_Assert(dstQuad_.empty() || dstQuad_.size() == 4);
+  dstQuad = dstQuad_;
+  warpMap1.release();  // rebuild on the next update
+}
+/**
+ *   @brief Function to get the quadrilateral in the camera image
+ *
+ *   @param nothing
+ *   @return four vertices of type std::vector<cv::Point2f>
+ */
+std::vector<cv::Point2f> PerspectiveGeometry::getSrcQuad(void) const {
+  return srcQuad;
+}
+/**
+ *   @brief Function to get the quadrilateral in the bird's-eye image
+ *
+ *   @param nothing
+ *   @return four vertices, or none for the image corners, of type
+ *           std::vector<cv::Point2f>
+ */
+std::vector<cv::Point2f> PerspectiveGeometry::getDstQuad(void) const {
+  return dstQuad;
+}
+/**
+ *   @brief Function to build the homographies and warp maps if the
+ *          quadrilaterals or the image size changed
+ *
+ *   @param image size of type cv::Size
+ *   @return nothing
+ */
+void PerspectiveGeometry::update(const cv::Size& imgSize_) {
+  if (!warpMap1.empty() && imgSize == imgSize_) {
+    return;
+  }
+  std::vector<cv::Point2f> outQuad = dstQuad;
+  if (outQuad.empty()) {
+    // stretch the quadrilateral over the whole bird's-eye image
+    outQuad.push_back(cv::Point2f(0, 0));
+    outQuad.push_back(cv::Point2f(imgSize_.width, 0));
+    outQuad.push_back(cv::Point2f(imgSize_.width, imgSize_.height));
+    outQuad.push_back(cv::Point2f(0, imgSize_.height));
+  }
+  // fresh matrices, so headers handed out earlier keep their old values
+  T_perspective = cv::getPerspectiveTransform(srcQuad, outQuad);
+  T_perspective_inv = cv::getPerspectiveTransform(outQuad, srcQuad);
+  // bird's-eye pixels are looked up backwards through the inverse
+  // homography, rounded to fixed point the same way cv::warpPerspective
+  // rounds its per block maps
+  warpMap1.create(imgSize_, CV_16SC2);
+  warpMap2.create(imgSize_, CV_16UC1);
+  const double* M = T_perspective_inv.ptr<double>();
+  for (int y = 0; y < imgSize_.height; y++) {
+    cv::Vec2s* xy = warpMap1.ptr<cv::Vec2s>(y);
+    ushort* alpha = warpMap2.ptr<ushort>(y);
+    for (int x = 0; x < imgSize_.width; x++) {
+      double W = M[6] * x + M[7] * y + M[8];
+      W = W ? cv::INTER_TAB_SIZE / W : 0;
+      double fX = std::max(static_cast<double>(INT_MIN), std::min(
+          static_cast<double>(INT_MAX), (M[0] * x + M[1] * y + M[2]) * W));
+      double fY = std::max(static_cast<double>(INT_MIN), std::min(
+          static_cast<double>(INT_MAX), (M[3] * x + M[4] * y + M[5]) * W));
+      int X = cv::saturate_cast<int>(fX);
+      int Y = cv::saturate_cast<int>(fY);
+      xy[x] = cv::Vec2s(cv::saturate_cast<short>(X >> cv::INTER_BITS),
+                        cv::saturate_cast<short>(Y >> cv::INTER_BITS));
+      alpha[x] = static_cast<ushort>(
+          (Y & (cv::INTER_TAB_SIZE - 1)) * cv::INTER_TAB_SIZE
+              + (X & (cv::INTER_TAB_SIZE - 1)));
+    }
+  }
+  imgSize = imgSize_;
+}
+/**
+ *   @brief Function to get the camera to bird's-eye homography
+ *
+ *   @param nothing
+ *   @return 3x3 homography of type cv::Mat
+ */
+const cv::Mat& PerspectiveGeometry::getTransform(void) const {
+  return T_perspective;
+}
+/**
+ *   @brief Function to get the bird's-eye to camera homography
+ *
+ *   @param nothing
+ *   @return 3x3 homography of type cv::Mat
+ */
+const cv::Mat& PerspectiveGeometry::getInverseTransform(void) const {
+  return T_perspective_inv;
+}
+/**
+ *   @brief Function to warp a camera image to the bird's-eye view through
+ *          the cached maps, equivalent to cv::warpPerspective with
+ *          bilinear interpolation
+ *
+ *   @param camera image of type cv::Mat
+ *   @param bird's-eye image of type cv::Mat
+ *   @return nothing
+ */
+void PerspectiveGeometry::warp(const cv::Mat& src, cv::Mat& dst) {
+  update(src.size());
+  warpCached(src, dst);
+}
+/**
+ *   @brief Function to warp a camera image through maps already built
+ *          for its size; safe to call from several threads at once
+ *
+ *   @param camera image of the built size of type cv::Mat
+ *   @param bird's-eye image of type cv::Mat
+ *   @return nothing
+ */
+void PerspectiveGeometry::warpCached(const cv::Mat& src, cv::Mat& dst) const {
+  CV_Assert(!warpMap1.empty() && src.size() == imgSize);
+  cv::remap(src, dst, warpMap1, warpMap2, cv::INTER_LINEAR,
+            cv::BORDER_CONSTANT);
+}
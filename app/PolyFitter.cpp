@@ -0,0 +1,500 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    PolyFitter.cpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Polynomial Fitter Class File
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class file for the least-squares polynomial fit of lane pixels. The
+ *  points are mapped to u = (x - centre) / scale, in [-1, 1], before the
+ *  power sums are taken, which keeps the normal equations well
+ *  conditioned; the solution is mapped back to powers of x.
+ *
+ */
+
+#include "PolyFitter.hpp"
+
+/**
+ *   @brief Default constructor for PolyFitter
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+PolyFitter::PolyFitter() {
+  mode = FIT_LEAST_SQUARES;
+  huberDelta = 10.0;  // pixels
+  ransacThreshold = 10.0;  // pixels
+  iterations = 5;
+  ransacScorePoints = 1000;
+  domainSet = false;
+  domainCenter = 0.0;
+  domainScale = 1.0;
+  setOrder(2);
+}
+/**
+ *   @brief Copy constructor for PolyFitter; copies the settings only, so
+ *          the copies share no scratch
+ *
+ *   @param fitter to copy of type PolyFitter
+ *   @return nothing
+ */
+PolyFitter::PolyFitter(const PolyFitter& other) {
+  order = -1;  // sized by copySettings
+  copySettings(other);
+}
+/**
+ *   @brief Assignment operator for PolyFitter; copies the settings only
+ *
+ *   @param fitter to copy of type PolyFitter
+ *   @return this fitter of type PolyFitter&
+ */
+PolyFitter& PolyFitter::operator=(const PolyFitter& other) {
+  copySettings(other);
+  return *this;
+}
+/**
+ *   @brief Default destructor for PolyFitter
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+PolyFitter::~PolyFitter() {
+}
+/**
+ *   @brief Function to take the settings of another fitter, keeping this
+ *          fitter's scratch when the degree is the same
+ *
+ *   @param fitter to copy the settings of of type PolyFitter
+ *   @return nothing
+ */
+void PolyFitter::copySettings(const PolyFitter& other) {
+  if (order != other.order) {
+    setOrder(other.order);
+  }
+  mode = other.mode;
+  huberDelta = other.huberDelta;
+  ransacThreshold = other.ransacThreshold;
+  iterations = other.iterations;
+  ransacScorePoints = other.ransacScorePoints;
+  domainSet = other.domainSet;
+  domainCenter = other.domainCenter;
+  domainScale = other.domainScale;
+}
+/**
+ *   @brief Function to set the degree of the polynomial
+ *
+ *   @param degree of type int
+ *   @return nothing
+ */
+void PolyFitter::setOrder(int order_) {
+  CV_Assert(order_ >= 0);
+  order = order_;
+  powerSums.assign(2 * order + 1, 0.0);
+  momentSums.assign(order + 1, 0.0);
+  normalMatrix.create(order + 1, order + 1);
+  momentVector.create(order + 1, 1);
+  sampleMatrix.create(order + 1, order + 1);
+  sampleValues.create(order + 1, 1);
+}
+/**
+ *   @brief Function to get the degree of the polynomial
+ *
+ *   @param nothing
+ *   @return degree of type int
+ */
+int PolyFitter::getOrder(void) {
+  return order;
+}
+/**
+ *   @brief Function to select the loss of the fit
+ *
+ *   @param loss of type PolyFitter::FitMode
+ *   @return nothing
+ */
+void PolyFitter::setMode(int mode_) {
+  CV_Assert(mode_ >= FIT_LEAST_SQUARES && mode_ <= FIT_RANSAC);
+  mode = mode_;
+}
+/**
+ *   @brief Function to get the loss of the fit
+ *
+ *   @param nothing
+ *   @return loss of type PolyFitter::FitMode
+ */
+int PolyFitter::getMode(void) {
+  return mode;
+}
+/**
+ *   @brief Function to set the residual where the Huber loss turns linear
+ *
+ *   @param residual of type double
+ *   @return nothing
+ */
+void PolyFitter::setHuberDelta(double huberDelta_) {
+  CV_Assert(huberDelta_ > 0.0);
+  huberDelta = huberDelta_;
+}
+/**
+ *   @brief Function to set the largest residual of a RANSAC inlier
+ *
+ *   @param residual of type double
+ *   @return nothing
+ */
+void PolyFitter::setRansacThreshold(double ransacThreshold_) {
+  CV_Assert(ransacThreshold_ > 0.0);
+  ransacThreshold = ransacThreshold_;
+}
+/**
+ *   @brief Function to set the number of reweighting passes of the Huber
+ *          fit and of samples of the RANSAC fit
+ *
+ *   @param number of iterations of type int
+ *   @return nothing
+ */
+void PolyFitter::setIterations(int iterations_) {
+  CV_Assert(iterations_ >= 1);
+  iterations = iterations_;
+}
+/**
+ *   @brief Function to set the most points a RANSAC sample is scored on
+ *
+ *   @param number of points of type int
+ *   @return nothing
+ */
+void PolyFitter::setRansacScorePoints(int ransacScorePoints_) {
+  CV_Assert(ransacScorePoints_ >= 1);
+  ransacScorePoints = ransacScorePoints_;
+}
+/**
+ *   @brief Function to give the x range of the points, so the fit needs
+ *          no pass to find it
+ *
+ *   @param x mapped to 0 of type double
+ *   @param half width of the x range of type double
+ *   @return nothing
+ */
+void PolyFitter::setDomain(double domainCenter_, double domainScale_) {
+  CV_Assert(domainScale_ > 0.0);
+  domainSet = true;
+  domainCenter = domainCenter_;
+  domainScale = domainScale_;
+}
+/**
+ *   @brief Function to find the x range from the points again
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void PolyFitter::clearDomain(void) {
+  domainSet = false;
+}
+/**
+ *   @brief Function to evaluate a polynomial by Horner's rule
+ *
+ *   @param coefficients in increasing order of power of type double*
+ *   @param degree of the polynomial of type int
+ *   @param point to evaluate at of type double
+ *   @return value of the polynomial of type double
+ */
+double PolyFitter::evaluate(const double* coeffs, int degree, double u) {
+  double value = coeffs[degree];
+  for (int k = degree - 1; k >= 0; k--) {
+    value = value * u + coeffs[k];
+  }
+  return value;
+}
+/**
+ *   @brief Function to accumulate the weighted power sums of the points in
+ *          the centred and scaled domain. With a model, the weights are
+ *          scaled by the Huber loss or zeroed for RANSAC outliers
+ *
+ *   @param x of the points of type int*
+ *   @param y of the points of type int*
+ *   @param number of ints from one point to the next of type std::size_t
+ *   @param weights of the points or nullptr for 1, of type float*
+ *   @param number of points of type std::size_t
+ *   @param centre of the domain of type double
+ *   @param scale of the domain of type double
+ *   @param coefficients in the domain or nullptr, of type double*
+ *   @return nothing
+ */
+void PolyFitter::accumulate(const int* xs, const int* ys, std::size_t stride,
+                            const float* weights, std::size_t count,
+                            double center, double scale,
+                            const double* model) {
+  std::fill(powerSums.begin(), powerSums.end(), 0.0);
+  std::fill(momentSums.begin(), momentSums.end(), 0.0);
+  double invScale = 1.0 / scale;
+  int numPowers = 2 * order + 1;
+  for (std::size_t i = 0; i < count; i++) {
+    double u = (xs[i * stride] - center) * invScale;
+    double y = ys[i * stride];
+    double w = weights ? weights[i] : 1.0;
+    if (model) {
+      double absResidual = std::abs(y - evaluate(model, order, u));
+      if (mode == FIT_HUBER) {
+        // the Huber loss weighs large residuals down to delta / |r|
+        if (absResidual > huberDelta) {
+          w *= huberDelta / absResidual;
+        }
+      } else if (absResidual > ransacThreshold) {
+        continue;  // RANSAC outlier
+      }
+    }
+    // w u^k for the moments, then on up to u^(2 order)
+    double wPower = w;
+    int k = 0;
+    for (; k <= order; k++) {
+      powerSums[k] += wPower;
+      momentSums[k] += wPower * y;
+      wPower *= u;
+    }
+    for (; k < numPowers; k++) {
+      powerSums[k] += wPower;
+      wPower *= u;
+    }
+  }
+}
+/**
+ *   @brief Function to solve the normal equations of the accumulated sums
+ *
+ *   @param coefficients in the domain, released if the points have no
+ *          weight, of type cv::Mat
+ *   @return true if the points determine the polynomial, type bool
+ */
+bool PolyFitter::solveNormal(cv::Mat& solvedCoeffs) {
+  int n = order + 1;
+  for (int j = 0; j < n; j++) {
+    for (int k = 0; k < n; k++) {
+      normalMatrix(j, k) = powerSums[j + k];
+    }
+    momentVector(j, 0) = momentSums[j];
+  }
+  if (powerSums[0] <= 0.0) {
+    // no point has weight, nothing to solve
+    solvedCoeffs.release();
+    return false;
+  }
+  // the normal matrix is symmetric positive definite unless the points
+  // are degenerate; then take the least norm solution
+  if (cv::solve(normalMatrix, momentVector, solvedCoeffs,
+                cv::DECOMP_CHOLESKY)) {
+    return true;
+  }
+  cv::solve(normalMatrix, momentVector, solvedCoeffs, cv::DECOMP_SVD);
+  return false;
+}
+/**
+ *   @brief Function to fit the polynomial through a random minimal sample
+ *          for every iteration and keep the one with the most inliers
+ *
+ *   @param x of the points of type int*
+ *   @param y of the points of type int*
+ *   @param number of ints from one point to the next of type std::size_t
+ *   @param number of points of type std::size_t
+ *   @param centre of the domain of type double
+ *   @param scale of the domain of type double
+ *   @param coefficients in the domain of the best sample of type cv::Mat
+ *   @return true if a sample had more inliers than its size, type bool
+ */
+bool PolyFitter::bestSample(const int* xs, const int* ys, std::size_t stride,
+                            std::size_t count, double center, double scale,
+                            cv::Mat& bestCoeffs) {
+  int n = order + 1;
+  double invScale = 1.0 / scale;
+  // score every sample on the same evenly strided subset of the points
+  std::size_t scoreStride = std::max<std::size_t>(1,
+                                                 count / ransacScorePoints);
+  // a fixed seed keeps the fit of the same points the same
+  cv::RNG rng(0x2018);
+  std::size_t bestInliers = n;
+  for (int iter = 0; iter < iterations; iter++) {
+    for (int j = 0; j < n; j++) {
+      std::size_t idx = rng.uniform(0, static_cast<int>(count)) * stride;
+      double u = (xs[idx] - center) * invScale;
+      double uPower = 1.0;
+      for (int k = 0; k < n; k++) {
+        sampleMatrix(j, k) = uPower;
+        uPower *= u;
+      }
+      sampleValues(j, 0) = ys[idx];
+    }
+    // samples repeating an x do not determine the polynomial
+    if (!cv::solve(sampleMatrix, sampleValues, sampleCoeffs, cv::DECOMP_LU)) {
+      continue;
+    }
+    const double* model = sampleCoeffs.ptr<double>();
+    std::size_t inliers = 0;
+    for (std::size_t i = 0; i < count; i += scoreStride) {
+      double u = (xs[i * stride] - center) * invScale;
+      if (std::abs(ys[i * stride] - evaluate(model, order, u))
+          <= ransacThreshold) {
+        inliers++;
+      }
+    }
+    if (inliers > bestInliers) {
+      bestInliers = inliers;
+      sampleCoeffs.copyTo(bestCoeffs);
+    }
+  }
+  return bestInliers > static_cast<std::size_t>(n);
+}
+/**
+ *   @brief Function to fit y as a polynomial in x
+ *
+ *   @param points of type std::vector<cv::Point>
+ *   @param coefficients in increasing order of power of type cv::Mat
+ *   @return nothing
+ */
+void PolyFitter::fit(const std::vector<cv::Point>& pts, cv::Mat& coeffs) {
+  fit(pts.data(), nullptr, pts.size(), coeffs);
+}
+/**
+ *   @brief Function to fit y as a polynomial in x with weighted points
+ *
+ *   @param points of type std::vector<cv::Point>
+ *   @param weights of the points of type std::vector<float>
+ *   @param coefficients in increasing order of power, empty if no point
+ *          has weight, of type cv::Mat
+ *   @return nothing
+ */
+void PolyFitter::fit(const std::vector<cv::Point>& pts,
+                     const std::vector<float>& weights, cv::Mat& coeffs) {
+  CV_Assert(weights.size() == pts.size());
+  fit(pts.data(), weights.data(), pts.size(), coeffs);
+}
+/**
+ *   @brief Function to fit y as a polynomial in x over a range of points
+ *
+ *   @param points of type cv::Point*
+ *   @param weights of the points or nullptr for 1, of type float*
+ *   @param number of points of type std::size_t
+ *   @param coefficients in increasing order of power, as a column of
+ *          CV_64F, empty if no point has weight, of type cv::Mat
+ *   @return nothing
+ */
+void PolyFitter::fit(const cv::Point* pts, const float* weights,
+                     std::size_t count, cv::Mat& coeffs) {
+  if (count == 0) {
+    // no point to interleave, and none with weight
+    coeffs.release();
+    return;
+  }
+  // x and y interleave in the points
+  fit(&pts[0].x, &pts[0].y, 2, weights, count, coeffs);
+}
+/**
+ *   @brief Function to fit a lane's column as a polynomial in the row,
+ *          reading the arrays of the set in place
+ *
+ *   @param pixels of the lane of type LanePointSet
+ *   @param coefficients in increasing order of power, as a column of
+ *          CV_64F, of type cv::Mat
+ *   @return nothing
+ */
+void PolyFitter::fit(const LanePointSet& lanePts, cv::Mat& coeffs) {
+  fit(lanePts.getY(), lanePts.getX(), 1, nullptr, lanePts.size(), coeffs);
+}
+/**
+ *   @brief Function to fit y as a polynomial in x over strided arrays
+ *
+ *   @param x of the points of type int*
+ *   @param y of the points of type int*
+ *   @param number of ints from one point to the next of type std::size_t
+ *   @param weights of the points or nullptr for 1, of type float*
+ *   @param number of points of type std::size_t
+ *   @param coefficients in increasing order of power, as a column of
+ *          CV_64F, empty if no point has weight and the least norm
+ *          solution if fewer than order + 1 distinct x have weight, of
+ *          type cv::Mat
+ *   @return nothing
+ */
+void PolyFitter::fit(const int* xs, const int* ys, std::size_t stride,
+                     const float* weights, std::size_t count,
+                     cv::Mat& coeffs) {
+  // map the x range of the points to [-1, 1]
+  double center = domainCenter;
+  double scale = domainScale;
+  if (!domainSet && count > 0) {
+    int xMin = xs[0], xMax = xs[0];
+    for (std::size_t i = 1; i < count; i++) {
+      xMin = std::min(xMin, xs[i * stride]);
+      xMax = std::max(xMax, xs[i * stride]);
+    }
+    center = 0.5 * (xMin + xMax);
+    scale = std::max(0.5 * (xMax - xMin), 1.0);
+  }
+  // a sample needs order + 1 points; with fewer the normal equations are
+  // singular and solveNormal takes their least norm solution
+  bool sampled = mode == FIT_RANSAC
+      && count > static_cast<std::size_t>(order)
+      && bestSample(xs, ys, stride, count, center, scale, domainCoeffs);
+  if (sampled) {
+    // least squares on the inliers of the best sample
+    accumulate(xs, ys, stride, weights, count, center, scale,
+               domainCoeffs.ptr<double>());
+    solveNormal(refitCoeffs);
+    cv::swap(domainCoeffs, refitCoeffs);
+  } else {
+    accumulate(xs, ys, stride, weights, count, center, scale, nullptr);
+    solveNormal(domainCoeffs);
+    if (mode == FIT_HUBER && !domainCoeffs.empty()) {
+      for (int iter = 0; iter < iterations; iter++) {
+        accumulate(xs, ys, stride, weights, count, center, scale,
+                   domainCoeffs.ptr<double>());
+        solveNormal(refitCoeffs);
+        cv::swap(domainCoeffs, refitCoeffs);
+      }
+    }
+  }
+  if (domainCoeffs.empty()) {
+    // all weights are zero, the points are left unfitted
+    coeffs.release();
+    return;
+  }
+  // expand sum a_k ((x - c) / s)^k into powers of x
+  const double* a = domainCoeffs.ptr<double>();
+  coeffs.create(order + 1, 1, CV_64F);
+  coeffs.setTo(cv::Scalar(0));
+  double* dst = coeffs.ptr<double>();
+  double invScalePower = 1.0;
+  for (int k = 0; k <= order; k++) {
+    // binomial C(k, j) (-c)^(k - j), from j = k down to 0
+    double term = a[k] * invScalePower;
+    for (int j = k; j >= 0; j--) {
+      dst[j] += term;
+      if (j > 0) {
+        term *= -center * j / (k - j + 1);
+      }
+    }
+    invScalePower /= scale;
+  }
+}
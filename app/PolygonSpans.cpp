@@ -0,0 +1,162 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright [2018] rohithjayarajan, Akash Guha
+ *  @file    PolygonSpans.cpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Polygon Spans Class File
+ *
+ *  @section DESCRIPTION
+ *
+ *  Rasterizes a static convex polygon once into per row spans used to
+ *  bound the per pixel loops of the lane detection pipeline.
+ *
+ */
+
+#include "PolygonSpans.hpp"
+/**
+ *   @brief Default constructor for PolygonSpans
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+PolygonSpans::PolygonSpans() {
+  beginRow = 0;
+  endRow = 0;
+}
+/**
+ *   @brief Default destructor for PolygonSpans
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+PolygonSpans::~PolygonSpans() {
+}
+/**
+ *   @brief Function to set the vertices of the convex polygon
+ *
+ *   @param vertices of type std::vector<cv::Point>
+ *   @return nothing
+ */
+void PolygonSpans::setVertices(const std::vector<cv::Point>& vertices_) {
+  vertices = vertices_;
+  spans.clear();  // rasterize again on the next update
+}
+/**
+ *   @brief Function to get the vertices of the convex polygon
+ *
+ *   @param nothing
+ *   @return vertices of type std::vector<cv::Point>
+ */
+std::vector<cv::Point> PolygonSpans::getVertices(void) const {
+  return vertices;
+}
+/**
+ *   @brief Function to rasterize the polygon if the vertices or the image
+ *          size changed since the spans were last built
+ *
+ *   @param image size of type cv::Size
+ *   @return nothing
+ */
+void PolygonSpans::update(const cv::Size& imgSize_) {
+  if (!spans.empty() && imgSize == imgSize_) {
+    return;
+  }
+  spans.assign(imgSize_.height, cv::Vec2i(0, 0));
+  beginRow = imgSize_.height;
+  endRow = 0;
+  if (vertices.size() >= 3) {
+    // rasterize with the same routine the lane mask was drawn with, so the
+    // spans cover exactly the pixels of that mask; the polygon is convex
+    // so every row is a single span
+    cv::Mat mask(imgSize_, CV_8U, cv::Scalar(0));
+    cv::fillConvexPoly(mask, vertices, 255);
+    for (int y = 0; y < imgSize_.height; y++) {
+      const uchar* maskRow = mask.ptr<uchar>(y);
+      int xBegin = 0;
+      while (xBegin < imgSize_.width && !maskRow[xBegin]) {
+        xBegin++;
+      }
+      int xEnd = imgSize_.width;
+      while (xEnd > xBegin && !maskRow[xEnd - 1]) {
+        xEnd--;
+      }
+      spans[y] = cv::Vec2i(xBegin, xEnd);
+      if (xEnd > xBegin) {
+        beginRow = std::min(beginRow, y);
+        endRow = y + 1;
+      }
+    }
+  }
+  if (endRow == 0) {
+    beginRow = 0;
+  }
+  imgSize = imgSize_;
+}
+/**
+ *   @brief Function to get the span of the polygon in a row
+ *
+ *   @param row of type int
+ *   @return [xBegin, xEnd), empty if xEnd <= xBegin, type cv::Vec2i
+ */
+cv::Vec2i PolygonSpans::getSpan(int y) const {
+  return spans[y];
+}
+/**
+ *   @brief Function to get the first row the polygon covers
+ *
+ *   @param nothing
+ *   @return row of type int
+ */
+int PolygonSpans::getBeginRow(void) const {
+  return beginRow;
+}
+/**
+ *   @brief Function to get the row after the last row the polygon covers
+ *
+ *   @param nothing
+ *   @return row of type int
+ */
+int PolygonSpans::getEndRow(void) const {
+  return endRow;
+}
+/**
+ *   @brief Function to draw the spans as a binary mask
+ *
+ *   @param binary mask of type cv::Mat
+ *   @return nothing
+ */
+void PolygonSpans::toMask(cv::Mat& mask) const {
+  mask.create(imgSize, CV_8U);
+  mask.setTo(cv::Scalar(0));
+  for (int y = beginRow; y < endRow; y++) {
+    if (spans[y][1] > spans[y][0]) {
+      mask.row(y).colRange(spans[y][0], spans[y][1]).setTo(cv::Scalar(255));
+    }
+  }
+}
@@ -0,0 +1,199 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright [2018] rohithjayarajan, Akash Guha
+ *  @file    SharedCalibration.cpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Shared Calibration Class File
+ *
+ *  @section DESCRIPTION
+ *
+ *  Builds the undistortion maps, bird's-eye geometry and lane polygon
+ *  spans of one calibration once, for every stream that shares it.
+ *
+ */
+
+#include "SharedCalibration.hpp"
+/**
+ *   @brief Function to compare two matrices element by element
+ *
+ *   @param first matrix of type cv::Mat
+ *   @param second matrix of type cv::Mat
+ *   @return true if size, type and elements are equal, type bool
+ */
+static bool isSameMat(const cv::Mat& a, const cv::Mat& b) {
+  if (a.size() != b.size() || a.type() != b.type()) {
+    return false;
+  }
+  return a.empty() || cv::norm(a, b, cv::NORM_INF) == 0;
+}
+/**
+ *   @brief Constructor building the artefacts of a calibration
+ *
+ *   @param camera matrix of type cv::Mat
+ *   @param distortion coefficients k1, k2, p1, p2, k3 of type cv::Mat
+ *   @param four vertices in the camera image of type
+ *          std::vector<cv::Point2f>
+ *   @param four vertices in the bird's-eye image, or none to use the image
+ *          corners, of type std::vector<cv::Point2f>
+ *   @param vertices of the lane polygon of type std::vector<cv::Point>
+ *   @param frame size of type cv::Size
+ *   @param true to build the fused remap instead of the undistortion maps
+ *          of type bool
+ *   @return nothing
+ */
+SharedCalibration::SharedCalibration(
+    const cv::Mat& intrinsic_, const cv::Mat& distortionCoeffs_,
+    const std::vector<cv::Point2f>& srcQuad_,
+    const std::vector<cv::Point2f>& dstQuad_,
+    const std::vector<cv::Point>& laneROIVertices_, const cv::Size& imgSize_,
+    bool fusedRemap_) {
+  CV_Assert(imgSize_.area() > 0);
+  // own copies, the caller may change its calibration afterwards
+  intrinsic = intrinsic_.clone();
+  distortionCoeffs = distortionCoeffs_.clone();
+  srcQuad = srcQuad_;
+  dstQuad = dstQuad_;
+  laneROIVertices = laneROIVertices_;
+  imgSize = imgSize_;
+  fusedRemap = fusedRemap_;
+  perspectiveGeometry.setSrcQuad(srcQuad);
+  perspectiveGeometry.setDstQuad(dstQuad);
+  perspectiveGeometry.update(imgSize);
+  laneSpans.setVertices(laneROIVertices);
+  laneSpans.update(imgSize);
+  if (fusedRemap) {
+    birdsEyeRemap.build(intrinsic, distortionCoeffs,
+                        perspectiveGeometry.getTransform(), laneROIVertices,
+                        imgSize, imgSize);
+  } else {
+    // same rectification ImageProcessing builds for itself
+    cv::initUndistortRectifyMap(intrinsic, distortionCoeffs, cv::Mat(),
+                                intrinsic, imgSize, CV_16SC2, undistortMap1,
+                                undistortMap2);
+  }
+}
+/**
+ *   @brief Default destructor for SharedCalibration
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+SharedCalibration::~SharedCalibration() {
+}
+/**
+ *   @brief Function to check if the artefacts were built from the given
+ *          calibration, for any frame size
+ *
+ *   @param camera matrix of type cv::Mat
+ *   @param distortion coefficients of type cv::Mat
+ *   @param four vertices in the camera image of type
+ *          std::vector<cv::Point2f>
+ *   @param four vertices in the bird's-eye image of type
+ *          std::vector<cv::Point2f>
+ *   @param vertices of the lane polygon of type std::vector<cv::Point>
+ *   @param true for the fused remap of type bool
+ *   @return true if the calibrations are equal, type bool
+ */
+bool SharedCalibration::matches(const cv::Mat& intrinsic_,
+                                const cv::Mat& distortionCoeffs_,
+                                const std::vector<cv::Point2f>& srcQuad_,
+                                const std::vector<cv::Point2f>& dstQuad_,
+                                const std::vector<cv::Point>& laneROIVertices_,
+                                bool fusedRemap_) const {
+  return fusedRemap == fusedRemap_ && srcQuad == srcQuad_
+      && dstQuad == dstQuad_ && laneROIVertices == laneROIVertices_
+      && isSameMat(intrinsic, intrinsic_)
+      && isSameMat(distortionCoeffs, distortionCoeffs_);
+}
+/**
+ *   @brief Function to get the frame size the artefacts are built for
+ *
+ *   @param nothing
+ *   @return frame size of type cv::Size
+ */
+cv::Size SharedCalibration::getImageSize(void) const {
+  return imgSize;
+}
+/**
+ *   @brief Function to check if the fused remap is built instead of the
+ *          undistortion maps
+ *
+ *   @param nothing
+ *   @return true for the fused remap of type bool
+ */
+bool SharedCalibration::isFusedRemap(void) const {
+  return fusedRemap;
+}
+/**
+ *   @brief Function to get the fixed-point undistortion map
+ *
+ *   @param nothing
+ *   @return map, empty with the fused remap, of type cv::Mat
+ */
+const cv::Mat& SharedCalibration::getUndistortMap1(void) const {
+  return undistortMap1;
+}
+/**
+ *   @brief Function to get the interpolation table of the undistortion
+ *          map
+ *
+ *   @param nothing
+ *   @return table, empty with the fused remap, of type cv::Mat
+ */
+const cv::Mat& SharedCalibration::getUndistortMap2(void) const {
+  return undistortMap2;
+}
+/**
+ *   @brief Function to get the bird's-eye homographies and warp maps
+ *
+ *   @param nothing
+ *   @return geometry of type PerspectiveGeometry
+ */
+const PerspectiveGeometry& SharedCalibration::getPerspectiveGeometry(
+    void) const {
+  return perspectiveGeometry;
+}
+/**
+ *   @brief Function to get the fused raw sensor to bird's-eye remap
+ *
+ *   @param nothing
+ *   @return remap, empty without the fused remap, of type BirdsEyeRemap
+ */
+const BirdsEyeRemap& SharedCalibration::getBirdsEyeRemap(void) const {
+  return birdsEyeRemap;
+}
+/**
+ *   @brief Function to get the lane polygon rasterized at the frame size
+ *
+ *   @param nothing
+ *   @return row spans of type PolygonSpans
+ */
+const PolygonSpans& SharedCalibration::getLaneSpans(void) const {
+  return laneSpans;
+}
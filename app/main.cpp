@@ -9,13 +9,142 @@
  *
  *  This program is used to implement lane detection system and
  *  curvature prediction on a video sequence or image snesor data.
+ *  Without arguments it shows the lanes of test_video.mp4; with input
+ *  videos it processes them headless into per frame CSV files.
+ *  Exit status is 0 on success, 1 if any input failed and 2 for a bad
+ *  command line.
  *
  */
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
+#include <string>
+#include <vector>
+#include "BatchProcessor.hpp"
 #include "LaneDetection.hpp"
 
-int main() {
-  LaneDetection lanes;
-  lanes.detectLanes();
-  return 0;
+/**
+ *   @brief Function to print the command line usage
+ *
+ *   @param name of the program of type char*
+ *   @return nothing
+ */
+void printUsage(const char* program) {
+  std::cerr << "Usage: " << program << " [options] <video|glob>...\n"
+      << "  -o, --output DIR      directory of the CSV files (default .)\n"
+      << "  -r, --resolution WxH  resize frames before processing\n"
+      << "  -j, --threads N       threads of the parallel loops and of the\n"
+      << "                        chunk workers; a video processed in one\n"
+      << "                        chunk always runs its 4 pipeline stages\n"
+      << "                        on their own threads, see -q\n"
+      << "  -q, --queue-depth N   frames in flight (default 4)\n"
+      << "  -c, --chunks N        split each video into N parallel time\n"
+      << "                        chunks (default 1)\n"
+      << "      --warmup N        frames replayed before a chunk to settle\n"
+      << "                        the tracker (default 30)\n"
+      << "      --tracking        search around the previous fits\n"
+      << "      --display         show the frames while processing\n"
+      << "  -h, --help            show this help\n"
+      << "Without inputs the lanes of test_video.mp4 are shown."
+      << std::endl;
+}
+/**
+ *   @brief Function to parse an integer argument of at least a minimum
+ *
+ *   @param argument of type char*
+ *   @param smallest accepted value of type int
+ *   @param parsed value of type int
+ *   @return false if not an integer of at least the minimum, type bool
+ */
+bool parseCount(const char* arg, int minValue, int& value) {
+  char* end = nullptr;
+  long parsed = std::strtol(arg, &end, 10);
+  if (end == arg || *end != '\0' || parsed < minValue || parsed > 1 << 16) {
+    return false;
+  }
+  value = static_cast<int>(parsed);
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc == 1) {
+    LaneDetection lanes;
+    return lanes.detectLanes() ? 0 : 1;
+  }
+  BatchProcessor batch;
+  std::vector<std::string> inputs;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    // options other than the flags take the next argument
+    bool hasValue = i + 1 < argc;
+    if (arg == "-h" || arg == "--help") {
+      printUsage(argv[0]);
+      return 0;
+    } else if (arg == "--tracking") {
+      batch.getLaneDetection().setTracking(true);
+    } else if (arg == "--display") {
+      batch.setDisplay(true);
+    } else if ((arg == "-o" || arg == "--output") && hasValue) {
+      batch.setOutputDir(argv[++i]);
+    } else if ((arg == "-r" || arg == "--resolution") && hasValue) {
+      int width = 0, height = 0;
+      char separator = 0;
+      if (std::sscanf(argv[++i], "%d%c%d", &width, &separator, &height) != 3
+          || separator != 'x' || width < 1 || height < 1) {
+        std::cerr << "Bad resolution " << argv[i] << std::endl;
+        return 2;
+      }
+      batch.setResolution(cv::Size(width, height));
+    } else if ((arg == "-j" || arg == "--threads") && hasValue) {
+      int numThreads = 0;
+      if (!parseCount(argv[++i], 1, numThreads)) {
+        std::cerr << "Bad thread count " << argv[i] << std::endl;
+        return 2;
+      }
+      cv::setNumThreads(numThreads);
+      batch.getChunkedProcessor().getEngine().setNumWorkers(numThreads);
+    } else if ((arg == "-q" || arg == "--queue-depth") && hasValue) {
+      int queueDepth = 0;
+      if (!parseCount(argv[++i], 1, queueDepth)) {
+        std::cerr << "Bad queue depth " << argv[i] << std::endl;
+        return 2;
+      }
+      batch.setQueueDepth(queueDepth);
+    } else if ((arg == "-c" || arg == "--chunks") && hasValue) {
+      int numChunks = 0;
+      if (!parseCount(argv[++i], 1, numChunks)) {
+        std::cerr << "Bad chunk count " << argv[i] << std::endl;
+        return 2;
+      }
+      batch.getChunkedProcessor().setNumChunks(numChunks);
+    } else if (arg == "--warmup" && hasValue) {
+      int warmupFrames = 0;
+      if (!parseCount(argv[++i], 0, warmupFrames)) {
+        std::cerr << "Bad warm-up " << argv[i] << std::endl;
+        return 2;
+      }
+      batch.getChunkedProcessor().setWarmupFrames(warmupFrames);
+    } else if (!arg.empty() && arg[0] == '-') {
+      std::cerr << "Unknown or incomplete option " << arg << std::endl;
+      printUsage(argv[0]);
+      return 2;
+    } else {
+      inputs.push_back(arg);
+    }
+  }
+  if (inputs.empty()) {
+    printUsage(argv[0]);
+    return 2;
+  }
+  std::vector<std::string> videoPaths;
+  bool isSuccess = batch.expandInputs(inputs, videoPaths);
+  for (const std::string& videoPath : videoPaths) {
+    if (batch.processVideo(videoPath)) {
+      std::cout << videoPath << " -> " << batch.getOutputPath(videoPath)
+          << std::endl;
+    } else {
+      isSuccess = false;
+    }
+  }
+  return isSuccess ? 0 : 1;
 }
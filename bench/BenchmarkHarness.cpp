@@ -0,0 +1,407 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright [2018] rohithjayarajan, Akash Guha
+ *  @file    BenchmarkHarness.cpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Benchmark Harness Class File
+ *
+ *  @section DESCRIPTION
+ *
+ *  Times named bodies on input frames and writes the results and the
+ *  speedups of optimized paths as JSON.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include "BenchmarkHarness.hpp"
+
+/**
+ *   @brief Default constructor for BenchmarkHarness
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+BenchmarkHarness::BenchmarkHarness() {
+  minTimeMs = 200.0;
+  minIterations = 5;
+  maxIterations = 1000;
+}
+/**
+ *   @brief Default destructor for BenchmarkHarness
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+BenchmarkHarness::~BenchmarkHarness() {
+}
+/**
+ *   @brief Function to set the time measured per benchmark at least
+ *
+ *   @param time in milliseconds, at least 0, of type double
+ *   @return nothing
+ */
+void BenchmarkHarness::setMinTimeMs(double minTimeMs_) {
+  CV_Assert(minTimeMs_ >= 0);
+  minTimeMs = minTimeMs_;
+}
+/**
+ *   @brief Function to get the time measured per benchmark at least
+ *
+ *   @param nothing
+ *   @return time in milliseconds of type double
+ */
+double BenchmarkHarness::getMinTimeMs(void) {
+  return minTimeMs;
+}
+/**
+ *   @brief Function to set the bounds of the timed calls per benchmark
+ *
+ *   @param least number of calls, at least 1, of type int
+ *   @param most number of calls, at least the least, of type int
+ *   @return nothing
+ */
+void BenchmarkHarness::setIterations(int minIterations_, int maxIterations_) {
+  CV_Assert(minIterations_ >= 1 && maxIterations_ >= minIterations_);
+  minIterations = minIterations_;
+  maxIterations = maxIterations_;
+}
+/**
+ *   @brief Function to get the least number of timed calls per
+ *          benchmark
+ *
+ *   @param nothing
+ *   @return number of calls of type int
+ */
+int BenchmarkHarness::getMinIterations(void) {
+  return minIterations;
+}
+/**
+ *   @brief Function to get the most timed calls per benchmark
+ *
+ *   @param nothing
+ *   @return number of calls of type int
+ */
+int BenchmarkHarness::getMaxIterations(void) {
+  return maxIterations;
+}
+/**
+ *   @brief Function to set the text the names of the benchmarks to run
+ *          contain
+ *
+ *   @param text, empty to run all, of type std::string
+ *   @return nothing
+ */
+void BenchmarkHarness::setFilter(const std::string& filter_) {
+  filter = filter_;
+}
+/**
+ *   @brief Function to get the text the names of the benchmarks to run
+ *          contain
+ *
+ *   @param nothing
+ *   @return text of type std::string
+ */
+std::string BenchmarkHarness::getFilter(void) {
+  return filter;
+}
+/**
+ *   @brief Function to check if a benchmark passes the filter
+ *
+ *   @param benchmark name of type std::string
+ *   @return true if it runs, type bool
+ */
+bool BenchmarkHarness::isSelected(const std::string& name) {
+  return name.find(filter) != std::string::npos;
+}
+/**
+ *   @brief Function to add a key and value to the context written with
+ *          the results
+ *
+ *   @param key of type std::string
+ *   @param value of type std::string
+ *   @return nothing
+ */
+void BenchmarkHarness::addContext(const std::string& key,
+                                  const std::string& value) {
+  context.push_back(std::make_pair(key, value));
+}
+/**
+ *   @brief Function to time a body on an input and keep its result
+ *
+ *   @param benchmark name of type std::string
+ *   @param input name of type std::string
+ *   @param size of the input frame of type cv::Size
+ *   @param body timed call by call of type BenchmarkHarness::Body
+ *   @return false if the filter skipped it, type bool
+ */
+bool BenchmarkHarness::run(const std::string& name, const std::string& input,
+                           const cv::Size& frameSize, const Body& body) {
+  if (!isSelected(name)) {
+    return false;
+  }
+  // the first call sizes the buffers and warms the caches
+  body();
+  std::vector<double> samplesMs;
+  double totalMs = 0;
+  double msPerTick = 1000.0 / cv::getTickFrequency();
+  while (static_cast<int>(samplesMs.size()) < maxIterations
+      && (static_cast<int>(samplesMs.size()) < minIterations
+          || totalMs < minTimeMs)) {
+    int64 begin = cv::getTickCount();
+    body();
+    double sampleMs = (cv::getTickCount() - begin) * msPerTick;
+    samplesMs.push_back(sampleMs);
+    totalMs += sampleMs;
+  }
+  Result result;
+  result.name = name;
+  result.input = input;
+  result.frameSize = frameSize;
+  result.iterations = static_cast<int>(samplesMs.size());
+  result.meanMs = totalMs / samplesMs.size();
+  double sumSquares = 0;
+  for (double sampleMs : samplesMs) {
+    sumSquares += (sampleMs - result.meanMs) * (sampleMs - result.meanMs);
+  }
+  result.stdDevMs = std::sqrt(sumSquares / samplesMs.size());
+  std::sort(samplesMs.begin(), samplesMs.end());
+  std::size_t middle = samplesMs.size() / 2;
+  result.medianMs = (samplesMs.size() % 2) ? samplesMs[middle]
+      : 0.5 * (samplesMs[middle - 1] + samplesMs[middle]);
+  result.minMs = samplesMs.front();
+  results.push_back(result);
+  return true;
+}
+/**
+ *   @brief Function to report the speedup of an optimized benchmark over
+ *          its reference on every input both ran on
+ *
+ *   @param optimized benchmark name of type std::string
+ *   @param reference benchmark name of type std::string
+ *   @return nothing
+ */
+void BenchmarkHarness::addComparison(const std::string& optimized,
+                                     const std::string& reference) {
+  comparisons.push_back(std::make_pair(optimized, reference));
+}
+/**
+ *   @brief Function to keep an accuracy metric of a path on an input
+ *
+ *   @param path name of type std::string
+ *   @param input name of type std::string
+ *   @param metric name of type std::string
+ *   @param value of type double
+ *   @return nothing
+ */
+void BenchmarkHarness::addMetric(const std::string& name,
+                                 const std::string& input,
+                                 const std::string& key, double value) {
+  Metric metric;
+  metric.name = name;
+  metric.input = input;
+  metric.key = key;
+  metric.value = value;
+  metrics.push_back(metric);
+}
+/**
+ *   @brief Function to get the accuracy metrics in the order they were
+ *          added
+ *
+ *   @param nothing
+ *   @return metrics of type std::vector<BenchmarkHarness::Metric>
+ */
+const std::vector<BenchmarkHarness::Metric>& BenchmarkHarness::getMetrics(
+    void) {
+  return metrics;
+}
+/**
+ *   @brief Function to get the results in the order they ran
+ *
+ *   @param nothing
+ *   @return results of type std::vector<BenchmarkHarness::Result>
+ */
+const std::vector<BenchmarkHarness::Result>& BenchmarkHarness::getResults(
+    void) {
+  return results;
+}
+/**
+ *   @brief Function to find the result of a benchmark on an input
+ *
+ *   @param benchmark name of type std::string
+ *   @param input name of type std::string
+ *   @return result, nullptr if it did not run, of type
+ *           BenchmarkHarness::Result*
+ */
+const BenchmarkHarness::Result* BenchmarkHarness::findResult(
+    const std::string& name, const std::string& input) {
+  for (const Result& result : results) {
+    if (result.name == name && result.input == input) {
+      return &result;
+    }
+  }
+  return nullptr;
+}
+/**
+ *   @brief Function to forget the results and the accuracy metrics
+ *
+ *   @param nothing
+ *   @return nothing
+ */
+void BenchmarkHarness::clearResults(void) {
+  results.clear();
+  metrics.clear();
+}
+/**
+ *   @brief Function to write a string as a JSON string
+ *
+ *   @param JSON output of type std::ostream
+ *   @param text of type std::string
+ *   @return nothing
+ */
+void BenchmarkHarness::writeString(std::ostream& out,
+                                   const std::string& text) {
+  static const char hexDigits[] = "0123456789abcdef";
+  out << '"';
+  for (char c : text) {
+    unsigned char code = static_cast<unsigned char>(c);
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (code < 0x20) {
+      // control characters as \u00XX
+      out << "\\u00" << hexDigits[code >> 4] << hexDigits[code & 0xf];
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+/**
+ *   @brief Function to write a number as JSON, null if it is not finite
+ *
+ *   @param JSON output of type std::ostream
+ *   @param value of type double
+ *   @return nothing
+ */
+void BenchmarkHarness::writeNumber(std::ostream& out, double value) {
+  if (std::isfinite(value)) {
+    out << value;
+  } else {
+    out << "null";
+  }
+}
+/**
+ *   @brief Function to write the context of the run, the results, the
+ *          comparisons and the accuracy metrics as JSON
+ *
+ *   @param JSON output of type std::ostream
+ *   @return nothing
+ */
+void BenchmarkHarness::writeJson(std::ostream& out) {
+  std::streamsize oldPrecision = out.precision(6);
+  char date[32] = "";
+  std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+  out << "{\n  \"context\": {\n    \"date\": ";
+  writeString(out, date);
+  out << ",\n    \"opencv_version\": ";
+  writeString(out, CV_VERSION);
+  out << ",\n    \"num_cpus\": " << cv::getNumberOfCPUs()
+      << ",\n    \"num_threads\": " << cv::getNumThreads()
+      << ",\n    \"min_time_ms\": ";
+  writeNumber(out, minTimeMs);
+  out << ",\n    \"min_iterations\": " << minIterations
+      << ",\n    \"max_iterations\": " << maxIterations;
+  for (const auto& entry : context) {
+    out << ",\n    ";
+    writeString(out, entry.first);
+    out << ": ";
+    writeString(out, entry.second);
+  }
+  out << "\n  },\n  \"benchmarks\": [";
+  for (std::size_t i = 0; i < results.size(); i++) {
+    const Result& result = results[i];
+    out << (i ? ",\n" : "\n") << "    {\"name\": ";
+    writeString(out, result.name);
+    out << ", \"input\": ";
+    writeString(out, result.input);
+    out << ", \"width\": " << result.frameSize.width
+        << ", \"height\": " << result.frameSize.height
+        << ", \"iterations\": " << result.iterations << ", \"mean_ms\": ";
+    writeNumber(out, result.meanMs);
+    out << ", \"median_ms\": ";
+    writeNumber(out, result.medianMs);
+    out << ", \"min_ms\": ";
+    writeNumber(out, result.minMs);
+    out << ", \"stddev_ms\": ";
+    writeNumber(out, result.stdDevMs);
+    out << "}";
+  }
+  out << (results.empty() ? "]" : "\n  ]") << ",\n  \"comparisons\": [";
+  bool isFirst = true;
+  for (const auto& comparison : comparisons) {
+    for (const Result& optimized : results) {
+      if (optimized.name != comparison.first) {
+        continue;
+      }
+      const Result* reference = findResult(comparison.second,
+                                           optimized.input);
+      if (!reference) {
+        continue;
+      }
+      out << (isFirst ? "\n" : ",\n") << "    {\"optimized\": ";
+      writeString(out, comparison.first);
+      out << ", \"reference\": ";
+      writeString(out, comparison.second);
+      out << ", \"input\": ";
+      writeString(out, optimized.input);
+      // medians are robust to the odd preempted call
+      out << ", \"speedup\": ";
+      writeNumber(out, reference->medianMs / optimized.medianMs);
+      out << "}";
+      isFirst = false;
+    }
+  }
+  out << (isFirst ? "]" : "\n  ]") << ",\n  \"accuracy\": [";
+  for (std::size_t i = 0; i < metrics.size(); i++) {
+    const Metric& metric = metrics[i];
+    out << (i ? ",\n" : "\n") << "    {\"name\": ";
+    writeString(out, metric.name);
+    out << ", \"input\": ";
+    writeString(out, metric.input);
+    out << ", \"metric\": ";
+    writeString(out, metric.key);
+    out << ", \"value\": ";
+    writeNumber(out, metric.value);
+    out << "}";
+  }
+  out << (metrics.empty() ? "]" : "\n  ]") << "\n}" << std::endl;
+  out.precision(oldPrecision);
+}
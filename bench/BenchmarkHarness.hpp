@@ -0,0 +1,269 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    BenchmarkHarness.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Benchmark Harness Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for the in-tree micro-benchmark harness of lane-bench.
+ *  A benchmark is a named body run on an input frame: after one untimed
+ *  call the body is timed call by call until both the minimum time and
+ *  the minimum number of iterations are reached, or the maximum number
+ *  of iterations is. The results, the speedup of optimized paths over
+ *  their reference paths on every input and the accuracy metrics of the
+ *  approximate paths are written as JSON so runs of different releases
+ *  can be compared.
+ *
+ */
+
+#ifndef BENCH_BENCHMARKHARNESS_HPP_
+#define BENCH_BENCHMARKHARNESS_HPP_
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "opencv2/core/core.hpp"
+
+class BenchmarkHarness {
+ public:
+  /**
+   *  Timings of a benchmark on one input, in milliseconds per call
+   */
+  struct Result {
+    std::string name;  // stage and path, e.g. generateHist/packed
+    std::string input;  // frame the body ran on
+    cv::Size frameSize;  // size of that frame
+    int iterations;  // timed calls
+    double meanMs;
+    double medianMs;
+    double minMs;
+    double stdDevMs;
+  };
+  /**
+   *  Accuracy of an approximate path on one input, e.g. how far its lanes
+   *  are from the lanes of the full resolution search
+   */
+  struct Metric {
+    std::string name;  // stage and path, e.g. endToEnd/pyramid_1
+    std::string input;  // frame the path ran on
+    std::string key;  // what is measured, e.g. mean_col_dev_px
+    double value;
+  };
+  typedef std::function<void(void)> Body;
+
+ private:
+  double minTimeMs;  // time measured per benchmark at least
+  int minIterations;  // calls timed per benchmark at least
+  int maxIterations;  // calls timed per benchmark at most
+  std::string filter;  // only names containing it run, empty for all
+  // keys and values describing the run, e.g. the build type
+  std::vector<std::pair<std::string, std::string> > context;
+  std::vector<Result> results;
+  // pairs of optimized and reference benchmark names
+  std::vector<std::pair<std::string, std::string> > comparisons;
+  std::vector<Metric> metrics;  // accuracy metrics in the order added
+  /**
+   *   @brief Function to write a string as a JSON string
+   *
+   *   @param JSON output of type std::ostream
+   *   @param text of type std::string
+   *   @return nothing
+   */
+  static void writeString(std::ostream& out, const std::string& text);
+  /**
+   *   @brief Function to write a number as JSON, null if it is not finite
+   *
+   *   @param JSON output of type std::ostream
+   *   @param value of type double
+   *   @return nothing
+   */
+  static void writeNumber(std::ostream& out, double value);
+
+ public:
+  /**
+   *   @brief Default constructor for BenchmarkHarness
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  BenchmarkHarness();
+  /**
+   *   @brief Default destructor for BenchmarkHarness
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ~BenchmarkHarness();
+  /**
+   *   @brief Function to set the time measured per benchmark at least
+   *
+   *   @param time in milliseconds, at least 0, of type double
+   *   @return nothing
+   */
+  void setMinTimeMs(double minTimeMs_);
+  /**
+   *   @brief Function to get the time measured per benchmark at least
+   *
+   *   @param nothing
+   *   @return time in milliseconds of type double
+   */
+  double getMinTimeMs(void);
+  /**
+   *   @brief Function to set the bounds of the timed calls per benchmark
+   *
+   *   @param least number of calls, at least 1, of type int
+   *   @param most number of calls, at least the least, of type int
+   *   @return nothing
+   */
+  void setIterations(int minIterations_, int maxIterations_);
+  /**
+   *   @brief Function to get the least number of timed calls per
+   *          benchmark
+   *
+   *   @param nothing
+   *   @return number of calls of type int
+   */
+  int getMinIterations(void);
+  /**
+   *   @brief Function to get the most timed calls per benchmark
+   *
+   *   @param nothing
+   *   @return number of calls of type int
+   */
+  int getMaxIterations(void);
+  /**
+   *   @brief Function to set the text the names of the benchmarks to run
+   *          contain
+   *
+   *   @param text, empty to run all, of type std::string
+   *   @return nothing
+   */
+  void setFilter(const std::string& filter_);
+  /**
+   *   @brief Function to get the text the names of the benchmarks to run
+   *          contain
+   *
+   *   @param nothing
+   *   @return text of type std::string
+   */
+  std::string getFilter(void);
+  /**
+   *   @brief Function to check if a benchmark passes the filter
+   *
+   *   @param benchmark name of type std::string
+   *   @return true if it runs, type bool
+   */
+  bool isSelected(const std::string& name);
+  /**
+   *   @brief Function to add a key and value to the context written with
+   *          the results
+   *
+   *   @param key of type std::string
+   *   @param value of type std::string
+   *   @return nothing
+   */
+  void addContext(const std::string& key, const std::string& value);
+  /**
+   *   @brief Function to time a body on an input and keep its result
+   *
+   *   @param benchmark name of type std::string
+   *   @param input name of type std::string
+   *   @param size of the input frame of type cv::Size
+   *   @param body timed call by call of type BenchmarkHarness::Body
+   *   @return false if the filter skipped it, type bool
+   */
+  bool run(const std::string& name, const std::string& input,
+           const cv::Size& frameSize, const Body& body);
+  /**
+   *   @brief Function to report the speedup of an optimized benchmark over
+   *          its reference on every input both ran on
+   *
+   *   @param optimized benchmark name of type std::string
+   *   @param reference benchmark name of type std::string
+   *   @return nothing
+   */
+  void addComparison(const std::string& optimized,
+                     const std::string& reference);
+  /**
+   *   @brief Function to keep an accuracy metric of a path on an input
+   *
+   *   @param path name of type std::string
+   *   @param input name of type std::string
+   *   @param metric name of type std::string
+   *   @param value of type double
+   *   @return nothing
+   */
+  void addMetric(const std::string& name, const std::string& input,
+                 const std::string& key, double value);
+  /**
+   *   @brief Function to get the accuracy metrics in the order they were
+   *          added
+   *
+   *   @param nothing
+   *   @return metrics of type std::vector<BenchmarkHarness::Metric>
+   */
+  const std::vector<Metric>& getMetrics(void);
+  /**
+   *   @brief Function to get the results in the order they ran
+   *
+   *   @param nothing
+   *   @return results of type std::vector<BenchmarkHarness::Result>
+   */
+  const std::vector<Result>& getResults(void);
+  /**
+   *   @brief Function to find the result of a benchmark on an input
+   *
+   *   @param benchmark name of type std::string
+   *   @param input name of type std::string
+   *   @return result, nullptr if it did not run, of type
+   *           BenchmarkHarness::Result*
+   */
+  const Result* findResult(const std::string& name,
+                           const std::string& input);
+  /**
+   *   @brief Function to forget the results and the accuracy metrics
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void clearResults(void);
+  /**
+   *   @brief Function to write the context of the run, the results, the
+   *          comparisons and the accuracy metrics as JSON
+   *
+   *   @param JSON output of type std::ostream
+   *   @return nothing
+   */
+  void writeJson(std::ostream& out);
+};
+
+#endif  // BENCH_BENCHMARKHARNESS_HPP_
@@ -0,0 +1,503 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    main.cpp
+ *  @author  Akash Guha, rohithjayarajan
+ *
+ *  @brief Lane Detection Benchmark
+ *
+ *  @section DESCRIPTION
+ *
+ *  This program times each stage of the lane detection on the bundled
+ *  frames and on synthetic frames of several resolutions, and writes
+ *  the timings, the speedups of the optimized paths over their
+ *  reference paths, e.g. FixedPointRemap over cv::remap, and the lane
+ *  deviation of the pyramid searches from the full resolution search as
+ *  JSON. Exit status is 0 on success, 1 if no input could be read and 2
+ *  for a bad command line.
+ *
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "opencv2/highgui/highgui.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+#include "BenchmarkHarness.hpp"
+#include "FixedPointRemap.hpp"
+#include "LaneDetection.hpp"
+
+// frames the default calibration is for
+static const cv::Size calibratedSize(1280, 720);
+
+/**
+ *   @brief Function to print the command line usage
+ *
+ *   @param name of the program of type char*
+ *   @return nothing
+ */
+void printUsage(const char* program) {
+  std::cerr << "Usage: " << program << " [options]\n"
+      << "  -o, --output FILE     JSON file (default standard output)\n"
+      << "  -i, --images GLOB     frames to time (default ../images/*.png)\n"
+      << "  -s, --sizes LIST      synthetic frame sizes, e.g.\n"
+      << "                        640x360,1920x1080 (default 640x360,\n"
+      << "                        1280x720,1920x1080), none for no\n"
+      << "                        synthetic frames\n"
+      << "  -t, --min-time MS     time measured per benchmark (default "
+      << "200)\n"
+      << "  -f, --filter TEXT     only benchmarks whose names contain it\n"
+      << "  -j, --threads N       threads of the parallel loops\n"
+      << "  -h, --help            show this help" << std::endl;
+}
+/**
+ *   @brief Function to parse a list of frame sizes
+ *
+ *   @param comma separated sizes WxH, or none, of type std::string
+ *   @param parsed sizes of type std::vector<cv::Size>
+ *   @return false if a size is malformed, type bool
+ */
+bool parseSizes(const std::string& arg, std::vector<cv::Size>& sizes) {
+  sizes.clear();
+  if (arg == "none") {
+    return true;
+  }
+  std::istringstream items(arg);
+  std::string item;
+  while (std::getline(items, item, ',')) {
+    int width = 0, height = 0;
+    char separator = 0;
+    if (std::sscanf(item.c_str(), "%d%c%d", &width, &separator, &height) != 3
+        || separator != 'x' || width < 64 || height < 64) {
+      return false;
+    }
+    sizes.push_back(cv::Size(width, height));
+  }
+  return !sizes.empty();
+}
+/**
+ *   @brief Function to draw a road with a solid yellow and a dashed white
+ *          lane, scaled from the calibrated frame size
+ *
+ *   @param frame size of type cv::Size
+ *   @return synthetic frame of type cv::Mat
+ */
+cv::Mat syntheticFrame(const cv::Size& size) {
+  double sx = size.width / static_cast<double>(calibratedSize.width);
+  double sy = size.height / static_cast<double>(calibratedSize.height);
+  cv::Mat frame(size, CV_8UC3, cv::Scalar(90, 95, 100));
+  // asphalt texture, the same for every run
+  cv::Mat texture(size, CV_8UC3);
+  cv::RNG rng(0x1a2b3c4d);
+  rng.fill(texture, cv::RNG::UNIFORM, 0, 24);
+  frame += texture;
+  int thickness = std::max(1, cvRound(12 * sx));
+  cv::line(frame, cv::Point(cvRound(600 * sx), cvRound(440 * sy)),
+           cv::Point(cvRound(320 * sx), cvRound(670 * sy)),
+           cv::Scalar(0, 210, 240), thickness);
+  for (int dash = 0; dash < 4; dash++) {
+    double begin = dash / 4.0, end = begin + 0.15;
+    cv::line(frame, cv::Point(cvRound((680 + 380 * begin) * sx),
+                              cvRound((440 + 230 * begin) * sy)),
+             cv::Point(cvRound((680 + 380 * end) * sx),
+                       cvRound((440 + 230 * end) * sy)),
+             cv::Scalar(235, 235, 235), thickness);
+  }
+  return frame;
+}
+/**
+ *   @brief Function to scale the default calibration, quadrilaterals and
+ *          regions of interest from the calibrated frame size
+ *
+ *   @param lane detection to configure of type LaneDetection
+ *   @param frame size of type cv::Size
+ *   @return nothing
+ */
+void scaleCalibration(LaneDetection& lanes, const cv::Size& size) {
+  if (size == calibratedSize) {
+    return;
+  }
+  double sx = size.width / static_cast<double>(calibratedSize.width);
+  double sy = size.height / static_cast<double>(calibratedSize.height);
+  ImageProcessing& processImage = lanes.getImageProcessing();
+  cv::Mat intrinsic = processImage.getIntrinsic();
+  processImage.setIntrinsic(intrinsic.at<double>(0, 0) * sx,
+                            intrinsic.at<double>(1, 1) * sy,
+                            intrinsic.at<double>(0, 2) * sx,
+                            intrinsic.at<double>(1, 2) * sy);
+  const PerspectiveGeometry& geometry =
+      processImage.getPerspectiveGeometry();
+  std::vector<cv::Point2f> srcQuad = geometry.getSrcQuad();
+  std::vector<cv::Point2f> dstQuad = geometry.getDstQuad();
+  for (cv::Point2f& point : srcQuad) {
+    point = cv::Point2f(point.x * sx, point.y * sy);
+  }
+  for (cv::Point2f& point : dstQuad) {
+    point = cv::Point2f(point.x * sx, point.y * sy);
+  }
+  processImage.setPerspectiveQuads(srcQuad, dstQuad);
+  std::vector<cv::Point> laneROI = processImage.getLaneROI();
+  for (cv::Point& point : laneROI) {
+    point = cv::Point(cvRound(point.x * sx), cvRound(point.y * sy));
+  }
+  processImage.setLaneROI(laneROI);
+  cv::Rect roi = processImage.getROI();
+  processImage.setROI(cv::Rect(cvRound(roi.x * sx), cvRound(roi.y * sy),
+                               cvRound(roi.width * sx),
+                               cvRound(roi.height * sy)));
+}
+/**
+ *   @brief Function to evaluate a lane fit at a bird's-eye row
+ *
+ *   @param coefficients in increasing order of power, as a column of
+ *          CV_64F, of type cv::Mat
+ *   @param bird's-eye row of type double
+ *   @return lane column of type double
+ */
+double evaluateFit(const cv::Mat& laneFit, double row) {
+  const double* coeffs = laneFit.ptr<double>();
+  int order = static_cast<int>(laneFit.total()) - 1;
+  double col = coeffs[order];
+  for (int k = order - 1; k >= 0; k--) {
+    col = col * row + coeffs[k];
+  }
+  return col;
+}
+/**
+ *   @brief Function to keep how far the lanes of an approximate search are
+ *          from the lanes of the full resolution search of the same frame:
+ *          the mean and largest column deviation over the bird's-eye rows
+ *          and the largest column delta at the base row. The metrics are
+ *          null if a lane is fitted by only one of the searches
+ *
+ *   @param harness keeping the metrics of type BenchmarkHarness
+ *   @param approximate path name of type std::string
+ *   @param input name of type std::string
+ *   @param fits of the full resolution search of type cv::Mat*
+ *   @param fits of the approximate search of type cv::Mat*
+ *   @param rows of the bird's-eye view of type int
+ *   @return nothing
+ */
+void addLaneDeviation(BenchmarkHarness& bench, const std::string& name,
+                      const std::string& input, const cv::Mat* referenceFits,
+                      const cv::Mat* laneFits, int rows) {
+  double sumDev = 0.0, maxDev = 0.0, baseDelta = 0.0;
+  int numRows = 0;
+  for (int lane = 0; lane < LaneTracker::NUM_LANES; lane++) {
+    if (referenceFits[lane].empty() && laneFits[lane].empty()) {
+      continue;
+    }
+    if (referenceFits[lane].empty() || laneFits[lane].empty()) {
+      // a lane lost or found by the approximation only
+      sumDev = maxDev = baseDelta = std::numeric_limits<double>::quiet_NaN();
+      break;
+    }
+    for (int row = 0; row < rows; row++) {
+      double dev = std::abs(evaluateFit(laneFits[lane], row)
+          - evaluateFit(referenceFits[lane], row));
+      sumDev += dev;
+      maxDev = std::max(maxDev, dev);
+      numRows++;
+    }
+    // the base is where the lane meets the bottom row
+    baseDelta = std::max(baseDelta, std::abs(
+        evaluateFit(laneFits[lane], rows - 1)
+            - evaluateFit(referenceFits[lane], rows - 1)));
+  }
+  bench.addMetric(name, input, "mean_col_dev_px",
+                  numRows ? sumDev / numRows : sumDev);
+  bench.addMetric(name, input, "max_col_dev_px", maxDev);
+  bench.addMetric(name, input, "base_col_delta_px", baseDelta);
+}
+/**
+ *   @brief Function to time each stage and the whole frame on an input
+ *
+ *   @param harness keeping the results of type BenchmarkHarness
+ *   @param input name of type std::string
+ *   @param input frame of type cv::Mat
+ *   @return nothing
+ */
+void benchFrame(BenchmarkHarness& bench, const std::string& input,
+                const cv::Mat& inputFrame) {
+  cv::Size size = inputFrame.size();
+  cv::Mat frame = inputFrame.clone();
+  LaneDetection lanes;
+  lanes.getVisualizer().setMode(LaneVisualizer::VISUALIZE_NONE);
+  scaleCalibration(lanes, size);
+  ImageProcessing& processImage = lanes.getImageProcessing();
+  FrameWorkspace workspace;
+  workspace.allocate(size);
+  // every stage gets the output of the previous optimized stage
+  cv::Mat processed, binary, birdsEye, T_perspective_inv;
+  bench.run("preProcessing/reference", input, size, [&]() {
+    processImage.preProcessing(frame, processed);
+  });
+  bench.run("preProcessing/workspace", input, size, [&]() {
+    processImage.preProcessing(frame, processed, workspace);
+  });
+  if (bench.isSelected("preProcessing/roi")) {
+    LaneDetection roiLanes;
+    scaleCalibration(roiLanes, size);
+    roiLanes.getImageProcessing().setROIProcessing(true);
+    cv::Mat roiProcessed;
+    bench.run("preProcessing/roi", input, size, [&]() {
+      roiLanes.getImageProcessing().preProcessing(frame, roiProcessed,
+                                                  workspace);
+    });
+  }
+  processImage.preProcessing(frame, processed, workspace);
+  bench.run("getBinaryImg", input, size, [&]() {
+    processImage.getBinaryImg(processed, binary);
+  });
+  processImage.getBinaryImg(processed, binary);
+  // the undistortion maps through cv::remap, which the pipeline uses, and
+  // through the scalar FixedPointRemap, on the frame and on the lane mask
+  std::shared_ptr<const SharedCalibration> calibration =
+      processImage.buildSharedCalibration(size);
+  const cv::Mat& map1 = calibration->getUndistortMap1();
+  const cv::Mat& map2 = calibration->getUndistortMap2();
+  cv::Mat remappedFrame, remappedMask;
+  bench.run("remap/cv_remap", input, size, [&]() {
+    cv::remap(frame, remappedFrame, map1, map2, cv::INTER_LINEAR,
+              cv::BORDER_CONSTANT);
+  });
+  bench.run("remap/fixed_point", input, size, [&]() {
+    FixedPointRemap::remap(frame, remappedFrame, map1, map2);
+  });
+  bench.run("remap/cv_remap_mask", input, size, [&]() {
+    cv::remap(binary, remappedMask, map1, map2, cv::INTER_LINEAR,
+              cv::BORDER_CONSTANT);
+  });
+  bench.run("remap/fixed_point_mask", input, size, [&]() {
+    FixedPointRemap::remap(binary, remappedMask, map1, map2);
+  });
+  PackedBinaryImage& packed = workspace.getPackedPerspective();
+  bench.run("prespectiveTransform/dense", input, size, [&]() {
+    processImage.prespectiveTransform(binary, birdsEye, T_perspective_inv);
+  });
+  bench.run("prespectiveTransform/packed", input, size, [&]() {
+    processImage.prespectiveTransform(binary, packed, T_perspective_inv,
+                                      workspace);
+  });
+  processImage.prespectiveTransform(binary, birdsEye, T_perspective_inv);
+  processImage.prespectiveTransform(binary, packed, T_perspective_inv,
+                                    workspace);
+  OccupancyIntegral& occupancy = workspace.getOccupancy();
+  std::vector<double> hist;
+  bench.run("generateHist/dense", input, size, [&]() {
+    lanes.generateHist(birdsEye, hist);
+  });
+  bench.run("generateHist/packed", input, size, [&]() {
+    lanes.generateHist(packed, hist);
+  });
+  // the table is built once per frame and reused by the window search
+  bench.run("generateHist/occupancy", input, size, [&]() {
+    occupancy.build(packed);
+    lanes.generateHist(occupancy, hist);
+  });
+  occupancy.build(packed);
+  lanes.generateHist(packed, hist);
+  std::vector<cv::Point> leftLane, rightLane;
+  cv::Mat drawWindow;
+  // the searches pack, build the table and gather the lane pixels in
+  // their own workspace, so only the search is timed and packed is kept
+  FrameWorkspace laneWorkspace;
+  bench.run("extractLane/dense", input, size, [&]() {
+    leftLane.clear();
+    rightLane.clear();
+    lanes.extractLane(birdsEye, hist, leftLane, "Left", drawWindow,
+                      laneWorkspace);
+    lanes.extractLane(birdsEye, hist, rightLane, "Right", drawWindow,
+                      laneWorkspace);
+  });
+  bench.run("extractLane/packed", input, size, [&]() {
+    leftLane.clear();
+    rightLane.clear();
+    lanes.extractLane(packed, hist, leftLane, "Left", drawWindow,
+                      laneWorkspace);
+    lanes.extractLane(packed, hist, rightLane, "Right", drawWindow,
+                      laneWorkspace);
+  });
+  bench.run("extractLane/occupancy", input, size, [&]() {
+    leftLane.clear();
+    rightLane.clear();
+    lanes.extractLane(packed, occupancy, hist, leftLane, "Left", drawWindow,
+                      laneWorkspace);
+    lanes.extractLane(packed, occupancy, hist, rightLane, "Right",
+                      drawWindow, laneWorkspace);
+  });
+  // fit the lane pixels found, or a synthetic curve on an empty frame;
+  // the points are (row, column), the order of the legacy lane interface
+  if (leftLane.size() < 3) {
+    leftLane.clear();
+    for (int y = 0; y < size.height; y += 2) {
+      leftLane.push_back(cv::Point(y, size.width / 4 + y * y / size.height));
+    }
+  }
+  LanePointSet leftLanePts;
+  leftLanePts.reserve(leftLane.size(), 1);
+  for (const cv::Point& point : leftLane) {
+    leftLanePts.push(point.y, point.x);
+  }
+  leftLanePts.endWindow();
+  cv::Mat laneFit;
+  bench.run("fitPoly/points", input, size, [&]() {
+    lanes.fitPoly(leftLane, laneFit, 2);
+  });
+  PolyFitter& laneFitter = lanes.getLaneFitter();
+  bench.run("fitPoly/point_set", input, size, [&]() {
+    laneFitter.fit(leftLanePts, laneFit);
+  });
+  // lanes of the full resolution search the pyramid searches are measured
+  // against
+  LaneDetection referenceLanes;
+  referenceLanes.getVisualizer().setMode(LaneVisualizer::VISUALIZE_NONE);
+  referenceLanes.setLaneFitting(true);
+  scaleCalibration(referenceLanes, size);
+  FrameWorkspace referenceWorkspace;
+  referenceWorkspace.allocate(size);
+  referenceLanes.processFrame(frame, referenceWorkspace);
+  // whole frames, each path with its own settings
+  const char* const paths[] = { "reference", "pyramid_1", "pyramid_2",
+      "fused_remap", "tracking" };
+  for (const char* path : paths) {
+    std::string name = std::string("endToEnd/") + path;
+    if (!bench.isSelected(name)) {
+      continue;
+    }
+    LaneDetection frameLanes;
+    frameLanes.getVisualizer().setMode(LaneVisualizer::VISUALIZE_NONE);
+    frameLanes.setLaneFitting(true);
+    scaleCalibration(frameLanes, size);
+    if (name == "endToEnd/pyramid_1") {
+      frameLanes.setPyramidLevel(1);
+    } else if (name == "endToEnd/pyramid_2") {
+      frameLanes.setPyramidLevel(2);
+    } else if (name == "endToEnd/fused_remap") {
+      frameLanes.getImageProcessing().setFusedRemap(true);
+    } else if (name == "endToEnd/tracking") {
+      // the same frame again, so searches after the first are tracked
+      frameLanes.setTracking(true);
+    }
+    FrameWorkspace frameWorkspace;
+    frameWorkspace.allocate(size);
+    bench.run(name, input, size, [&]() {
+      frameLanes.processFrame(frame, frameWorkspace);
+    });
+    if (frameLanes.getPyramidLevel() > 0) {
+      // every call searched the same frame, so the fits are those of any
+      addLaneDeviation(bench, name, input, referenceWorkspace.getLaneFits(),
+                       frameWorkspace.getLaneFits(),
+                       frameWorkspace.getPackedPerspective().getSize().height);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  BenchmarkHarness bench;
+  std::string outputPath;
+  std::string imageGlob = "../images/*.png";
+  std::vector<cv::Size> sizes = { cv::Size(640, 360), cv::Size(1280, 720),
+      cv::Size(1920, 1080) };
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    // options other than the flags take the next argument
+    bool hasValue = i + 1 < argc;
+    if (arg == "-h" || arg == "--help") {
+      printUsage(argv[0]);
+      return 0;
+    } else if ((arg == "-o" || arg == "--output") && hasValue) {
+      outputPath = argv[++i];
+    } else if ((arg == "-i" || arg == "--images") && hasValue) {
+      imageGlob = argv[++i];
+    } else if ((arg == "-s" || arg == "--sizes") && hasValue) {
+      if (!parseSizes(argv[++i], sizes)) {
+        std::cerr << "Bad sizes " << argv[i] << std::endl;
+        return 2;
+      }
+    } else if ((arg == "-t" || arg == "--min-time") && hasValue) {
+      char* end = nullptr;
+      double minTimeMs = std::strtod(argv[++i], &end);
+      if (end == argv[i] || *end != '\0' || !(minTimeMs >= 0)) {
+        std::cerr << "Bad minimum time " << argv[i] << std::endl;
+        return 2;
+      }
+      bench.setMinTimeMs(minTimeMs);
+    } else if ((arg == "-f" || arg == "--filter") && hasValue) {
+      bench.setFilter(argv[++i]);
+    } else if ((arg == "-j" || arg == "--threads") && hasValue) {
+      char* end = nullptr;
+      long numThreads = std::strtol(argv[++i], &end, 10);
+      if (end == argv[i] || *end != '\0' || numThreads < 1
+          || numThreads > 1 << 16) {
+        std::cerr << "Bad thread count " << argv[i] << std::endl;
+        return 2;
+      }
+      cv::setNumThreads(static_cast<int>(numThreads));
+    } else {
+      std::cerr << "Unknown or incomplete option " << arg << std::endl;
+      printUsage(argv[0]);
+      return 2;
+    }
+  }
+  bench.addContext("build_type", LANE_BENCH_BUILD_TYPE);
+  bench.addComparison("preProcessing/workspace", "preProcessing/reference");
+  bench.addComparison("preProcessing/roi", "preProcessing/reference");
+  bench.addComparison("remap/fixed_point", "remap/cv_remap");
+  bench.addComparison("remap/fixed_point_mask", "remap/cv_remap_mask");
+  bench.addComparison("prespectiveTransform/packed",
+                      "prespectiveTransform/dense");
+  bench.addComparison("generateHist/packed", "generateHist/dense");
+  bench.addComparison("generateHist/occupancy", "generateHist/dense");
+  bench.addComparison("extractLane/packed", "extractLane/dense");
+  bench.addComparison("extractLane/occupancy", "extractLane/dense");
+  bench.addComparison("fitPoly/point_set", "fitPoly/points");
+  bench.addComparison("endToEnd/pyramid_1", "endToEnd/reference");
+  bench.addComparison("endToEnd/pyramid_2", "endToEnd/reference");
+  bench.addComparison("endToEnd/fused_remap", "endToEnd/reference");
+  bench.addComparison("endToEnd/tracking", "endToEnd/reference");
+  std::vector<cv::String> imagePaths;
+  if (!imageGlob.empty()) {
+    cv::glob(imageGlob, imagePaths, false);
+  }
+  int numInputs = 0;
+  for (const cv::String& imagePath : imagePaths) {
+    cv::Mat image = cv::imread(imagePath, cv::IMREAD_COLOR);
+    if (image.empty()) {
+      std::cerr << "Can not read " << imagePath << std::endl;
+      continue;
+    }
+    std::cerr << "Timing " << imagePath << std::endl;
+    benchFrame(bench, imagePath, image);
+    numInputs++;
+  }
+  for (const cv::Size& size : sizes) {
+    std::ostringstream input;
+    input << "synthetic_" << size.width << "x" << size.height;
+    std::cerr << "Timing " << input.str() << std::endl;
+    benchFrame(bench, input.str(), syntheticFrame(size));
+    numInputs++;
+  }
+  if (numInputs == 0) {
+    std::cerr << "No input frame" << std::endl;
+    return 1;
+  }
+  if (outputPath.empty()) {
+    bench.writeJson(std::cout);
+    return 0;
+  }
+  std::ofstream json(outputPath.c_str());
+  bench.writeJson(json);
+  json.flush();
+  if (!json) {
+    std::cerr << "Failed writing " << outputPath << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,215 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    BatchProcessor.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Batch Processor Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for the offline processing of recorded videos. Each
+ *  video runs through the frame pipeline without display, and for every
+ *  frame the lane fits, their confidence and the stage timings are
+ *  written as one row of a CSV file named after the video.
+ *
+ */
+
+#ifndef INCLUDE_BATCHPROCESSOR_HPP_
+#define INCLUDE_BATCHPROCESSOR_HPP_
+#include <iostream>
+#include <string>
+#include <vector>
+#include "opencv2/core/core.hpp"
+#include "ChunkedProcessor.hpp"
+#include "FramePipeline.hpp"
+#include "LaneDetection.hpp"
+
+class BatchProcessor {
+ private:
+  LaneDetection lanes;  // lane detection run on every video
+  std::string outputDir;  // directory the CSV files are written to
+  cv::Size resolution;  // size frames are resized to, empty for none
+  int queueDepth;  // frames in flight in the pipeline
+  bool displayEnabled;  // show the frames while processing
+  ChunkedProcessor chunkedProcessor;  // splits a video into parallel chunks
+  /**
+   *   @brief Function to write the column names of the CSV file
+   *
+   *   @param CSV file of type std::ostream
+   *   @return nothing
+   */
+  void writeHeader(std::ostream& csv);
+  /**
+   *   @brief Function to write the row of a processed frame
+   *
+   *   @param CSV file of type std::ostream
+   *   @param processed frame of type FramePipeline::FrameResult
+   *   @return nothing
+   */
+  void writeRow(std::ostream& csv, const FramePipeline::FrameResult& result);
+  /**
+   *   @brief Function to process a video in frame order through the
+   *          pipeline
+   *
+   *   @param opened video of type cv::VideoCapture
+   *   @param CSV file of type std::ostream
+   *   @return number of frames written of type uint64_t
+   */
+  uint64_t processSequential(cv::VideoCapture& cap, std::ostream& csv);
+  /**
+   *   @brief Function to process a video as parallel time chunks, each
+   *          read by its own capture
+   *
+   *   @param path of the video of type std::string
+   *   @param opened video of type cv::VideoCapture
+   *   @param CSV file of type std::ostream
+   *   @return false if a chunk could not seek to its first frame, type bool
+   */
+  bool processChunks(const std::string& videoPath, cv::VideoCapture& cap,
+                     std::ostream& csv);
+
+ public:
+  /**
+   *   @brief Default constructor for BatchProcessor
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  BatchProcessor();
+  /**
+   *   @brief Default destructor for BatchProcessor
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ~BatchProcessor();
+  /**
+   *   @brief Function to set the directory the CSV files are written to;
+   *          it must exist
+   *
+   *   @param directory of type std::string
+   *   @return nothing
+   */
+  void setOutputDir(const std::string& outputDir_);
+  /**
+   *   @brief Function to get the directory the CSV files are written to
+   *
+   *   @param nothing
+   *   @return directory of type std::string
+   */
+  std::string getOutputDir(void);
+  /**
+   *   @brief Function to set the size frames are resized to before
+   *          processing
+   *
+   *   @param size, empty to keep the size of the video, of type cv::Size
+   *   @return nothing
+   */
+  void setResolution(const cv::Size& resolution_);
+  /**
+   *   @brief Function to get the size frames are resized to before
+   *          processing
+   *
+   *   @param nothing
+   *   @return size, empty for the size of the video, of type cv::Size
+   */
+  cv::Size getResolution(void);
+  /**
+   *   @brief Function to set the number of frames in flight in the pipeline
+   *
+   *   @param number of frames, at least 1, of type int
+   *   @return nothing
+   */
+  void setQueueDepth(int queueDepth_);
+  /**
+   *   @brief Function to get the number of frames in flight in the pipeline
+   *
+   *   @param nothing
+   *   @return number of frames of type int
+   */
+  int getQueueDepth(void);
+  /**
+   *   @brief Function to show the frames in a window while processing
+   *
+   *   @param true to show the frames of type bool
+   *   @return nothing
+   */
+  void setDisplay(bool displayEnabled_);
+  /**
+   *   @brief Function to check if the frames are shown while processing
+   *
+   *   @param nothing
+   *   @return true if the frames are shown of type bool
+   */
+  bool isDisplay(void);
+  /**
+   *   @brief Function to get the lane detection run on every video
+   *
+   *   @param nothing
+   *   @return lane detection of type LaneDetection&
+   */
+  LaneDetection& getLaneDetection(void);
+  /**
+   *   @brief Function to get the splitting of videos into parallel time
+   *          chunks; with more than one chunk videos are processed in
+   *          chunks unless the frames are shown
+   *
+   *   @param nothing
+   *   @return chunked processor of type ChunkedProcessor&
+   */
+  ChunkedProcessor& getChunkedProcessor(void);
+  /**
+   *   @brief Function to expand the input arguments into video paths;
+   *          arguments with wildcards are globbed
+   *
+   *   @param input paths or globs of type std::vector<std::string>
+   *   @param video paths of type std::vector<std::string>
+   *   @return false if a glob matched nothing, type bool
+   */
+  bool expandInputs(const std::vector<std::string>& inputs,
+                    std::vector<std::string>& videoPaths);
+  /**
+   *   @brief Function to get the CSV file of a video, named after it in the
+   *          output directory
+   *
+   *   @param path of the video of type std::string
+   *   @return path of the CSV file of type std::string
+   */
+  std::string getOutputPath(const std::string& videoPath);
+  /**
+   *   @brief Function to process a video into its CSV file
+   *
+   *   @param path of the video of type std::string
+   *   @return false if the video could not be read, processed or written,
+   *          type bool
+   */
+  bool processVideo(const std::string& videoPath);
+};
+
+#endif  // INCLUDE_BATCHPROCESSOR_HPP_
@@ -0,0 +1,151 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    BirdsEyeRemap.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Birds Eye Remap Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for the fused camera to bird's-eye geometry. The lens
+ *  distortion model and the perspective homography are composed into
+ *  a single lookup table so raw sensor pixels are sampled straight into
+ *  the top-down view in one resampling pass.
+ *
+ */
+
+#ifndef INCLUDE_BIRDSEYEREMAP_HPP_
+#define INCLUDE_BIRDSEYEREMAP_HPP_
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "opencv2/core/core.hpp"
+#include "opencv2/calib3d/calib3d.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+#include "PackedBinaryImage.hpp"
+#include "PolygonSpans.hpp"
+
+class BirdsEyeRemap {
+ private:
+  cv::Mat linearMap1;  // fixed-point map for bilinear sampling (CV_16SC2)
+  cv::Mat linearMap2;  // interpolation table for linearMap1
+  cv::Mat nearestMap;  // integer map for nearest neighbour sampling
+  PolygonSpans birdsEyeROI;  // lane polygon in bird's-eye space
+  bool hasROI;  // clip warped masks to birdsEyeROI
+  cv::Size srcSize;  // raw sensor image size the maps are built for
+  cv::Size dstSize;  // bird's-eye image size the maps are built for
+
+ public:
+  /**
+   *   @brief Default constructor for BirdsEyeRemap
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  BirdsEyeRemap();
+  /**
+   *   @brief Default destructor for BirdsEyeRemap
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ~BirdsEyeRemap();
+  /**
+   *   @brief Function to compose the distortion model and the homography
+   *          into the raw sensor to bird's-eye lookup tables
+   *
+   *   @param camera matrix of type cv::Mat
+   *   @param distortion coefficients k1, k2, p1, p2, k3 of type cv::Mat
+   *   @param undistorted image to bird's-eye homography of type cv::Mat
+   *   @param lane polygon in undistorted image coordinates, empty for none,
+   *          type std::vector<cv::Point>
+   *   @param raw sensor image size of type cv::Size
+   *   @param bird's-eye image size of type cv::Size
+   *   @return nothing
+   */
+  void build(const cv::Mat& intrinsic, const cv::Mat& distortionCoeffs,
+             const cv::Mat& T_perspective,
+             const std::vector<cv::Point>& laneROIVertices,
+             const cv::Size& srcSize_, const cv::Size& dstSize_);
+  /**
+   *   @brief Function to drop the lookup tables
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void clear(void);
+  /**
+   *   @brief Function to check if the lookup tables are built for the
+   *          given image sizes
+   *
+   *   @param raw sensor image size of type cv::Size
+   *   @param bird's-eye image size of type cv::Size
+   *   @return true if the tables can be used, type bool
+   */
+  bool isBuiltFor(const cv::Size& srcSize_,
+                  const cv::Size& dstSize_) const;
+  /**
+   *   @brief Function to sample a raw sensor image into the bird's-eye view
+   *          with bilinear interpolation
+   *
+   *   @param raw sensor image of type cv::Mat
+   *   @param bird's-eye image of type cv::Mat
+   *   @return nothing
+   */
+  void warpImage(const cv::Mat& src, cv::Mat& dst) const;
+  /**
+   *   @brief Function to sample a raw sensor binary mask into the bird's-eye
+   *          view with nearest neighbour interpolation, so the output stays
+   *          binary, and clip it to the lane polygon
+   *
+   *   @param raw sensor binary image of type cv::Mat
+   *   @param bird's-eye binary image of type cv::Mat
+   *   @return nothing
+   */
+  void warpMask(const cv::Mat& src, cv::Mat& dst) const;
+  /**
+   *   @brief Function to sample a raw sensor binary mask straight into a
+   *          packed bird's-eye mask, same pixels as warpMask
+   *
+   *   @param raw sensor binary image of type cv::Mat
+   *   @param packed bird's-eye binary image of type PackedBinaryImage
+   *   @return nothing
+   */
+  void warpMaskPacked(const cv::Mat& src, PackedBinaryImage& dst) const;
+  /**
+   *   @brief Function to get the lane polygon in bird's-eye space
+   *
+   *   @param nothing
+   *   @return per row spans of the polygon of type PolygonSpans
+   */
+  const PolygonSpans& getBirdsEyeROI(void) const;
+};
+
+#endif  // INCLUDE_BIRDSEYEREMAP_HPP_
@@ -0,0 +1,186 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    ChunkedProcessor.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Chunked Processor Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for processing one long recording as time chunks in
+ *  parallel. Every chunk is a stream of a LaneDetectionEngine that starts
+ *  warmupFrames before the chunk, so the lane tracker and the search
+ *  around the previous fits settle before the chunk's own frames; warm-up
+ *  frames are processed but not written. Each chunk writes its rows to its
+ *  own buffer and the buffers are concatenated in time order.
+ *
+ *  Tolerance: a chunk's rows match the sequential run once the tracker
+ *  state built in the warm-up equals the one built from the whole
+ *  recording. With the default moving average over historyLength frames
+ *  this holds exactly when the last historyLength warm-up frames found the
+ *  same lane pixels as the sequential run, which they do as soon as both
+ *  runs track the same lanes; hence the default warm-up of twice the
+ *  default history. With the exponential filter the remaining difference
+ *  of the state decays as (1 - gain)^warmupFrames, 1e-3 for the default
+ *  gain and warm-up. Rows can differ where the sequential run was still
+ *  recovering a lost lane at a chunk boundary.
+ *
+ */
+
+#ifndef INCLUDE_CHUNKEDPROCESSOR_HPP_
+#define INCLUDE_CHUNKEDPROCESSOR_HPP_
+#include <stdint.h>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+#include "opencv2/core/core.hpp"
+#include "FramePipeline.hpp"
+#include "LaneDetection.hpp"
+#include "LaneDetectionEngine.hpp"
+
+class ChunkedProcessor {
+ public:
+  // source positioned at a frame of the recording, empty if it can not
+  // seek there exactly
+  typedef std::function<FramePipeline::FrameSource(uint64_t)> SourceOpener;
+  // writes the output of a frame; frameIdx is the index in the recording
+  typedef std::function<void(std::ostream&,
+                             const FramePipeline::FrameResult&)> RowWriter;
+
+ private:
+  /**
+   *  A time range of the recording and its output
+   */
+  struct Chunk {
+    uint64_t warmupBegin;  // first frame read, processed but not written
+    uint64_t begin;  // first frame written
+    uint64_t end;  // frame after the last frame read
+    uint64_t nextFrame;  // index of the next frame read
+    FramePipeline::FrameSource readFrame;  // source at warmupBegin
+    std::ostringstream rows;  // output of the chunk's own frames
+    uint64_t framesWritten;  // frames written to rows
+  };
+  LaneDetectionEngine engine;  // runs the chunks as streams
+  int numChunks;  // chunks a recording is split into
+  int warmupFrames;  // frames processed before a chunk's first frame
+  std::vector<std::unique_ptr<Chunk> > chunks;  // chunks of the last run
+
+ public:
+  /**
+   *   @brief Default constructor for ChunkedProcessor
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ChunkedProcessor();
+  /**
+   *   @brief Default destructor for ChunkedProcessor
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ~ChunkedProcessor();
+  /**
+   *   @brief Function to set the number of chunks a recording is split
+   *          into
+   *
+   *   @param number of chunks, 1 for a sequential run, of type int
+   *   @return nothing
+   */
+  void setNumChunks(int numChunks_);
+  /**
+   *   @brief Function to get the number of chunks a recording is split
+   *          into
+   *
+   *   @param nothing
+   *   @return number of chunks of type int
+   */
+  int getNumChunks(void);
+  /**
+   *   @brief Function to set the number of frames processed before the
+   *          first frame of a chunk
+   *
+   *   @param number of frames, at least 0, of type int
+   *   @return nothing
+   */
+  void setWarmupFrames(int warmupFrames_);
+  /**
+   *   @brief Function to get the number of frames processed before the
+   *          first frame of a chunk
+   *
+   *   @param nothing
+   *   @return number of frames of type int
+   */
+  int getWarmupFrames(void);
+  /**
+   *   @brief Function to get the engine running the chunks, e.g. to set
+   *          the number of workers
+   *
+   *   @param nothing
+   *   @return engine of type LaneDetectionEngine&
+   */
+  LaneDetectionEngine& getEngine(void);
+  /**
+   *   @brief Function to process a recording in chunks and write the
+   *          output of every frame in time order
+   *
+   *   @param settings every chunk starts from of type LaneDetection
+   *   @param frames in the recording, 0 if unknown for a sequential run,
+   *          of type uint64_t; the last chunk reads to the end
+   *   @param opener of a source at a frame of type
+   *          ChunkedProcessor::SourceOpener
+   *   @param writer of the output of a frame, called on the workers, of
+   *          type ChunkedProcessor::RowWriter
+   *   @param merged output of type std::ostream
+   *   @return false if a chunk could not be opened, nothing is processed
+   *          then, type bool
+   */
+  bool process(LaneDetection& settings, uint64_t frameCount,
+               const SourceOpener& openSource, const RowWriter& writeRow,
+               std::ostream& output);
+  /**
+   *   @brief Function to get the number of frames the last run wrote
+   *
+   *   @param nothing
+   *   @return number of frames of type uint64_t
+   */
+  uint64_t getFramesWritten(void);
+  /**
+   *   @brief Function to get the number of frames the last run processed,
+   *          warm-up frames included
+   *
+   *   @param nothing
+   *   @return number of frames of type uint64_t
+   */
+  uint64_t getFramesProcessed(void);
+};
+
+#endif  // INCLUDE_CHUNKEDPROCESSOR_HPP_
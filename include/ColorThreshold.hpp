@@ -0,0 +1,241 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    ColorThreshold.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Color Threshold Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for the fused multi-rule colour threshold kernel. It
+ *  reads BGR pixels and writes one binary lane mask holding the OR of
+ *  any number of colour space range rules (BGR, HLS, Lab, YUV), without
+ *  producing converted images or one mask per rule.
+ *
+ */
+
+#ifndef INCLUDE_COLORTHRESHOLD_HPP_
+#define INCLUDE_COLORTHRESHOLD_HPP_
+#include <stdint.h>
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "opencv2/core/core.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+
+class ColorThreshold {
+ public:
+  /**
+   *   @brief Colour spaces a rule can threshold in
+   */
+  enum ColorSpace {
+    COLOR_SPACE_BGR = 0,
+    COLOR_SPACE_HLS = 1,
+    COLOR_SPACE_LAB = 2,
+    COLOR_SPACE_YUV = 3
+  };
+
+ private:
+  /**
+   *   @brief One inclusive range in one colour space
+   */
+  struct ColorRule {
+    int colorSpace;  // colour space of the bounds
+    cv::Scalar lower;  // lower bounds per channel
+    cv::Scalar upper;  // upper bounds per channel
+    // one bit per 24 bit BGR colour, set if the colour passes this rule;
+    // shared read-only by copies of the threshold
+    std::shared_ptr<const std::vector<uint64_t> > lut;
+    int minSumL;  // HLS: lowest max+min that can pass the lightness bound
+    int maxSumL;  // HLS: highest max+min that can pass the lightness bound
+    int minSat;  // HLS: saturation bound of the conservative reject test
+    uchar lowerBGR[3];  // BGR: lower bounds rounded down
+    uchar upperBGR[3];  // BGR: upper bounds rounded up
+  };
+  std::vector<ColorRule> rules;  // rules ORed into the mask
+  // OR of the tables of all rules, shared read-only by copies
+  std::shared_ptr<const std::vector<uint64_t> > lut;
+  bool dirty;  // rules changed since the tables were built
+  bool hitCounting;  // count pixels passing each rule
+  std::vector<uint64_t> ruleHits;  // per rule count of passing pixels
+  uint64_t pixelCount;  // pixels thresholded while counting
+  /**
+   *   @brief Function to look up a BGR colour in a predicate table
+   *
+   *   @param predicate table of type std::vector<uint64_t>
+   *   @param pointer to a BGR pixel of type const uchar*
+   *   @return true if the colour is set in the table, type bool
+   */
+  static bool lookup(const std::vector<uint64_t>& table, const uchar* bgr);
+  /**
+   *   @brief Function to generate the predicate table and the conservative
+   *          bounds of a rule
+   *
+   *   @param rule of type ColorRule
+   *   @return nothing
+   */
+  static void buildRule(ColorRule& rule);
+  /**
+   *   @brief Function to check if a pixel can pass any rule. Never rejects
+   *          a passing pixel
+   *
+   *   @param pointer to a BGR pixel of type const uchar*
+   *   @return false if the pixel surely fails every rule, type bool
+   */
+  bool isCandidate(const uchar* bgr) const;
+  /**
+   *   @brief Function to resolve a candidate pixel exactly and update the
+   *          per rule hit counters
+   *
+   *   @param pointer to a BGR pixel of type const uchar*
+   *   @return 255 if the pixel passes any rule else 0, type uchar
+   */
+  uchar resolve(const uchar* bgr);
+
+ public:
+  /**
+   *   @brief Default constructor for ColorThreshold
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ColorThreshold();
+  /**
+   *   @brief Default destructor for ColorThreshold
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ~ColorThreshold();
+  /**
+   *   @brief Function to add a range rule
+   *
+   *   @param colour space of type ColorSpace
+   *   @param lower bounds per channel of type cv::Scalar
+   *   @param upper bounds per channel of type cv::Scalar
+   *   @return index of the rule of type int
+   */
+  int addRule(int colorSpace, const cv::Scalar& lower,
+              const cv::Scalar& upper);
+  /**
+   *   @brief Function to change the bounds of a rule
+   *
+   *   @param index of the rule of type int
+   *   @param lower bounds per channel of type cv::Scalar
+   *   @param upper bounds per channel of type cv::Scalar
+   *   @return nothing
+   */
+  void setRule(int ruleIdx, const cv::Scalar& lower, const cv::Scalar& upper);
+  /**
+   *   @brief Function to remove all rules
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void clearRules(void);
+  /**
+   *   @brief Function to get the number of rules
+   *
+   *   @param nothing
+   *   @return number of rules of type int
+   */
+  int getNumRules(void);
+  /**
+   *   @brief Function to build the predicate tables if the rules changed.
+   *          Tables are generated with cv::cvtColor and cv::inRange, so the
+   *          kernel is bit-exact with them
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void build(void);
+  /**
+   *   @brief Function to enable per rule hit counting
+   *
+   *   @param true to count hits of type bool
+   *   @return nothing
+   */
+  void setHitCounting(bool hitCounting_);
+  /**
+   *   @brief Function to reset the hit counters
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void resetHits(void);
+  /**
+   *   @brief Function to get the number of pixels that passed each rule
+   *          since the counters were reset
+   *
+   *   @param nothing
+   *   @return per rule hit counts of type std::vector<uint64_t>
+   */
+  std::vector<uint64_t> getRuleHits(void);
+  /**
+   *   @brief Function to get the number of pixels thresholded since the
+   *          counters were reset
+   *
+   *   @param nothing
+   *   @return pixel count of type uint64_t
+   */
+  uint64_t getPixelCount(void);
+  /**
+   *   @brief Function to get the built OR table of all rules. Copies of a
+   *          built threshold share it until their rules change
+   *
+   *   @param nothing
+   *   @return table, nullptr before the first build, of type
+   *           const std::vector<uint64_t>*
+   */
+  const std::vector<uint64_t>* getTable(void) const;
+  /**
+   *   @brief Function to threshold a span of one BGR row
+   *
+   *   @param BGR row of type const uchar*
+   *   @param binary row of type uchar*
+   *   @param first column of the span of type int
+   *   @param column after the last column of the span of type int
+   *   @return nothing
+   */
+  void thresholdRow(const uchar* bgrRow, uchar* maskRow, int xBegin,
+                    int xEnd);
+  /**
+   *   @brief Function to threshold a whole BGR image
+   *
+   *   @param BGR image of type cv::Mat
+   *   @param binary image of type cv::Mat
+   *   @return nothing
+   */
+  void apply(const cv::Mat& src, cv::Mat& dst);
+};
+
+#endif  // INCLUDE_COLORTHRESHOLD_HPP_
@@ -0,0 +1,172 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    Denoiser.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Denoiser Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for the denoise stage of the lane detection pipeline.
+ *  The stage runs one of several filters, from a plain copy to a median,
+ *  and bypasses Gaussian kernels that are effectively a delta, so tiny
+ *  sigmas do not cost a full frame convolution.
+ *
+ */
+
+#ifndef INCLUDE_DENOISER_HPP_
+#define INCLUDE_DENOISER_HPP_
+#include <stdint.h>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "opencv2/core/core.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+
+class Denoiser {
+ public:
+  /**
+   *  Denoise filters. Costs are per pixel and channel on 8 bit images.
+   */
+  enum DenoiseMode {
+    DENOISE_BYPASS = 0,  // no filter, the image is passed through; free
+                         // when the caller can skip the copy
+    DENOISE_GAUSSIAN,  // cv::GaussianBlur 5x5 with the configured sigmas,
+                       // 10 float multiply-adds; bypassed when the kernel
+                       // is effectively a delta
+    DENOISE_BINOMIAL3,  // 3x3 [1 2 1] binomial, separable in 16 and 32 bit
+                        // integers, 6 integer multiply-adds
+    DENOISE_GAUSSIAN5_FIXED,  // 5x5 Gaussian of the configured sigmas with
+                              // 8 bit fixed-point taps, separable in 16
+                              // and 32 bit integers, 10 integer
+                              // multiply-adds; bypassed when the quantized
+                              // kernel is a delta
+    DENOISE_MEDIAN3  // cv::medianBlur 3x3, a sorting network of 19
+                     // compare-exchanges; removes salt and pepper noise
+                     // without blurring lane edges
+  };
+
+ private:
+  int mode;  // selected DenoiseMode
+  double sigmaX;  // standard deviation in X of the Gaussian modes
+  double sigmaY;  // standard deviation in Y of the Gaussian modes
+  std::vector<int> kernelX;  // fixed-point taps in X of the integer modes
+  std::vector<int> kernelY;  // fixed-point taps in Y of the integer modes
+  int kernelShift;  // fractional bits of the product of both kernels
+  bool bypass;  // the selected filter leaves every pixel unchanged
+  std::vector<uchar> paddedRow;  // source row with a reflected apron
+  std::vector<ushort> rowSums;  // ring of horizontally filtered rows
+  std::vector<int> rowSumTags;  // unreflected source row of each ring slot
+  /**
+   *   @brief Function to recompute the kernels and the bypass decision
+   *          after the mode or a sigma changed
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void updateKernels(void);
+  /**
+   *   @brief Function to quantize a 5 tap Gaussian to 8 bit fixed-point
+   *          taps summing to 256
+   *
+   *   @param standard deviation of type double
+   *   @param fixed-point taps of type std::vector<int>
+   *   @return nothing
+   */
+  static void quantizeGaussian(double sigma, std::vector<int>& taps);
+  /**
+   *   @brief Function to filter an 8 bit image with separable fixed-point
+   *          kernels and a reflected border, like cv::BORDER_DEFAULT
+   *
+   *   @param input image of type cv::Mat
+   *   @param filtered image of type cv::Mat
+   *   @return nothing
+   */
+  void separableFixedPoint(const cv::Mat& src, cv::Mat& dst);
+
+ public:
+  /**
+   *   @brief Default constructor for Denoiser
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  Denoiser();
+  /**
+   *   @brief Default destructor for Denoiser
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ~Denoiser();
+  /**
+   *   @brief Function to select the denoise filter
+   *
+   *   @param filter of type Denoiser::DenoiseMode
+   *   @return nothing
+   */
+  void setMode(int mode_);
+  /**
+   *   @brief Function to set the standard deviations of the Gaussian modes
+   *
+   *   @param standard deviation in X of type double
+   *   @param standard deviation in Y of type double
+   *   @return nothing
+   */
+  void setSigma(double sigmaX_, double sigmaY_);
+  /**
+   *   @brief Function to get the selected denoise filter
+   *
+   *   @param nothing
+   *   @return filter of type Denoiser::DenoiseMode
+   */
+  int getMode(void);
+  /**
+   *   @brief Function to check if the selected filter leaves every pixel
+   *          unchanged, so callers can skip the stage altogether
+   *
+   *   @param nothing
+   *   @return true if the stage is bypassed, type bool
+   */
+  bool isBypass(void);
+  /**
+   *   @brief Function to denoise an 8 bit image
+   *
+   *   @param input image of type cv::Mat
+   *   @param denoised image of type cv::Mat
+   *   @return nothing
+   */
+  void apply(const cv::Mat& src, cv::Mat& dst);
+};
+
+#endif  // INCLUDE_DENOISER_HPP_
@@ -0,0 +1,69 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    FixedPointRemap.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Fixed Point Remap Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for the bilinear remap of 8 bit images through the
+ *  fixed-point maps of cv::convertMaps (CV_16SC2 integer positions and
+ *  CV_16UC1 interpolation table indices) with a zero constant border.
+ *  The weights are exact products of the 1/32 pixel fractions in 15 bit
+ *  fixed point, the precision cv::remap uses, so the output is within one
+ *  grey level of cv::remap. Unlike cv::remap it needs no scratch buffers,
+ *  but it is scalar, so the pipeline keeps cv::remap; lane-bench times
+ *  both on the same maps.
+ *
+ */
+
+#ifndef INCLUDE_FIXEDPOINTREMAP_HPP_
+#define INCLUDE_FIXEDPOINTREMAP_HPP_
+#include "opencv2/core/core.hpp"
+
+class FixedPointRemap {
+ public:
+  /**
+   *   @brief Function to sample an image through fixed-point maps with
+   *          bilinear interpolation and a zero constant border, like
+   *          cv::remap with cv::INTER_LINEAR and cv::BORDER_CONSTANT
+   *
+   *   @param 8 bit input image of type cv::Mat
+   *   @param output image, of the size of the maps, of type cv::Mat; must
+   *          not share the input's pixels
+   *   @param integer positions of type cv::Mat (CV_16SC2)
+   *   @param interpolation table indices of type cv::Mat (CV_16UC1)
+   *   @return nothing
+   */
+  static void remap(const cv::Mat& src, cv::Mat& dst, const cv::Mat& map1,
+                    const cv::Mat& map2);
+};
+
+#endif  // INCLUDE_FIXEDPOINTREMAP_HPP_
@@ -0,0 +1,293 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    FramePipeline.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Frame Pipeline Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for the pipelined executor of the lane detection. Decode,
+ *  the geometric and colour stage, the lane search and fitting, and the
+ *  output run on their own threads. A fixed set of frame slots, each with
+ *  its own frame and workspace, circulates through bounded single
+ *  producer single consumer queues, so frames stay in order and the
+ *  throughput approaches that of the slowest stage. A stage whose queue
+ *  is empty sleeps on a condition variable instead of spinning.
+ *
+ */
+
+#ifndef INCLUDE_FRAMEPIPELINE_HPP_
+#define INCLUDE_FRAMEPIPELINE_HPP_
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "opencv2/core/core.hpp"
+#include "opencv2/highgui/highgui.hpp"
+#include "FrameWorkspace.hpp"
+#include "LaneDetection.hpp"
+#include "SpscQueue.hpp"
+
+class FramePipeline {
+ public:
+  /**
+   *  What decode does when every frame slot is in flight.
+   */
+  enum BackPressure {
+    BACKPRESSURE_BLOCK = 0,  // wait for a slot, every frame is processed
+    BACKPRESSURE_DROP  // read and drop the frame, decode never waits
+  };
+  /**
+   *  Stages of the pipeline, in frame order.
+   */
+  enum Stage {
+    DECODE_STAGE = 0,  // read a frame into a free slot
+    TRANSFORM_STAGE,  // pre-process, threshold and warp
+    SEARCH_STAGE,  // search, fit and track the lanes
+    OUTPUT_STAGE,  // render and hand the frame on
+    NUM_STAGES
+  };
+  /**
+   *  A processed frame as the sink receives it
+   */
+  struct FrameResult {
+    uint64_t frameIdx;  // index of the frame in the stream
+    FrameWorkspace* workspace;  // lane pixels, fits and OUTPUT_FRAME
+    double stageMs[NUM_STAGES];  // time each stage worked on the frame
+    double latencyMs;  // from the start of decode to the end of output
+  };
+  // copies the next frame into the Mat, false at the end of the stream
+  typedef std::function<bool(cv::Mat&)> FrameSource;
+  // takes a processed frame, false to stop
+  typedef std::function<bool(const FrameResult&)> FrameSink;
+
+ private:
+  /**
+   *  Everything a frame needs on its way through the stages
+   */
+  struct FrameSlot {
+    cv::Mat frame;  // decoded frame
+    FrameWorkspace workspace;  // intermediate images of the frame
+    uint64_t frameIdx;  // index of the frame in the stream
+    int64 stageBegin[NUM_STAGES];  // tick count as each stage takes the slot
+    int64 stageEnd[NUM_STAGES];  // tick count as each stage is done
+  };
+  static const int END_OF_STREAM = -1;  // slot index closing a queue
+  LaneDetection& lanes;  // stages of the lane detection
+  int queueDepth;  // frame slots in flight
+  int backPressure;  // selected BackPressure
+  FrameSink frameSink;  // consumer of the rendered frames, or empty
+  std::vector<std::unique_ptr<FrameSlot> > slots;  // preallocated slots
+  // input queue of each stage; decode's holds the free slots
+  SpscQueue<int> queues[NUM_STAGES];
+  // a thread blocks on a queue only once its lock-free try failed
+  std::mutex queueMutexes[NUM_STAGES];  // guard the waits on each queue
+  std::condition_variable queueChanged[NUM_STAGES];  // a slot moved
+  std::atomic<int> queueWaiters[NUM_STAGES];  // threads blocked on each
+  std::atomic<bool> stopRequested;  // the sink asked to stop or a stage
+                                    // failed
+  std::mutex errorMutex;  // guards the first failure
+  std::exception_ptr error;  // first failure of a stage
+  cv::Mat droppedFrame;  // frame read while every slot was in flight
+  uint64_t framesProcessed;  // frames handed to the sink
+  uint64_t framesDropped;  // frames dropped by back-pressure
+  /**
+   *   @brief Function to wake the threads blocked on a queue, if any
+   *
+   *   @param stage of the queue of type FramePipeline::Stage
+   *   @return nothing
+   */
+  void notifyQueue(int stage);
+  /**
+   *   @brief Function to take the next slot of a stage without waiting
+   *
+   *   @param stage of type FramePipeline::Stage
+   *   @param slot index or END_OF_STREAM of type int
+   *   @return false if the queue is empty, type bool
+   */
+  bool tryPopSlot(int stage, int& slotIdx);
+  /**
+   *   @brief Function to wait for the next slot of a stage, blocking once
+   *          the lock-free try fails
+   *
+   *   @param stage of type FramePipeline::Stage
+   *   @param slot index or END_OF_STREAM of type int
+   *   @param true to give up when the pipeline stops of type bool
+   *   @return false if it gave up, type bool
+   */
+  bool waitPopSlot(int stage, int& slotIdx, bool isStoppable);
+  /**
+   *   @brief Function to hand a slot to the next stage
+   *
+   *   @param stage whose queue takes the slot of type FramePipeline::Stage
+   *   @param slot index or END_OF_STREAM of type int
+   *   @return nothing
+   */
+  void pushSlot(int stage, int slotIdx);
+  /**
+   *   @brief Function to wait for the next slot of a stage
+   *
+   *   @param stage of type FramePipeline::Stage
+   *   @return slot index or END_OF_STREAM of type int
+   */
+  int popSlot(int stage);
+  /**
+   *   @brief Function to stop the pipeline and wake decode if it waits
+   *          for a free slot
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void requestStop(void);
+  /**
+   *   @brief Function to record the failure of a stage and stop the
+   *          pipeline
+   *
+   *   @param failure of type std::exception_ptr
+   *   @return nothing
+   */
+  void fail(std::exception_ptr stageError);
+  /**
+   *   @brief Function to read frames into free slots until the stream ends
+   *          or the pipeline stops
+   *
+   *   @param source of the frames of type FramePipeline::FrameSource
+   *   @return nothing
+   */
+  void decodeLoop(const FrameSource& readFrame);
+  /**
+   *   @brief Function to run the transform or the search stage on every
+   *          slot until the end of the stream
+   *
+   *   @param stage of type FramePipeline::Stage
+   *   @return nothing
+   */
+  void stageLoop(int stage);
+  /**
+   *   @brief Function to render every slot, hand it to the sink and
+   *          recycle it, until the end of the stream
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void outputLoop(void);
+
+ public:
+  /**
+   *   @brief Constructor for FramePipeline
+   *
+   *   @param lane detection whose stages are run, of type LaneDetection
+   *   @return nothing
+   */
+  explicit FramePipeline(LaneDetection& lanes_);
+  /**
+   *   @brief Default destructor for FramePipeline
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ~FramePipeline();
+  /**
+   *   @brief Function to set the number of frames in flight
+   *
+   *   @param number of frame slots, at least 1, of type int
+   *   @return nothing
+   */
+  void setQueueDepth(int queueDepth_);
+  /**
+   *   @brief Function to get the number of frames in flight
+   *
+   *   @param nothing
+   *   @return number of frame slots of type int
+   */
+  int getQueueDepth(void);
+  /**
+   *   @brief Function to select what decode does when every slot is in
+   *          flight
+   *
+   *   @param policy of type FramePipeline::BackPressure
+   *   @return nothing
+   */
+  void setBackPressure(int backPressure_);
+  /**
+   *   @brief Function to get what decode does when every slot is in flight
+   *
+   *   @param nothing
+   *   @return policy of type FramePipeline::BackPressure
+   */
+  int getBackPressure(void);
+  /**
+   *   @brief Function to set the consumer of the rendered frames; without
+   *          one the frames are shown by the visualizer
+   *
+   *   @param consumer of type FramePipeline::FrameSink
+   *   @return nothing
+   */
+  void setFrameSink(const FrameSink& frameSink_);
+  /**
+   *   @brief Function to run the pipeline on a video until it ends or the
+   *          sink stops it
+   *
+   *   @param opened video of type cv::VideoCapture
+   *   @return nothing
+   */
+  void run(cv::VideoCapture& cap);
+  /**
+   *   @brief Function to run the pipeline on a source of frames until it
+   *          ends or the sink stops it. The output stage runs on the calling
+   *          thread; a failure of any stage is rethrown here
+   *
+   *   @param source of the frames of type FramePipeline::FrameSource
+   *   @return nothing
+   */
+  void run(const FrameSource& readFrame);
+  /**
+   *   @brief Function to get the number of frames the last run handed to
+   *          the sink
+   *
+   *   @param nothing
+   *   @return number of frames of type uint64_t
+   */
+  uint64_t getFramesProcessed(void);
+  /**
+   *   @brief Function to get the number of frames the last run dropped
+   *          under back-pressure
+   *
+   *   @param nothing
+   *   @return number of frames of type uint64_t
+   */
+  uint64_t getFramesDropped(void);
+};
+
+#endif  // INCLUDE_FRAMEPIPELINE_HPP_
@@ -0,0 +1,243 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    FrameWorkspace.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Frame Workspace Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for the arena that owns every intermediate buffer of the
+ *  lane detection pipeline. The buffers are sized once from the stream
+ *  resolution and reused for every frame, so the steady state performs
+ *  no heap allocation apart from the row-block scratch cv::remap takes
+ *  and frees within each call of the undistortion and the warps.
+ *  Allocations of the workspace buffers are counted to verify this.
+ *  This holds with one OpenCV thread (cv::setNumThreads(1)) only: with
+ *  more, the pthreads backend of cv::parallel_for_ allocates a job on
+ *  every parallel loop of a frame, and cv::remap takes its scratch once
+ *  per stripe.
+ *
+ */
+
+#ifndef INCLUDE_FRAMEWORKSPACE_HPP_
+#define INCLUDE_FRAMEWORKSPACE_HPP_
+#include <stdint.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "opencv2/core/core.hpp"
+#include "LanePointSet.hpp"
+#include "OccupancyIntegral.hpp"
+#include "PackedBinaryImage.hpp"
+
+class FrameWorkspace {
+ public:
+  enum Buffer {
+    UNDISTORTED_IMG = 0,  // undistorted frame before denoising
+    UNDISTORTED_BAND,  // undistorted ROI band before denoising
+    DENOISED_BAND,  // denoised ROI band
+    PROCESSED_FRAME,  // pre-processed frame
+    BINARY_FRAME,  // thresholded frame
+    PERSPECTIVE_IMG,  // bird's-eye view of the binary frame
+    DRAW_WINDOW,  // bird's-eye debug image with the lane pixels
+    OUTPUT_FRAME,  // lane pixels unwarped and composited on the frame
+    OVERLAY_FRAME,  // sparse lane overlay, written only where blended
+    NUM_BUFFERS
+  };
+  enum LaneBuffer {
+    LEFT_LANE_POINTS = 0,  // left lane pixels, in LaneTracker::Lane order
+    RIGHT_LANE_POINTS,  // right lane pixels
+    NUM_LANE_BUFFERS
+  };
+  static const int MAX_PYRAMID_LEVEL = 3;  // coarsest level, 1/8 scale
+
+ private:
+  /**
+   *  Mat allocator forwarding to the default OpenCV allocator and counting
+   *  the buffers it allocates
+   */
+  class CountingAllocator : public cv::MatAllocator {
+   private:
+    mutable uint64_t allocationCount;  // buffers allocated so far
+
+   public:
+    CountingAllocator();
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data,
+                           size_t* step, int flags,
+                           cv::UMatUsageFlags usageFlags) const;
+    bool allocate(cv::UMatData* data, int accessflags,
+                  cv::UMatUsageFlags usageFlags) const;
+    void deallocate(cv::UMatData* data) const;
+    uint64_t getAllocationCount(void) const;
+    void resetAllocationCount(void);
+  };
+  CountingAllocator allocator;  // allocator of all workspace buffers
+  cv::Mat buffers[NUM_BUFFERS];  // intermediate images of the pipeline
+  PackedBinaryImage packedPerspective;  // bird's-eye mask, 1 bit per pixel
+  OccupancyIntegral occupancy;  // summed-area table of packedPerspective
+  // packedPerspective max pooled to 1/2, 1/4 and 1/8 scale
+  PackedBinaryImage packedPyramid[MAX_PYRAMID_LEVEL];
+  std::vector<double> pyramidHistogram;  // lane histogram of a coarse level
+  std::vector<double> histogram;  // lane pixel histogram
+  // pixels of each lane, written by its own task of the lane search
+  LanePointSet lanePoints[NUM_LANE_BUFFERS];
+  cv::Mat laneFits[NUM_LANE_BUFFERS];  // fit of each lane, or empty
+  cv::Mat perspectiveInverse;  // bird's-eye to frame transform of the frame
+  cv::Size frameSize;  // resolution the workspace is sized for
+
+ public:
+  /**
+   *   @brief Default constructor for FrameWorkspace
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  FrameWorkspace();
+  /**
+   *   @brief Default destructor for FrameWorkspace
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ~FrameWorkspace();
+  /**
+   *   @brief Buffers point to the allocator of the workspace that owns
+   *          them, so a workspace can not be copied
+   */
+  FrameWorkspace(const FrameWorkspace&) = delete;
+  FrameWorkspace& operator=(const FrameWorkspace&) = delete;
+  /**
+   *   @brief Function to size all buffers for a stream resolution
+   *
+   *   @param frame size of the stream of type cv::Size
+   *   @return nothing
+   */
+  void allocate(const cv::Size& frameSize_);
+  /**
+   *   @brief Function to check if the buffers are sized for a resolution
+   *
+   *   @param frame size of the stream of type cv::Size
+   *   @return true if allocate was called with this size, type bool
+   */
+  bool isAllocatedFor(const cv::Size& frameSize_);
+  /**
+   *   @brief Function to get an intermediate image. Write it only through
+   *          create, copyTo or as an OpenCV output, never by assignment,
+   *          so it keeps its buffer and allocator
+   *
+   *   @param buffer of type FrameWorkspace::Buffer
+   *   @return image of type cv::Mat&
+   */
+  cv::Mat& getBuffer(int buffer);
+  /**
+   *   @brief Function to get the packed bird's-eye mask
+   *
+   *   @param nothing
+   *   @return packed bird's-eye mask of type PackedBinaryImage&
+   */
+  PackedBinaryImage& getPackedPerspective(void);
+  /**
+   *   @brief Function to get the occupancy table of the bird's-eye mask
+   *
+   *   @param nothing
+   *   @return occupancy table of type OccupancyIntegral&
+   */
+  OccupancyIntegral& getOccupancy(void);
+  /**
+   *   @brief Function to get the lane pixel histogram
+   *
+   *   @param nothing
+   *   @return histogram of type std::vector<double>&
+   */
+  std::vector<double>& getHistogram(void);
+  /**
+   *   @brief Function to get a max pooled level of the packed bird's-eye
+   *          mask
+   *
+   *   @param level, 1 for 1/2 scale up to MAX_PYRAMID_LEVEL, of type int
+   *   @return packed mask at the level of type PackedBinaryImage&
+   */
+  PackedBinaryImage& getPackedPyramid(int level);
+  /**
+   *   @brief Function to get the lane pixel histogram of a coarse level
+   *
+   *   @param nothing
+   *   @return histogram of type std::vector<double>&
+   */
+  std::vector<double>& getPyramidHistogram(void);
+  /**
+   *   @brief Function to get the pixels of one lane of the current frame
+   *
+   *   @param lane of type FrameWorkspace::LaneBuffer
+   *   @return lane pixels of type LanePointSet&
+   */
+  LanePointSet& getLanePoints(int lane);
+  /**
+   *   @brief Function to get the fits of the lanes of the current frame,
+   *          in FrameWorkspace::LaneBuffer order
+   *
+   *   @param nothing
+   *   @return column of each lane as a polynomial in the row, or empty, of
+   *           type cv::Mat*
+   */
+  cv::Mat* getLaneFits(void);
+  /**
+   *   @brief Function to get the inverse perspective transform the current
+   *          frame was warped with
+   *
+   *   @param nothing
+   *   @return 3x3 transform of type cv::Mat&
+   */
+  cv::Mat& getPerspectiveInverse(void);
+  /**
+   *   @brief Function to get the resolution the workspace is sized for
+   *
+   *   @param nothing
+   *   @return frame size of type cv::Size
+   */
+  cv::Size getFrameSize(void);
+  /**
+   *   @brief Function to get the number of image buffers allocated since
+   *          the counter was reset
+   *
+   *   @param nothing
+   *   @return number of allocations of type uint64_t
+   */
+  uint64_t getAllocationCount(void);
+  /**
+   *   @brief Function to reset the allocation counter
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void resetAllocationCount(void);
+};
+
+#endif  // INCLUDE_FRAMEWORKSPACE_HPP_
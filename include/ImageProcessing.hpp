@@ -41,7 +41,10 @@
 
 #ifndef INCLUDE_IMAGEPROCESSING_HPP_
 #define INCLUDE_IMAGEPROCESSING_HPP_
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 #include "opencv2/core/core.hpp"
@@ -49,6 +52,14 @@
 #include "opencv2/imgproc/imgproc.hpp"
 #include "opencv2/opencv.hpp"
 #include "opencv2/highgui/highgui.hpp"
+#include "BirdsEyeRemap.hpp"
+#include "ColorThreshold.hpp"
+#include "Denoiser.hpp"
+#include "FrameWorkspace.hpp"
+#include "PackedBinaryImage.hpp"
+#include "PerspectiveGeometry.hpp"
+#include "PolygonSpans.hpp"
+#include "SharedCalibration.hpp"
 
 class ImageProcessing {
  private:
@@ -56,10 +67,85 @@ class ImageProcessing {
   cv::Mat distortionCoeffs;  // Distortion coefficients
   double gaussianSigmaX;  // standard deviation in X for gaussian blur
   double gaussianSigmaY;  // standard deviation in Y for gaussian blur
+  Denoiser denoiser;  // denoise stage of preProcessing
   cv::Scalar minThreshHLS;  // HSL color space threshold values
   cv::Scalar maxThreshHLS;  // HSL color space threshold values
   cv::Scalar minThreshBGR;  // RGB color space threshold values
   cv::Scalar maxThreshBGR;  // RGB color space threshold values
+  cv::Mat undistortMap1;  // cached fixed-point undistortion map (CV_16SC2)
+  cv::Mat undistortMap2;  // cached interpolation table for undistortMap1
+  cv::Size undistortMapSize;  // image size the undistortion maps are built for
+  bool fusedRemap;  // undistort and warp in one pass from the raw frame
+  BirdsEyeRemap birdsEyeRemap;  // fused raw sensor to bird's-eye geometry
+  PerspectiveGeometry perspectiveGeometry;  // cached bird's-eye homographies
+  cv::Rect roiRect;  // region of the frame used for lane detection
+  bool roiProcessing;  // process only the ROI instead of the whole frame
+  ColorThreshold colorThreshold;  // fused multi-rule colour threshold kernel
+  int hlsRule;  // index of the HLS threshold rule in colorThreshold
+  int bgrRule;  // index of the BGR threshold rule in colorThreshold
+  PolygonSpans laneSpans;  // polygon in which lanes appear, as row spans
+  // artefacts of this calibration shared with other streams, or null
+  std::shared_ptr<const SharedCalibration> sharedCalibration;
+  /**
+   *   @brief Function to get the shared artefacts if they are built for
+   *          the image size and the remap mode in use
+   *
+   *   @param size of the image of type cv::Size
+   *   @return shared artefacts, or nullptr to use the own caches, of type
+   *           const SharedCalibration*
+   */
+  const SharedCalibration* findSharedCalibration(const cv::Size& imgSize);
+  /**
+   *   @brief Function to build the undistortion maps if the camera model or
+   *          the image size changed since they were last built
+   *
+   *   @param size of the image to be undistorted of type cv::Size
+   *   @return nothing
+   */
+  void updateUndistortMaps(const cv::Size& imgSize);
+  /**
+   *   @brief Function to get the region of interest clipped to the image
+   *
+   *   @param image size of type cv::Size
+   *   @return clipped region of interest of type cv::Rect
+   */
+  cv::Rect getClippedROI(const cv::Size& imgSize);
+  /**
+   *   @brief Function to set all pixels outside the region of interest to 0
+   *
+   *   @param image of type cv::Mat
+   *   @param region of interest inside the image of type cv::Rect
+   *   @return nothing
+   */
+  void zeroOutsideROI(cv::Mat& img, const cv::Rect& roi);
+  /**
+   *   @brief Function to pre-process only the region of interest of the
+   *          input image
+   *
+   *   @param input image of type cv::Mat
+   *   @param processed image, zero outside the ROI, of type cv::Mat
+   *   @param workspace holding the intermediate images of type
+   *          FrameWorkspace
+   *   @return nothing
+   */
+  void preProcessingROI(cv::Mat& src, cv::Mat& dst,
+                        FrameWorkspace& workspace);
+  /**
+   *   @brief Function to build the bird's-eye geometry for an image size,
+   *          or pick the shared one, and hand out the inverse perspective
+   *          transform
+   *
+   *   @param size of the binary image of type cv::Size
+   *   @param inverse perspective transform, a header sharing the cached
+   *          3x3 matrix, of type cv::Mat
+   *   @param geometry built for the size of type const PerspectiveGeometry*
+   *   @param fused remap built for the size, used only with the fused
+   *          remap, of type const BirdsEyeRemap*
+   *   @return nothing
+   */
+  void updatePerspective(const cv::Size& imgSize, cv::Mat& T_perspective_inv,
+                         const PerspectiveGeometry*& geometry,
+                         const BirdsEyeRemap*& fusedMap);
 
  public:
   /**
@@ -84,6 +170,17 @@ class ImageProcessing {
    *   @return nothing
    */
   void preProcessing(cv::Mat& src, cv::Mat& dst);
+  /**
+   *   @brief Function to pre-process the input image without allocating
+   *          once the workspace buffers are sized
+   *
+   *   @param input image of type cv::Mat
+   *   @param processed image of type cv::Mat
+   *   @param workspace holding the intermediate images of type
+   *          FrameWorkspace
+   *   @return nothing
+   */
+  void preProcessing(cv::Mat& src, cv::Mat& dst, FrameWorkspace& workspace);
   /**
    *   @brief Function to get a binary image after color thresholding and edge
    *   detection
@@ -98,10 +195,28 @@ class ImageProcessing {
    *
    *   @param binary image of type cv::Mat
    *   @param bird's view image of type cv::Mat
+   *   @param inverse perspective transform, a header sharing the cached
+   *          3x3 matrix, of type cv::Mat
    *   @return nothing
    */
   void prespectiveTransform(cv::Mat& src, cv::Mat& dst,
                             cv::Mat& T_perspective_inv);
+  /**
+   *   @brief Function to perform prospective transform into a packed one
+   *          bit per pixel bird's-eye mask, set where the bird's-eye view
+   *          of the binary image is non-zero
+   *
+   *   @param binary image of type cv::Mat
+   *   @param packed bird's view image of type PackedBinaryImage
+   *   @param inverse perspective transform, a header sharing the cached
+   *          3x3 matrix, of type cv::Mat
+   *   @param workspace holding the intermediate images of type
+   *          FrameWorkspace
+   *   @return nothing
+   */
+  void prespectiveTransform(cv::Mat& src, PackedBinaryImage& dst,
+                            cv::Mat& T_perspective_inv,
+                            FrameWorkspace& workspace);
   /**
    *   @brief Function to set camera matrix
    *
@@ -138,6 +253,13 @@ class ImageProcessing {
    *   @return nothing
    */
   void setgaussianSigmaY(double gaussianSigmaY_);
+  /**
+   *   @brief Function to select the denoise filter of preProcessing
+   *
+   *   @param filter of type Denoiser::DenoiseMode
+   *   @return nothing
+   */
+  void setDenoiseMode(int denoiseMode_);
   /**
    *   @brief Function to set HSL color space minimum threshold value
    *
@@ -166,6 +288,61 @@ class ImageProcessing {
    *   @return nothing
    */
   void setMaxThreshBGR(cv::Scalar maxThreshBGR_);
+  /**
+   *   @brief Function to enable the fused raw sensor to bird's-eye remap.
+   *          When enabled preProcessing skips undistortion, getBinaryImg
+   *          thresholds the raw frame and prespectiveTransform undistorts
+   *          and warps the mask in one nearest neighbour pass
+   *
+   *   @param true to use the fused remap of type bool
+   *   @return nothing
+   */
+  void setFusedRemap(bool fusedRemap_);
+  /**
+   *   @brief Function to set the quadrilaterals of the perspective transform
+   *
+   *   @param four vertices in the camera image of type
+   *          std::vector<cv::Point2f>
+   *   @param four vertices in the bird's-eye image, or none to use the image
+   *          corners, of type std::vector<cv::Point2f>
+   *   @return nothing
+   */
+  void setPerspectiveQuads(const std::vector<cv::Point2f>& srcQuad,
+                           const std::vector<cv::Point2f>& dstQuad);
+  /**
+   *   @brief Function to set the region of the frame used for lane detection
+   *
+   *   @param region of interest of type cv::Rect
+   *   @return nothing
+   */
+  void setROI(cv::Rect roiRect_);
+  /**
+   *   @brief Function to enable ROI only processing. When enabled
+   *          undistortion, denoising, colour conversion and thresholding
+   *          only produce the rows and columns inside the ROI
+   *
+   *   @param true to process only the ROI of type bool
+   *   @return nothing
+   */
+  void setROIProcessing(bool roiProcessing_);
+  /**
+   *   @brief Function to set the convex polygon in which lanes appear
+   *
+   *   @param vertices of the polygon of type std::vector<cv::Point>
+   *   @return nothing
+   */
+  void setLaneROI(const std::vector<cv::Point>& laneROIVertices);
+  /**
+   *   @brief Function to add a colour range rule to the binary image, ORed
+   *          with the HLS and BGR threshold rules
+   *
+   *   @param colour space of type ColorThreshold::ColorSpace
+   *   @param lower bounds per channel of type cv::Scalar
+   *   @param upper bounds per channel of type cv::Scalar
+   *   @return index of the rule of type int
+   */
+  int addColorRule(int colorSpace, const cv::Scalar& lower,
+                   const cv::Scalar& upper);
   /**
    *   @brief Function to get camera matrix
    *
@@ -201,6 +378,21 @@ class ImageProcessing {
    *   @return standard deviation in Y for gaussian blur
    */
   double getgaussianSigmaY(void);
+  /**
+   *   @brief Function to get the denoise filter of preProcessing
+   *
+   *   @param nothing
+   *   @return filter of type Denoiser::DenoiseMode
+   */
+  int getDenoiseMode(void);
+  /**
+   *   @brief Function to check if the denoise stage is skipped because the
+   *          selected filter would not change any pixel
+   *
+   *   @param nothing
+   *   @return true if denoising is bypassed, type bool
+   */
+  bool isDenoiseBypassed(void);
   /**
    *   @brief Function to get HSL color space minimum threshold value
    *
@@ -229,6 +421,89 @@ class ImageProcessing {
    *   @return maximum threshold values for red,green and blue, type cv::Vec<double, 3>
    */
   cv::Scalar getMaxThreshBGR(void);
+  /**
+   *   @brief Function to check if the fused raw sensor to bird's-eye remap
+   *          is enabled
+   *
+   *   @param nothing
+   *   @return true if the fused remap is used, type bool
+   */
+  bool getFusedRemap(void);
+  /**
+   *   @brief Function to get the cached perspective geometry; the quads are
+   *          changed through setPerspectiveQuads, which drops the remaps
+   *          built from them
+   *
+   *   @param nothing
+   *   @return perspective geometry of type const PerspectiveGeometry&
+   */
+  const PerspectiveGeometry& getPerspectiveGeometry(void) const;
+  /**
+   *   @brief Function to get the region of the frame used for lane detection
+   *
+   *   @param nothing
+   *   @return region of interest of type cv::Rect
+   */
+  cv::Rect getROI(void);
+  /**
+   *   @brief Function to check if ROI only processing is enabled
+   *
+   *   @param nothing
+   *   @return true if only the ROI is processed, type bool
+   */
+  bool getROIProcessing(void);
+  /**
+   *   @brief Function to get the convex polygon in which lanes appear
+   *
+   *   @param nothing
+   *   @return vertices of the polygon of type std::vector<cv::Point>
+   */
+  std::vector<cv::Point> getLaneROI(void);
+  /**
+   *   @brief Function to get the colour threshold kernel, e.g. to read the
+   *          per rule hit counters
+   *
+   *   @param nothing
+   *   @return colour threshold kernel of type ColorThreshold&
+   */
+  ColorThreshold& getColorThreshold(void);
+  /**
+   *   @brief Function to build the undistortion maps, bird's-eye geometry
+   *          and lane polygon of the current calibration for sharing
+   *
+   *   @param frame size of type cv::Size
+   *   @return immutable artefacts of type
+   *           std::shared_ptr<const SharedCalibration>
+   */
+  std::shared_ptr<const SharedCalibration> buildSharedCalibration(
+      const cv::Size& imgSize);
+  /**
+   *   @brief Function to check if shared artefacts were built from the
+   *          current calibration
+   *
+   *   @param shared artefacts of type SharedCalibration
+   *   @return true if they can be used, type bool
+   */
+  bool canShareCalibration(const SharedCalibration& calibration);
+  /**
+   *   @brief Function to use shared artefacts instead of the own caches
+   *          for frames of their size. Changing the camera model, the
+   *          perspective quadrilaterals or the lane polygon drops them
+   *
+   *   @param artefacts of the current calibration, or null, of type
+   *          std::shared_ptr<const SharedCalibration>
+   *   @return nothing
+   */
+  void setSharedCalibration(
+      const std::shared_ptr<const SharedCalibration>& calibration);
+  /**
+   *   @brief Function to get the shared artefacts in use
+   *
+   *   @param nothing
+   *   @return artefacts, or null, of type
+   *           std::shared_ptr<const SharedCalibration>
+   */
+  std::shared_ptr<const SharedCalibration> getSharedCalibration(void);
 };
 
 #endif  // INCLUDE_IMAGEPROCESSING_HPP_
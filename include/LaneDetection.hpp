@@ -42,6 +42,7 @@
 
 #ifndef INCLUDE_LANEDETECTION_HPP_
 #define INCLUDE_LANEDETECTION_HPP_
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -50,13 +51,175 @@
 #include "opencv2/imgproc/imgproc.hpp"
 #include "opencv2/opencv.hpp"
 #include "opencv2/highgui/highgui.hpp"
+#include "FrameWorkspace.hpp"
+#include "ImageProcessing.hpp"
+#include "LanePointSet.hpp"
+#include "LaneTracker.hpp"
+#include "LaneVisualizer.hpp"
+#include "OccupancyIntegral.hpp"
+#include "PackedBinaryImage.hpp"
+#include "PolyFitter.hpp"
 
 class LaneDetection {
  private:
-  int windowBuffer;
-  std::vector<int> avgRightCenter;
+  LaneTracker laneTracker;  // filter of the lane bases and fits
+  LaneVisualizer visualizer;  // debug drawing and GUI, or a null sink
   cv::Mat leftLaneCoeffs;
   cv::Mat rightLaneCoeffs;
+  ImageProcessing processImage;  // image processing stage of the pipeline
+  double histBandBegin;  // top of the histogram band, fraction of height
+  double histBandEnd;  // bottom of the histogram band, fraction of height
+  int numWindows;  // sliding windows per lane
+  int windowWidth;  // sliding window width, 0 for twice the window height
+  int pyramidLevel;  // max pooled level the windows are centred on
+  bool trackingEnabled;  // search around the previous fits when confident
+  bool fittingEnabled;  // fit both lanes every frame for the output
+  bool trackValid;  // both lane fits are confident for the next frame
+  int trackMargin;  // half width of the band around the previous fits
+  std::size_t minTrackPixels;  // pixels per lane for a confident fit
+  PolyFitter laneFitter;  // quadratic fit of the tracked lanes
+  PolyFitter rightLaneFitter;  // settings of laneFitter for the right lane
+  uint64_t frameCount;  // frames processed
+  uint64_t fullSearchCount;  // frames that needed the full search
+  /**
+   *   @brief Function to follow a lane up the bird's-eye mask with sliding
+   *          windows, each centred on the mean x of the hits of the window
+   *          below it
+   *
+   *   @param packed projective transform of binary image of type
+   *          PackedBinaryImage
+   *   @param occupancy table of the packed image of type OccupancyIntegral
+   *   @param x coordinate of the centre of the bottom window of type int
+   *   @param pixels of the lane, one window per sliding window, of type
+   *          LanePointSet
+   *   @return nothing
+   */
+  void scanWindows(const PackedBinaryImage& perspectiveImg,
+                   const OccupancyIntegral& occupancy, int xStart,
+                   LanePointSet& dstLane);
+  /**
+   *   @brief Function to follow a lane up the bird's-eye mask coarse to fine.
+   *          Each sliding window is centred on the mean x of its hits in a
+   *          max pooled level of the mask; only a window narrower by the
+   *          scale around that centre is read at full resolution
+   *
+   *   @param packed projective transform of binary image of type
+   *          PackedBinaryImage
+   *   @param max pooled level of the packed image of type PackedBinaryImage
+   *   @param full resolution pixels per pooled pixel of type int
+   *   @param x coordinate of the centre of the bottom window of type int
+   *   @param pixels of the lane, one window per sliding window, of type
+   *          LanePointSet
+   *   @return nothing
+   */
+  void scanWindowsPyramid(const PackedBinaryImage& perspectiveImg,
+                          const PackedBinaryImage& coarseImg, int scale,
+                          int xStart, LanePointSet& dstLane);
+  /**
+   *   @brief Function to gather the pixels of a packed bird's-eye mask in a
+   *          band of trackMargin pixels on either side of a lane fit. The
+   *          rows are split bottom up into numWindows windows
+   *
+   *   @param packed projective transform of binary image of type
+   *          PackedBinaryImage
+   *   @param column of the lane as a polynomial in the row, coefficients in
+   *          increasing order of power, of type cv::Mat
+   *   @param pixels of the lane of type LanePointSet
+   *   @return nothing
+   */
+  void scanAroundFit(const PackedBinaryImage& perspectiveImg,
+                     const cv::Mat& laneCoeffs, LanePointSet& dstLane);
+  /**
+   *   @brief Function to search lanes concurrently, one task per lane. Each
+   *          task reads the mask and writes only its own lane's points, so
+   *          the result does not depend on the scheduling
+   *
+   *   @param packed projective transform of binary image of type
+   *          PackedBinaryImage
+   *   @param occupancy table of the packed image for the sliding windows of
+   *          type OccupancyIntegral*
+   *   @param max pooled image at pyramidLevel for the coarse to fine
+   *          sliding windows of type PackedBinaryImage*
+   *   @param x of the bottom window of each lane of type int*
+   *   @param fit of each lane to search around, or nullptr for the sliding
+   *          windows, of type cv::Mat*
+   *   @param number of lanes of type int
+   *   @param pixels of each lane, cleared first, of type
+   *          LanePointSet* const*
+   *   @return nothing
+   */
+  void searchLanes(const PackedBinaryImage& perspectiveImg,
+                   const OccupancyIntegral* occupancy,
+                   const PackedBinaryImage* coarseImg, const int* xStarts,
+                   const cv::Mat* laneFits, int numLanes,
+                   LanePointSet* const* dstLanes);
+  /**
+   *   @brief Function to get the start of a lane's sliding windows from the
+   *          peak of its half of the histogram
+   *
+   *   @param histogram containing lane pixels of type std::vector<double>
+   *   @param lane of type LaneTracker::Lane
+   *   @param full resolution pixels per histogram bin of type int
+   *   @return x of the centre of the bottom window of type int
+   */
+  int laneStart(const std::vector<double>& hist, int lane, int scale);
+  /**
+   *   @brief Function to follow a lane up a packed bird's-eye mask with
+   *          sliding windows from the peak of its half of the histogram,
+   *          appending its pixels to the legacy lane points
+   *
+   *   @param packed projective transform of binary image of type
+   *          PackedBinaryImage
+   *   @param occupancy table of the packed image of type OccupancyIntegral
+   *   @param histogram containing lane pixels of type std::vector<double>
+   *   @param lane to be extracted - left or right of type string
+   *   @param empty pixel set the windows are gathered in of type
+   *          LanePointSet
+   *   @param pixel locations of left or right lane, type std::vector<cv::Point_<int>>
+   *   @param debug image with the lane pixels marked of type cv::Mat
+   *   @return nothing
+   */
+  void extractLanePoints(const PackedBinaryImage& perspectiveImg,
+                         const OccupancyIntegral& occupancy,
+                         const std::vector<double>& hist,
+                         const std::string& laneType, LanePointSet& lanePts,
+                         std::vector<cv::Point>& dstLane,
+                         cv::Mat& drawWindow);
+  /**
+   *   @brief Function to fit each lane's column as a polynomial in the row
+   *          concurrently. A lane with too few pixels for the fit is left
+   *          empty
+   *
+   *   @param left lane pixels of type LanePointSet
+   *   @param right lane pixels of type LanePointSet
+   *   @param fit of each lane of type cv::Mat*
+   *   @return nothing
+   */
+  void fitLanes(const LanePointSet& leftLanePts,
+                const LanePointSet& rightLanePts, cv::Mat* laneFits);
+  /**
+   *   @brief Function to track the frame's fits for the next frame's search,
+   *          or to fall back to the full search if either lane has too few
+   *          pixels
+   *
+   *   @param left lane pixels of type LanePointSet
+   *   @param right lane pixels of type LanePointSet
+   *   @param frame's fit of each lane, or empty, of type cv::Mat*
+   *   @return nothing
+   */
+  void updateTrack(const LanePointSet& leftLanePts,
+                   const LanePointSet& rightLanePts, const cv::Mat* laneFits);
+  /**
+   *   @brief Function to get the start of a lane's sliding windows. A
+   *          histogram peak is filtered with the previous frames' peaks; an
+   *          empty histogram falls back to the lane's predicted position
+   *
+   *   @param lane of type LaneTracker::Lane
+   *   @param x of the lane's histogram peak of type int
+   *   @param true if the peak holds lane pixels of type bool
+   *   @return x of the centre of the bottom window of type int
+   */
+  int seedWindowCenter(int lane, int xPeak, bool isPeakValid);
 
  public:
   /**
@@ -82,13 +245,32 @@ class LaneDetection {
    */
   void generateHist(cv::Mat& src, std::vector<double>& hist);
   /**
-   *   @brief Function to get average of window center
+   *   @brief Function to generate lane pixel histogram from a packed
+   *          bird's-eye mask, equal to the histogram of the unpacked mask
    *
-   *   @param histogram containing lane pixels of type cv::Mat
-   *   @param pixel locations of left or right lane, type std::vector<cv::Point_<int>>
-   *   @param lane to be extracted - left or right of type string
+   *   @param packed projective transform of binary image of type
+   *          PackedBinaryImage
+   *   @param histogram containing lane pixels of type std::vector<double>
    *   @return nothing
    */
+  void generateHist(const PackedBinaryImage& src, std::vector<double>& hist);
+  /**
+   *   @brief Function to generate lane pixel histogram over the configured
+   *          band of rows from the occupancy table of the bird's-eye mask
+   *
+   *   @param occupancy table of the bird's-eye mask of type
+   *          OccupancyIntegral
+   *   @param histogram containing lane pixels of type std::vector<double>
+   *   @return nothing
+   */
+  void generateHist(const OccupancyIntegral& src, std::vector<double>& hist);
+  /**
+   *   @brief Function to get the start of the right lane's sliding windows,
+   *          the histogram peak filtered over the last frames
+   *
+   *   @param x of the right histogram peak of type int
+   *   @return x of the centre of the bottom window of type int
+   */
   int averageWindowCenter(int& xVal);
   /**
    *   @brief Function to extract left or right lane
@@ -102,6 +284,114 @@ class LaneDetection {
                    std::vector<cv::Point>& dstLane,
                    std::string laneType,
                    cv::Mat& drawWindow);
+  /**
+   *   @brief Function to extract left or right lane from a packed bird's-eye
+   *          mask, visiting only the set pixels with bit-scan
+   *
+   *   @param packed projective transform of binary image of type
+   *          PackedBinaryImage
+   *   @param histogram containing lane pixels of type std::vector<double>
+   *   @param pixel locations of left or right lane, type std::vector<cv::Point_<int>>
+   *   @param lane to be extracted - left or right of type string
+   *   @param debug image with the lane pixels marked of type cv::Mat
+   *   @return nothing
+   */
+  void extractLane(const PackedBinaryImage& perspectiveImg,
+                   std::vector<double>& hist,
+                   std::vector<cv::Point>& dstLane,
+                   std::string laneType,
+                   cv::Mat& drawWindow);
+  /**
+   *   @brief Function to extract left or right lane from a packed bird's-eye
+   *          mask, skipping windows the occupancy table reports empty and
+   *          visiting only the set pixels with bit-scan. A drawWindow of
+   *          another size is first initialised from the mask, otherwise
+   *          the lane pixels are drawn over its content
+   *
+   *   @param packed projective transform of binary image of type
+   *          PackedBinaryImage
+   *   @param occupancy table of the packed image of type OccupancyIntegral
+   *   @param histogram containing lane pixels of type std::vector<double>
+   *   @param pixel locations of left or right lane, type std::vector<cv::Point_<int>>
+   *   @param lane to be extracted - left or right of type string
+   *   @param debug image with the lane pixels marked of type cv::Mat
+   *   @return nothing
+   */
+  void extractLane(const PackedBinaryImage& perspectiveImg,
+                   const OccupancyIntegral& occupancy,
+                   std::vector<double>& hist,
+                   std::vector<cv::Point>& dstLane,
+                   std::string laneType,
+                   cv::Mat& drawWindow);
+  /**
+   *   @brief Function to extract left or right lane, packing the mask into
+   *          the workspace's packed bird's-eye buffer. The workspace
+   *          overloads reuse its buffers, so repeated calls allocate only
+   *          while the buffers grow
+   *
+   *   @param projective transform of binary image of type cv::Mat
+   *   @param histogram containing lane pixels of type std::vector<double>
+   *   @param pixel locations of left or right lane, type std::vector<cv::Point_<int>>
+   *   @param lane to be extracted - left or right of type string
+   *   @param debug image with the lane pixels marked of type cv::Mat
+   *   @param workspace whose buffers are reused of type FrameWorkspace
+   *   @return nothing
+   */
+  void extractLane(cv::Mat& perspectiveImg, std::vector<double>& hist,
+                   std::vector<cv::Point>& dstLane, std::string laneType,
+                   cv::Mat& drawWindow, FrameWorkspace& workspace);
+  /**
+   *   @brief Function to extract left or right lane from a packed bird's-eye
+   *          mask, building the occupancy table in the workspace
+   *
+   *   @param packed projective transform of binary image of type
+   *          PackedBinaryImage
+   *   @param histogram containing lane pixels of type std::vector<double>
+   *   @param pixel locations of left or right lane, type std::vector<cv::Point_<int>>
+   *   @param lane to be extracted - left or right of type string
+   *   @param debug image with the lane pixels marked of type cv::Mat
+   *   @param workspace whose buffers are reused of type FrameWorkspace
+   *   @return nothing
+   */
+  void extractLane(const PackedBinaryImage& perspectiveImg,
+                   std::vector<double>& hist,
+                   std::vector<cv::Point>& dstLane, std::string laneType,
+                   cv::Mat& drawWindow, FrameWorkspace& workspace);
+  /**
+   *   @brief Function to extract left or right lane from a packed bird's-eye
+   *          mask and its occupancy table, gathering the pixels in the
+   *          workspace's set of the lane
+   *
+   *   @param packed projective transform of binary image of type
+   *          PackedBinaryImage
+   *   @param occupancy table of the packed image of type OccupancyIntegral
+   *   @param histogram containing lane pixels of type std::vector<double>
+   *   @param pixel locations of left or right lane, type std::vector<cv::Point_<int>>
+   *   @param lane to be extracted - left or right of type string
+   *   @param debug image with the lane pixels marked of type cv::Mat
+   *   @param workspace whose buffers are reused of type FrameWorkspace
+   *   @return nothing
+   */
+  void extractLane(const PackedBinaryImage& perspectiveImg,
+                   const OccupancyIntegral& occupancy,
+                   std::vector<double>& hist,
+                   std::vector<cv::Point>& dstLane, std::string laneType,
+                   cv::Mat& drawWindow, FrameWorkspace& workspace);
+  /**
+   *   @brief Function to extract left or right lane from a packed bird's-eye
+   *          mask by gathering the pixels in a band of trackMargin pixels on
+   *          either side of the lane's previous fit
+   *
+   *   @param packed projective transform of binary image of type
+   *          PackedBinaryImage
+   *   @param pixel locations of left or right lane, type std::vector<cv::Point_<int>>
+   *   @param lane to be extracted - left or right of type string
+   *   @param debug image with the lane pixels marked of type cv::Mat
+   *   @return nothing
+   */
+  void extractLaneAroundFit(const PackedBinaryImage& perspectiveImg,
+                            std::vector<cv::Point>& dstLane,
+                            std::string laneType, cv::Mat& drawWindow);
   /**
    *   @brief Function to fit a polynomial on the received lane pixel data
    *
@@ -132,9 +422,274 @@ class LaneDetection {
    *   @brief Function to implement the entire system pipeline
    *
    *   @param nothing
+   *   @return false if the video could not be opened, type bool
+   */
+  bool detectLanes(void);
+  /**
+   *   @brief Function to run the pipeline on one frame. Once the workspace
+   *          is sized for the frame no intermediate image is allocated;
+   *          the result is left in the FrameWorkspace::OUTPUT_FRAME buffer.
+   *          With tracking enabled, frames after a confident fit of both
+   *          lanes skip the histogram and the sliding windows. The lanes
+   *          are searched and fitted concurrently. With the null
+   *          visualization sink nothing is drawn and OUTPUT_FRAME is left
+   *          untouched
+   *
+   *   @param input frame of type cv::Mat
+   *   @param workspace holding the intermediate images of type
+   *          FrameWorkspace
+   *   @return nothing
+   */
+  void processFrame(cv::Mat& frame, FrameWorkspace& workspace);
+  /**
+   *   @brief Function to run the geometric and colour stage of the pipeline:
+   *          pre-process and threshold a frame and pack its bird's-eye mask
+   *          into the workspace
+   *
+   *   @param input frame of type cv::Mat
+   *   @param workspace holding the intermediate images of type
+   *          FrameWorkspace
+   *   @return nothing
+   */
+  void transformFrame(cv::Mat& frame, FrameWorkspace& workspace);
+  /**
+   *   @brief Function to run the lane search and fitting stage of the
+   *          pipeline on the bird's-eye mask of the workspace, leaving the
+   *          lane pixels and fits in the workspace
+   *
+   *   @param workspace holding the intermediate images of type
+   *          FrameWorkspace
+   *   @return nothing
+   */
+  void searchFrame(FrameWorkspace& workspace);
+  /**
+   *   @brief Function to run the output stage of the pipeline: draw the
+   *          lanes of the workspace and composite them on the frame into the
+   *          FrameWorkspace::OUTPUT_FRAME buffer, unless visualization is off
+   *
+   *   @param input frame of type cv::Mat
+   *   @param workspace holding the intermediate images of type
+   *          FrameWorkspace
+   *   @return nothing
+   */
+  void renderFrame(const cv::Mat& frame, FrameWorkspace& workspace);
+  /**
+   *   @brief Function to get the image processing stage of the pipeline
+   *
+   *   @param nothing
+   *   @return image processing stage of type ImageProcessing&
+   */
+  ImageProcessing& getImageProcessing(void);
+  /**
+   *   @brief Function to get the fitter of the lanes tracked across frames
+   *
+   *   @param nothing
+   *   @return lane fitter of type PolyFitter&
+   */
+  PolyFitter& getLaneFitter(void);
+  /**
+   *   @brief Function to get the temporal filter of the lanes
+   *
+   *   @param nothing
+   *   @return lane tracker of type LaneTracker&
+   */
+  LaneTracker& getLaneTracker(void);
+  /**
+   *   @brief Function to get the debug visualization of the pipeline
+   *
+   *   @param nothing
+   *   @return visualization sink of type LaneVisualizer&
+   */
+  LaneVisualizer& getVisualizer(void);
+  /**
+   *   @brief Function to set the number of sliding windows per lane
+   *
+   *   @param number of windows of type int
+   *   @return nothing
+   */
+  void setNumWindows(int numWindows_);
+  /**
+   *   @brief Function to set the width of the sliding windows
+   *
+   *   @param width in pixels, 0 for twice the window height, of type int
+   *   @return nothing
+   */
+  void setWindowWidth(int windowWidth_);
+  /**
+   *   @brief Function to get the number of sliding windows per lane
+   *
+   *   @param nothing
+   *   @return number of windows of type int
+   */
+  int getNumWindows(void);
+  /**
+   *   @brief Function to get the width of the sliding windows
+   *
+   *   @param nothing
+   *   @return width in pixels, 0 for twice the window height, of type int
+   */
+  int getWindowWidth(void);
+  /**
+   *   @brief Function to set the band of rows the lane histogram is computed
+   *          over, as fractions of the image height
+   *
+   *   @param top of the band, 0 is the top row, of type double
+   *   @param bottom of the band, 1 is below the bottom row, of type double
+   *   @return nothing
+   */
+  void setHistBand(double histBandBegin_, double histBandEnd_);
+  /**
+   *   @brief Function to get the band of rows the lane histogram is computed
+   *          over, as fractions of the image height
+   *
+   *   @param nothing
+   *   @return top and bottom of the band of type cv::Vec2d
+   */
+  cv::Vec2d getHistBand(void);
+  /**
+   *   @brief Function to set the level of the max pooled bird's-eye mask the
+   *          sliding windows are centred on
+   *
+   *   @param level, 0 for full resolution, 1 for 1/2 scale up to
+   *          FrameWorkspace::MAX_PYRAMID_LEVEL, of type int
+   *   @return nothing
+   */
+  void setPyramidLevel(int pyramidLevel_);
+  /**
+   *   @brief Function to get the level of the max pooled bird's-eye mask the
+   *          sliding windows are centred on
+   *
+   *   @param nothing
+   *   @return level, 0 for full resolution, of type int
+   */
+  int getPyramidLevel(void);
+  /**
+   *   @brief Function to enable searching around the previous fits once both
+   *          lanes are fitted with confidence
+   *
+   *   @param true to enable tracking of type bool
+   *   @return nothing
+   */
+  void setTracking(bool trackingEnabled_);
+  /**
+   *   @brief Function to check if searching around the previous fits is
+   *          enabled
+   *
+   *   @param nothing
+   *   @return true if tracking is enabled of type bool
+   */
+  bool isTracking(void);
+  /**
+   *   @brief Function to fit both lanes every frame, even when neither the
+   *          tracking nor the visualization needs the fits
+   *
+   *   @param true to fit every frame of type bool
+   *   @return nothing
+   */
+  void setLaneFitting(bool fittingEnabled_);
+  /**
+   *   @brief Function to check if both lanes are fitted every frame
+   *
+   *   @param nothing
+   *   @return true if fitting every frame of type bool
+   */
+  bool isLaneFitting(void);
+  /**
+   *   @brief Function to check if the next frame will be searched around the
+   *          previous fits
+   *
+   *   @param nothing
+   *   @return true if both lanes have a confident fit of type bool
+   */
+  bool isTrackValid(void);
+  /**
+   *   @brief Function to drop the previous fits, so the next frame is searched
+   *          in full; the coefficients are released rather than cleared, so a
+   *          copy never writes into the buffers of the fits it was copied from
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void resetTrack(void);
+  /**
+   *   @brief Function to set the half width of the band searched around the
+   *          previous fits
+   *
+   *   @param margin in pixels of type int
+   *   @return nothing
+   */
+  void setTrackMargin(int trackMargin_);
+  /**
+   *   @brief Function to get the half width of the band searched around the
+   *          previous fits
+   *
+   *   @param nothing
+   *   @return margin in pixels of type int
+   */
+  int getTrackMargin(void);
+  /**
+   *   @brief Function to set the number of pixels each lane needs for its fit
+   *          to be trusted for the next frame
+   *
+   *   @param number of pixels of type std::size_t
+   *   @return nothing
+   */
+  void setMinTrackPixels(std::size_t minTrackPixels_);
+  /**
+   *   @brief Function to get the number of pixels each lane needs for its fit
+   *          to be trusted for the next frame
+   *
+   *   @param nothing
+   *   @return number of pixels of type std::size_t
+   */
+  std::size_t getMinTrackPixels(void);
+  /**
+   *   @brief Function to set the fit of a lane, column as a polynomial in the
+   *          row, and search around it from the next frame on
+   *
+   *   @param lane to be set - left or right of type string
+   *   @param coefficients in increasing order of power of type cv::Mat
+   *   @return nothing
+   */
+  void setLaneFit(std::string laneType, const cv::Mat& coeffs);
+  /**
+   *   @brief Function to get the fit of a lane, column as a polynomial in the
+   *          row
+   *
+   *   @param lane to be returned - left or right of type string
+   *   @return coefficients in increasing order of power of type cv::Mat
+   */
+  cv::Mat getLaneFit(std::string laneType);
+  /**
+   *   @brief Function to get the number of frames processed
+   *
+   *   @param nothing
+   *   @return number of frames of type uint64_t
+   */
+  uint64_t getFrameCount(void);
+  /**
+   *   @brief Function to get the number of frames that needed the full
+   *          histogram and sliding window search
+   *
+   *   @param nothing
+   *   @return number of frames of type uint64_t
+   */
+  uint64_t getFullSearchCount(void);
+  /**
+   *   @brief Function to get the share of processed frames that needed the
+   *          full histogram and sliding window search
+   *
+   *   @param nothing
+   *   @return share of frames in [0, 1], 0 before any frame, of type double
+   */
+  double getFullSearchRatio(void);
+  /**
+   *   @brief Function to reset the frame and full search counts
+   *
+   *   @param nothing
    *   @return nothing
    */
-  void detectLanes(void);
+  void resetSearchStats(void);
 };
 
 #endif  // INCLUDE_LANEDETECTION_HPP_
@@ -0,0 +1,249 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    LaneDetectionEngine.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Lane Detection Engine Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for running many independent streams, e.g. the cameras of
+ *  a vehicle or recorded drives, on a fixed pool of worker threads. Every
+ *  stream owns its lane detection, tracker state and frame workspace, and
+ *  its frames are processed one at a time in order; workers pick whichever
+ *  stream is ready next. The undistortion maps, bird's-eye geometry and
+ *  lane polygon are built once per calibration and frame size and shared
+ *  read-only by all streams using them, as are the colour threshold
+ *  tables of streams copied from the same settings.
+ *
+ */
+
+#ifndef INCLUDE_LANEDETECTIONENGINE_HPP_
+#define INCLUDE_LANEDETECTIONENGINE_HPP_
+#include <stdint.h>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "opencv2/core/core.hpp"
+#include "opencv2/highgui/highgui.hpp"
+#include "FramePipeline.hpp"
+#include "FrameWorkspace.hpp"
+#include "LaneDetection.hpp"
+#include "SharedCalibration.hpp"
+
+class LaneDetectionEngine {
+ private:
+  /**
+   *  Everything one stream needs between its frames
+   */
+  struct Stream {
+    LaneDetection lanes;  // settings, tracker and fits of the stream
+    FramePipeline::FrameSource readFrame;  // source of the frames
+    FramePipeline::FrameSink frameSink;  // consumer of the frames, or empty
+    cv::Mat frame;  // frame being processed
+    FrameWorkspace workspace;  // intermediate images of the frame
+    cv::Size calibratedSize;  // frame size shared calibration is set for
+    uint64_t frameIdx;  // index of the next frame in the stream
+    uint64_t framesProcessed;  // frames handed to the sink in this run
+    /**
+     *   @brief Constructor for Stream
+     *
+     *   @param settings to copy of type LaneDetection
+     *   @return nothing
+     */
+    explicit Stream(const LaneDetection& lanes_);
+  };
+  LaneDetection lanes;  // settings new streams are copied from
+  int numWorkers;  // threads processing the streams
+  std::vector<std::unique_ptr<Stream> > streams;  // streams of the engine
+  // artefacts built so far, one per calibration and frame size
+  std::vector<std::shared_ptr<const SharedCalibration> > calibrations;
+  std::mutex calibrationMutex;  // guards calibrations
+  std::mutex scheduleMutex;  // guards the scheduling state below
+  std::condition_variable streamReady;  // signals readyStreams or the end
+  std::deque<int> readyStreams;  // streams waiting for a worker
+  int activeStreams;  // streams not yet ended in this run
+  bool stopRequested;  // a stream failed
+  std::exception_ptr error;  // first failure of a stream
+  /**
+   *   @brief Function to prepare settings for copying into streams: the
+   *          colour tables are built once so every copy shares them
+   *
+   *   @param settings of type LaneDetection
+   *   @return nothing
+   */
+  void prepareSettings(LaneDetection& settings);
+  /**
+   *   @brief Function to point a stream at the shared artefacts of its
+   *          calibration, building them if no stream did yet
+   *
+   *   @param stream of type Stream
+   *   @param frame size of type cv::Size
+   *   @return nothing
+   */
+  void attachCalibration(Stream& stream, const cv::Size& imgSize);
+  /**
+   *   @brief Function to read, process and hand on the next frame of a
+   *          stream
+   *
+   *   @param stream of type Stream
+   *   @return false at the end of the stream or if the sink stopped it,
+   *          type bool
+   */
+  bool processFrame(Stream& stream);
+  /**
+   *   @brief Function to process frames of ready streams until every
+   *          stream ended
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void workerLoop(void);
+
+ public:
+  /**
+   *   @brief Default constructor for LaneDetectionEngine
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  LaneDetectionEngine();
+  /**
+   *   @brief Default destructor for LaneDetectionEngine
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ~LaneDetectionEngine();
+  /**
+   *   @brief Function to get the settings new streams are copied from
+   *
+   *   @param nothing
+   *   @return lane detection of type LaneDetection&
+   */
+  LaneDetection& getLaneDetection(void);
+  /**
+   *   @brief Function to set the number of worker threads, including the
+   *          thread calling run
+   *
+   *   @param number of threads, at least 1, of type int
+   *   @return nothing
+   */
+  void setNumWorkers(int numWorkers_);
+  /**
+   *   @brief Function to get the number of worker threads
+   *
+   *   @param nothing
+   *   @return number of threads of type int
+   */
+  int getNumWorkers(void);
+  /**
+   *   @brief Function to add a stream with the engine's settings
+   *
+   *   @param source of the frames of type FramePipeline::FrameSource
+   *   @param consumer of the processed frames, called on a worker thread,
+   *          or empty, of type FramePipeline::FrameSink
+   *   @return index of the stream of type int
+   */
+  int addStream(const FramePipeline::FrameSource& readFrame,
+                const FramePipeline::FrameSink& frameSink);
+  /**
+   *   @brief Function to add a stream with its own settings, e.g. the
+   *          calibration of its camera
+   *
+   *   @param settings to copy of type LaneDetection
+   *   @param source of the frames of type FramePipeline::FrameSource
+   *   @param consumer of the processed frames, called on a worker thread,
+   *          or empty, of type FramePipeline::FrameSink
+   *   @return index of the stream of type int
+   */
+  int addStream(LaneDetection& settings,
+                const FramePipeline::FrameSource& readFrame,
+                const FramePipeline::FrameSink& frameSink);
+  /**
+   *   @brief Function to remove all streams; the shared calibrations are
+   *          kept for later streams
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void clearStreams(void);
+  /**
+   *   @brief Function to get the number of streams
+   *
+   *   @param nothing
+   *   @return number of streams of type int
+   */
+  int getNumStreams(void);
+  /**
+   *   @brief Function to get the lane detection of a stream
+   *
+   *   @param index of the stream of type int
+   *   @return lane detection of type LaneDetection&
+   */
+  LaneDetection& getStreamLanes(int streamIdx);
+  /**
+   *   @brief Function to get the number of frames of a stream the last run
+   *          handed on
+   *
+   *   @param index of the stream of type int
+   *   @return number of frames of type uint64_t
+   */
+  uint64_t getFramesProcessed(int streamIdx);
+  /**
+   *   @brief Function to get the number of frames of all streams the last
+   *          run handed on
+   *
+   *   @param nothing
+   *   @return number of frames of type uint64_t
+   */
+  uint64_t getFramesProcessed(void);
+  /**
+   *   @brief Function to get the number of distinct shared calibrations
+   *          built
+   *
+   *   @param nothing
+   *   @return number of calibrations of type int
+   */
+  int getNumCalibrations(void);
+  /**
+   *   @brief Function to process every stream until it ends or its sink
+   *          stops it. The calling thread is one of the workers; the first
+   *          failure of a stream stops all and is rethrown here
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void run(void);
+};
+
+#endif  // INCLUDE_LANEDETECTIONENGINE_HPP_
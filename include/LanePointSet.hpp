@@ -0,0 +1,200 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    LanePointSet.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Lane Point Set Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for the pixels of one lane, stored as separate
+ *  contiguous arrays of columns and rows with the number of hits of every
+ *  sliding window. The fitter, the tracker and the renderer read the
+ *  arrays in place, so a lane is never converted between point formats.
+ *
+ */
+
+#ifndef INCLUDE_LANEPOINTSET_HPP_
+#define INCLUDE_LANEPOINTSET_HPP_
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include "opencv2/core/core.hpp"
+
+class LanePointSet {
+ private:
+  std::vector<int> xs;  // column of every pixel
+  std::vector<int> ys;  // row of every pixel
+  std::vector<std::size_t> windowEnds;  // pixels up to the end of every
+                                        // window, bottom window first
+
+ public:
+  /**
+   *   @brief Default constructor for LanePointSet
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  LanePointSet();
+  /**
+   *   @brief Default destructor for LanePointSet
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ~LanePointSet();
+  /**
+   *   @brief Function to reserve room, so filling the set does not
+   *          allocate
+   *
+   *   @param number of pixels of type std::size_t
+   *   @param number of windows of type int
+   *   @return nothing
+   */
+  void reserve(std::size_t capacity, int numWindows);
+  /**
+   *   @brief Function to reserve room for every pixel of a lane's sliding
+   *          windows
+   *
+   *   @param size of the bird's-eye image of type cv::Size
+   *   @param number of windows of type int
+   *   @param width of the windows, 0 for twice their height, of type int
+   *   @return nothing
+   */
+  void reserveForWindows(const cv::Size& imgSize, int numWindows,
+                         int windowWidth);
+  /**
+   *   @brief Function to drop all pixels and windows, keeping the capacity
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void clear(void);
+  /**
+   *   @brief Function to add a pixel to the current window
+   *
+   *   @param column of type int
+   *   @param row of type int
+   *   @return nothing
+   */
+  inline void push(int x, int y) {
+    xs.push_back(x);
+    ys.push_back(y);
+  }
+  /**
+   *   @brief Function to close the current window; the pixels added since
+   *          the last window belong to it
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void endWindow(void);
+  /**
+   *   @brief Function to get the number of pixels
+   *
+   *   @param nothing
+   *   @return number of pixels of type std::size_t
+   */
+  std::size_t size(void) const;
+  /**
+   *   @brief Function to check if the set holds no pixel
+   *
+   *   @param nothing
+   *   @return true if empty, type bool
+   */
+  bool empty(void) const;
+  /**
+   *   @brief Function to get the number of pixels the set can hold without
+   *          allocating
+   *
+   *   @param nothing
+   *   @return number of pixels of type std::size_t
+   */
+  std::size_t capacity(void) const;
+  /**
+   *   @brief Function to get the columns of the pixels
+   *
+   *   @param nothing
+   *   @return contiguous columns of type const int*
+   */
+  const int* getX(void) const;
+  /**
+   *   @brief Function to get the rows of the pixels
+   *
+   *   @param nothing
+   *   @return contiguous rows of type const int*
+   */
+  const int* getY(void) const;
+  /**
+   *   @brief Function to get the number of closed windows
+   *
+   *   @param nothing
+   *   @return number of windows of type int
+   */
+  int getNumWindows(void) const;
+  /**
+   *   @brief Function to get the number of hits of a window
+   *
+   *   @param window, 0 for the bottom one, of type int
+   *   @return number of pixels of type std::size_t
+   */
+  std::size_t getWindowCount(int window) const;
+  /**
+   *   @brief Function to get the first pixel of a window
+   *
+   *   @param window, 0 for the bottom one, of type int
+   *   @return index of the pixel of type std::size_t
+   */
+  std::size_t getWindowBegin(int window) const;
+  /**
+   *   @brief Function to get the mean column of the hits of a window
+   *
+   *   @param window, 0 for the bottom one, of type int
+   *   @return column of type double, 0 for an empty window
+   */
+  double getWindowMeanX(int window) const;
+  /**
+   *   @brief Function to append the pixels as points of (row, column), the
+   *          order of the std::vector<cv::Point> lane interface
+   *
+   *   @param points of type std::vector<cv::Point>
+   *   @return nothing
+   */
+  void appendTo(std::vector<cv::Point>& dstLane) const;
+  /**
+   *   @brief Function to check if two sets hold the same pixels in the same
+   *          windows
+   *
+   *   @param set to compare with of type LanePointSet
+   *   @return true if equal, type bool
+   */
+  bool operator==(const LanePointSet& other) const;
+};
+
+#endif  // INCLUDE_LANEPOINTSET_HPP_
@@ -0,0 +1,305 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    LaneTracker.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Lane Tracker Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for the temporal filter of the lanes. It smooths each
+ *  lane's base position and polynomial coefficients over frames with a
+ *  moving average, an exponential filter or a constant velocity Kalman
+ *  filter, and predicts them for the next frame. The history is a fixed
+ *  capacity ring buffer, so an update is O(1) per value and does not
+ *  allocate.
+ *
+ */
+
+#ifndef INCLUDE_LANETRACKER_HPP_
+#define INCLUDE_LANETRACKER_HPP_
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include "opencv2/core/core.hpp"
+
+class LaneTracker {
+ public:
+  /**
+   *  Tracked lanes.
+   */
+  enum Lane {
+    LEFT_LANE = 0,
+    RIGHT_LANE,
+    NUM_LANES
+  };
+  /**
+   *  Temporal filters.
+   */
+  enum TrackMode {
+    TRACK_MOVING_AVERAGE = 0,  // mean of the last historyLength values;
+                               // predicts the mean
+    TRACK_EXPONENTIAL,  // state += gain * (value - state); predicts the
+                        // state
+    TRACK_KALMAN  // position and velocity per value, with process noise
+                  // relative to the measurement noise; predicts one frame
+                  // of motion ahead
+  };
+
+ private:
+  /**
+   *  Filter state of a group of values tracked together.
+   */
+  struct Channel {
+    int size;  // values in the group
+    int count;  // updates since the last reset
+    int head;  // ring slot of the next value
+    std::vector<double> history;  // ring of historyLength groups of values
+    std::vector<double> sum;  // sum of the values in the ring
+    std::vector<double> state;  // filtered values
+    std::vector<double> velocity;  // change per frame of the Kalman filter
+    std::vector<double> covariance;  // Kalman P00, P01, P11 per value
+  };
+  enum ChannelType {
+    BASE_CHANNEL = 0,  // x of the lane at the bottom of the image
+    FIT_CHANNEL,  // polynomial coefficients of the lane
+    NUM_CHANNELS
+  };
+  int mode;  // selected TrackMode
+  int historyLength;  // capacity of the ring buffers
+  int order;  // degree of the tracked polynomials
+  double gain;  // weight of a new value in the exponential filter
+  double processNoise;  // Kalman process noise over measurement noise
+  Channel channels[NUM_LANES][NUM_CHANNELS];
+  /**
+   *   @brief Function to size a channel and clear its history
+   *
+   *   @param channel of type Channel
+   *   @param number of values of type int
+   *   @return nothing
+   */
+  void allocateChannel(Channel& channel, int size);
+  /**
+   *   @brief Function to clear the history and the filter state of a channel
+   *
+   *   @param channel of type Channel
+   *   @return nothing
+   */
+  void resetChannel(Channel& channel);
+  /**
+   *   @brief Function to filter a new group of values into a channel
+   *
+   *   @param channel of type Channel
+   *   @param values of type double*
+   *   @return nothing
+   */
+  void updateChannel(Channel& channel, const double* values);
+  /**
+   *   @brief Function to get a lane's channel
+   *
+   *   @param lane of type LaneTracker::Lane
+   *   @param channel of type ChannelType
+   *   @return channel of type Channel&
+   */
+  Channel& getChannel(int lane, int channelType);
+
+ public:
+  /**
+   *   @brief Default constructor for LaneTracker
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  LaneTracker();
+  /**
+   *   @brief Default destructor for LaneTracker
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ~LaneTracker();
+  /**
+   *   @brief Function to select the temporal filter; clears the tracks
+   *
+   *   @param filter of type LaneTracker::TrackMode
+   *   @return nothing
+   */
+  void setMode(int mode_);
+  /**
+   *   @brief Function to get the temporal filter
+   *
+   *   @param nothing
+   *   @return filter of type LaneTracker::TrackMode
+   */
+  int getMode(void);
+  /**
+   *   @brief Function to set the capacity of the history; reallocates the
+   *          ring buffers and clears the tracks
+   *
+   *   @param number of frames of type int
+   *   @return nothing
+   */
+  void setHistoryLength(int historyLength_);
+  /**
+   *   @brief Function to get the capacity of the history
+   *
+   *   @param nothing
+   *   @return number of frames of type int
+   */
+  int getHistoryLength(void);
+  /**
+   *   @brief Function to set the degree of the tracked polynomials;
+   *          reallocates the ring buffers and clears the tracks
+   *
+   *   @param degree of type int
+   *   @return nothing
+   */
+  void setOrder(int order_);
+  /**
+   *   @brief Function to get the degree of the tracked polynomials
+   *
+   *   @param nothing
+   *   @return degree of type int
+   */
+  int getOrder(void);
+  /**
+   *   @brief Function to set the weight of a new value in the exponential
+   *          filter
+   *
+   *   @param gain in (0, 1] of type double
+   *   @return nothing
+   */
+  void setGain(double gain_);
+  /**
+   *   @brief Function to get the weight of a new value in the exponential
+   *          filter
+   *
+   *   @param nothing
+   *   @return gain of type double
+   */
+  double getGain(void);
+  /**
+   *   @brief Function to set the Kalman process noise relative to the
+   *          measurement noise; larger values follow changes faster
+   *
+   *   @param ratio of the noise variances of type double
+   *   @return nothing
+   */
+  void setProcessNoise(double processNoise_);
+  /**
+   *   @brief Function to get the Kalman process noise relative to the
+   *          measurement noise
+   *
+   *   @param nothing
+   *   @return ratio of the noise variances of type double
+   */
+  double getProcessNoise(void);
+  /**
+   *   @brief Function to clear the tracks of both lanes
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void reset(void);
+  /**
+   *   @brief Function to clear the polynomial track of a lane, keeping its
+   *          base position
+   *
+   *   @param lane of type LaneTracker::Lane
+   *   @return nothing
+   */
+  void resetFit(int lane);
+  /**
+   *   @brief Function to filter a new base position of a lane
+   *
+   *   @param lane of type LaneTracker::Lane
+   *   @param x of the lane at the bottom of the image of type double
+   *   @return nothing
+   */
+  void updateBase(int lane, double base);
+  /**
+   *   @brief Function to filter new polynomial coefficients of a lane
+   *
+   *   @param lane of type LaneTracker::Lane
+   *   @param order + 1 coefficients in increasing order of power of type
+   *          cv::Mat
+   *   @return nothing
+   */
+  void updateFit(int lane, const cv::Mat& coeffs);
+  /**
+   *   @brief Function to check if a lane's base position is tracked
+   *
+   *   @param lane of type LaneTracker::Lane
+   *   @return true after an update of the base, type bool
+   */
+  bool hasBase(int lane);
+  /**
+   *   @brief Function to check if a lane's polynomial is tracked
+   *
+   *   @param lane of type LaneTracker::Lane
+   *   @return true after an update of the fit, type bool
+   */
+  bool hasFit(int lane);
+  /**
+   *   @brief Function to get the filtered base position of a lane
+   *
+   *   @param lane of type LaneTracker::Lane
+   *   @return x of the lane at the bottom of the image of type double
+   */
+  double getBase(int lane);
+  /**
+   *   @brief Function to predict the base position of a lane in the next
+   *          frame
+   *
+   *   @param lane of type LaneTracker::Lane
+   *   @return x of the lane at the bottom of the image of type double
+   */
+  double predictBase(int lane);
+  /**
+   *   @brief Function to get the filtered polynomial coefficients of a lane
+   *
+   *   @param lane of type LaneTracker::Lane
+   *   @param coefficients in increasing order of power, as a column of
+   *          CV_64F, of type cv::Mat
+   *   @return nothing
+   */
+  void getFit(int lane, cv::Mat& coeffs);
+  /**
+   *   @brief Function to predict the polynomial coefficients of a lane in
+   *          the next frame
+   *
+   *   @param lane of type LaneTracker::Lane
+   *   @param coefficients in increasing order of power, as a column of
+   *          CV_64F, of type cv::Mat
+   *   @return nothing
+   */
+  void predictFit(int lane, cv::Mat& coeffs);
+};
+
+#endif  // INCLUDE_LANETRACKER_HPP_
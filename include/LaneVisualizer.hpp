@@ -0,0 +1,303 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    LaneVisualizer.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Lane Visualizer Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for the debug visualization of the lane detection
+ *  pipeline. The visualization is a sink the pipeline hands its results
+ *  to; the null sink does no drawing, colour conversion, GUI calls or
+ *  waiting, so headless runs pay nothing for it.
+ *
+ */
+
+#ifndef INCLUDE_LANEVISUALIZER_HPP_
+#define INCLUDE_LANEVISUALIZER_HPP_
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "opencv2/core/core.hpp"
+#include "opencv2/highgui/highgui.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+#include "LanePointSet.hpp"
+#include "LaneTracker.hpp"
+#include "PackedBinaryImage.hpp"
+
+class LaneVisualizer {
+ public:
+  /**
+   *  Visualization sinks.
+   */
+  enum VisualizationMode {
+    VISUALIZE_NONE = 0,  // null sink, nothing is drawn or shown
+    VISUALIZE_OVERLAY,  // lanes drawn on the bird's-eye mask and composited
+                        // on the frame, no GUI
+    VISUALIZE_WINDOW  // overlay shown in a window, waiting waitTime ms for
+                      // a key every frame
+  };
+  /**
+   *  Ways of compositing the lanes on the frame.
+   */
+  enum RenderMode {
+    RENDER_WARP = 0,  // lane pixels drawn on the bird's-eye mask, which is
+                      // warped back over the whole frame
+    RENDER_SPARSE  // lane fits sampled, projected into the frame and
+                   // blended over their bounding box only
+  };
+
+ private:
+  int mode;  // selected VisualizationMode
+  int renderMode;  // selected RenderMode
+  int waitTime;  // ms to wait for a key after showing a frame
+  std::string windowName;  // title of the window
+  bool isWindowOpen;  // a frame was shown since the last close
+  double alpha;  // opacity of the sparse lane overlay
+  int numSamples;  // rows each lane fit is sampled at
+  int lineWidth;  // thickness of the sparse lane curves
+  std::vector<cv::Point2f> birdsEyePts;  // samples of the lane fits
+  std::vector<cv::Point2f> cameraPts;  // the samples projected in the frame
+  // projected samples of each lane, relative to the blended region
+  std::vector<cv::Point2d> laneCurves[LaneTracker::NUM_LANES];
+  std::vector<cv::Point2d> lanePolygon;  // area between the lane curves
+  std::vector<double> crossings;  // polygon edges crossing a row
+  /**
+   *   @brief Function to reserve the sample and polygon vectors for the
+   *          number of samples, so drawing the overlay does not allocate
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void reserveSamples(void);
+  /**
+   *   @brief Function to fill a polygon, even-odd, with pixel centres on
+   *          integer coordinates and each edge covering the rows from its
+   *          upper end up to but not including its lower end
+   *
+   *   @param colour image to draw in of type cv::Mat
+   *   @param vertices of the polygon of type cv::Point2d*
+   *   @param number of vertices of type int
+   *   @param colour of type cv::Vec3b
+   *   @return nothing
+   */
+  void fillPolygon(cv::Mat& img, const cv::Point2d* pts, int numPts,
+                   const cv::Vec3b& color);
+  /**
+   *   @brief Function to draw an open curve lineWidth wide, each segment
+   *          as a rectangle extended by half the width at both ends, so the
+   *          segments overlap at the joints
+   *
+   *   @param colour image to draw in of type cv::Mat
+   *   @param points of the curve of type std::vector<cv::Point2d>
+   *   @param colour of type cv::Vec3b
+   *   @return nothing
+   */
+  void drawCurve(cv::Mat& img, const std::vector<cv::Point2d>& curve,
+                 const cv::Vec3b& color);
+
+ public:
+  /**
+   *   @brief Default constructor for LaneVisualizer
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  LaneVisualizer();
+  /**
+   *   @brief Default destructor for LaneVisualizer
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ~LaneVisualizer();
+  /**
+   *   @brief Function to select the visualization sink
+   *
+   *   @param sink of type LaneVisualizer::VisualizationMode
+   *   @return nothing
+   */
+  void setMode(int mode_);
+  /**
+   *   @brief Function to get the visualization sink
+   *
+   *   @param nothing
+   *   @return sink of type LaneVisualizer::VisualizationMode
+   */
+  int getMode(void);
+  /**
+   *   @brief Function to check if the pipeline should render its results
+   *
+   *   @param nothing
+   *   @return false for the null sink, type bool
+   */
+  bool isEnabled(void);
+  /**
+   *   @brief Function to set the time to wait for a key after showing a
+   *          frame in a window
+   *
+   *   @param time in ms, at least 1, of type int
+   *   @return nothing
+   */
+  void setWaitTime(int waitTime_);
+  /**
+   *   @brief Function to get the time to wait for a key after showing a
+   *          frame in a window
+   *
+   *   @param nothing
+   *   @return time in ms of type int
+   */
+  int getWaitTime(void);
+  /**
+   *   @brief Function to select how the lanes are composited on the frame
+   *
+   *   @param mode of type LaneVisualizer::RenderMode
+   *   @return nothing
+   */
+  void setRenderMode(int renderMode_);
+  /**
+   *   @brief Function to get how the lanes are composited on the frame
+   *
+   *   @param nothing
+   *   @return mode of type LaneVisualizer::RenderMode
+   */
+  int getRenderMode(void);
+  /**
+   *   @brief Function to set the opacity of the sparse lane overlay
+   *
+   *   @param opacity in [0, 1] of type double
+   *   @return nothing
+   */
+  void setAlpha(double alpha_);
+  /**
+   *   @brief Function to get the opacity of the sparse lane overlay
+   *
+   *   @param nothing
+   *   @return opacity of type double
+   */
+  double getAlpha(void);
+  /**
+   *   @brief Function to set the number of rows each lane fit is sampled
+   *          at for the sparse overlay
+   *
+   *   @param number of samples, at least 2, of type int
+   *   @return nothing
+   */
+  void setNumSamples(int numSamples_);
+  /**
+   *   @brief Function to get the number of rows each lane fit is sampled
+   *          at for the sparse overlay
+   *
+   *   @param nothing
+   *   @return number of samples of type int
+   */
+  int getNumSamples(void);
+  /**
+   *   @brief Function to draw a packed bird's-eye mask in BGR as the
+   *          background of the debug image
+   *
+   *   @param packed projective transform of binary image of type
+   *          PackedBinaryImage
+   *   @param debug image of type cv::Mat
+   *   @return nothing
+   */
+  void drawLaneMask(const PackedBinaryImage& perspectiveImg,
+                    cv::Mat& drawWindow);
+  /**
+   *   @brief Function to mark lane pixels in the colour of their lane
+   *
+   *   @param pixels of the lane of type LanePointSet
+   *   @param lane of type LaneTracker::Lane
+   *   @param debug image with the lane pixels marked of type cv::Mat
+   *   @return nothing
+   */
+  void drawLanePoints(const LanePointSet& lanePts, int lane,
+                      cv::Mat& drawWindow);
+  /**
+   *   @brief Function to draw the lanes of a frame over its bird's-eye mask
+   *          and composite them on the frame; the null sink returns at once
+   *
+   *   @param input frame of type cv::Mat
+   *   @param packed projective transform of binary image of type
+   *          PackedBinaryImage
+   *   @param left lane pixels of type LanePointSet
+   *   @param right lane pixels of type LanePointSet
+   *   @param inverse perspective transform of type cv::Mat
+   *   @param debug image with the lane pixels marked of type cv::Mat
+   *   @param frame with the lanes composited of type cv::Mat
+   *   @return nothing
+   */
+  void render(const cv::Mat& frame, const PackedBinaryImage& perspectiveImg,
+              const LanePointSet& leftLanePts,
+              const LanePointSet& rightLanePts,
+              const cv::Mat& T_perspective_inv, cv::Mat& drawWindow,
+              cv::Mat& outputFrame);
+  /**
+   *   @brief Function to composite lane fits on a frame. The fits are
+   *          sampled, projected into the frame and drawn as the lane area
+   *          and curves, blended over their bounding box only; the rest
+   *          of the frame is copied. The null sink returns at once
+   *
+   *   @param input frame of type cv::Mat
+   *   @param column of each lane as a polynomial in the bird's-eye row,
+   *          coefficients in increasing order of power, or empty, of type
+   *          cv::Mat*
+   *   @param size of the bird's-eye view of type cv::Size
+   *   @param inverse perspective transform of type cv::Mat
+   *   @param frame sized scratch the lanes are drawn in before blending,
+   *          of type cv::Mat
+   *   @param frame with the lanes composited of type cv::Mat
+   *   @return nothing
+   */
+  void renderFits(const cv::Mat& frame, const cv::Mat* laneFits,
+                  const cv::Size& birdsEyeSize,
+                  const cv::Mat& T_perspective_inv, cv::Mat& overlay,
+                  cv::Mat& outputFrame);
+  /**
+   *   @brief Function to show a rendered frame in a window; only the window
+   *          sink calls into the GUI
+   *
+   *   @param frame with the lanes composited of type cv::Mat
+   *   @return false if a key was pressed to stop, type bool
+   */
+  bool show(const cv::Mat& outputFrame);
+  /**
+   *   @brief Function to close the window if one was shown
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void close(void);
+};
+
+#endif  // INCLUDE_LANEVISUALIZER_HPP_
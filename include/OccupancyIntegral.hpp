@@ -0,0 +1,128 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    OccupancyIntegral.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Occupancy Integral Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for a summed-area table of the set pixels of a packed
+ *  binary image. Once built, the number of lane pixels in any window
+ *  costs four lookups and the column histogram of any band of rows two
+ *  lookups per column.
+ *
+ */
+
+#ifndef INCLUDE_OCCUPANCYINTEGRAL_HPP_
+#define INCLUDE_OCCUPANCYINTEGRAL_HPP_
+#include <stdint.h>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "opencv2/core/core.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+#include "PackedBinaryImage.hpp"
+
+class OccupancyIntegral {
+ private:
+  std::vector<int> table;  // (rows + 1) x (cols + 1) table, entry (y, x)
+                           // counts the set pixels above row y and left
+                           // of column x
+  std::vector<int> rowPrefix;  // set pixels left of each column of a row
+  cv::Size imgSize;  // size of the image the table is built for
+  int stride;  // entries per table row
+  /**
+   *   @brief Function to get a row of the table
+   *
+   *   @param row of the table, 0 to rows, of type int
+   *   @return entries of the row of type const int*
+   */
+  const int* getRow(int y) const;
+
+ public:
+  /**
+   *   @brief Default constructor for OccupancyIntegral
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  OccupancyIntegral();
+  /**
+   *   @brief Default destructor for OccupancyIntegral
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ~OccupancyIntegral();
+  /**
+   *   @brief Function to size the table, keeping the buffer if the size
+   *          is unchanged
+   *
+   *   @param image size of type cv::Size
+   *   @return nothing
+   */
+  void create(const cv::Size& imgSize_);
+  /**
+   *   @brief Function to build the table of a packed binary image in one
+   *          pass over its rows
+   *
+   *   @param packed binary image of type PackedBinaryImage
+   *   @return nothing
+   */
+  void build(const PackedBinaryImage& img);
+  /**
+   *   @brief Function to get the size of the image the table is built for
+   *
+   *   @param nothing
+   *   @return image size of type cv::Size
+   */
+  cv::Size getSize(void) const;
+  /**
+   *   @brief Function to count the set pixels of a window in constant time
+   *
+   *   @param window, clipped to the image, of type cv::Rect
+   *   @return number of set pixels of type int
+   */
+  int count(const cv::Rect& window) const;
+  /**
+   *   @brief Function to compute the column histogram of a band of rows,
+   *          scaled by 255 to match summing a 0/255 mask
+   *
+   *   @param first row of the band of type int
+   *   @param row after the last row of the band of type int
+   *   @param histogram with one bin per column of type std::vector<double>
+   *   @return nothing
+   */
+  void columnHistogram(int rowBegin, int rowEnd,
+                       std::vector<double>& hist) const;
+};
+
+#endif  // INCLUDE_OCCUPANCYINTEGRAL_HPP_
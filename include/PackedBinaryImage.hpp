@@ -0,0 +1,183 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    PackedBinaryImage.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Packed Binary Image Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for a binary image stored with one bit per pixel in
+ *  64 bit words, 8 times smaller than a CV_8U mask. Pixel counts over row
+ *  ranges and windows are computed with popcount and set pixels are
+ *  enumerated with bit-scan, so the lane search stages stay in cache.
+ *
+ */
+
+#ifndef INCLUDE_PACKEDBINARYIMAGE_HPP_
+#define INCLUDE_PACKEDBINARYIMAGE_HPP_
+#include <stdint.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "opencv2/core/core.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+
+class PackedBinaryImage {
+ private:
+  std::vector<uint64_t> words;  // rows of bits, bit x & 63 of word x >> 6
+                                // holds column x; bits past the last
+                                // column are always 0
+  cv::Size imgSize;  // size of the image in pixels
+  int wordsPerRow;  // 64 bit words per row
+
+ public:
+  /**
+   *   @brief Default constructor for PackedBinaryImage
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  PackedBinaryImage();
+  /**
+   *   @brief Default destructor for PackedBinaryImage
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ~PackedBinaryImage();
+  /**
+   *   @brief Function to size the image, keeping the buffer if the size
+   *          is unchanged. Pixel values are undefined afterwards
+   *
+   *   @param image size of type cv::Size
+   *   @return nothing
+   */
+  void create(const cv::Size& imgSize_);
+  /**
+   *   @brief Function to set all pixels to 0
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void clear(void);
+  /**
+   *   @brief Function to pack a mask, every non-zero pixel becomes a set
+   *          bit
+   *
+   *   @param mask of type CV_8U cv::Mat
+   *   @return nothing
+   */
+  void pack(const cv::Mat& mask);
+  /**
+   *   @brief Function to unpack the image into a 0/255 mask
+   *
+   *   @param mask of type CV_8U cv::Mat
+   *   @return nothing
+   */
+  void unpack(cv::Mat& mask) const;
+  /**
+   *   @brief Function to get the size of the image
+   *
+   *   @param nothing
+   *   @return image size of type cv::Size
+   */
+  cv::Size getSize(void) const;
+  /**
+   *   @brief Function to get the number of 64 bit words per row
+   *
+   *   @param nothing
+   *   @return words per row of type int
+   */
+  int getWordsPerRow(void) const;
+  /**
+   *   @brief Function to get the words of a row
+   *
+   *   @param row of type int
+   *   @return words of the row of type uint64_t*
+   */
+  uint64_t* getRow(int y);
+  /**
+   *   @brief Function to get the words of a row
+   *
+   *   @param row of type int
+   *   @return words of the row of type const uint64_t*
+   */
+  const uint64_t* getRow(int y) const;
+  /**
+   *   @brief Function to count the set pixels of a row span
+   *
+   *   @param row of type int
+   *   @param first column of the span of type int
+   *   @param column after the last column of the span of type int
+   *   @return number of set pixels of type int
+   */
+  int countRange(int y, int xBegin, int xEnd) const;
+  /**
+   *   @brief Function to count the set pixels of a window
+   *
+   *   @param window, clipped to the image, of type cv::Rect
+   *   @return number of set pixels of type int
+   */
+  int countWindow(const cv::Rect& window) const;
+  /**
+   *   @brief Function to find the next set pixel of a row span
+   *
+   *   @param row of type int
+   *   @param first column to search of type int
+   *   @param column after the last column to search of type int
+   *   @return column of the first set pixel, or xEnd if there is none,
+   *           type int
+   */
+  int nextSetBit(int y, int xBegin, int xEnd) const;
+  /**
+   *   @brief Function to compute the column histogram of a band of rows,
+   *          scaled by 255 to match summing a 0/255 mask
+   *
+   *   @param first row of the band of type int
+   *   @param row after the last row of the band of type int
+   *   @param histogram with one bin per column of type std::vector<double>
+   *   @return nothing
+   */
+  void columnHistogram(int rowBegin, int rowEnd,
+                       std::vector<double>& hist) const;
+  /**
+   *   @brief Function to downsample an image by 2 in both directions,
+   *          setting a pixel if any pixel of its 2x2 block is set, so thin
+   *          lines survive
+   *
+   *   @param image at twice the resolution of type PackedBinaryImage
+   *   @return nothing
+   */
+  void maxPool(const PackedBinaryImage& src);
+};
+
+#endif  // INCLUDE_PACKEDBINARYIMAGE_HPP_
@@ -0,0 +1,152 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    PerspectiveGeometry.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Perspective Geometry Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for the cached bird's-eye perspective geometry. The
+ *  forward and inverse homographies between the source and destination
+ *  quadrilaterals, and the fixed-point warp maps of the forward
+ *  homography, are computed once per image size.
+ *
+ */
+
+#ifndef INCLUDE_PERSPECTIVEGEOMETRY_HPP_
+#define INCLUDE_PERSPECTIVEGEOMETRY_HPP_
+#include <algorithm>
+#include <climits>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "opencv2/core/core.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+
+class PerspectiveGeometry {
+ private:
+  std::vector<cv::Point2f> srcQuad;  // quadrilateral in the camera image
+  std::vector<cv::Point2f> dstQuad;  // quadrilateral in bird's-eye image,
+                                     // empty to use the image corners
+  cv::Size imgSize;  // image size the geometry is built for
+  cv::Mat T_perspective;  // camera to bird's-eye homography
+  cv::Mat T_perspective_inv;  // bird's-eye to camera homography
+  cv::Mat warpMap1;  // fixed-point bird's-eye warp map (CV_16SC2)
+  cv::Mat warpMap2;  // interpolation table for warpMap1
+
+ public:
+  /**
+   *   @brief Default constructor for PerspectiveGeometry
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  PerspectiveGeometry();
+  /**
+   *   @brief Default destructor for PerspectiveGeometry
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ~PerspectiveGeometry();
+  /**
+   *   @brief Function to set the quadrilateral in the camera image
+   *
+   *   @param four vertices of type std::vector<cv::Point2f>
+   *   @return nothing
+   */
+  void setSrcQuad(const std::vector<cv::Point2f>& srcQuad_);
+  /**
+   *   @brief Function to set the quadrilateral in the bird's-eye image
+   *
+   *   @param four vertices, or none to use the image corners, of type
+   *          std::vector<cv::Point2f>
+   *   @return nothing
+   */
+  void setDstQuad(const std::vector<cv::Point2f>& dstQuad_);
+  /**
+   *   @brief Function to get the quadrilateral in the camera image
+   *
+   *   @param nothing
+   *   @return four vertices of type std::vector<cv::Point2f>
+   */
+  std::vector<cv::Point2f> getSrcQuad(void) const;
+  /**
+   *   @brief Function to get the quadrilateral in the bird's-eye image
+   *
+   *   @param nothing
+   *   @return four vertices, or none for the image corners, of type
+   *           std::vector<cv::Point2f>
+   */
+  std::vector<cv::Point2f> getDstQuad(void) const;
+  /**
+   *   @brief Function to build the homographies and warp maps if the
+   *          quadrilaterals or the image size changed
+   *
+   *   @param image size of type cv::Size
+   *   @return nothing
+   */
+  void update(const cv::Size& imgSize_);
+  /**
+   *   @brief Function to get the camera to bird's-eye homography
+   *
+   *   @param nothing
+   *   @return 3x3 homography of type cv::Mat
+   */
+  const cv::Mat& getTransform(void) const;
+  /**
+   *   @brief Function to get the bird's-eye to camera homography
+   *
+   *   @param nothing
+   *   @return 3x3 homography of type cv::Mat
+   */
+  const cv::Mat& getInverseTransform(void) const;
+  /**
+   *   @brief Function to warp a camera image to the bird's-eye view through
+   *          the cached maps, equivalent to cv::warpPerspective with
+   *          bilinear interpolation
+   *
+   *   @param camera image of type cv::Mat
+   *   @param bird's-eye image of type cv::Mat
+   *   @return nothing
+   */
+  void warp(const cv::Mat& src, cv::Mat& dst);
+  /**
+   *   @brief Function to warp a camera image through maps already built
+   *          for its size; safe to call from several threads at once
+   *
+   *   @param camera image of the built size of type cv::Mat
+   *   @param bird's-eye image of type cv::Mat
+   *   @return nothing
+   */
+  void warpCached(const cv::Mat& src, cv::Mat& dst) const;
+};
+
+#endif  // INCLUDE_PERSPECTIVEGEOMETRY_HPP_
@@ -0,0 +1,311 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    PolyFitter.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Polynomial Fitter Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for the least-squares polynomial fit of lane pixels.
+ *  The fit accumulates the power sums of the points in one pass, in a
+ *  centred and scaled domain for conditioning, and solves the small
+ *  normal equations, so its cost is linear in the number of points and
+ *  needs no design matrix. Weighted, Huber and RANSAC fits are bounded
+ *  to a fixed number of passes.
+ *
+ */
+
+#ifndef INCLUDE_POLYFITTER_HPP_
+#define INCLUDE_POLYFITTER_HPP_
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "opencv2/core/core.hpp"
+#include "LanePointSet.hpp"
+
+class PolyFitter {
+ public:
+  /**
+   *  Loss of the fit. Costs are passes over the points.
+   */
+  enum FitMode {
+    FIT_LEAST_SQUARES = 0,  // plain least squares, 1 pass
+    FIT_HUBER,  // iteratively reweighted least squares with the Huber
+                // loss, 1 + iterations passes
+    FIT_RANSAC  // best of iterations minimal samples, each scored on at
+                // most ransacScorePoints points, then least squares on the
+                // inliers, 2 passes
+  };
+
+ private:
+  int order;  // degree of the polynomial
+  int mode;  // selected FitMode
+  double huberDelta;  // residual where the Huber loss turns linear
+  double ransacThreshold;  // largest residual of a RANSAC inlier
+  int iterations;  // reweighting passes or RANSAC samples
+  int ransacScorePoints;  // most points a RANSAC sample is scored on
+  bool domainSet;  // centre and scale are given, not found from the points
+  double domainCenter;  // x mapped to 0
+  double domainScale;  // half width of the x range mapped to [-1, 1]
+  std::vector<double> powerSums;  // sums of w u^k for k up to 2 order
+  std::vector<double> momentSums;  // sums of w u^k y for k up to order
+  // scratch reused from fit to fit, so the fits do not allocate
+  cv::Mat_<double> normalMatrix;  // normal equations of the sums
+  cv::Mat_<double> momentVector;  // right hand side of the normal equations
+  cv::Mat domainCoeffs;  // coefficients in the domain
+  cv::Mat refitCoeffs;  // coefficients of a Huber or RANSAC refit
+  cv::Mat_<double> sampleMatrix;  // Vandermonde matrix of a RANSAC sample
+  cv::Mat_<double> sampleValues;  // y of a RANSAC sample
+  cv::Mat_<double> sampleCoeffs;  // coefficients through a RANSAC sample
+  /**
+   *   @brief Function to evaluate a polynomial by Horner's rule
+   *
+   *   @param coefficients in increasing order of power of type double*
+   *   @param degree of the polynomial of type int
+   *   @param point to evaluate at of type double
+   *   @return value of the polynomial of type double
+   */
+  static double evaluate(const double* coeffs, int degree, double u);
+  /**
+   *   @brief Function to accumulate the weighted power sums of the points in
+   *          the centred and scaled domain. With a model, the weights are
+   *          scaled by the Huber loss or zeroed for RANSAC outliers
+   *
+   *   @param x of the points of type int*
+   *   @param y of the points of type int*
+   *   @param number of ints from one point to the next of type std::size_t
+   *   @param weights of the points or nullptr for 1, of type float*
+   *   @param number of points of type std::size_t
+   *   @param centre of the domain of type double
+   *   @param scale of the domain of type double
+   *   @param coefficients in the domain or nullptr, of type double*
+   *   @return nothing
+   */
+  void accumulate(const int* xs, const int* ys, std::size_t stride,
+                  const float* weights, std::size_t count, double center,
+                  double scale, const double* model);
+  /**
+   *   @brief Function to solve the normal equations of the accumulated sums
+   *
+   *   @param coefficients in the domain, released if the points have no
+   *          weight, of type cv::Mat
+   *   @return true if the points determine the polynomial, type bool
+   */
+  bool solveNormal(cv::Mat& solvedCoeffs);
+  /**
+   *   @brief Function to fit the polynomial through a random minimal sample
+   *          for every iteration and keep the one with the most inliers
+   *
+   *   @param x of the points of type int*
+   *   @param y of the points of type int*
+   *   @param number of ints from one point to the next of type std::size_t
+   *   @param number of points of type std::size_t
+   *   @param centre of the domain of type double
+   *   @param scale of the domain of type double
+   *   @param coefficients in the domain of the best sample of type cv::Mat
+   *   @return true if a sample had more inliers than its size, type bool
+   */
+  bool bestSample(const int* xs, const int* ys, std::size_t stride,
+                  std::size_t count, double center, double scale,
+                  cv::Mat& bestCoeffs);
+
+ public:
+  /**
+   *   @brief Default constructor for PolyFitter
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  PolyFitter();
+  /**
+   *   @brief Copy constructor for PolyFitter; copies the settings only, so
+   *          the copies share no scratch
+   *
+   *   @param fitter to copy of type PolyFitter
+   *   @return nothing
+   */
+  PolyFitter(const PolyFitter& other);
+  /**
+   *   @brief Assignment operator for PolyFitter; copies the settings only
+   *
+   *   @param fitter to copy of type PolyFitter
+   *   @return this fitter of type PolyFitter&
+   */
+  PolyFitter& operator=(const PolyFitter& other);
+  /**
+   *   @brief Default destructor for PolyFitter
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ~PolyFitter();
+  /**
+   *   @brief Function to take the settings of another fitter, keeping this
+   *          fitter's scratch when the degree is the same
+   *
+   *   @param fitter to copy the settings of of type PolyFitter
+   *   @return nothing
+   */
+  void copySettings(const PolyFitter& other);
+  /**
+   *   @brief Function to set the degree of the polynomial
+   *
+   *   @param degree of type int
+   *   @return nothing
+   */
+  void setOrder(int order_);
+  /**
+   *   @brief Function to get the degree of the polynomial
+   *
+   *   @param nothing
+   *   @return degree of type int
+   */
+  int getOrder(void);
+  /**
+   *   @brief Function to select the loss of the fit
+   *
+   *   @param loss of type PolyFitter::FitMode
+   *   @return nothing
+   */
+  void setMode(int mode_);
+  /**
+   *   @brief Function to get the loss of the fit
+   *
+   *   @param nothing
+   *   @return loss of type PolyFitter::FitMode
+   */
+  int getMode(void);
+  /**
+   *   @brief Function to set the residual where the Huber loss turns linear
+   *
+   *   @param residual of type double
+   *   @return nothing
+   */
+  void setHuberDelta(double huberDelta_);
+  /**
+   *   @brief Function to set the largest residual of a RANSAC inlier
+   *
+   *   @param residual of type double
+   *   @return nothing
+   */
+  void setRansacThreshold(double ransacThreshold_);
+  /**
+   *   @brief Function to set the number of reweighting passes of the Huber
+   *          fit and of samples of the RANSAC fit
+   *
+   *   @param number of iterations of type int
+   *   @return nothing
+   */
+  void setIterations(int iterations_);
+  /**
+   *   @brief Function to set the most points a RANSAC sample is scored on
+   *
+   *   @param number of points of type int
+   *   @return nothing
+   */
+  void setRansacScorePoints(int ransacScorePoints_);
+  /**
+   *   @brief Function to give the x range of the points, so the fit needs
+   *          no pass to find it
+   *
+   *   @param x mapped to 0 of type double
+   *   @param half width of the x range of type double
+   *   @return nothing
+   */
+  void setDomain(double domainCenter_, double domainScale_);
+  /**
+   *   @brief Function to find the x range from the points again
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  void clearDomain(void);
+  /**
+   *   @brief Function to fit y as a polynomial in x
+   *
+   *   @param points of type std::vector<cv::Point>
+   *   @param coefficients in increasing order of power of type cv::Mat
+   *   @return nothing
+   */
+  void fit(const std::vector<cv::Point>& pts, cv::Mat& coeffs);
+  /**
+   *   @brief Function to fit y as a polynomial in x with weighted points
+   *
+   *   @param points of type std::vector<cv::Point>
+   *   @param weights of the points of type std::vector<float>
+   *   @param coefficients in increasing order of power, empty if no point
+   *          has weight, of type cv::Mat
+   *   @return nothing
+   */
+  void fit(const std::vector<cv::Point>& pts,
+           const std::vector<float>& weights, cv::Mat& coeffs);
+  /**
+   *   @brief Function to fit y as a polynomial in x over a range of points
+   *
+   *   @param points of type cv::Point*
+   *   @param weights of the points or nullptr for 1, of type float*
+   *   @param number of points of type std::size_t
+   *   @param coefficients in increasing order of power, as a column of
+   *          CV_64F, empty if no point has weight, of type cv::Mat
+   *   @return nothing
+   */
+  void fit(const cv::Point* pts, const float* weights, std::size_t count,
+           cv::Mat& coeffs);
+  /**
+   *   @brief Function to fit a lane's column as a polynomial in the row,
+   *          reading the arrays of the set in place
+   *
+   *   @param pixels of the lane of type LanePointSet
+   *   @param coefficients in increasing order of power, as a column of
+   *          CV_64F, of type cv::Mat
+   *   @return nothing
+   */
+  void fit(const LanePointSet& lanePts, cv::Mat& coeffs);
+  /**
+   *   @brief Function to fit y as a polynomial in x over strided arrays
+   *
+   *   @param x of the points of type int*
+   *   @param y of the points of type int*
+   *   @param number of ints from one point to the next of type std::size_t
+   *   @param weights of the points or nullptr for 1, of type float*
+   *   @param number of points of type std::size_t
+   *   @param coefficients in increasing order of power, as a column of
+   *          CV_64F, empty if no point has weight and the least norm
+   *          solution if fewer than order + 1 distinct x have weight, of
+   *          type cv::Mat
+   *   @return nothing
+   */
+  void fit(const int* xs, const int* ys, std::size_t stride,
+           const float* weights, std::size_t count, cv::Mat& coeffs);
+};
+
+#endif  // INCLUDE_POLYFITTER_HPP_
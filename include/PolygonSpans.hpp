@@ -0,0 +1,127 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    PolygonSpans.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Polygon Spans Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for a convex polygon rasterized once into a per row
+ *  table of [xBegin, xEnd) spans. Pipeline stages bound their loops with
+ *  the table instead of building and applying an image sized mask every
+ *  frame.
+ *
+ */
+
+#ifndef INCLUDE_POLYGONSPANS_HPP_
+#define INCLUDE_POLYGONSPANS_HPP_
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "opencv2/core/core.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+
+class PolygonSpans {
+ private:
+  std::vector<cv::Point> vertices;  // vertices of the convex polygon
+  std::vector<cv::Vec2i> spans;  // per row [xBegin, xEnd) of the polygon
+  cv::Size imgSize;  // image size the spans are built for
+  int beginRow;  // first row with a non-empty span
+  int endRow;  // row after the last row with a non-empty span
+
+ public:
+  /**
+   *   @brief Default constructor for PolygonSpans
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  PolygonSpans();
+  /**
+   *   @brief Default destructor for PolygonSpans
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ~PolygonSpans();
+  /**
+   *   @brief Function to set the vertices of the convex polygon
+   *
+   *   @param vertices of type std::vector<cv::Point>
+   *   @return nothing
+   */
+  void setVertices(const std::vector<cv::Point>& vertices_);
+  /**
+   *   @brief Function to get the vertices of the convex polygon
+   *
+   *   @param nothing
+   *   @return vertices of type std::vector<cv::Point>
+   */
+  std::vector<cv::Point> getVertices(void) const;
+  /**
+   *   @brief Function to rasterize the polygon if the vertices or the image
+   *          size changed since the spans were last built
+   *
+   *   @param image size of type cv::Size
+   *   @return nothing
+   */
+  void update(const cv::Size& imgSize_);
+  /**
+   *   @brief Function to get the span of the polygon in a row
+   *
+   *   @param row of type int
+   *   @return [xBegin, xEnd), empty if xEnd <= xBegin, type cv::Vec2i
+   */
+  cv::Vec2i getSpan(int y) const;
+  /**
+   *   @brief Function to get the first row the polygon covers
+   *
+   *   @param nothing
+   *   @return row of type int
+   */
+  int getBeginRow(void) const;
+  /**
+   *   @brief Function to get the row after the last row the polygon covers
+   *
+   *   @param nothing
+   *   @return row of type int
+   */
+  int getEndRow(void) const;
+  /**
+   *   @brief Function to draw the spans as a binary mask
+   *
+   *   @param binary mask of type cv::Mat
+   *   @return nothing
+   */
+  void toMask(cv::Mat& mask) const;
+};
+
+#endif  // INCLUDE_POLYGONSPANS_HPP_
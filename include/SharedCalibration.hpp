@@ -0,0 +1,171 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    SharedCalibration.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Shared Calibration Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for the immutable artefacts of one camera calibration at
+ *  one frame size: the undistortion maps, the bird's-eye homographies and
+ *  warp maps or the fused raw to bird's-eye remap, and the rasterized lane
+ *  polygon. They are built once and only read afterwards, so streams with
+ *  the same calibration share one instance across threads.
+ *
+ */
+
+#ifndef INCLUDE_SHAREDCALIBRATION_HPP_
+#define INCLUDE_SHAREDCALIBRATION_HPP_
+#include <iostream>
+#include <vector>
+#include "opencv2/core/core.hpp"
+#include "opencv2/calib3d/calib3d.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+#include "BirdsEyeRemap.hpp"
+#include "PerspectiveGeometry.hpp"
+#include "PolygonSpans.hpp"
+
+class SharedCalibration {
+ private:
+  cv::Mat intrinsic;  // camera matrix the artefacts are built from
+  cv::Mat distortionCoeffs;  // distortion coefficients
+  std::vector<cv::Point2f> srcQuad;  // perspective quadrilateral in camera
+  std::vector<cv::Point2f> dstQuad;  // and in bird's-eye image
+  std::vector<cv::Point> laneROIVertices;  // polygon in which lanes appear
+  cv::Size imgSize;  // frame size the artefacts are built for
+  bool fusedRemap;  // fused remap built instead of the undistortion maps
+  cv::Mat undistortMap1;  // fixed-point undistortion map (CV_16SC2)
+  cv::Mat undistortMap2;  // interpolation table for undistortMap1
+  PerspectiveGeometry perspectiveGeometry;  // bird's-eye homographies
+  BirdsEyeRemap birdsEyeRemap;  // fused raw sensor to bird's-eye geometry
+  PolygonSpans laneSpans;  // lane polygon as row spans
+
+ public:
+  /**
+   *   @brief Constructor building the artefacts of a calibration
+   *
+   *   @param camera matrix of type cv::Mat
+   *   @param distortion coefficients k1, k2, p1, p2, k3 of type cv::Mat
+   *   @param four vertices in the camera image of type
+   *          std::vector<cv::Point2f>
+   *   @param four vertices in the bird's-eye image, or none to use the image
+   *          corners, of type std::vector<cv::Point2f>
+   *   @param vertices of the lane polygon of type std::vector<cv::Point>
+   *   @param frame size of type cv::Size
+   *   @param true to build the fused remap instead of the undistortion maps
+   *          of type bool
+   *   @return nothing
+   */
+  SharedCalibration(const cv::Mat& intrinsic_,
+                    const cv::Mat& distortionCoeffs_,
+                    const std::vector<cv::Point2f>& srcQuad_,
+                    const std::vector<cv::Point2f>& dstQuad_,
+                    const std::vector<cv::Point>& laneROIVertices_,
+                    const cv::Size& imgSize_, bool fusedRemap_);
+  /**
+   *   @brief Default destructor for SharedCalibration
+   *
+   *   @param nothing
+   *   @return nothing
+   */
+  ~SharedCalibration();
+  /**
+   *   @brief Function to check if the artefacts were built from the given
+   *          calibration, for any frame size
+   *
+   *   @param camera matrix of type cv::Mat
+   *   @param distortion coefficients of type cv::Mat
+   *   @param four vertices in the camera image of type
+   *          std::vector<cv::Point2f>
+   *   @param four vertices in the bird's-eye image of type
+   *          std::vector<cv::Point2f>
+   *   @param vertices of the lane polygon of type std::vector<cv::Point>
+   *   @param true for the fused remap of type bool
+   *   @return true if the calibrations are equal, type bool
+   */
+  bool matches(const cv::Mat& intrinsic_, const cv::Mat& distortionCoeffs_,
+               const std::vector<cv::Point2f>& srcQuad_,
+               const std::vector<cv::Point2f>& dstQuad_,
+               const std::vector<cv::Point>& laneROIVertices_,
+               bool fusedRemap_) const;
+  /**
+   *   @brief Function to get the frame size the artefacts are built for
+   *
+   *   @param nothing
+   *   @return frame size of type cv::Size
+   */
+  cv::Size getImageSize(void) const;
+  /**
+   *   @brief Function to check if the fused remap is built instead of the
+   *          undistortion maps
+   *
+   *   @param nothing
+   *   @return true for the fused remap of type bool
+   */
+  bool isFusedRemap(void) const;
+  /**
+   *   @brief Function to get the fixed-point undistortion map
+   *
+   *   @param nothing
+   *   @return map, empty with the fused remap, of type cv::Mat
+   */
+  const cv::Mat& getUndistortMap1(void) const;
+  /**
+   *   @brief Function to get the interpolation table of the undistortion
+   *          map
+   *
+   *   @param nothing
+   *   @return table, empty with the fused remap, of type cv::Mat
+   */
+  const cv::Mat& getUndistortMap2(void) const;
+  /**
+   *   @brief Function to get the bird's-eye homographies and warp maps
+   *
+   *   @param nothing
+   *   @return geometry of type PerspectiveGeometry
+   */
+  const PerspectiveGeometry& getPerspectiveGeometry(void) const;
+  /**
+   *   @brief Function to get the fused raw sensor to bird's-eye remap
+   *
+   *   @param nothing
+   *   @return remap, empty without the fused remap, of type BirdsEyeRemap
+   */
+  const BirdsEyeRemap& getBirdsEyeRemap(void) const;
+  /**
+   *   @brief Function to get the lane polygon rasterized at the frame size
+   *
+   *   @param nothing
+   *   @return row spans of type PolygonSpans
+   */
+  const PolygonSpans& getLaneSpans(void) const;
+};
+
+#endif  // INCLUDE_SHAREDCALIBRATION_HPP_
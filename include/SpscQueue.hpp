@@ -0,0 +1,154 @@
+/************************************************************************
+ MIT License
+
+ Copyright (c) 2018 Rohith Jayarajan, Akash Guha
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ *************************************************************************/
+/**
+ *  Copyright 2018 rohithjayarajan, Akash Guha
+ *  @file    SpscQueue.hpp
+ *  @author  rohithjayarajan, Akash Guha
+ *  @date 10/17/2026
+ *  @version 1.1
+ *
+ *  @brief Single Producer Single Consumer Queue Class Header
+ *
+ *  @section DESCRIPTION
+ *
+ *  Class header for a bounded lock-free ring buffer between one producer
+ *  thread and one consumer thread. The ring is sized once; pushing and
+ *  popping never allocate or lock, each side only publishes its own index.
+ *
+ */
+
+#ifndef INCLUDE_SPSCQUEUE_HPP_
+#define INCLUDE_SPSCQUEUE_HPP_
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+template <typename T>
+class SpscQueue {
+ private:
+  std::vector<T> items;  // ring of capacity + 1 slots, one always free
+  // next slot to pop, written only by the consumer
+  alignas(64) std::atomic<std::size_t> head;
+  // next slot to push, written only by the producer
+  alignas(64) std::atomic<std::size_t> tail;
+
+ public:
+  /**
+   *   @brief Constructor for SpscQueue
+   *
+   *   @param number of items the queue holds of type std::size_t
+   *   @return nothing
+   */
+  explicit SpscQueue(std::size_t capacity = 1)
+      : items(capacity + 1),
+        head(0),
+        tail(0) {
+  }
+  /**
+   *   @brief Items are handed between two threads by index, so a queue can
+   *          not be copied
+   */
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+  /**
+   *   @brief Function to resize and empty the queue; neither side may use
+   *          it meanwhile
+   *
+   *   @param number of items the queue holds of type std::size_t
+   *   @return nothing
+   */
+  void reset(std::size_t capacity) {
+    items.assign(capacity + 1, T());
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+  }
+  /**
+   *   @brief Function for the producer to add an item
+   *
+   *   @param item of type T
+   *   @return false if the queue is full, type bool
+   */
+  bool tryPush(const T& item) {
+    std::size_t tailIdx = tail.load(std::memory_order_relaxed);
+    std::size_t nextIdx = (tailIdx + 1 == items.size()) ? 0 : tailIdx + 1;
+    if (nextIdx == head.load(std::memory_order_acquire)) {
+      return false;
+    }
+    items[tailIdx] = item;
+    // publish the item to the consumer
+    tail.store(nextIdx, std::memory_order_release);
+    return true;
+  }
+  /**
+   *   @brief Function for the consumer to take the oldest item
+   *
+   *   @param item of type T
+   *   @return false if the queue is empty, type bool
+   */
+  bool tryPop(T& item) {
+    std::size_t headIdx = head.load(std::memory_order_relaxed);
+    if (headIdx == tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+    item = items[headIdx];
+    // hand the slot back to the producer
+    head.store((headIdx + 1 == items.size()) ? 0 : headIdx + 1,
+               std::memory_order_release);
+    return true;
+  }
+  /**
+   *   @brief Function to get the number of items, exact only when neither
+   *          side is running
+   *
+   *   @param nothing
+   *   @return number of items of type std::size_t
+   */
+  std::size_t size(void) const {
+    std::size_t headIdx = head.load(std::memory_order_acquire);
+    std::size_t tailIdx = tail.load(std::memory_order_acquire);
+    return (tailIdx >= headIdx) ? tailIdx - headIdx
+        : tailIdx + items.size() - headIdx;
+  }
+  /**
+   *   @brief Function to check if the queue holds no item
+   *
+   *   @param nothing
+   *   @return true if empty, type bool
+   */
+  bool empty(void) const {
+    return size() == 0;
+  }
+  /**
+   *   @brief Function to get the number of items the queue holds
+   *
+   *   @param nothing
+   *   @return capacity of type std::size_t
+   */
+  std::size_t capacity(void) const {
+    return items.size() - 1;
+  }
+};
+
+#endif  // INCLUDE_SPSCQUEUE_HPP_
@@ -0,0 +1,65 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    BatchProcessorTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Batch Processor Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests the naming of the output
+ *  files and the failures reported for inputs.
+ *
+ */
+#include <gtest/gtest.h>
+#include "BatchProcessor.hpp"
+
+/**
+ * @brief  Class to test BatchProcessor.
+ */
+class BatchProcessorTest : public ::testing::Test {
+ protected:
+  BatchProcessor testObject;
+};
+/**
+ *@brief Test to ensure the CSV file is named after the video
+ */
+TEST_F(BatchProcessorTest, isOutputNamedAfterVideo) {
+  testObject.setOutputDir("results");
+  EXPECT_EQ("results/drive_01.csv",
+            testObject.getOutputPath("/data/drives/drive_01.mp4"));
+  EXPECT_EQ("results/drive.02.csv",
+            testObject.getOutputPath("drive.02.avi"));
+  EXPECT_EQ("results/.hidden.csv", testObject.getOutputPath(".hidden"));
+}
+/**
+ *@brief Test to ensure headless processing fits every frame
+ */
+TEST_F(BatchProcessorTest, isHeadlessByDefault) {
+  EXPECT_FALSE(testObject.isDisplay());
+  EXPECT_FALSE(testObject.getLaneDetection().getVisualizer().isEnabled());
+  EXPECT_TRUE(testObject.getLaneDetection().isLaneFitting());
+  testObject.setDisplay(true);
+  EXPECT_EQ(LaneVisualizer::VISUALIZE_WINDOW,
+            testObject.getLaneDetection().getVisualizer().getMode());
+}
+/**
+ *@brief Test to ensure videos are processed sequentially unless chunks
+ *       are asked for
+ */
+TEST_F(BatchProcessorTest, isSequentialByDefault) {
+  EXPECT_EQ(1, testObject.getChunkedProcessor().getNumChunks());
+  testObject.getChunkedProcessor().setNumChunks(4);
+  EXPECT_EQ(4, testObject.getChunkedProcessor().getNumChunks());
+}
+/**
+ *@brief Test to ensure missing inputs are reported as failures
+ */
+TEST_F(BatchProcessorTest, isMissingInputFailed) {
+  std::vector<std::string> videoPaths;
+  std::vector<std::string> inputs = { "missing_video.mp4",
+      "missing_dir/*.mp4" };
+  EXPECT_FALSE(testObject.expandInputs(inputs, videoPaths));
+  ASSERT_EQ(1u, videoPaths.size());
+  EXPECT_FALSE(testObject.processVideo(videoPaths[0]));
+}
@@ -0,0 +1,104 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    BenchmarkHarnessTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Benchmark Harness Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests that the benchmark
+ *  harness bounds its timed calls, filters
+ *  benchmarks and writes them and the accuracy
+ *  metrics as JSON.
+ *
+ */
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include "BenchmarkHarness.hpp"
+
+/**
+ * @brief  Class to test BenchmarkHarness.
+ */
+class BenchmarkHarnessTest : public ::testing::Test {
+ protected:
+  BenchmarkHarness testObject;
+};
+/**
+ *@brief Test to ensure the timed calls stay within their bounds
+ */
+TEST_F(BenchmarkHarnessTest, isIterationCountBounded) {
+  int numCalls = 0;
+  testObject.setMinTimeMs(1e9);
+  testObject.setIterations(2, 7);
+  EXPECT_EQ(2, testObject.getMinIterations());
+  EXPECT_EQ(7, testObject.getMaxIterations());
+  EXPECT_TRUE(testObject.run("slow", "frame", cv::Size(4, 3), [&]() {
+    numCalls++;
+  }));
+  // one untimed call before the timed ones
+  EXPECT_EQ(8, numCalls);
+  testObject.setMinTimeMs(0);
+  EXPECT_TRUE(testObject.run("fast", "frame", cv::Size(4, 3), [&]() {
+    numCalls++;
+  }));
+  EXPECT_EQ(8 + 3, numCalls);
+  ASSERT_EQ(2u, testObject.getResults().size());
+  const BenchmarkHarness::Result* result = testObject.findResult("slow",
+                                                                 "frame");
+  ASSERT_TRUE(result != nullptr);
+  EXPECT_EQ(7, result->iterations);
+  EXPECT_EQ(cv::Size(4, 3), result->frameSize);
+  EXPECT_LE(result->minMs, result->medianMs);
+  EXPECT_GE(result->stdDevMs, 0);
+  EXPECT_EQ(2, testObject.findResult("fast", "frame")->iterations);
+  EXPECT_TRUE(testObject.findResult("slow", "other") == nullptr);
+}
+/**
+ *@brief Test to ensure only benchmarks whose names contain the filter run
+ */
+TEST_F(BenchmarkHarnessTest, isFilterApplied) {
+  int numCalls = 0;
+  testObject.setMinTimeMs(0);
+  testObject.setFilter("Hist");
+  EXPECT_EQ("Hist", testObject.getFilter());
+  EXPECT_TRUE(testObject.isSelected("generateHist/packed"));
+  EXPECT_FALSE(testObject.run("fitPoly/points", "frame", cv::Size(1, 1),
+                              [&]() { numCalls++; }));
+  EXPECT_EQ(0, numCalls);
+  EXPECT_TRUE(testObject.getResults().empty());
+}
+/**
+ *@brief Test to ensure the results and the speedups are written as JSON
+ */
+TEST_F(BenchmarkHarnessTest, isJsonWritten) {
+  testObject.setMinTimeMs(0);
+  testObject.setIterations(1, 1);
+  testObject.addContext("build_type", "Release");
+  testObject.addComparison("stage/fast", "stage/reference");
+  testObject.run("stage/reference", "a \"quoted\" frame", cv::Size(8, 6),
+                 []() { cv::Mat(64, 64, CV_8U, cv::Scalar(1)).clone(); });
+  testObject.run("stage/fast", "a \"quoted\" frame", cv::Size(8, 6), []() {
+  });
+  testObject.run("stage/fast", "unmatched", cv::Size(8, 6), []() {
+  });
+  testObject.addMetric("stage/fast", "unmatched", "mean_col_dev_px", 0.25);
+  ASSERT_EQ(1u, testObject.getMetrics().size());
+  EXPECT_EQ("mean_col_dev_px", testObject.getMetrics()[0].key);
+  std::ostringstream json;
+  testObject.writeJson(json);
+  std::string text = json.str();
+  EXPECT_NE(std::string::npos, text.find("\"build_type\": \"Release\""));
+  EXPECT_NE(std::string::npos, text.find("\"name\": \"stage/reference\""));
+  EXPECT_NE(std::string::npos, text.find("\"a \\\"quoted\\\" frame\""));
+  EXPECT_NE(std::string::npos, text.find("\"width\": 8, \"height\": 6"));
+  // one comparison, the unmatched input has no reference
+  EXPECT_NE(std::string::npos, text.find("\"optimized\": \"stage/fast\""));
+  EXPECT_EQ(text.find("\"speedup\""), text.rfind("\"speedup\""));
+  EXPECT_NE(std::string::npos,
+            text.find("\"metric\": \"mean_col_dev_px\", \"value\": 0.25"));
+  testObject.clearResults();
+  EXPECT_TRUE(testObject.getResults().empty());
+  EXPECT_TRUE(testObject.getMetrics().empty());
+}
@@ -0,0 +1,110 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    BirdsEyeRemapTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Birds Eye Remap Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests the fused raw sensor to
+ *  bird's-eye remap.
+ *
+ */
+#include <gtest/gtest.h>
+#include "BirdsEyeRemap.hpp"
+
+/**
+ * @brief  Class to test BirdsEyeRemap.
+ */
+class BirdsEyeRemapTest : public ::testing::Test {
+ protected:
+  BirdsEyeRemap testObject;
+  cv::Mat intrinsic;
+  cv::Mat T_perspective;
+  cv::Mat srcImg;
+  /**
+   *@brief Set up a pinhole camera and the pipeline's perspective transform
+   */
+  virtual void SetUp() {
+    intrinsic = (cv::Mat_<double>(3, 3) << 1154.22732, 0.0, 671.627794, 0.0,
+        1148.18221, 386.046312, 0.0, 0.0, 1.0);
+    cv::Point2f inQuadrilateral[4] = { cv::Point(544, 462), cv::Point(731, 462),
+        cv::Point(1268, 708), cv::Point(0, 708) };
+    cv::Point2f outQuadrilateral[4] = { cv::Point(0, 0), cv::Point(1280, 0),
+        cv::Point(1280, 720), cv::Point(0, 720) };
+    T_perspective = cv::getPerspectiveTransform(inQuadrilateral,
+                                                outQuadrilateral);
+    srcImg.create(720, 1280, CV_8UC3);
+    for (int y = 0; y < srcImg.rows; y++) {
+      for (int x = 0; x < srcImg.cols; x++) {
+        srcImg.at<cv::Vec3b>(y, x) = cv::Vec3b(
+            cv::saturate_cast<uchar>(x / 5),
+            cv::saturate_cast<uchar>(y / 3),
+            cv::saturate_cast<uchar>((x + y) / 8));
+      }
+    }
+  }
+};
+/**
+ *@brief Test to ensure that without lens distortion the fused remap is the
+ *       perspective warp
+ */
+TEST_F(BirdsEyeRemapTest, isPerspectiveWarpWithoutDistortion) {
+  cv::Mat noDistortion = cv::Mat::zeros(1, 5, CV_64F);
+  std::vector<cv::Point> noROI;
+  testObject.build(intrinsic, noDistortion, T_perspective, noROI,
+                   srcImg.size(), srcImg.size());
+  EXPECT_TRUE(testObject.isBuiltFor(srcImg.size(), srcImg.size()));
+  cv::Mat gotImg, expectedImg;
+  testObject.warpImage(srcImg, gotImg);
+  cv::warpPerspective(srcImg, expectedImg, T_perspective, srcImg.size());
+  ASSERT_EQ(expectedImg.size(), gotImg.size());
+  double meanDiff = cv::norm(expectedImg, gotImg, cv::NORM_L1)
+      / (gotImg.total() * gotImg.channels());
+  EXPECT_LT(meanDiff, 1.0);
+  testObject.clear();
+  EXPECT_FALSE(testObject.isBuiltFor(srcImg.size(), srcImg.size()));
+}
+/**
+ *@brief Test to ensure a warped mask stays binary and inside the lane polygon
+ */
+TEST_F(BirdsEyeRemapTest, isWarpedMaskBinary) {
+  cv::Mat distortion = (cv::Mat_<double>(1, 5) << -0.242565104, -0.0477893070,
+      -0.00131388084, -0.0000879107779, 0.0220573263);
+  std::vector<cv::Point> laneROI = { cv::Point(560, 429), cv::Point(690, 429),
+      cv::Point(1155, 672), cv::Point(225, 672) };
+  testObject.build(intrinsic, distortion, T_perspective, laneROI,
+                   srcImg.size(), srcImg.size());
+  cv::Mat mask(srcImg.size(), CV_8U, cv::Scalar(255));
+  cv::Mat gotMask;
+  testObject.warpMask(mask, gotMask);
+  int zeros = gotMask.total() - cv::countNonZero(gotMask);
+  int saturated = cv::countNonZero(gotMask == 255);
+  EXPECT_EQ(static_cast<int>(gotMask.total()), zeros + saturated);
+  EXPECT_GT(saturated, 0);
+  // the top corners of the bird's-eye view lie outside the lane polygon
+  EXPECT_EQ(0, gotMask.at<uchar>(0, 0));
+  EXPECT_EQ(0, gotMask.at<uchar>(0, gotMask.cols - 1));
+}
+/**
+ *@brief Test to ensure the packed warp sets exactly the pixels of warpMask
+ */
+TEST_F(BirdsEyeRemapTest, isPackedMaskEqual) {
+  cv::Mat distortion = (cv::Mat_<double>(1, 5) << -0.242565104, -0.0477893070,
+      -0.00131388084, -0.0000879107779, 0.0220573263);
+  std::vector<cv::Point> laneROI = { cv::Point(560, 429), cv::Point(690, 429),
+      cv::Point(1155, 672), cv::Point(225, 672) };
+  testObject.build(intrinsic, distortion, T_perspective, laneROI,
+                   srcImg.size(), srcImg.size());
+  cv::Mat mask(srcImg.size(), CV_8U, cv::Scalar(0));
+  cv::line(mask, cv::Point(600, 440), cv::Point(320, 670), 255, 12);
+  cv::line(mask, cv::Point(680, 440), cv::Point(1060, 670), 255, 12);
+  cv::Mat expectedMask, gotMask;
+  testObject.warpMask(mask, expectedMask);
+  PackedBinaryImage packedMask;
+  testObject.warpMaskPacked(mask, packedMask);
+  packedMask.unpack(gotMask);
+  EXPECT_GT(cv::countNonZero(expectedMask), 0);
+  EXPECT_EQ(0, cv::countNonZero(gotMask != expectedMask));
+}
@@ -0,0 +1,233 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    ChunkedProcessorTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Chunked Processor Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests that a recording split
+ *  into chunks with a tracker warm-up gives
+ *  the rows of a sequential run in time order.
+ *
+ */
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <sstream>
+#include <vector>
+#include "ChunkedProcessor.hpp"
+
+/**
+ * @brief  Class to test ChunkedProcessor.
+ */
+class ChunkedProcessorTest : public ::testing::Test {
+ protected:
+  ChunkedProcessor testObject;
+  LaneDetection settings;
+  std::vector<cv::Mat> frames;
+  std::vector<uint64_t> openedAt;
+  /**
+   *@brief Create a recording with the lanes drifting slowly
+   */
+  virtual void SetUp() {
+    for (int i = 0; i < 24; i++) {
+      cv::Mat frame(720, 1280, CV_8UC3, cv::Scalar(90, 95, 100));
+      cv::line(frame, cv::Point(600 - i, 440), cv::Point(320 + i, 670),
+               cv::Scalar(0, 210, 240), 12);
+      cv::line(frame, cv::Point(680 + i, 440), cv::Point(1060 - i, 670),
+               cv::Scalar(235, 235, 235), 12);
+      frames.push_back(frame);
+    }
+    settings.setTracking(true);
+    testObject.getEngine().setNumWorkers(3);
+  }
+  /**
+   *@brief Opener of the recording at a frame
+   */
+  ChunkedProcessor::SourceOpener opener() {
+    return [this](uint64_t firstFrame) -> FramePipeline::FrameSource {
+      openedAt.push_back(firstFrame);
+      std::shared_ptr<std::size_t> nextFrame =
+          std::make_shared<std::size_t>(firstFrame);
+      return [this, nextFrame](cv::Mat& frame) {
+        if (*nextFrame >= frames.size()) {
+          return false;
+        }
+        frames[(*nextFrame)++].copyTo(frame);
+        return true;
+      };
+    };
+  }
+  /**
+   *@brief Writer of the frame index and the lane fits of a frame
+   */
+  static void writeRow(std::ostream& rows,
+                       const FramePipeline::FrameResult& result) {
+    const cv::Mat* laneFits = result.workspace->getLaneFits();
+    rows << result.frameIdx;
+    for (int lane = 0; lane < 2; lane++) {
+      for (int k = 0; k < 3; k++) {
+        rows << ' ' << (laneFits[lane].empty() ? 0.0
+            : laneFits[lane].at<double>(k));
+      }
+    }
+    rows << '\n';
+  }
+  /**
+   *@brief Read the rows back, one vector of values per frame
+   */
+  static std::vector<std::vector<double> > readRows(const std::string& text) {
+    std::vector<std::vector<double> > rows;
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+      std::istringstream values(line);
+      std::vector<double> row;
+      double value = 0;
+      while (values >> value) {
+        row.push_back(value);
+      }
+      rows.push_back(row);
+    }
+    return rows;
+  }
+  /**
+   *@brief Process the recording with the current chunking
+   */
+  std::vector<std::vector<double> > process(void) {
+    std::ostringstream output;
+    output.precision(12);
+    EXPECT_TRUE(testObject.process(settings, frames.size(), opener(),
+                                   writeRow, output));
+    return readRows(output.str());
+  }
+  /**
+   *@brief Check that the chunked rows are the sequential rows in time
+   *       order, the fits within a relative tolerance
+   */
+  static void expectRowsNear(
+      const std::vector<std::vector<double> >& sequential,
+      const std::vector<std::vector<double> >& chunked, double tolerance) {
+    ASSERT_EQ(sequential.size(), chunked.size());
+    for (std::size_t i = 0; i < chunked.size(); i++) {
+      ASSERT_EQ(sequential[i].size(), chunked[i].size());
+      EXPECT_EQ(static_cast<double>(i), chunked[i][0]);
+      for (std::size_t k = 1; k < chunked[i].size(); k++) {
+        EXPECT_NEAR(sequential[i][k], chunked[i][k],
+                    tolerance * (1.0 + std::abs(sequential[i][k])));
+      }
+    }
+  }
+};
+/**
+ *@brief Test to ensure chunks with a warm-up covering the tracker history
+ *       give the rows of a sequential run in time order
+ */
+TEST_F(ChunkedProcessorTest, isChunkedMatchingSequential) {
+  EXPECT_EQ(1, testObject.getNumChunks());
+  std::vector<std::vector<double> > sequential = process();
+  ASSERT_EQ(frames.size(), sequential.size());
+  testObject.setNumChunks(3);
+  testObject.setWarmupFrames(16);
+  EXPECT_EQ(3, testObject.getNumChunks());
+  EXPECT_EQ(16, testObject.getWarmupFrames());
+  openedAt.clear();
+  std::vector<std::vector<double> > chunked = process();
+  // chunks of 8 frames, each opened its warm-up before
+  ASSERT_EQ(3u, openedAt.size());
+  EXPECT_EQ(0u, openedAt[0]);
+  EXPECT_EQ(0u, openedAt[1]);
+  EXPECT_EQ(0u, openedAt[2]);
+  EXPECT_EQ(frames.size(), testObject.getFramesWritten());
+  EXPECT_EQ(8u + 16u + 24u, testObject.getFramesProcessed());
+  expectRowsNear(sequential, chunked, 1e-6);
+}
+/**
+ *@brief Test to ensure chunks opened after the first frame, with a warm-up
+ *       of twice the moving average history as documented, still match
+ *       the sequential run
+ */
+TEST_F(ChunkedProcessorTest, isTruncatedWarmupMatchingSequential) {
+  settings.getLaneTracker().setHistoryLength(3);
+  std::vector<std::vector<double> > sequential = process();
+  ASSERT_EQ(frames.size(), sequential.size());
+  testObject.setNumChunks(3);
+  testObject.setWarmupFrames(6);
+  openedAt.clear();
+  std::vector<std::vector<double> > chunked = process();
+  // the later chunks start their tracker state mid recording
+  ASSERT_EQ(3u, openedAt.size());
+  EXPECT_EQ(0u, openedAt[0]);
+  EXPECT_EQ(2u, openedAt[1]);
+  EXPECT_EQ(10u, openedAt[2]);
+  EXPECT_EQ(frames.size() + 2 * 6, testObject.getFramesProcessed());
+  expectRowsNear(sequential, chunked, 1e-6);
+}
+/**
+ *@brief Test to ensure chunks opened after the first frame with the
+ *       exponential filter stay within the documented decay of the state
+ *       difference, (1 - gain)^warmupFrames
+ */
+TEST_F(ChunkedProcessorTest, isTruncatedWarmupWithinExponentialTolerance) {
+  LaneTracker& tracker = settings.getLaneTracker();
+  tracker.setMode(LaneTracker::TRACK_EXPONENTIAL);
+  tracker.setGain(0.5);
+  std::vector<std::vector<double> > sequential = process();
+  ASSERT_EQ(frames.size(), sequential.size());
+  testObject.setNumChunks(3);
+  testObject.setWarmupFrames(6);
+  openedAt.clear();
+  std::vector<std::vector<double> > chunked = process();
+  ASSERT_EQ(3u, openedAt.size());
+  EXPECT_EQ(2u, openedAt[1]);
+  EXPECT_EQ(10u, openedAt[2]);
+  expectRowsNear(sequential, chunked, std::pow(1.0 - 0.5, 6));
+}
+/**
+ *@brief Test to ensure a short warm-up opens the chunks later and still
+ *       writes every frame once
+ */
+TEST_F(ChunkedProcessorTest, isWarmupLimited) {
+  testObject.setNumChunks(4);
+  testObject.setWarmupFrames(2);
+  std::vector<std::vector<double> > chunked = process();
+  ASSERT_EQ(4u, openedAt.size());
+  EXPECT_EQ(0u, openedAt[0]);
+  EXPECT_EQ(4u, openedAt[1]);
+  EXPECT_EQ(10u, openedAt[2]);
+  EXPECT_EQ(16u, openedAt[3]);
+  EXPECT_EQ(frames.size() + 3 * 2, testObject.getFramesProcessed());
+  ASSERT_EQ(frames.size(), chunked.size());
+  for (std::size_t i = 0; i < chunked.size(); i++) {
+    EXPECT_EQ(static_cast<double>(i), chunked[i][0]);
+  }
+}
+/**
+ *@brief Test to ensure more chunks than frames gives one chunk per frame
+ */
+TEST_F(ChunkedProcessorTest, isChunkCountLimited) {
+  frames.resize(2);
+  testObject.setNumChunks(5);
+  testObject.setWarmupFrames(0);
+  std::vector<std::vector<double> > chunked = process();
+  EXPECT_EQ(2u, openedAt.size());
+  ASSERT_EQ(2u, chunked.size());
+  EXPECT_EQ(0.0, chunked[0][0]);
+  EXPECT_EQ(1.0, chunked[1][0]);
+}
+/**
+ *@brief Test to ensure nothing is processed when a chunk can not be opened
+ */
+TEST_F(ChunkedProcessorTest, isOpenFailureReported) {
+  testObject.setNumChunks(2);
+  std::ostringstream output;
+  EXPECT_FALSE(testObject.process(settings, frames.size(),
+      [](uint64_t firstFrame) {
+        return firstFrame == 0 ? FramePipeline::FrameSource(
+            [](cv::Mat&) { return false; }) : FramePipeline::FrameSource();
+      }, writeRow, output));
+  EXPECT_TRUE(output.str().empty());
+  EXPECT_EQ(0u, testObject.getFramesWritten());
+}
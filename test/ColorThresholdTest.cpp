@@ -0,0 +1,138 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    ColorThresholdTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Color Threshold Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests the fused colour
+ *  threshold kernel.
+ *
+ */
+#include <gtest/gtest.h>
+#include "ColorThreshold.hpp"
+
+/**
+ * @brief  Class to test ColorThreshold.
+ */
+class ColorThresholdTest : public ::testing::Test {
+ protected:
+  ColorThreshold testObject;
+  /**
+   *@brief Reference threshold through a converted image
+   */
+  void referenceThreshold(const cv::Mat& src, int colorCode,
+                          const cv::Scalar& lower, const cv::Scalar& upper,
+                          cv::Mat& dst) {
+    cv::Mat convertedImg;
+    if (colorCode < 0) {
+      convertedImg = src;
+    } else {
+      cv::cvtColor(src, convertedImg, colorCode);
+    }
+    cv::inRange(convertedImg, lower, upper, dst);
+  }
+};
+/**
+ *@brief Test to ensure the kernel is bit-exact with cvtColor and inRange
+ */
+TEST_F(ColorThresholdTest, isBitExact) {
+  cv::Mat srcImg(123, 517, CV_8UC3);
+  cv::theRNG().state = 2018;
+  cv::randu(srcImg, cv::Scalar::all(0), cv::Scalar::all(256));
+  std::vector<cv::Scalar> lowers = { cv::Scalar(18, 97, 97),
+      cv::Scalar(0, 0, 0), cv::Scalar(90, 200, 10) };
+  std::vector<cv::Scalar> uppers = { cv::Scalar(32, 255, 255),
+      cv::Scalar(180, 120, 255), cv::Scalar(130, 255, 60) };
+  testObject.addRule(ColorThreshold::COLOR_SPACE_HLS, lowers[0], uppers[0]);
+  for (std::size_t i = 0; i < lowers.size(); i++) {
+    testObject.setRule(0, lowers[i], uppers[i]);
+    cv::Mat gotMask, expectedMask;
+    testObject.apply(srcImg, gotMask);
+    referenceThreshold(srcImg, cv::COLOR_BGR2HLS, lowers[i], uppers[i],
+                       expectedMask);
+    EXPECT_EQ(0, cv::countNonZero(gotMask != expectedMask));
+  }
+}
+/**
+ *@brief Test to ensure rules in several colour spaces are ORed bit-exactly
+ *       and counted per rule
+ */
+TEST_F(ColorThresholdTest, isMultiRuleBitExact) {
+  cv::Mat srcImg(97, 301, CV_8UC3);
+  cv::theRNG().state = 2018;
+  cv::randu(srcImg, cv::Scalar::all(0), cv::Scalar::all(256));
+  std::vector<int> colorSpaces = { ColorThreshold::COLOR_SPACE_HLS,
+      ColorThreshold::COLOR_SPACE_BGR, ColorThreshold::COLOR_SPACE_LAB,
+      ColorThreshold::COLOR_SPACE_YUV };
+  std::vector<int> colorCodes = { cv::COLOR_BGR2HLS, -1, cv::COLOR_BGR2Lab,
+      cv::COLOR_BGR2YUV };
+  std::vector<cv::Scalar> lowers = { cv::Scalar(18, 97, 97),
+      cv::Scalar(200, 200, 200), cv::Scalar(0, 0, 150),
+      cv::Scalar(0, 0, 180) };
+  std::vector<cv::Scalar> uppers = { cv::Scalar(32, 255, 255),
+      cv::Scalar(255, 255, 255), cv::Scalar(255, 255, 255),
+      cv::Scalar(255, 255, 255) };
+  cv::Mat expectedMask(srcImg.size(), CV_8U, cv::Scalar(0));
+  std::vector<int> expectedHits;
+  for (std::size_t i = 0; i < colorSpaces.size(); i++) {
+    EXPECT_EQ(static_cast<int>(i),
+              testObject.addRule(colorSpaces[i], lowers[i], uppers[i]));
+    cv::Mat ruleMask;
+    referenceThreshold(srcImg, colorCodes[i], lowers[i], uppers[i], ruleMask);
+    expectedHits.push_back(cv::countNonZero(ruleMask));
+    cv::bitwise_or(expectedMask, ruleMask, expectedMask);
+  }
+  EXPECT_EQ(4, testObject.getNumRules());
+  testObject.build();
+  testObject.setHitCounting(true);
+  cv::Mat gotMask;
+  testObject.apply(srcImg, gotMask);
+  EXPECT_GT(cv::countNonZero(expectedMask), 0);
+  EXPECT_EQ(0, cv::countNonZero(gotMask != expectedMask));
+  std::vector<uint64_t> ruleHits = testObject.getRuleHits();
+  ASSERT_EQ(colorSpaces.size(), ruleHits.size());
+  for (std::size_t i = 0; i < ruleHits.size(); i++) {
+    EXPECT_EQ(static_cast<uint64_t>(expectedHits[i]), ruleHits[i]);
+  }
+  EXPECT_EQ(static_cast<uint64_t>(srcImg.total()), testObject.getPixelCount());
+  testObject.resetHits();
+  EXPECT_EQ(0u, testObject.getPixelCount());
+}
+/**
+ *@brief Test to ensure only the requested span of a row is written
+ */
+TEST_F(ColorThresholdTest, isSpanRespected) {
+  testObject.addRule(ColorThreshold::COLOR_SPACE_HLS, cv::Scalar(18, 97, 97),
+                     cv::Scalar(32, 255, 255));
+  cv::Mat srcImg(1, 64, CV_8UC3, cv::Scalar(0, 210, 240));
+  cv::Mat mask(1, 64, CV_8U, cv::Scalar(7));
+  testObject.thresholdRow(srcImg.ptr<uchar>(0), mask.ptr<uchar>(0), 5, 43);
+  EXPECT_EQ(7, mask.at<uchar>(0, 4));
+  EXPECT_EQ(255, mask.at<uchar>(0, 5));
+  EXPECT_EQ(255, mask.at<uchar>(0, 42));
+  EXPECT_EQ(7, mask.at<uchar>(0, 43));
+}
+/**
+ *@brief Test to ensure copies share the built tables until their rules change
+ */
+TEST_F(ColorThresholdTest, isTableShared) {
+  EXPECT_EQ(nullptr, testObject.getTable());
+  testObject.addRule(ColorThreshold::COLOR_SPACE_BGR, cv::Scalar(200, 200, 200),
+                     cv::Scalar(255, 255, 255));
+  testObject.build();
+  ColorThreshold copyObject = testObject;
+  EXPECT_EQ(testObject.getTable(), copyObject.getTable());
+  copyObject.setRule(0, cv::Scalar(100, 100, 100), cv::Scalar(255, 255, 255));
+  copyObject.build();
+  EXPECT_NE(testObject.getTable(), copyObject.getTable());
+  // the original keeps thresholding with its own table
+  cv::Mat srcImg(1, 1, CV_8UC3, cv::Scalar(150, 150, 150));
+  cv::Mat mask, copyMask;
+  testObject.apply(srcImg, mask);
+  copyObject.apply(srcImg, copyMask);
+  EXPECT_EQ(0, mask.at<uchar>(0, 0));
+  EXPECT_EQ(255, copyMask.at<uchar>(0, 0));
+}
@@ -0,0 +1,86 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    DenoiserTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Denoiser Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests the denoise modes
+ *  and the automatic bypass.
+ *
+ */
+#include <gtest/gtest.h>
+#include "Denoiser.hpp"
+
+/**
+ * @brief  Class to test Denoiser.
+ */
+class DenoiserTest : public ::testing::Test {
+ protected:
+  Denoiser testObject;
+  cv::Mat srcImg;
+  /**
+   *@brief Create a noisy colour image whose width is not a multiple of 16
+   */
+  virtual void SetUp() {
+    srcImg.create(67, 141, CV_8UC3);
+    cv::theRNG().state = 2018;
+    cv::randu(srcImg, cv::Scalar::all(0), cv::Scalar::all(256));
+  }
+  /**
+   *@brief Largest absolute difference between two images
+   */
+  double maxAbsDiff(const cv::Mat& a, const cv::Mat& b) {
+    return cv::norm(a, b, cv::NORM_INF);
+  }
+};
+/**
+ *@brief Test to ensure a delta-like Gaussian is bypassed without changing
+ *       the image
+ */
+TEST_F(DenoiserTest, isDeltaKernelBypassed) {
+  testObject.setMode(Denoiser::DENOISE_GAUSSIAN);
+  testObject.setSigma(0.04, 0.06);
+  EXPECT_TRUE(testObject.isBypass());
+  cv::Mat gotImg, expectedImg;
+  testObject.apply(srcImg, gotImg);
+  cv::GaussianBlur(srcImg, expectedImg, cv::Size(5, 5), 0.04, 0.06);
+  EXPECT_EQ(0, maxAbsDiff(srcImg, gotImg));
+  EXPECT_EQ(0, maxAbsDiff(expectedImg, gotImg));
+  testObject.setSigma(1.0, 1.0);
+  EXPECT_FALSE(testObject.isBypass());
+  testObject.setMode(Denoiser::DENOISE_GAUSSIAN5_FIXED);
+  EXPECT_FALSE(testObject.isBypass());
+  testObject.setSigma(0.04, 0.06);
+  EXPECT_TRUE(testObject.isBypass());
+}
+/**
+ *@brief Test to ensure the integer modes match their float references
+ */
+TEST_F(DenoiserTest, isFixedPointAccurate) {
+  cv::Mat gotImg, expectedImg;
+  testObject.setMode(Denoiser::DENOISE_BINOMIAL3);
+  EXPECT_EQ(Denoiser::DENOISE_BINOMIAL3, testObject.getMode());
+  testObject.apply(srcImg, gotImg);
+  cv::Mat binomial = (cv::Mat_<float>(3, 1) << 0.25f, 0.5f, 0.25f);
+  cv::sepFilter2D(srcImg, expectedImg, -1, binomial, binomial);
+  EXPECT_LE(maxAbsDiff(expectedImg, gotImg), 1);
+  testObject.setMode(Denoiser::DENOISE_GAUSSIAN5_FIXED);
+  testObject.setSigma(1.2, 0.8);
+  testObject.apply(srcImg, gotImg);
+  cv::GaussianBlur(srcImg, expectedImg, cv::Size(5, 5), 1.2, 0.8);
+  EXPECT_LE(maxAbsDiff(expectedImg, gotImg), 2);
+}
+/**
+ *@brief Test to ensure the median mode is a 3x3 median
+ */
+TEST_F(DenoiserTest, isMedianApplied) {
+  cv::Mat gotImg, expectedImg;
+  testObject.setMode(Denoiser::DENOISE_MEDIAN3);
+  testObject.apply(srcImg, gotImg);
+  cv::medianBlur(srcImg, expectedImg, 3);
+  EXPECT_FALSE(testObject.isBypass());
+  EXPECT_EQ(0, maxAbsDiff(expectedImg, gotImg));
+}
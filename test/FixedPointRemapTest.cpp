@@ -0,0 +1,83 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    FixedPointRemapTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Fixed Point Remap Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests the fixed-point remap against cv::remap.
+ *
+ */
+#include <gtest/gtest.h>
+#include "FixedPointRemap.hpp"
+
+/**
+ * @brief  Class to test FixedPointRemap.
+ */
+class FixedPointRemapTest : public ::testing::Test {
+ protected:
+  FixedPointRemap testObject;
+  cv::Mat srcImg;
+  cv::Mat map1;
+  cv::Mat map2;
+  /**
+   *@brief Create a random colour image and fixed-point maps that sample
+   *       inside, on the border of and outside of it
+   */
+  virtual void SetUp() {
+    srcImg.create(67, 141, CV_8UC3);
+    cv::theRNG().state = 2018;
+    cv::randu(srcImg, cv::Scalar::all(0), cv::Scalar::all(256));
+    cv::Mat mapX(53, 97, CV_32FC1), mapY(53, 97, CV_32FC1);
+    cv::randu(mapX, cv::Scalar(-3), cv::Scalar(srcImg.cols + 3));
+    cv::randu(mapY, cv::Scalar(-3), cv::Scalar(srcImg.rows + 3));
+    cv::convertMaps(mapX, mapY, map1, map2, CV_16SC2, false);
+  }
+};
+/**
+ *@brief Test to ensure the output is within one grey level of cv::remap
+ *       inside the image and on its zero border
+ */
+TEST_F(FixedPointRemapTest, isRemapAccurate) {
+  cv::Mat gotImg, expectedImg;
+  testObject.remap(srcImg, gotImg, map1, map2);
+  cv::remap(srcImg, expectedImg, map1, map2, cv::INTER_LINEAR,
+            cv::BORDER_CONSTANT);
+  EXPECT_EQ(map1.size(), gotImg.size());
+  EXPECT_EQ(srcImg.type(), gotImg.type());
+  EXPECT_LE(cv::norm(expectedImg, gotImg, cv::NORM_INF), 1);
+  cv::Mat gray, gotGray, expectedGray;
+  cv::cvtColor(srcImg, gray, cv::COLOR_BGR2GRAY);
+  testObject.remap(gray, gotGray, map1, map2);
+  cv::remap(gray, expectedGray, map1, map2, cv::INTER_LINEAR,
+            cv::BORDER_CONSTANT);
+  EXPECT_LE(cv::norm(expectedGray, gotGray, cv::NORM_INF), 1);
+}
+/**
+ *@brief Test to ensure an identity map copies the image exactly
+ */
+TEST_F(FixedPointRemapTest, isIdentityExact) {
+  cv::Mat mapX(srcImg.size(), CV_32FC1), mapY(srcImg.size(), CV_32FC1);
+  for (int y = 0; y < srcImg.rows; y++) {
+    for (int x = 0; x < srcImg.cols; x++) {
+      mapX.at<float>(y, x) = static_cast<float>(x);
+      mapY.at<float>(y, x) = static_cast<float>(y);
+    }
+  }
+  cv::convertMaps(mapX, mapY, map1, map2, CV_16SC2, false);
+  cv::Mat gotImg;
+  testObject.remap(srcImg, gotImg, map1, map2);
+  EXPECT_EQ(0, cv::norm(srcImg, gotImg, cv::NORM_INF));
+}
+/**
+ *@brief Test to ensure the output buffer is reused once sized
+ */
+TEST_F(FixedPointRemapTest, isOutputReused) {
+  cv::Mat gotImg;
+  testObject.remap(srcImg, gotImg, map1, map2);
+  const uchar* data = gotImg.data;
+  testObject.remap(srcImg, gotImg, map1, map2);
+  EXPECT_TRUE(data == gotImg.data);
+}
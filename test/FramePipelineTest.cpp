@@ -0,0 +1,144 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    FramePipelineTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Frame Pipeline Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests that the pipelined executor
+ *  keeps the frames in order, matches the serial
+ *  pipeline and applies back-pressure.
+ *
+ */
+#include <gtest/gtest.h>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "FramePipeline.hpp"
+
+/**
+ * @brief  Class to test FramePipeline.
+ */
+class FramePipelineTest : public ::testing::Test {
+ protected:
+  LaneDetection lanes;
+  FramePipeline testObject;
+  std::vector<cv::Mat> frames;
+  std::size_t nextFrame;
+  FramePipelineTest()
+      : testObject(lanes),
+        nextFrame(0) {
+  }
+  /**
+   *@brief Create a short stream with the lanes moving apart
+   */
+  virtual void SetUp() {
+    lanes.getVisualizer().setMode(LaneVisualizer::VISUALIZE_OVERLAY);
+    for (int i = 0; i < 6; i++) {
+      cv::Mat frame(720, 1280, CV_8UC3, cv::Scalar(90, 95, 100));
+      cv::line(frame, cv::Point(600 - 4 * i, 440), cv::Point(320, 670),
+               cv::Scalar(0, 210, 240), 12);
+      cv::line(frame, cv::Point(680 + 4 * i, 440), cv::Point(1060, 670),
+               cv::Scalar(235, 235, 235), 12);
+      frames.push_back(frame);
+    }
+  }
+  /**
+   *@brief Source reading the stream one frame at a time
+   */
+  FramePipeline::FrameSource source() {
+    nextFrame = 0;
+    return [this](cv::Mat& frame) {
+      if (nextFrame == frames.size()) {
+        return false;
+      }
+      frames[nextFrame++].copyTo(frame);
+      return true;
+    };
+  }
+};
+/**
+ *@brief Test to ensure the frames come out in order and as the serial
+ *       pipeline renders them
+ */
+TEST_F(FramePipelineTest, isSerialOrderKept) {
+  LaneDetection serialLanes;
+  serialLanes.getVisualizer().setMode(LaneVisualizer::VISUALIZE_OVERLAY);
+  FrameWorkspace workspace;
+  workspace.allocate(frames[0].size());
+  std::vector<cv::Mat> expectedFrames;
+  for (std::size_t i = 0; i < frames.size(); i++) {
+    serialLanes.processFrame(frames[i], workspace);
+    expectedFrames.push_back(
+        workspace.getBuffer(FrameWorkspace::OUTPUT_FRAME).clone());
+  }
+  uint64_t expectedIdx = 0;
+  testObject.setFrameSink([&](const FramePipeline::FrameResult& result) {
+    EXPECT_EQ(expectedIdx, result.frameIdx);
+    EXPECT_EQ(0, cv::norm(expectedFrames[result.frameIdx],
+                          result.workspace->getBuffer(
+                              FrameWorkspace::OUTPUT_FRAME),
+                          cv::NORM_INF));
+    EXPECT_LE(result.stageMs[FramePipeline::SEARCH_STAGE], result.latencyMs);
+    expectedIdx++;
+    return true;
+  });
+  testObject.setQueueDepth(3);
+  testObject.run(source());
+  EXPECT_EQ(frames.size(), testObject.getFramesProcessed());
+  EXPECT_EQ(0u, testObject.getFramesDropped());
+  EXPECT_EQ(frames.size(), lanes.getFrameCount());
+}
+/**
+ *@brief Test to ensure dropped frames are counted and the rest stay in
+ *       order
+ */
+TEST_F(FramePipelineTest, isBackPressureDropping) {
+  testObject.setBackPressure(FramePipeline::BACKPRESSURE_DROP);
+  testObject.setQueueDepth(1);
+  uint64_t lastIdx = 0;
+  bool isFirst = true;
+  testObject.setFrameSink([&](const FramePipeline::FrameResult& result) {
+    EXPECT_TRUE(isFirst || result.frameIdx > lastIdx);
+    isFirst = false;
+    lastIdx = result.frameIdx;
+    // a slow sink keeps the only slot in flight
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    return true;
+  });
+  testObject.run(source());
+  EXPECT_LE(1u, testObject.getFramesProcessed());
+  EXPECT_EQ(frames.size(),
+            testObject.getFramesProcessed() + testObject.getFramesDropped());
+}
+/**
+ *@brief Test to ensure the sink can stop the pipeline
+ */
+TEST_F(FramePipelineTest, isStoppedBySink) {
+  testObject.setFrameSink([](const FramePipeline::FrameResult&) {
+    return false;
+  });
+  testObject.run(source());
+  EXPECT_EQ(1u, testObject.getFramesProcessed());
+}
+/**
+ *@brief Test to ensure a failure wakes decode blocked on a full pipeline
+ *       and is rethrown
+ */
+TEST_F(FramePipelineTest, isFailureRethrownWhileBlocked) {
+  testObject.setQueueDepth(1);
+  testObject.setFrameSink([](const FramePipeline::FrameResult&) -> bool {
+    // decode waits for the only slot meanwhile
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    throw std::runtime_error("sink failed");
+  });
+  // an endless stream, only the failure ends the run
+  EXPECT_THROW(testObject.run([this](cv::Mat& frame) {
+    frames[0].copyTo(frame);
+    return true;
+  }), std::runtime_error);
+  EXPECT_EQ(1u, testObject.getFramesProcessed());
+}
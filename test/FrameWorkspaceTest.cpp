@@ -0,0 +1,108 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    FrameWorkspaceTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Frame Workspace Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests that the pipeline reuses the
+ *  frame workspace buffers once they are sized. The
+ *  allocations outside the workspace are counted by
+ *  SteadyStateAllocationTest in cpp-alloc-test.
+ *
+ */
+#include <gtest/gtest.h>
+#include "FrameWorkspace.hpp"
+#include "LaneDetection.hpp"
+
+/**
+ * @brief  Class to test FrameWorkspace.
+ */
+class FrameWorkspaceTest : public ::testing::Test {
+ protected:
+  FrameWorkspace testObject;
+  LaneDetection lanes;
+  cv::Mat srcImg;
+  /**
+   *@brief Create a synthetic road frame with a yellow and a white lane
+   *       marking
+   */
+  virtual void SetUp() {
+    srcImg.create(720, 1280, CV_8UC3);
+    srcImg.setTo(cv::Scalar(90, 95, 100));
+    cv::line(srcImg, cv::Point(600, 440), cv::Point(320, 670),
+             cv::Scalar(0, 210, 240), 12);
+    cv::line(srcImg, cv::Point(680, 440), cv::Point(1060, 670),
+             cv::Scalar(235, 235, 235), 12);
+  }
+  /**
+   *@brief Run the pipeline on a few frames and check that only the first
+   *       ones allocate workspace buffers
+   */
+  void expectSteadyStateAllocationFree() {
+    testObject.allocate(srcImg.size());
+    // the first frames size the scratch of the full and the tracked search
+    for (int i = 0; i < 2; i++) {
+      lanes.processFrame(srcImg, testObject);
+    }
+    testObject.resetAllocationCount();
+    const uchar* outputData = testObject.getBuffer(
+        FrameWorkspace::OUTPUT_FRAME).data;
+    const double* histData = testObject.getHistogram().data();
+    std::size_t laneCapacity[FrameWorkspace::NUM_LANE_BUFFERS];
+    for (int lane = 0; lane < FrameWorkspace::NUM_LANE_BUFFERS; lane++) {
+      laneCapacity[lane] = testObject.getLanePoints(lane).capacity();
+    }
+    for (int i = 0; i < 3; i++) {
+      lanes.processFrame(srcImg, testObject);
+    }
+    EXPECT_EQ(0u, testObject.getAllocationCount());
+    EXPECT_EQ(outputData,
+              testObject.getBuffer(FrameWorkspace::OUTPUT_FRAME).data);
+    EXPECT_EQ(histData, testObject.getHistogram().data());
+    for (int lane = 0; lane < FrameWorkspace::NUM_LANE_BUFFERS; lane++) {
+      EXPECT_EQ(laneCapacity[lane], testObject.getLanePoints(lane).capacity());
+      EXPECT_FALSE(testObject.getLanePoints(lane).empty());
+    }
+  }
+};
+/**
+ *@brief Test to ensure the buffers are sized for the stream resolution
+ */
+TEST_F(FrameWorkspaceTest, isAllocated) {
+  EXPECT_FALSE(testObject.isAllocatedFor(srcImg.size()));
+  testObject.allocate(srcImg.size());
+  EXPECT_TRUE(testObject.isAllocatedFor(srcImg.size()));
+  EXPECT_EQ(srcImg.size(), testObject.getFrameSize());
+  EXPECT_EQ(srcImg.size(),
+            testObject.getBuffer(FrameWorkspace::PROCESSED_FRAME).size());
+  EXPECT_EQ(CV_8U, testObject.getBuffer(FrameWorkspace::BINARY_FRAME).type());
+  EXPECT_EQ(static_cast<std::size_t>(srcImg.cols),
+            testObject.getHistogram().size());
+  EXPECT_GT(testObject.getAllocationCount(), 0u);
+}
+/**
+ *@brief Test to ensure the steady state of the pipeline reuses the
+ *       workspace buffers
+ */
+TEST_F(FrameWorkspaceTest, isSteadyStateAllocationFree) {
+  expectSteadyStateAllocationFree();
+}
+/**
+ *@brief Test to ensure the ROI only path reuses them too
+ */
+TEST_F(FrameWorkspaceTest, isROISteadyStateAllocationFree) {
+  lanes.getImageProcessing().setROIProcessing(true);
+  expectSteadyStateAllocationFree();
+}
+/**
+ *@brief Test to ensure tracking the lanes from frame to frame reuses them
+ *       too
+ */
+TEST_F(FrameWorkspaceTest, isTrackingSteadyStateAllocationFree) {
+  lanes.setTracking(true);
+  expectSteadyStateAllocationFree();
+  EXPECT_TRUE(lanes.isTrackValid());
+}
@@ -21,10 +21,50 @@
 class ImageProcessingTest : public ::testing::Test {
  protected:
   ImageProcessing testObject;
-//  cv::Mat srcImg;
+  cv::Mat srcImg;
 //  cv::Mat preProcessedImg;
 //  cv::Mat binaryImg;
 //  cv::Mat birdViewImg;
+  /**
+   *@brief Create a synthetic road frame with a smooth background, a yellow
+   *       left lane marking and a white right lane marking
+   */
+  virtual void SetUp() {
+    srcImg.create(720, 1280, CV_8UC3);
+    for (int y = 0; y < srcImg.rows; y++) {
+      for (int x = 0; x < srcImg.cols; x++) {
+        srcImg.at<cv::Vec3b>(y, x) = cv::Vec3b(
+            cv::saturate_cast<uchar>(60 + x / 16),
+            cv::saturate_cast<uchar>(70 + y / 12),
+            cv::saturate_cast<uchar>(80 + (x + y) / 32));
+      }
+    }
+    cv::line(srcImg, cv::Point(600, 440), cv::Point(320, 670),
+             cv::Scalar(0, 210, 240), 12);
+    cv::line(srcImg, cv::Point(680, 440), cv::Point(1060, 670),
+             cv::Scalar(235, 235, 235), 12);
+  }
+  /**
+   *@brief Mean absolute difference per channel between two images
+   */
+  double meanAbsDiff(const cv::Mat& a, const cv::Mat& b) {
+    return cv::norm(a, b, cv::NORM_L1) / (a.total() * a.channels());
+  }
+  /**
+   *@brief Reference pre-processing with a per frame call to cv::undistort
+   */
+  void referencePreProcessing(const cv::Mat& src, cv::Mat& dst) {
+    cv::Mat undistortedImg, densoisedImg;
+    cv::undistort(src, undistortedImg, testObject.getIntrinsic(),
+                  testObject.getDistCoeffs());
+    cv::GaussianBlur(undistortedImg, densoisedImg, cv::Size(5, 5),
+                     testObject.getgaussianSigmaX(),
+                     testObject.getgaussianSigmaY());
+    cv::Mat ROImask = cv::Mat::zeros(src.size(), src.type());
+    cv::rectangle(ROImask, cv::Point(0, 429), cv::Point(1280, 672),
+                  cv::Scalar(255, 255, 255), -1, 8, 0);
+    densoisedImg.copyTo(dst, ROImask);
+  }
 };
 /**
  *@brief Test to ensure intrinsic parameters are set
@@ -97,3 +137,152 @@ TEST_F(ImageProcessingTest, isBGRMaxThresholdSet) {
   testObject.setMaxThreshBGR(tempBGRMax);
   EXPECT_EQ(tempBGRMax, testObject.getMaxThreshBGR());
 }
+/**
+ *@brief Test to ensure the cached undistortion maps reproduce cv::undistort
+ *       and are rebuilt when the camera model changes
+ */
+TEST_F(ImageProcessingTest, isCachedUndistortionEquivalent) {
+  cv::Mat gotImg, expectedImg;
+  testObject.preProcessing(srcImg, gotImg);
+  referencePreProcessing(srcImg, expectedImg);
+  ASSERT_EQ(expectedImg.size(), gotImg.size());
+  EXPECT_LT(meanAbsDiff(expectedImg, gotImg), 0.5);
+  // the second frame reuses the cached maps
+  testObject.preProcessing(srcImg, gotImg);
+  EXPECT_LT(meanAbsDiff(expectedImg, gotImg), 0.5);
+  // a new camera model must not reuse the old maps
+  testObject.setIntrinsic(1000.0, 1000.0, 640.0, 360.0);
+  testObject.setDistCoeffs(-0.1, 0.01, 0.0, 0.0, 0.0);
+  testObject.preProcessing(srcImg, gotImg);
+  referencePreProcessing(srcImg, expectedImg);
+  EXPECT_LT(meanAbsDiff(expectedImg, gotImg), 0.5);
+}
+/**
+ *@brief Test to ensure the default near-delta blur is bypassed and other
+ *       denoise modes can be selected
+ */
+TEST_F(ImageProcessingTest, isDenoiseModeSet) {
+  EXPECT_EQ(Denoiser::DENOISE_GAUSSIAN, testObject.getDenoiseMode());
+  EXPECT_TRUE(testObject.isDenoiseBypassed());
+  testObject.setgaussianSigmaX(1.5);
+  EXPECT_FALSE(testObject.isDenoiseBypassed());
+  testObject.setDenoiseMode(Denoiser::DENOISE_MEDIAN3);
+  EXPECT_EQ(Denoiser::DENOISE_MEDIAN3, testObject.getDenoiseMode());
+  cv::Mat gotImg, expectedImg;
+  testObject.preProcessing(srcImg, gotImg);
+  testObject.setDenoiseMode(Denoiser::DENOISE_BYPASS);
+  testObject.preProcessing(srcImg, expectedImg);
+  ASSERT_EQ(expectedImg.size(), gotImg.size());
+  EXPECT_LT(meanAbsDiff(expectedImg, gotImg), 2.0);
+}
+/**
+ *@brief Test to ensure the fused remap produces a binary bird's-eye mask
+ */
+TEST_F(ImageProcessingTest, isFusedRemapBinary) {
+  EXPECT_FALSE(testObject.getFusedRemap());
+  testObject.setFusedRemap(true);
+  EXPECT_TRUE(testObject.getFusedRemap());
+  cv::Mat processedImg, binaryImg, birdViewImg, T_perspective_inv;
+  testObject.preProcessing(srcImg, processedImg);
+  testObject.getBinaryImg(processedImg, binaryImg);
+  testObject.prespectiveTransform(binaryImg, birdViewImg, T_perspective_inv);
+  ASSERT_EQ(srcImg.size(), birdViewImg.size());
+  int nonZero = cv::countNonZero(birdViewImg);
+  EXPECT_GT(nonZero, 0);
+  EXPECT_EQ(nonZero, cv::countNonZero(birdViewImg == 255));
+}
+/**
+ *@brief Test to ensure ROI only processing matches whole frame processing
+ */
+TEST_F(ImageProcessingTest, isROIProcessingEquivalent) {
+  cv::Mat processedImg, binaryImg;
+  testObject.preProcessing(srcImg, processedImg);
+  testObject.getBinaryImg(processedImg, binaryImg);
+  EXPECT_FALSE(testObject.getROIProcessing());
+  testObject.setROIProcessing(true);
+  EXPECT_TRUE(testObject.getROIProcessing());
+  cv::Mat processedROI, binaryROI;
+  testObject.preProcessing(srcImg, processedROI);
+  testObject.getBinaryImg(processedROI, binaryROI);
+  EXPECT_EQ(0.0, cv::norm(processedImg, processedROI, cv::NORM_INF));
+  EXPECT_EQ(0.0, cv::norm(binaryImg, binaryROI, cv::NORM_INF));
+  // nothing outside a configured ROI is produced
+  testObject.setROI(cv::Rect(0, 500, 1280, 100));
+  EXPECT_EQ(cv::Rect(0, 500, 1280, 100), testObject.getROI());
+  testObject.preProcessing(srcImg, processedROI);
+  EXPECT_EQ(0, cv::countNonZero(
+      processedROI.rowRange(0, 500).reshape(1)));
+  EXPECT_EQ(0, cv::countNonZero(
+      processedROI.rowRange(600, 720).reshape(1)));
+}
+/**
+ *@brief Test to ensure the fused threshold kernel matches ORing the HLS
+ *       and BGR thresholds and masking it with the lane polygon
+ */
+TEST_F(ImageProcessingTest, isBinaryImgBitExact) {
+  cv::Mat processedImg, binaryImg;
+  testObject.preProcessing(srcImg, processedImg);
+  testObject.getBinaryImg(processedImg, binaryImg);
+  cv::Mat HLSimg, thresholdImg, expectedImg;
+  cv::cvtColor(processedImg, HLSimg, cv::COLOR_BGR2HLS);
+  cv::inRange(HLSimg, testObject.getMinThreshHLS(),
+              testObject.getMaxThreshHLS(), thresholdImg);
+  cv::Mat whiteImg;
+  cv::inRange(processedImg, testObject.getMinThreshBGR(),
+              testObject.getMaxThreshBGR(), whiteImg);
+  cv::bitwise_or(thresholdImg, whiteImg, thresholdImg);
+  std::vector<cv::Point> lanePoints = { cv::Point(560, 429),
+      cv::Point(690, 429), cv::Point(1155, 672), cv::Point(225, 672) };
+  cv::Mat laneMaskROI(processedImg.size(), CV_8U, cv::Scalar(0));
+  cv::fillConvexPoly(laneMaskROI, lanePoints, 255);
+  cv::bitwise_and(thresholdImg, laneMaskROI, expectedImg);
+  EXPECT_GT(cv::countNonZero(expectedImg), 0);
+  EXPECT_EQ(0, cv::countNonZero(binaryImg != expectedImg));
+}
+/**
+ *@brief Test to ensure a configured lane polygon bounds the binary image
+ */
+TEST_F(ImageProcessingTest, isLaneROISet) {
+  std::vector<cv::Point> laneROI = { cv::Point(600, 500), cv::Point(700, 500),
+      cv::Point(700, 600), cv::Point(600, 600) };
+  testObject.setLaneROI(laneROI);
+  EXPECT_EQ(laneROI, testObject.getLaneROI());
+  cv::Mat processedImg, binaryImg;
+  testObject.preProcessing(srcImg, processedImg);
+  testObject.getBinaryImg(processedImg, binaryImg);
+  cv::Mat outsideROI = binaryImg.clone();
+  outsideROI(cv::Rect(600, 500, 101, 101)).setTo(cv::Scalar(0));
+  EXPECT_EQ(0, cv::countNonZero(outsideROI));
+}
+/**
+ *@brief Test to ensure shared calibration artefacts give the same frames as
+ *       the own caches and are dropped when the calibration changes
+ */
+TEST_F(ImageProcessingTest, isSharedCalibrationEquivalent) {
+  cv::Mat processedImg, binaryImg, birdViewImg, T_perspective_inv;
+  testObject.preProcessing(srcImg, processedImg);
+  testObject.getBinaryImg(processedImg, binaryImg);
+  testObject.prespectiveTransform(binaryImg, birdViewImg, T_perspective_inv);
+  ImageProcessing sharingObject;
+  std::shared_ptr<const SharedCalibration> calibration =
+      sharingObject.buildSharedCalibration(srcImg.size());
+  EXPECT_TRUE(testObject.canShareCalibration(*calibration));
+  sharingObject.setSharedCalibration(calibration);
+  EXPECT_EQ(calibration, sharingObject.getSharedCalibration());
+  cv::Mat sharedProcessed, sharedBinary, sharedBirdView, sharedT_inv;
+  sharingObject.preProcessing(srcImg, sharedProcessed);
+  sharingObject.getBinaryImg(sharedProcessed, sharedBinary);
+  sharingObject.prespectiveTransform(sharedBinary, sharedBirdView,
+                                     sharedT_inv);
+  EXPECT_EQ(0.0, cv::norm(processedImg, sharedProcessed, cv::NORM_INF));
+  EXPECT_EQ(0.0, cv::norm(binaryImg, sharedBinary, cv::NORM_INF));
+  EXPECT_EQ(0.0, cv::norm(birdViewImg, sharedBirdView, cv::NORM_INF));
+  EXPECT_EQ(0.0, cv::norm(T_perspective_inv, sharedT_inv, cv::NORM_INF));
+  // the shared inverse transform is handed out without a copy
+  EXPECT_TRUE(calibration->getPerspectiveGeometry().getInverseTransform().data
+              == sharedT_inv.data);
+  // a different camera model can not use the shared artefacts
+  sharingObject.setIntrinsic(1000.0, 1000.0, 640.0, 360.0);
+  EXPECT_TRUE(sharingObject.getSharedCalibration() == nullptr);
+  EXPECT_FALSE(sharingObject.canShareCalibration(*calibration));
+}
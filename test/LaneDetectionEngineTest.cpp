@@ -0,0 +1,175 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    LaneDetectionEngineTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Lane Detection Engine Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests that streams run on the
+ *  worker pool match a serial run, keep their
+ *  state apart and share their calibration.
+ *
+ */
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "LaneDetectionEngine.hpp"
+
+/**
+ * @brief  Class to test LaneDetectionEngine.
+ */
+class LaneDetectionEngineTest : public ::testing::Test {
+ protected:
+  LaneDetectionEngine testObject;
+  std::vector<cv::Mat> frames;
+  /**
+   *@brief Create a short stream with the lanes moving apart
+   */
+  virtual void SetUp() {
+    for (int i = 0; i < 6; i++) {
+      cv::Mat frame(720, 1280, CV_8UC3, cv::Scalar(90, 95, 100));
+      cv::line(frame, cv::Point(600 - 4 * i, 440), cv::Point(320, 670),
+               cv::Scalar(0, 210, 240), 12);
+      cv::line(frame, cv::Point(680 + 4 * i, 440), cv::Point(1060, 670),
+               cv::Scalar(235, 235, 235), 12);
+      frames.push_back(frame);
+    }
+  }
+  /**
+   *@brief Source reading the stream one frame at a time, with its own
+   *       position
+   */
+  FramePipeline::FrameSource source() {
+    std::shared_ptr<std::size_t> nextFrame = std::make_shared<std::size_t>(0);
+    return [this, nextFrame](cv::Mat& frame) {
+      if (*nextFrame == frames.size()) {
+        return false;
+      }
+      frames[(*nextFrame)++].copyTo(frame);
+      return true;
+    };
+  }
+  /**
+   *@brief Sink keeping the lane fits of every frame
+   */
+  FramePipeline::FrameSink fitSink(std::vector<cv::Mat>& fits) {
+    return [&fits](const FramePipeline::FrameResult& result) {
+      const cv::Mat* laneFits = result.workspace->getLaneFits();
+      fits.push_back(laneFits[0].clone());
+      fits.push_back(laneFits[1].clone());
+      return true;
+    };
+  }
+};
+/**
+ *@brief Test to ensure every stream gets the fits of a serial run, so the
+ *       tracker state of the streams stays apart
+ */
+TEST_F(LaneDetectionEngineTest, isStreamMatchingSerial) {
+  testObject.getLaneDetection().setTracking(true);
+  LaneDetection serialLanes;
+  serialLanes.setTracking(true);
+  serialLanes.setLaneFitting(true);
+  serialLanes.getVisualizer().setMode(LaneVisualizer::VISUALIZE_NONE);
+  FrameWorkspace workspace;
+  workspace.allocate(frames[0].size());
+  std::vector<cv::Mat> expectedFits;
+  for (std::size_t i = 0; i < frames.size(); i++) {
+    serialLanes.processFrame(frames[i], workspace);
+    expectedFits.push_back(workspace.getLaneFits()[0].clone());
+    expectedFits.push_back(workspace.getLaneFits()[1].clone());
+  }
+  const int numStreams = 3;
+  std::vector<cv::Mat> gotFits[numStreams];
+  for (int i = 0; i < numStreams; i++) {
+    EXPECT_EQ(i, testObject.addStream(source(), fitSink(gotFits[i])));
+  }
+  testObject.setNumWorkers(2);
+  EXPECT_EQ(2, testObject.getNumWorkers());
+  testObject.run();
+  EXPECT_EQ(numStreams * frames.size(), testObject.getFramesProcessed());
+  for (int i = 0; i < numStreams; i++) {
+    EXPECT_EQ(frames.size(), testObject.getFramesProcessed(i));
+    ASSERT_EQ(expectedFits.size(), gotFits[i].size());
+    for (std::size_t k = 0; k < expectedFits.size(); k++) {
+      ASSERT_EQ(expectedFits[k].empty(), gotFits[i][k].empty());
+      if (!expectedFits[k].empty()) {
+        EXPECT_EQ(0, cv::norm(expectedFits[k], gotFits[i][k],
+                              cv::NORM_INF));
+      }
+    }
+  }
+}
+/**
+ *@brief Test to ensure the streams fit into buffers of their own, so the
+ *       fits of the settings they copied stay untouched
+ */
+TEST_F(LaneDetectionEngineTest, isSettingsFitUnshared) {
+  LaneDetection& settings = testObject.getLaneDetection();
+  settings.setTracking(true);
+  cv::Mat leftFit = (cv::Mat_<double>(3, 1) << 300, 0, 0);
+  cv::Mat rightFit = (cv::Mat_<double>(3, 1) << 1000, 0, 0);
+  settings.setLaneFit("Left", leftFit);
+  settings.setLaneFit("Right", rightFit);
+  std::vector<cv::Mat> gotFits;
+  EXPECT_EQ(0, testObject.addStream(source(), fitSink(gotFits)));
+  testObject.run();
+  EXPECT_EQ(frames.size(), testObject.getFramesProcessed(0));
+  EXPECT_EQ(0, cv::norm(leftFit, settings.getLaneFit("Left"), cv::NORM_INF));
+  EXPECT_EQ(0, cv::norm(rightFit, settings.getLaneFit("Right"),
+                        cv::NORM_INF));
+}
+/**
+ *@brief Test to ensure streams with the same calibration share one set of
+ *       artefacts and colour tables
+ */
+TEST_F(LaneDetectionEngineTest, isCalibrationShared) {
+  LaneDetection otherCamera;
+  otherCamera.getImageProcessing().setIntrinsic(1000.0, 1000.0, 640.0, 360.0);
+  testObject.addStream(source(), FramePipeline::FrameSink());
+  testObject.addStream(source(), FramePipeline::FrameSink());
+  testObject.addStream(otherCamera, source(), FramePipeline::FrameSink());
+  testObject.setNumWorkers(3);
+  testObject.run();
+  EXPECT_EQ(2, testObject.getNumCalibrations());
+  ImageProcessing& first = testObject.getStreamLanes(0).getImageProcessing();
+  ImageProcessing& second = testObject.getStreamLanes(1).getImageProcessing();
+  ImageProcessing& third = testObject.getStreamLanes(2).getImageProcessing();
+  ASSERT_TRUE(first.getSharedCalibration() != nullptr);
+  EXPECT_EQ(first.getSharedCalibration(), second.getSharedCalibration());
+  EXPECT_NE(first.getSharedCalibration(), third.getSharedCalibration());
+  EXPECT_EQ(first.getColorThreshold().getTable(),
+            second.getColorThreshold().getTable());
+  // a later run reuses the artefacts
+  testObject.run();
+  EXPECT_EQ(2, testObject.getNumCalibrations());
+}
+/**
+ *@brief Test to ensure a sink stops only its own stream
+ */
+TEST_F(LaneDetectionEngineTest, isStoppedBySink) {
+  testObject.addStream(source(), [](const FramePipeline::FrameResult&) {
+    return false;
+  });
+  testObject.addStream(source(), FramePipeline::FrameSink());
+  testObject.run();
+  EXPECT_EQ(1u, testObject.getFramesProcessed(0));
+  EXPECT_EQ(frames.size(), testObject.getFramesProcessed(1));
+}
+/**
+ *@brief Test to ensure the failure of a stream is rethrown by run
+ */
+TEST_F(LaneDetectionEngineTest, isFailureRethrown) {
+  testObject.addStream([](cv::Mat&) -> bool {
+    throw std::runtime_error("camera lost");
+  }, FramePipeline::FrameSink());
+  testObject.addStream(source(), FramePipeline::FrameSink());
+  testObject.setNumWorkers(2);
+  EXPECT_THROW(testObject.run(), std::runtime_error);
+  EXPECT_EQ(2, testObject.getNumStreams());
+  testObject.clearStreams();
+  EXPECT_EQ(0, testObject.getNumStreams());
+}
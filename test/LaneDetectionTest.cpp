@@ -13,6 +13,9 @@
  */
 
 #include <gtest/gtest.h>
+#include <limits>
+#include <numeric>
+#include <string>
 #include "LaneDetection.hpp"
 
 /**
@@ -22,3 +25,231 @@ class LaneDetectionTest : public ::testing::Test {
  protected:
   LaneDetection testObject;
 };
+/**
+ *@brief Test to ensure the occupancy histogram covers the configured band
+ */
+TEST_F(LaneDetectionTest, isHistBandApplied) {
+  cv::Mat birdViewImg(720, 1280, CV_8U, cv::Scalar(0));
+  cv::line(birdViewImg, cv::Point(300, 0), cv::Point(320, 719), 255, 9);
+  cv::line(birdViewImg, cv::Point(900, 100), cv::Point(960, 600), 255, 9);
+  PackedBinaryImage packedImg;
+  packedImg.pack(birdViewImg);
+  OccupancyIntegral occupancy;
+  occupancy.build(packedImg);
+  std::vector<double> expectedHist, gotHist;
+  testObject.generateHist(birdViewImg, expectedHist);
+  testObject.generateHist(occupancy, gotHist);
+  EXPECT_EQ(expectedHist, gotHist);
+  testObject.setHistBand(0.25, 0.75);
+  EXPECT_EQ(cv::Vec2d(0.25, 0.75), testObject.getHistBand());
+  testObject.generateHist(occupancy, gotHist);
+  cv::reduce(birdViewImg.rowRange(180, 540), expectedHist, 0, CV_REDUCE_SUM,
+             CV_64FC1);
+  EXPECT_EQ(expectedHist, gotHist);
+}
+/**
+ *@brief Test to ensure the sliding windows stay in the image and each lane
+ *       is taken from its own half
+ */
+TEST_F(LaneDetectionTest, isLaneExtractionBounded) {
+  cv::Mat birdViewImg(720, 1280, CV_8U, cv::Scalar(0));
+  cv::line(birdViewImg, cv::Point(2, 0), cv::Point(2, 719), 255, 5);
+  cv::line(birdViewImg, cv::Point(1277, 0), cv::Point(1277, 719), 255, 5);
+  PackedBinaryImage packedImg;
+  packedImg.pack(birdViewImg);
+  std::vector<double> hist;
+  testObject.generateHist(packedImg, hist);
+  testObject.setNumWindows(4);
+  testObject.setWindowWidth(40);
+  EXPECT_EQ(4, testObject.getNumWindows());
+  EXPECT_EQ(40, testObject.getWindowWidth());
+  std::vector<cv::Point> leftLane, rightLane;
+  cv::Mat drawWindow;
+  testObject.extractLane(packedImg, hist, leftLane, "Left", drawWindow);
+  testObject.extractLane(packedImg, hist, rightLane, "Right", drawWindow);
+  ASSERT_FALSE(leftLane.empty());
+  ASSERT_FALSE(rightLane.empty());
+  // lane points are stored as (row, column)
+  for (const cv::Point& pt : leftLane) {
+    EXPECT_LE(0, pt.y);
+    EXPECT_GT(640, pt.y);
+    EXPECT_EQ(cv::Vec3b(0, 255, 0), drawWindow.at<cv::Vec3b>(pt.x, pt.y));
+  }
+  for (const cv::Point& pt : rightLane) {
+    EXPECT_LE(640, pt.y);
+    EXPECT_GT(1280, pt.y);
+    EXPECT_EQ(cv::Vec3b(0, 0, 255), drawWindow.at<cv::Vec3b>(pt.x, pt.y));
+  }
+}
+/**
+ *@brief Test to ensure the workspace overloads find the lanes of the
+ *       legacy overloads
+ */
+TEST_F(LaneDetectionTest, isWorkspaceLaneExtractionMatching) {
+  cv::Mat birdViewImg(720, 1280, CV_8U, cv::Scalar(0));
+  cv::line(birdViewImg, cv::Point(300, 0), cv::Point(340, 719), 255, 9);
+  cv::line(birdViewImg, cv::Point(950, 0), cv::Point(900, 719), 255, 9);
+  PackedBinaryImage packedImg;
+  packedImg.pack(birdViewImg);
+  std::vector<double> hist;
+  testObject.generateHist(packedImg, hist);
+  std::vector<cv::Point> expectedLane, gotLane;
+  cv::Mat expectedWindow, gotWindow;
+  FrameWorkspace workspace;
+  for (const std::string laneType : { "Left", "Right" }) {
+    expectedLane.clear();
+    testObject.extractLane(packedImg, hist, expectedLane, laneType,
+                           expectedWindow);
+    ASSERT_FALSE(expectedLane.empty());
+    // twice, the second call reuses the buffers of the first
+    for (int call = 0; call < 2; call++) {
+      gotLane.clear();
+      testObject.extractLane(birdViewImg, hist, gotLane, laneType, gotWindow,
+                             workspace);
+      EXPECT_EQ(expectedLane, gotLane);
+      gotLane.clear();
+      testObject.extractLane(packedImg, hist, gotLane, laneType, gotWindow,
+                             workspace);
+      EXPECT_EQ(expectedLane, gotLane);
+    }
+  }
+  EXPECT_EQ(0, cv::norm(expectedWindow, gotWindow, cv::NORM_INF));
+}
+/**
+ *@brief Test to ensure tracking gathers only the pixels around the
+ *       previous fits
+ */
+TEST_F(LaneDetectionTest, isSearchAroundFitBounded) {
+  cv::Mat birdViewImg(720, 1280, CV_8U, cv::Scalar(0));
+  cv::line(birdViewImg, cv::Point(300, 0), cv::Point(300, 719), 255, 5);
+  cv::line(birdViewImg, cv::Point(450, 0), cv::Point(450, 719), 255, 5);
+  cv::line(birdViewImg, cv::Point(1000, 0), cv::Point(1000, 719), 255, 5);
+  PackedBinaryImage packedImg;
+  packedImg.pack(birdViewImg);
+  testObject.setTracking(true);
+  testObject.setTrackMargin(50);
+  EXPECT_FALSE(testObject.isTrackValid());
+  testObject.setLaneFit("Left", (cv::Mat_<double>(3, 1) << 300, 0, 0));
+  testObject.setLaneFit("Right", (cv::Mat_<double>(3, 1) << 1000, 0, 0));
+  EXPECT_TRUE(testObject.isTrackValid());
+  std::vector<cv::Point> leftLane, rightLane;
+  cv::Mat drawWindow;
+  testObject.extractLaneAroundFit(packedImg, leftLane, "Left", drawWindow);
+  testObject.extractLaneAroundFit(packedImg, rightLane, "Right", drawWindow);
+  // the lines are 5 pixels wide over every row
+  EXPECT_EQ(5u * 720u, leftLane.size());
+  EXPECT_EQ(5u * 720u, rightLane.size());
+  // lane points are stored as (row, column)
+  for (const cv::Point& pt : leftLane) {
+    EXPECT_NEAR(300, pt.y, 2);
+  }
+  for (const cv::Point& pt : rightLane) {
+    EXPECT_NEAR(1000, pt.y, 2);
+  }
+}
+/**
+ *@brief Test to ensure a fit that is not finite gathers no pixels
+ */
+TEST_F(LaneDetectionTest, isSearchAroundNonFiniteFitEmpty) {
+  cv::Mat birdViewImg(720, 1280, CV_8U, cv::Scalar(255));
+  PackedBinaryImage packedImg;
+  packedImg.pack(birdViewImg);
+  testObject.setTracking(true);
+  double nan = std::numeric_limits<double>::quiet_NaN();
+  double inf = std::numeric_limits<double>::infinity();
+  testObject.setLaneFit("Left", (cv::Mat_<double>(3, 1) << nan, 0, 0));
+  // infinite on every row, and NaN on row 0 where inf is multiplied by 0
+  testObject.setLaneFit("Right", (cv::Mat_<double>(3, 1) << 0, inf, 0));
+  std::vector<cv::Point> leftLane, rightLane;
+  cv::Mat drawWindow;
+  testObject.extractLaneAroundFit(packedImg, leftLane, "Left", drawWindow);
+  testObject.extractLaneAroundFit(packedImg, rightLane, "Right", drawWindow);
+  EXPECT_TRUE(leftLane.empty());
+  EXPECT_TRUE(rightLane.empty());
+}
+/**
+ *@brief Test to ensure every frame without lanes needs the full search
+ */
+TEST_F(LaneDetectionTest, isFullSearchCounted) {
+  EXPECT_EQ(0.0, testObject.getFullSearchRatio());
+  testObject.setTracking(true);
+  EXPECT_TRUE(testObject.isTracking());
+  cv::Mat frame(720, 1280, CV_8UC3, cv::Scalar(90, 95, 100));
+  FrameWorkspace workspace;
+  workspace.allocate(frame.size());
+  for (int i = 0; i < 3; i++) {
+    testObject.processFrame(frame, workspace);
+  }
+  EXPECT_FALSE(testObject.isTrackValid());
+  EXPECT_EQ(3u, testObject.getFrameCount());
+  EXPECT_EQ(3u, testObject.getFullSearchCount());
+  EXPECT_EQ(1.0, testObject.getFullSearchRatio());
+  testObject.resetSearchStats();
+  EXPECT_EQ(0u, testObject.getFrameCount());
+}
+/**
+ *@brief Test to ensure the concurrent lane search gives the same lanes as
+ *       a single thread
+ */
+TEST_F(LaneDetectionTest, isParallelSearchDeterministic) {
+  cv::Mat frame(720, 1280, CV_8UC3, cv::Scalar(90, 95, 100));
+  cv::line(frame, cv::Point(600, 440), cv::Point(320, 670),
+           cv::Scalar(0, 210, 240), 12);
+  cv::line(frame, cv::Point(680, 440), cv::Point(1060, 670),
+           cv::Scalar(235, 235, 235), 12);
+  LaneDetection serialObject;
+  // the warp renderer draws the lane pixels on the debug image
+  serialObject.getVisualizer().setRenderMode(LaneVisualizer::RENDER_WARP);
+  testObject.getVisualizer().setRenderMode(LaneVisualizer::RENDER_WARP);
+  FrameWorkspace serialWorkspace, workspace;
+  serialWorkspace.allocate(frame.size());
+  workspace.allocate(frame.size());
+  int numThreads = cv::getNumThreads();
+  cv::setNumThreads(1);
+  serialObject.processFrame(frame, serialWorkspace);
+  cv::setNumThreads(numThreads);
+  testObject.processFrame(frame, workspace);
+  for (int lane = 0; lane < FrameWorkspace::NUM_LANE_BUFFERS; lane++) {
+    EXPECT_EQ(serialWorkspace.getLanePoints(lane),
+              workspace.getLanePoints(lane));
+  }
+  EXPECT_EQ(0, cv::norm(serialWorkspace.getBuffer(FrameWorkspace::DRAW_WINDOW),
+                        workspace.getBuffer(FrameWorkspace::DRAW_WINDOW),
+                        cv::NORM_INF));
+}
+/**
+ *@brief Test to ensure the coarse to fine search finds the lanes of the
+ *       full resolution search
+ */
+TEST_F(LaneDetectionTest, isPyramidSearchAccurate) {
+  cv::Mat frame(720, 1280, CV_8UC3, cv::Scalar(90, 95, 100));
+  cv::line(frame, cv::Point(600, 440), cv::Point(320, 670),
+           cv::Scalar(0, 210, 240), 12);
+  cv::line(frame, cv::Point(680, 440), cv::Point(1060, 670),
+           cv::Scalar(235, 235, 235), 12);
+  FrameWorkspace workspace;
+  workspace.allocate(frame.size());
+  testObject.processFrame(frame, workspace);
+  double meanColumn[FrameWorkspace::NUM_LANE_BUFFERS];
+  for (int lane = 0; lane < FrameWorkspace::NUM_LANE_BUFFERS; lane++) {
+    const LanePointSet& lanePts = workspace.getLanePoints(lane);
+    ASSERT_FALSE(lanePts.empty());
+    meanColumn[lane] = std::accumulate(lanePts.getX(),
+                                       lanePts.getX() + lanePts.size(), 0.0)
+        / lanePts.size();
+  }
+  for (int level = 1; level <= 2; level++) {
+    LaneDetection pyramidObject;
+    pyramidObject.setPyramidLevel(level);
+    EXPECT_EQ(level, pyramidObject.getPyramidLevel());
+    pyramidObject.processFrame(frame, workspace);
+    for (int lane = 0; lane < FrameWorkspace::NUM_LANE_BUFFERS; lane++) {
+      const LanePointSet& lanePts = workspace.getLanePoints(lane);
+      ASSERT_FALSE(lanePts.empty());
+      EXPECT_NEAR(meanColumn[lane],
+                  std::accumulate(lanePts.getX(),
+                                  lanePts.getX() + lanePts.size(), 0.0)
+                      / lanePts.size(), 4.0);
+    }
+  }
+}
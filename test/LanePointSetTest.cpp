@@ -0,0 +1,66 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    LanePointSetTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Lane Point Set Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests the per window bookkeeping
+ *  and the capacity of the lane point set.
+ *
+ */
+#include <gtest/gtest.h>
+#include "LanePointSet.hpp"
+
+/**
+ * @brief  Class to test LanePointSet.
+ */
+class LanePointSetTest : public ::testing::Test {
+ protected:
+  LanePointSet testObject;
+};
+/**
+ *@brief Test to ensure the windows count their own hits
+ */
+TEST_F(LanePointSetTest, isWindowCounted) {
+  testObject.push(10, 100);
+  testObject.push(14, 99);
+  testObject.endWindow();
+  testObject.endWindow();
+  testObject.push(20, 50);
+  testObject.endWindow();
+  ASSERT_EQ(3, testObject.getNumWindows());
+  EXPECT_EQ(3u, testObject.size());
+  EXPECT_EQ(2u, testObject.getWindowCount(0));
+  EXPECT_EQ(0u, testObject.getWindowCount(1));
+  EXPECT_EQ(1u, testObject.getWindowCount(2));
+  EXPECT_EQ(2u, testObject.getWindowBegin(2));
+  EXPECT_DOUBLE_EQ(12.0, testObject.getWindowMeanX(0));
+  EXPECT_DOUBLE_EQ(0.0, testObject.getWindowMeanX(1));
+  EXPECT_EQ(20, testObject.getX()[2]);
+  EXPECT_EQ(50, testObject.getY()[2]);
+  std::vector<cv::Point> lanePts;
+  testObject.appendTo(lanePts);
+  ASSERT_EQ(3u, lanePts.size());
+  EXPECT_EQ(cv::Point(99, 14), lanePts[1]);
+}
+/**
+ *@brief Test to ensure the reserved capacity holds every window pixel and
+ *       survives a clear
+ */
+TEST_F(LanePointSetTest, isCapacityReserved) {
+  cv::Size imgSize(160, 80);
+  testObject.reserveForWindows(imgSize, 8, 0);
+  // 8 windows of 11 rows by 21 columns
+  std::size_t capacity = testObject.capacity();
+  EXPECT_LE(8u * 11 * 21, capacity);
+  for (int y = 0; y < imgSize.height; y++) {
+    testObject.push(y % 21, y);
+  }
+  testObject.clear();
+  EXPECT_TRUE(testObject.empty());
+  EXPECT_EQ(0, testObject.getNumWindows());
+  EXPECT_EQ(capacity, testObject.capacity());
+}
@@ -0,0 +1,73 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    LaneTrackerTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Lane Tracker Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests the temporal filters
+ *  of the lane bases and fits.
+ *
+ */
+#include <gtest/gtest.h>
+#include "LaneTracker.hpp"
+
+/**
+ * @brief  Class to test LaneTracker.
+ */
+class LaneTrackerTest : public ::testing::Test {
+ protected:
+  LaneTracker testObject;
+};
+/**
+ *@brief Test to ensure the moving average covers only the last frames
+ */
+TEST_F(LaneTrackerTest, isMovingAverageBounded) {
+  testObject.setHistoryLength(4);
+  EXPECT_FALSE(testObject.hasBase(LaneTracker::LEFT_LANE));
+  for (int i = 1; i <= 10; i++) {
+    testObject.updateBase(LaneTracker::LEFT_LANE, i);
+  }
+  // mean of 7, 8, 9 and 10
+  EXPECT_DOUBLE_EQ(8.5, testObject.getBase(LaneTracker::LEFT_LANE));
+  EXPECT_DOUBLE_EQ(8.5, testObject.predictBase(LaneTracker::LEFT_LANE));
+  EXPECT_FALSE(testObject.hasBase(LaneTracker::RIGHT_LANE));
+  testObject.updateBase(LaneTracker::RIGHT_LANE, 900);
+  EXPECT_DOUBLE_EQ(900, testObject.getBase(LaneTracker::RIGHT_LANE));
+  testObject.reset();
+  EXPECT_FALSE(testObject.hasBase(LaneTracker::LEFT_LANE));
+}
+/**
+ *@brief Test to ensure the exponential filter applies its gain
+ */
+TEST_F(LaneTrackerTest, isExponentialGainApplied) {
+  testObject.setMode(LaneTracker::TRACK_EXPONENTIAL);
+  testObject.setGain(0.25);
+  testObject.updateBase(LaneTracker::LEFT_LANE, 100);
+  testObject.updateBase(LaneTracker::LEFT_LANE, 200);
+  EXPECT_DOUBLE_EQ(125, testObject.getBase(LaneTracker::LEFT_LANE));
+}
+/**
+ *@brief Test to ensure the Kalman filter follows and predicts a lane
+ *       moving at a constant rate
+ */
+TEST_F(LaneTrackerTest, isKalmanPredicting) {
+  testObject.setMode(LaneTracker::TRACK_KALMAN);
+  cv::Mat coeffs(3, 1, CV_64F), predicted;
+  for (int i = 0; i < 50; i++) {
+    coeffs.at<double>(0) = 300 + 2 * i;
+    coeffs.at<double>(1) = 0.1;
+    coeffs.at<double>(2) = 1e-4;
+    testObject.updateFit(LaneTracker::RIGHT_LANE, coeffs);
+    testObject.updateBase(LaneTracker::RIGHT_LANE, 900 - i);
+  }
+  testObject.predictFit(LaneTracker::RIGHT_LANE, predicted);
+  EXPECT_NEAR(400, predicted.at<double>(0), 0.5);
+  EXPECT_NEAR(0.1, predicted.at<double>(1), 1e-6);
+  EXPECT_NEAR(850, testObject.predictBase(LaneTracker::RIGHT_LANE), 0.5);
+  testObject.resetFit(LaneTracker::RIGHT_LANE);
+  EXPECT_FALSE(testObject.hasFit(LaneTracker::RIGHT_LANE));
+  EXPECT_TRUE(testObject.hasBase(LaneTracker::RIGHT_LANE));
+}
@@ -0,0 +1,111 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    LaneVisualizerTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Lane Visualizer Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests the overlay and
+ *  null visualization sinks and the
+ *  sparse lane overlay.
+ *
+ */
+#include <gtest/gtest.h>
+#include "LaneVisualizer.hpp"
+
+/**
+ * @brief  Class to test LaneVisualizer.
+ */
+class LaneVisualizerTest : public ::testing::Test {
+ protected:
+  LaneVisualizer testObject;
+  cv::Mat frame;
+  PackedBinaryImage packedImg;
+  LanePointSet leftLane, rightLane;
+  /**
+   *@brief Create a frame with a mask of two lanes
+   */
+  virtual void SetUp() {
+    frame.create(120, 160, CV_8UC3);
+    frame.setTo(cv::Scalar(90, 95, 100));
+    cv::Mat mask(frame.size(), CV_8U, cv::Scalar(0));
+    mask.col(40).setTo(255);
+    mask.col(120).setTo(255);
+    mask.at<uchar>(5, 80) = 255;
+    packedImg.pack(mask);
+    for (int row = 0; row < mask.rows; row++) {
+      leftLane.push(40, row);
+      rightLane.push(120, row);
+    }
+    leftLane.endWindow();
+    rightLane.endWindow();
+  }
+};
+/**
+ *@brief Test to ensure the overlay marks the lanes over the mask
+ */
+TEST_F(LaneVisualizerTest, isOverlayDrawn) {
+  testObject.setMode(LaneVisualizer::VISUALIZE_OVERLAY);
+  testObject.setRenderMode(LaneVisualizer::RENDER_WARP);
+  EXPECT_TRUE(testObject.isEnabled());
+  cv::Mat T_identity = cv::Mat::eye(3, 3, CV_64F);
+  cv::Mat drawWindow, outputFrame;
+  testObject.render(frame, packedImg, leftLane, rightLane, T_identity,
+                    drawWindow, outputFrame);
+  EXPECT_EQ(cv::Vec3b(0, 255, 0), drawWindow.at<cv::Vec3b>(60, 40));
+  EXPECT_EQ(cv::Vec3b(0, 0, 255), drawWindow.at<cv::Vec3b>(60, 120));
+  EXPECT_EQ(cv::Vec3b(255, 255, 255), drawWindow.at<cv::Vec3b>(5, 80));
+  EXPECT_EQ(cv::Vec3b(0, 255, 0), outputFrame.at<cv::Vec3b>(60, 40));
+  EXPECT_EQ(frame.at<cv::Vec3b>(60, 60), outputFrame.at<cv::Vec3b>(60, 60));
+  // no GUI without the window sink
+  EXPECT_TRUE(testObject.show(outputFrame));
+}
+/**
+ *@brief Test to ensure the null sink draws nothing
+ */
+TEST_F(LaneVisualizerTest, isNullSinkIdle) {
+  testObject.setMode(LaneVisualizer::VISUALIZE_NONE);
+  EXPECT_FALSE(testObject.isEnabled());
+  cv::Mat T_identity = cv::Mat::eye(3, 3, CV_64F);
+  cv::Mat drawWindow, outputFrame;
+  testObject.render(frame, packedImg, leftLane, rightLane, T_identity,
+                    drawWindow, outputFrame);
+  EXPECT_TRUE(drawWindow.empty());
+  EXPECT_TRUE(outputFrame.empty());
+  EXPECT_TRUE(testObject.show(frame));
+}
+/**
+ *@brief Test to ensure the sparse overlay blends the lanes over their
+ *       region only
+ */
+TEST_F(LaneVisualizerTest, isSparseOverlayBlended) {
+  testObject.setMode(LaneVisualizer::VISUALIZE_OVERLAY);
+  EXPECT_EQ(LaneVisualizer::RENDER_SPARSE, testObject.getRenderMode());
+  testObject.setAlpha(0.5);
+  // vertical lanes at columns 40 and 120
+  cv::Mat laneFits[LaneTracker::NUM_LANES] = {
+      (cv::Mat_<double>(2, 1) << 40, 0), (cv::Mat_<double>(2, 1) << 120, 0) };
+  cv::Mat T_identity = cv::Mat::eye(3, 3, CV_64F);
+  cv::Mat overlay, outputFrame;
+  testObject.renderFits(frame, laneFits, frame.size(), T_identity, overlay,
+                        outputFrame);
+  ASSERT_EQ(frame.size(), outputFrame.size());
+  // lane area half blue, left curve half green, outside untouched
+  cv::Vec3b area = outputFrame.at<cv::Vec3b>(60, 80);
+  EXPECT_NEAR(172.5, area[0], 1.0);
+  EXPECT_NEAR(47.5, area[1], 1.0);
+  EXPECT_NEAR(50.0, area[2], 1.0);
+  cv::Vec3b leftCurve = outputFrame.at<cv::Vec3b>(60, 40);
+  EXPECT_NEAR(45.0, leftCurve[0], 1.0);
+  EXPECT_NEAR(175.0, leftCurve[1], 1.0);
+  EXPECT_EQ(frame.at<cv::Vec3b>(60, 10), outputFrame.at<cv::Vec3b>(60, 10));
+  EXPECT_EQ(frame.at<cv::Vec3b>(60, 150), outputFrame.at<cv::Vec3b>(60, 150));
+  // without fits the frame is copied
+  laneFits[LaneTracker::LEFT_LANE].release();
+  laneFits[LaneTracker::RIGHT_LANE].release();
+  testObject.renderFits(frame, laneFits, frame.size(), T_identity, overlay,
+                        outputFrame);
+  EXPECT_EQ(0, cv::norm(frame, outputFrame, cv::NORM_INF));
+}
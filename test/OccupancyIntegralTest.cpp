@@ -0,0 +1,69 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    OccupancyIntegralTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Occupancy Integral Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests the summed-area table
+ *  of the packed lane mask.
+ *
+ */
+#include <gtest/gtest.h>
+#include "OccupancyIntegral.hpp"
+
+/**
+ * @brief  Class to test OccupancyIntegral.
+ */
+class OccupancyIntegralTest : public ::testing::Test {
+ protected:
+  OccupancyIntegral testObject;
+  PackedBinaryImage packedMask;
+  cv::Mat mask;
+  /**
+   *@brief Create a sparse random mask with an empty band and build its
+   *       table
+   */
+  virtual void SetUp() {
+    cv::Mat noise(150, 203, CV_8U);
+    cv::theRNG().state = 2018;
+    cv::randu(noise, cv::Scalar(0), cv::Scalar(256));
+    mask = noise > 240;
+    mask.colRange(64, 140).setTo(cv::Scalar(0));
+    packedMask.pack(mask);
+    testObject.build(packedMask);
+  }
+};
+/**
+ *@brief Test to ensure window counts equal counting the mask
+ */
+TEST_F(OccupancyIntegralTest, isWindowCountExact) {
+  EXPECT_EQ(mask.size(), testObject.getSize());
+  std::vector<cv::Rect> windows = { cv::Rect(0, 0, 203, 150),
+      cv::Rect(10, 20, 30, 40), cv::Rect(60, 0, 90, 150),
+      cv::Rect(64, 10, 76, 100), cv::Rect(190, 140, 13, 10) };
+  for (auto& window : windows) {
+    EXPECT_EQ(cv::countNonZero(mask(window)), testObject.count(window));
+  }
+  EXPECT_EQ(0, testObject.count(cv::Rect(64, 10, 76, 100)));
+  // windows are clipped to the image
+  EXPECT_EQ(cv::countNonZero(mask(cv::Rect(180, 130, 23, 20))),
+            testObject.count(cv::Rect(180, 130, 40, 40)));
+  EXPECT_EQ(0, testObject.count(cv::Rect(-20, -20, 10, 10)));
+}
+/**
+ *@brief Test to ensure band histograms equal summing the mask rows
+ */
+TEST_F(OccupancyIntegralTest, isHistogramExact) {
+  std::vector<double> expectedHist, gotHist;
+  cv::reduce(mask.rowRange(75, 150), expectedHist, 0, CV_REDUCE_SUM,
+             CV_64FC1);
+  testObject.columnHistogram(75, 150, gotHist);
+  EXPECT_EQ(expectedHist, gotHist);
+  cv::reduce(mask.rowRange(13, 61), expectedHist, 0, CV_REDUCE_SUM,
+             CV_64FC1);
+  testObject.columnHistogram(13, 61, gotHist);
+  EXPECT_EQ(expectedHist, gotHist);
+}
@@ -0,0 +1,102 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    PackedBinaryImageTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Packed Binary Image Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests the one bit per pixel
+ *  binary image.
+ *
+ */
+#include <gtest/gtest.h>
+#include "PackedBinaryImage.hpp"
+
+/**
+ * @brief  Class to test PackedBinaryImage.
+ */
+class PackedBinaryImageTest : public ::testing::Test {
+ protected:
+  PackedBinaryImage testObject;
+  cv::Mat mask;
+  /**
+   *@brief Create a sparse random mask whose width is not a multiple of 64
+   */
+  virtual void SetUp() {
+    cv::Mat noise(181, 301, CV_8U);
+    cv::theRNG().state = 2018;
+    cv::randu(noise, cv::Scalar(0), cv::Scalar(256));
+    mask = noise > 230;
+  }
+};
+/**
+ *@brief Test to ensure packing and unpacking keeps every pixel
+ */
+TEST_F(PackedBinaryImageTest, isRoundTrip) {
+  testObject.pack(mask);
+  EXPECT_EQ(mask.size(), testObject.getSize());
+  EXPECT_EQ(5, testObject.getWordsPerRow());
+  cv::Mat unpackedMask;
+  testObject.unpack(unpackedMask);
+  EXPECT_EQ(0, cv::countNonZero(unpackedMask != mask));
+}
+/**
+ *@brief Test to ensure popcount and bit-scan agree with the unpacked mask
+ */
+TEST_F(PackedBinaryImageTest, isCountingExact) {
+  testObject.pack(mask);
+  std::vector<cv::Vec2i> spans = { cv::Vec2i(0, 301), cv::Vec2i(3, 61),
+      cv::Vec2i(64, 128), cv::Vec2i(70, 71), cv::Vec2i(100, 101),
+      cv::Vec2i(250, 301) };
+  for (int y = 0; y < mask.rows; y += 7) {
+    for (auto& span : spans) {
+      cv::Mat rowSpan = mask.row(y).colRange(span[0], span[1]);
+      EXPECT_EQ(cv::countNonZero(rowSpan),
+                testObject.countRange(y, span[0], span[1]));
+      int expectedX = span[1];
+      for (int x = span[0]; x < span[1]; x++) {
+        if (mask.at<uchar>(y, x)) {
+          expectedX = x;
+          break;
+        }
+      }
+      EXPECT_EQ(expectedX, testObject.nextSetBit(y, span[0], span[1]));
+    }
+  }
+  cv::Rect window(37, 20, 150, 90);
+  EXPECT_EQ(cv::countNonZero(mask(window)), testObject.countWindow(window));
+}
+/**
+ *@brief Test to ensure the column histogram equals summing the mask rows
+ */
+TEST_F(PackedBinaryImageTest, isHistogramExact) {
+  testObject.pack(mask);
+  std::vector<double> expectedHist, gotHist;
+  cv::reduce(mask.rowRange(90, 180), expectedHist, 0, CV_REDUCE_SUM,
+             CV_64FC1);
+  testObject.columnHistogram(90, 180, gotHist);
+  EXPECT_EQ(expectedHist, gotHist);
+}
+/**
+ *@brief Test to ensure max pooling sets a pixel for every set 2x2 block
+ */
+TEST_F(PackedBinaryImageTest, isMaxPoolExact) {
+  testObject.pack(mask);
+  PackedBinaryImage pooled;
+  pooled.maxPool(testObject);
+  cv::Size pooledSize((mask.cols + 1) / 2, (mask.rows + 1) / 2);
+  EXPECT_EQ(pooledSize, pooled.getSize());
+  cv::Mat expected(pooledSize, CV_8U, cv::Scalar(0));
+  for (int y = 0; y < mask.rows; y++) {
+    for (int x = 0; x < mask.cols; x++) {
+      if (mask.at<uchar>(y, x)) {
+        expected.at<uchar>(y / 2, x / 2) = 255;
+      }
+    }
+  }
+  cv::Mat pooledMask;
+  pooled.unpack(pooledMask);
+  EXPECT_EQ(0, cv::countNonZero(pooledMask != expected));
+}
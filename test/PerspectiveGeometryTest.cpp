@@ -0,0 +1,64 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    PerspectiveGeometryTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Perspective Geometry Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests the cached bird's-eye
+ *  perspective geometry.
+ *
+ */
+#include <gtest/gtest.h>
+#include "PerspectiveGeometry.hpp"
+
+/**
+ * @brief  Class to test PerspectiveGeometry.
+ */
+class PerspectiveGeometryTest : public ::testing::Test {
+ protected:
+  PerspectiveGeometry testObject;
+};
+/**
+ *@brief Test to ensure the cached homographies match the per frame solve
+ */
+TEST_F(PerspectiveGeometryTest, isTransformComputed) {
+  cv::Point2f inQuadrilateral[4] = { cv::Point(544, 462), cv::Point(731, 462),
+      cv::Point(1268, 708), cv::Point(0, 708) };
+  cv::Point2f outQuadrilateral[4] = { cv::Point(0, 0), cv::Point(1280, 0),
+      cv::Point(1280, 720), cv::Point(0, 720) };
+  cv::Mat expected = cv::getPerspectiveTransform(inQuadrilateral,
+                                                 outQuadrilateral);
+  cv::Mat expectedInv = cv::getPerspectiveTransform(outQuadrilateral,
+                                                    inQuadrilateral);
+  testObject.update(cv::Size(1280, 720));
+  EXPECT_LT(cv::norm(expected, testObject.getTransform(), cv::NORM_INF),
+            1e-9);
+  EXPECT_LT(cv::norm(expectedInv, testObject.getInverseTransform(),
+                     cv::NORM_INF), 1e-9);
+  // later frames of the same size reuse the cached matrices
+  const uchar* cached = testObject.getInverseTransform().data;
+  testObject.update(cv::Size(1280, 720));
+  EXPECT_EQ(cached, testObject.getInverseTransform().data);
+}
+/**
+ *@brief Test to ensure the cached warp maps reproduce cv::warpPerspective
+ */
+TEST_F(PerspectiveGeometryTest, isWarpEquivalent) {
+  std::vector<cv::Point2f> srcQuad = { cv::Point2f(100, 50),
+      cv::Point2f(220, 50), cv::Point2f(310, 230), cv::Point2f(10, 230) };
+  testObject.setSrcQuad(srcQuad);
+  ASSERT_EQ(srcQuad, testObject.getSrcQuad());
+  EXPECT_TRUE(testObject.getDstQuad().empty());
+  cv::Mat srcImg(240, 320, CV_8U, cv::Scalar(0));
+  cv::line(srcImg, cv::Point(120, 60), cv::Point(60, 220), 255, 4);
+  cv::line(srcImg, cv::Point(200, 60), cv::Point(270, 220), 255, 4);
+  cv::Mat gotImg, expectedImg;
+  testObject.warp(srcImg, gotImg);
+  cv::warpPerspective(srcImg, expectedImg, testObject.getTransform(),
+                      srcImg.size());
+  ASSERT_EQ(expectedImg.size(), gotImg.size());
+  EXPECT_LE(cv::norm(expectedImg, gotImg, cv::NORM_INF), 1.0);
+}
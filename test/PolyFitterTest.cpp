@@ -0,0 +1,185 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    PolyFitterTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Polynomial Fitter Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests the power sum fit against
+ *  the SVD of the Vandermonde matrix and the robust fits.
+ *
+ */
+#include <gtest/gtest.h>
+#include "PolyFitter.hpp"
+
+/**
+ * @brief  Class to test PolyFitter.
+ */
+class PolyFitterTest : public ::testing::Test {
+ protected:
+  PolyFitter testObject;
+  std::vector<cv::Point> lanePts;
+  /**
+   *@brief Sample a noisy quadratic lane, column against row
+   */
+  virtual void SetUp() {
+    cv::RNG rng(2018);
+    for (int row = 0; row < 720; row++) {
+      for (int i = 0; i < 10; i++) {
+        double col = 300 + 0.2 * row + 2e-4 * row * row;
+        lanePts.push_back(cv::Point(row,
+                                    cvRound(col + rng.uniform(-4.0, 4.0))));
+      }
+    }
+  }
+  /**
+   *@brief Least-squares fit by SVD of the Vandermonde matrix
+   */
+  cv::Mat fitSVD(const std::vector<cv::Point>& pts, int order) {
+    cv::Mat_<double> A(pts.size(), order + 1), b(pts.size(), 1);
+    for (std::size_t i = 0; i < pts.size(); i++) {
+      double power = 1.0;
+      for (int k = 0; k <= order; k++) {
+        A(i, k) = power;
+        power *= pts[i].x;
+      }
+      b(i, 0) = pts[i].y;
+    }
+    cv::Mat w;
+    cv::solve(A, b, w, cv::DECOMP_SVD);
+    return w;
+  }
+  /**
+   *@brief Largest difference of two fits over the rows of the image
+   */
+  double maxFitDiff(const cv::Mat& a, const cv::Mat& b) {
+    double maxDiff = 0.0;
+    for (int row = 0; row < 720; row++) {
+      double va = 0.0, vb = 0.0, power = 1.0;
+      for (int k = 0; k < static_cast<int>(a.total()); k++) {
+        va += a.at<double>(k) * power;
+        vb += b.at<double>(k) * power;
+        power *= row;
+      }
+      maxDiff = std::max(maxDiff, std::abs(va - vb));
+    }
+    return maxDiff;
+  }
+};
+/**
+ *@brief Test to ensure the power sum fit matches the SVD fit
+ */
+TEST_F(PolyFitterTest, isEquivalentToSVD) {
+  for (int order = 1; order <= 3; order++) {
+    testObject.setOrder(order);
+    cv::Mat coeffs;
+    testObject.fit(lanePts, coeffs);
+    ASSERT_EQ(order + 1, coeffs.rows);
+    EXPECT_EQ(CV_64F, coeffs.type());
+    EXPECT_LT(maxFitDiff(fitSVD(lanePts, order), coeffs), 1e-6);
+  }
+  testObject.setOrder(2);
+  testObject.setDomain(360.0, 360.0);
+  cv::Mat coeffs;
+  testObject.fit(lanePts, coeffs);
+  EXPECT_LT(maxFitDiff(fitSVD(lanePts, 2), coeffs), 1e-6);
+}
+/**
+ *@brief Test to ensure zero weights drop points and unit weights change
+ *       nothing
+ */
+TEST_F(PolyFitterTest, isWeighted) {
+  std::vector<cv::Point> pts(lanePts);
+  std::vector<float> weights(pts.size(), 1.0f);
+  for (int i = 0; i < 500; i++) {
+    pts.push_back(cv::Point(i, 1200));
+    weights.push_back(0.0f);
+  }
+  cv::Mat expected, coeffs;
+  testObject.fit(lanePts, expected);
+  testObject.fit(pts, weights, coeffs);
+  EXPECT_LT(maxFitDiff(expected, coeffs), 1e-6);
+}
+/**
+ *@brief Test to ensure points without weight leave the fit empty in every
+ *       mode
+ */
+TEST_F(PolyFitterTest, isZeroWeightUnfitted) {
+  std::vector<float> weights(lanePts.size(), 0.0f);
+  const int modes[] = { PolyFitter::FIT_LEAST_SQUARES, PolyFitter::FIT_HUBER,
+      PolyFitter::FIT_RANSAC };
+  for (int mode : modes) {
+    cv::Mat coeffs;
+    testObject.fit(lanePts, coeffs);
+    EXPECT_FALSE(coeffs.empty());
+    testObject.setMode(mode);
+    testObject.fit(lanePts, weights, coeffs);
+    EXPECT_TRUE(coeffs.empty());
+  }
+}
+/**
+ *@brief Test to ensure fewer points than coefficients give the least norm
+ *       fit through them, and no points give no fit
+ */
+TEST_F(PolyFitterTest, isUnderdeterminedFitted) {
+  std::vector<cv::Point> pts = { cv::Point(100, 350), cv::Point(500, 420) };
+  const int modes[] = { PolyFitter::FIT_LEAST_SQUARES, PolyFitter::FIT_HUBER,
+      PolyFitter::FIT_RANSAC };
+  for (int mode : modes) {
+    testObject.setMode(mode);
+    cv::Mat coeffs;
+    testObject.fit(pts, coeffs);
+    ASSERT_EQ(3u, coeffs.total());
+    for (const cv::Point& pt : pts) {
+      double value = 0.0, power = 1.0;
+      for (int k = 0; k < 3; k++) {
+        value += coeffs.at<double>(k) * power;
+        power *= pt.x;
+      }
+      EXPECT_NEAR(pt.y, value, 1e-6);
+    }
+    testObject.fit(std::vector<cv::Point>(), coeffs);
+    EXPECT_TRUE(coeffs.empty());
+  }
+}
+/**
+ *@brief Test to ensure the robust fits ignore gross outliers
+ */
+TEST_F(PolyFitterTest, isRobust) {
+  cv::Mat expected;
+  testObject.fit(lanePts, expected);
+  std::vector<cv::Point> pts(lanePts);
+  for (int i = 0; i < 700; i++) {
+    pts.push_back(cv::Point(i, 1200));
+  }
+  cv::Mat plain, huber, ransac;
+  testObject.fit(pts, plain);
+  EXPECT_GT(maxFitDiff(expected, plain), 20.0);
+  testObject.setMode(PolyFitter::FIT_HUBER);
+  testObject.setIterations(10);
+  testObject.fit(pts, huber);
+  EXPECT_LT(maxFitDiff(expected, huber), maxFitDiff(expected, plain) / 4);
+  testObject.setMode(PolyFitter::FIT_RANSAC);
+  testObject.setIterations(50);
+  testObject.setRansacThreshold(8.0);
+  testObject.fit(pts, ransac);
+  EXPECT_LT(maxFitDiff(expected, ransac), 2.0);
+}
+/**
+ *@brief Test to ensure a fit of the lane point set in place matches the
+ *       fit of the points
+ */
+TEST_F(PolyFitterTest, isPointSetFitEqual) {
+  LanePointSet lanePointSet;
+  for (std::size_t i = 0; i < lanePts.size(); i++) {
+    // the points are (row, column), the set (column, row)
+    lanePointSet.push(lanePts[i].y, lanePts[i].x);
+  }
+  lanePointSet.endWindow();
+  cv::Mat coeffs, setCoeffs;
+  testObject.fit(lanePts, coeffs);
+  testObject.fit(lanePointSet, setCoeffs);
+  EXPECT_EQ(0, cv::norm(coeffs, setCoeffs, cv::NORM_INF));
+}
@@ -0,0 +1,57 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    PolygonSpansTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Polygon Spans Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests the per row span table
+ *  of the lane polygon.
+ *
+ */
+#include <gtest/gtest.h>
+#include "PolygonSpans.hpp"
+
+/**
+ * @brief  Class to test PolygonSpans.
+ */
+class PolygonSpansTest : public ::testing::Test {
+ protected:
+  PolygonSpans testObject;
+};
+/**
+ *@brief Test to ensure the spans cover exactly the filled polygon
+ */
+TEST_F(PolygonSpansTest, isPolygonRasterized) {
+  std::vector<cv::Point> lanePoints = { cv::Point(560, 429),
+      cv::Point(690, 429), cv::Point(1155, 672), cv::Point(225, 672) };
+  testObject.setVertices(lanePoints);
+  EXPECT_EQ(lanePoints, testObject.getVertices());
+  testObject.update(cv::Size(1280, 720));
+  EXPECT_EQ(429, testObject.getBeginRow());
+  EXPECT_EQ(673, testObject.getEndRow());
+  cv::Mat expectedMask(720, 1280, CV_8U, cv::Scalar(0));
+  cv::fillConvexPoly(expectedMask, lanePoints, 255);
+  cv::Mat gotMask;
+  testObject.toMask(gotMask);
+  EXPECT_EQ(0, cv::countNonZero(gotMask != expectedMask));
+  cv::Vec2i span = testObject.getSpan(100);
+  EXPECT_LE(span[1], span[0]);
+}
+/**
+ *@brief Test to ensure new vertices are rasterized again
+ */
+TEST_F(PolygonSpansTest, isPolygonUpdated) {
+  std::vector<cv::Point> square = { cv::Point(2, 3), cv::Point(5, 3),
+      cv::Point(5, 6), cv::Point(2, 6) };
+  testObject.setVertices(square);
+  testObject.update(cv::Size(10, 10));
+  EXPECT_EQ(cv::Vec2i(2, 6), testObject.getSpan(4));
+  std::vector<cv::Point> wider = { cv::Point(0, 3), cv::Point(9, 3),
+      cv::Point(9, 6), cv::Point(0, 6) };
+  testObject.setVertices(wider);
+  testObject.update(cv::Size(10, 10));
+  EXPECT_EQ(cv::Vec2i(0, 10), testObject.getSpan(4));
+}
@@ -0,0 +1,96 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    SharedCalibrationTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Shared Calibration Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests that the shared calibration
+ *  artefacts match the per stream caches and are
+ *  matched to equal calibrations only.
+ *
+ */
+#include <gtest/gtest.h>
+#include <vector>
+#include "SharedCalibration.hpp"
+
+/**
+ * @brief  Class to test SharedCalibration.
+ */
+class SharedCalibrationTest : public ::testing::Test {
+ protected:
+  cv::Mat intrinsic;
+  cv::Mat distortionCoeffs;
+  std::vector<cv::Point2f> srcQuad;
+  std::vector<cv::Point2f> dstQuad;
+  std::vector<cv::Point> laneROIVertices;
+  cv::Size imgSize;
+  SharedCalibrationTest()
+      : intrinsic((cv::Mat_<double>(3, 3) << 1154.2, 0.0, 671.6, 0.0,
+                   1148.2, 386.0, 0.0, 0.0, 1.0)),
+        distortionCoeffs((cv::Mat_<double>(1, 5) << -0.24, -0.05, -0.001,
+                          0.0, 0.02)),
+        srcQuad({ cv::Point2f(544, 462), cv::Point2f(731, 462),
+                  cv::Point2f(1268, 708), cv::Point2f(0, 708) }),
+        laneROIVertices({ cv::Point(560, 429), cv::Point(690, 429),
+                          cv::Point(1155, 672), cv::Point(225, 672) }),
+        imgSize(1280, 720) {
+  }
+};
+/**
+ *@brief Test to ensure the artefacts equal the ones built per stream
+ */
+TEST_F(SharedCalibrationTest, isArtefactEquivalent) {
+  SharedCalibration testObject(intrinsic, distortionCoeffs, srcQuad, dstQuad,
+                               laneROIVertices, imgSize, false);
+  EXPECT_EQ(imgSize, testObject.getImageSize());
+  EXPECT_FALSE(testObject.isFusedRemap());
+  cv::Mat map1, map2;
+  cv::initUndistortRectifyMap(intrinsic, distortionCoeffs, cv::Mat(),
+                              intrinsic, imgSize, CV_16SC2, map1, map2);
+  EXPECT_EQ(0, cv::norm(map1, testObject.getUndistortMap1(), cv::NORM_INF));
+  EXPECT_EQ(0, cv::norm(map2, testObject.getUndistortMap2(), cv::NORM_INF));
+  PerspectiveGeometry geometry;
+  geometry.setSrcQuad(srcQuad);
+  geometry.update(imgSize);
+  EXPECT_EQ(0, cv::norm(geometry.getTransform(),
+                        testObject.getPerspectiveGeometry().getTransform(),
+                        cv::NORM_INF));
+  PolygonSpans spans;
+  spans.setVertices(laneROIVertices);
+  spans.update(imgSize);
+  EXPECT_EQ(spans.getBeginRow(), testObject.getLaneSpans().getBeginRow());
+  EXPECT_EQ(spans.getEndRow(), testObject.getLaneSpans().getEndRow());
+  EXPECT_EQ(spans.getSpan(600), testObject.getLaneSpans().getSpan(600));
+  // the fused remap replaces the undistortion maps
+  SharedCalibration fusedObject(intrinsic, distortionCoeffs, srcQuad, dstQuad,
+                                laneROIVertices, imgSize, true);
+  EXPECT_TRUE(fusedObject.isFusedRemap());
+  EXPECT_TRUE(fusedObject.getUndistortMap1().empty());
+  EXPECT_TRUE(fusedObject.getBirdsEyeRemap().isBuiltFor(imgSize, imgSize));
+}
+/**
+ *@brief Test to ensure only an equal calibration matches
+ */
+TEST_F(SharedCalibrationTest, isCalibrationMatched) {
+  SharedCalibration testObject(intrinsic, distortionCoeffs, srcQuad, dstQuad,
+                               laneROIVertices, imgSize, false);
+  EXPECT_TRUE(testObject.matches(intrinsic.clone(), distortionCoeffs, srcQuad,
+                                 dstQuad, laneROIVertices, false));
+  EXPECT_FALSE(testObject.matches(intrinsic, distortionCoeffs, srcQuad,
+                                  dstQuad, laneROIVertices, true));
+  cv::Mat otherCoeffs = distortionCoeffs.clone();
+  otherCoeffs.at<double>(0) = -0.1;
+  EXPECT_FALSE(testObject.matches(intrinsic, otherCoeffs, srcQuad, dstQuad,
+                                  laneROIVertices, false));
+  std::vector<cv::Point2f> otherQuad = srcQuad;
+  otherQuad[0].x += 1;
+  EXPECT_FALSE(testObject.matches(intrinsic, distortionCoeffs, otherQuad,
+                                  dstQuad, laneROIVertices, false));
+  // the artefacts keep their own copy of the camera matrix
+  intrinsic.at<double>(0, 0) = 1000.0;
+  EXPECT_FALSE(testObject.matches(intrinsic, distortionCoeffs, srcQuad,
+                                  dstQuad, laneROIVertices, false));
+}
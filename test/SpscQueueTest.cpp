@@ -0,0 +1,71 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    SpscQueueTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Single Producer Single Consumer Queue Class Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests the bounds and the order
+ *  of the lock-free ring buffer.
+ *
+ */
+#include <gtest/gtest.h>
+#include <thread>
+#include "SpscQueue.hpp"
+
+/**
+ * @brief  Class to test SpscQueue.
+ */
+class SpscQueueTest : public ::testing::Test {
+ protected:
+  SpscQueue<int> testObject;
+};
+/**
+ *@brief Test to ensure the queue is bounded and first in, first out
+ */
+TEST_F(SpscQueueTest, isBounded) {
+  testObject.reset(3);
+  EXPECT_EQ(3u, testObject.capacity());
+  EXPECT_TRUE(testObject.empty());
+  for (int i = 0; i < 3; i++) {
+    EXPECT_TRUE(testObject.tryPush(i));
+  }
+  EXPECT_FALSE(testObject.tryPush(3));
+  EXPECT_EQ(3u, testObject.size());
+  int item = -1;
+  EXPECT_TRUE(testObject.tryPop(item));
+  EXPECT_EQ(0, item);
+  // wraps around the ring
+  EXPECT_TRUE(testObject.tryPush(3));
+  for (int i = 1; i <= 3; i++) {
+    EXPECT_TRUE(testObject.tryPop(item));
+    EXPECT_EQ(i, item);
+  }
+  EXPECT_FALSE(testObject.tryPop(item));
+}
+/**
+ *@brief Test to ensure items cross threads in order
+ */
+TEST_F(SpscQueueTest, isOrderedAcrossThreads) {
+  testObject.reset(8);
+  const int numItems = 100000;
+  std::thread producer([this, numItems]() {
+    for (int i = 0; i < numItems; i++) {
+      while (!testObject.tryPush(i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+  int expected = 0;
+  while (expected < numItems) {
+    int item;
+    if (testObject.tryPop(item)) {
+      ASSERT_EQ(expected, item);
+      expected++;
+    }
+  }
+  producer.join();
+  EXPECT_TRUE(testObject.empty());
+}
@@ -0,0 +1,229 @@
+/**
+ *  Copyright [2018] Akash Guha
+ *  @file    SteadyStateAllocationTest.cpp
+ *  @author  Akash Guha
+ *
+ *  @brief Steady State Allocation Test
+ *
+ *  @section DESCRIPTION
+ *
+ *  This module tests that the pipeline runs
+ *  without allocations once the frame workspace is sized,
+ *  apart from the row-block scratch of cv::remap.
+ *  It replaces the global operator new, so it is built as
+ *  its own executable, cpp-alloc-test, and the other
+ *  suites do not run under the counters. Every global
+ *  operator new and every cv::Mat buffer of the default
+ *  allocator is counted, not only the workspace buffers.
+ *  Scratch that OpenCV routines take with cv::fastMalloc
+ *  outside a cv::Mat is not counted. The frames run with
+ *  one OpenCV thread, the limit FrameWorkspace states.
+ *
+ */
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "FrameWorkspace.hpp"
+#include "LaneDetection.hpp"
+
+namespace {
+std::atomic<uint64_t> heapAllocationCount(0);  // global operator new calls
+/**
+ * @brief  Default cv::Mat allocator counting the buffers it allocates.
+ */
+class MatAllocationCounter : public cv::MatAllocator {
+ public:
+  mutable std::atomic<uint64_t> allocationCount;  // buffers allocated
+  mutable std::atomic<uint64_t> remapScratchCount;  // of them remap scratch
+  mutable std::atomic<uint64_t> headerCount;  // operator new of the headers
+  MatAllocationCounter()
+      : allocationCount(0),
+        remapScratchCount(0),
+        headerCount(0) {
+  }
+  cv::UMatData* allocate(int dims, const int* sizes, int type, void* data,
+                         size_t* step, int flags,
+                         cv::UMatUsageFlags usageFlags) const {
+    allocationCount++;
+    // cv::remap converts each block of rows of the maps into CV_16SC2
+    // positions and CV_16UC1 weight indices; the pipeline makes no other
+    // Mats of these types once its maps are built
+    if (type == CV_16SC2 || type == CV_16UC1) {
+      remapScratchCount++;
+    }
+    // the header of the buffer comes from the global operator new
+    uint64_t heapBefore = heapAllocationCount;
+    cv::UMatData* u = cv::Mat::getStdAllocator()->allocate(
+        dims, sizes, type, data, step, flags, usageFlags);
+    headerCount += heapAllocationCount - heapBefore;
+    return u;
+  }
+  bool allocate(cv::UMatData* data, int accessflags,
+                cv::UMatUsageFlags usageFlags) const {
+    return cv::Mat::getStdAllocator()->allocate(data, accessflags,
+                                                usageFlags);
+  }
+  void deallocate(cv::UMatData* data) const {
+    cv::Mat::getStdAllocator()->deallocate(data);
+  }
+};
+// outlives every cv::Mat it allocates
+MatAllocationCounter matAllocationCounter;
+}  // namespace
+
+/**
+ * @brief  Replaceable global allocation functions counting every
+ *         allocation of this test executable.
+ */
+void* operator new(std::size_t size) {
+  heapAllocationCount++;
+  void* ptr = std::malloc(size ? size : 1);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+void* operator new[](std::size_t size) {
+  return ::operator new(size);
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  heapAllocationCount++;
+  return std::malloc(size ? size : 1);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return ::operator new(size, std::nothrow);
+}
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+void operator delete[](void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+
+/**
+ * @brief  Class to test the allocations of the pipeline once its
+ *         FrameWorkspace is sized.
+ */
+class SteadyStateAllocationTest : public ::testing::Test {
+ protected:
+  FrameWorkspace testObject;
+  LaneDetection lanes;
+  cv::Mat srcImg;
+  cv::MatAllocator* defaultAllocator;  // allocator before the test
+  /**
+   *@brief Create a synthetic road frame with a yellow and a white lane
+   *       marking
+   */
+  virtual void SetUp() {
+    srcImg.create(720, 1280, CV_8UC3);
+    srcImg.setTo(cv::Scalar(90, 95, 100));
+    cv::line(srcImg, cv::Point(600, 440), cv::Point(320, 670),
+             cv::Scalar(0, 210, 240), 12);
+    cv::line(srcImg, cv::Point(680, 440), cv::Point(1060, 670),
+             cv::Scalar(235, 235, 235), 12);
+    defaultAllocator = cv::Mat::getDefaultAllocator();
+    cv::Mat::setDefaultAllocator(&matAllocationCounter);
+  }
+  /**
+   *@brief Restore the default cv::Mat allocator
+   */
+  virtual void TearDown() {
+    cv::Mat::setDefaultAllocator(defaultAllocator);
+  }
+  /**
+   *@brief Run the pipeline on a few frames and check that only the first
+   *       ones allocate, in the workspace or anywhere else, apart from the
+   *       scratch cv::remap takes per call
+   */
+  void expectSteadyStateAllocationFree() {
+    // with several threads the pthreads backend of cv::parallel_for_
+    // allocates a job per call inside OpenCV, so the loops run inline
+    int numThreads = cv::getNumThreads();
+    cv::setNumThreads(1);
+    testObject.allocate(srcImg.size());
+    // the first frames size the scratch of the full and the tracked search
+    for (int i = 0; i < 2; i++) {
+      lanes.processFrame(srcImg, testObject);
+    }
+    testObject.resetAllocationCount();
+    const uchar* outputData = testObject.getBuffer(
+        FrameWorkspace::OUTPUT_FRAME).data;
+    const double* histData = testObject.getHistogram().data();
+    std::size_t laneCapacity[FrameWorkspace::NUM_LANE_BUFFERS];
+    for (int lane = 0; lane < FrameWorkspace::NUM_LANE_BUFFERS; lane++) {
+      laneCapacity[lane] = testObject.getLanePoints(lane).capacity();
+    }
+    uint64_t heapBefore = heapAllocationCount;
+    uint64_t matBefore = matAllocationCounter.allocationCount;
+    uint64_t headerBefore = matAllocationCounter.headerCount;
+    uint64_t remapBefore = matAllocationCounter.remapScratchCount;
+    for (int i = 0; i < 3; i++) {
+      lanes.processFrame(srcImg, testObject);
+    }
+    uint64_t heapAllocations = heapAllocationCount - heapBefore
+        - (matAllocationCounter.headerCount - headerBefore);
+    uint64_t matAllocations = matAllocationCounter.allocationCount
+        - matBefore;
+    uint64_t remapScratch = matAllocationCounter.remapScratchCount
+        - remapBefore;
+    cv::setNumThreads(numThreads);
+    // nothing but the buffers cv::remap takes and frees within each call
+    EXPECT_EQ(0u, heapAllocations);
+    EXPECT_EQ(remapScratch, matAllocations);
+    EXPECT_EQ(0u, testObject.getAllocationCount());
+    EXPECT_EQ(outputData,
+              testObject.getBuffer(FrameWorkspace::OUTPUT_FRAME).data);
+    EXPECT_EQ(histData, testObject.getHistogram().data());
+    for (int lane = 0; lane < FrameWorkspace::NUM_LANE_BUFFERS; lane++) {
+      EXPECT_EQ(laneCapacity[lane], testObject.getLanePoints(lane).capacity());
+      EXPECT_FALSE(testObject.getLanePoints(lane).empty());
+    }
+  }
+};
+/**
+ *@brief Test to ensure the steady state of the pipeline does not allocate
+ */
+TEST_F(SteadyStateAllocationTest, isSteadyStateAllocationFree) {
+  expectSteadyStateAllocationFree();
+}
+/**
+ *@brief Test to ensure the ROI only path does not allocate either
+ */
+TEST_F(SteadyStateAllocationTest, isROISteadyStateAllocationFree) {
+  lanes.getImageProcessing().setROIProcessing(true);
+  expectSteadyStateAllocationFree();
+}
+/**
+ *@brief Test to ensure tracking the lanes from frame to frame does not
+ *       allocate either
+ */
+TEST_F(SteadyStateAllocationTest, isTrackingSteadyStateAllocationFree) {
+  lanes.setTracking(true);
+  expectSteadyStateAllocationFree();
+  EXPECT_TRUE(lanes.isTrackValid());
+}
+/**
+ *@brief Test to ensure a denoising stage that is not bypassed does not
+ *       allocate either
+ */
+TEST_F(SteadyStateAllocationTest, isDenoisedSteadyStateAllocationFree) {
+  ImageProcessing& processImage = lanes.getImageProcessing();
+  processImage.setDenoiseMode(Denoiser::DENOISE_GAUSSIAN5_FIXED);
+  processImage.setgaussianSigmaX(1.0);
+  processImage.setgaussianSigmaY(1.0);
+  ASSERT_FALSE(processImage.isDenoiseBypassed());
+  expectSteadyStateAllocationFree();
+}